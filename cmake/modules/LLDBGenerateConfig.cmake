@@ -22,9 +22,28 @@ check_cxx_source_compiles("
     #include <sys/syscall.h>
     int main() { return __NR_process_vm_readv; }"
     HAVE_NR_PROCESS_VM_READV)
+check_cxx_source_compiles("
+  #include <sys/uio.h>
+  int main() { process_vm_writev(0, nullptr, 0, nullptr, 0, 0); return 0; }"
+  HAVE_PROCESS_VM_WRITEV)
+check_cxx_source_compiles("
+    #include <sys/syscall.h>
+    int main() { return __NR_process_vm_writev; }"
+    HAVE_NR_PROCESS_VM_WRITEV)
 
 check_library_exists(compression compression_encode_buffer "" HAVE_LIBCOMPRESSION)
 
+# Portable libraries for gdb-remote packet compression on hosts that don't
+# have Apple's libcompression.
+check_include_file(zlib.h HAVE_ZLIB_H)
+if(HAVE_ZLIB_H)
+  check_library_exists(z deflateInit2_ "" HAVE_LIBZ)
+endif()
+check_include_file(lz4.h HAVE_LZ4_H)
+if(HAVE_LZ4_H)
+  check_library_exists(lz4 LZ4_compress_default "" HAVE_LIBLZ4)
+endif()
+
 # These checks exist in LLVM's configuration, so I want to match the LLVM names
 # so that the check isn't duplicated, but we translate them into the LLDB names
 # so that I don't have to change all the uses at the moment.
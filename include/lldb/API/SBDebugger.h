@@ -115,6 +115,15 @@ public:
   // Return true if target is deleted from the target list of the debugger.
   bool DeleteTarget(lldb::SBTarget &target);
 
+  // Load each of the core files in a target of its own for the executable
+  // "filename", run "commands" on it and return their output, one report
+  // per core file in the same order. The cores are analyzed in parallel, and
+  // the executable and its dependents are loaded and indexed only once for
+  // all of them.
+  lldb::SBStringList AnalyzeCoreFiles(const char *filename,
+                                      const lldb::SBStringList &core_files,
+                                      const lldb::SBStringList &commands);
+
   lldb::SBTarget GetTargetAtIndex(uint32_t idx);
 
   uint32_t GetIndexOfTarget(lldb::SBTarget target);
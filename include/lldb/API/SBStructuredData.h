@@ -99,6 +99,7 @@ public:
 protected:
   friend class SBTraceOptions;
   friend class SBDebugger;
+  friend class SBTarget;
 
   StructuredDataImplUP m_impl_up;
 };
@@ -806,6 +806,12 @@ public:
 
   lldb::addr_t GetStackRedZoneSize();
 
+  //------------------------------------------------------------------
+  /// Returns the statistics that "statistics dump --json" prints for
+  /// this target.
+  //------------------------------------------------------------------
+  lldb::SBStructuredData GetStatistics();
+
   lldb::SBLaunchInfo GetLaunchInfo() const;
 
   void SetLaunchInfo(const lldb::SBLaunchInfo &launch_info);
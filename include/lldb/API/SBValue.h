@@ -197,6 +197,27 @@ public:
                                 lldb::DynamicValueType use_dynamic,
                                 bool can_create_synthetic);
 
+  //------------------------------------------------------------------
+  /// Get the children at indexes [start, start + count) of a value.
+  ///
+  /// This is the same as calling GetChildAtIndex() for each index in
+  /// the range, except that synthetic child providers can fetch the
+  /// whole range at once. Clients that page through containers with
+  /// many children should use this instead.
+  ///
+  /// @param[in] start
+  ///     The index of the first child to get.
+  ///
+  /// @param[in] count
+  ///     The number of children to get. The range is clamped to the
+  ///     number of children the value has.
+  ///
+  /// @return
+  ///     A list with a value for each index in the range. Children that
+  ///     couldn't be created are invalid values.
+  //------------------------------------------------------------------
+  lldb::SBValueList GetChildrenRange(uint32_t start, uint32_t count);
+
   // Matches children of this object only and will match base classes and
   // member names if this is a clang typed object.
   uint32_t GetIndexOfChildWithName(const char *name);
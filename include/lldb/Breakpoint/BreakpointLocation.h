@@ -381,6 +381,10 @@ private:
 
   void UndoBumpHitCount();
 
+  // Count a hit the debug stub didn't stop at, using up the ignore counts
+  // the way ShouldStop would have.
+  void SkippedHit();
+
   //------------------------------------------------------------------
   // Constructors and Destructors
   //
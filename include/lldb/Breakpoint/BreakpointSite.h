@@ -129,6 +129,16 @@ public:
   //------------------------------------------------------------------
   bool ShouldStop(StoppointCallbackContext *context) override;
 
+  //------------------------------------------------------------------
+  /// Account for hits of this site that the debug stub skipped on its own
+  /// because of the ignore count it was given. Each owner counts them as
+  /// hits it ignored.
+  ///
+  /// @param[in] count
+  ///    The number of hits that were skipped.
+  //------------------------------------------------------------------
+  void AddSkippedHits(uint32_t count);
+
   //------------------------------------------------------------------
   /// Standard Dump method
   ///
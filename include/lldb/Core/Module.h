@@ -15,6 +15,7 @@
 #include "lldb/Symbol/SymbolContextScope.h"
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Target/PathMappingList.h"
+#include "lldb/Target/Statistics.h"
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/ConstString.h" // for ConstString
 #include "lldb/Utility/FileSpec.h"
@@ -771,6 +772,14 @@ public:
   //------------------------------------------------------------------
   const lldb_private::UUID &GetUUID();
 
+  //------------------------------------------------------------------
+  /// The time spent parsing this module's symbol table, and building
+  /// the indexes used to look symbols up by name and address.
+  //------------------------------------------------------------------
+  StatsDuration &GetSymtabParseTime() { return m_symtab_parse_time; }
+
+  StatsDuration &GetSymtabIndexTime() { return m_symtab_index_time; }
+
   //------------------------------------------------------------------
   /// A debugging function that will cause everything in a module to
   /// be parsed.
@@ -1133,6 +1142,8 @@ protected:
   std::atomic<bool> m_did_load_objfile{false};
   std::atomic<bool> m_did_load_symbol_vendor{false};
   std::atomic<bool> m_did_parse_uuid{false};
+  StatsDuration m_symtab_parse_time;
+  StatsDuration m_symtab_index_time;
   mutable bool m_file_has_changed : 1,
       m_first_file_changed_log : 1; /// See if the module was modified after it
                                     /// was initially opened.
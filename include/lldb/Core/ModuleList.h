@@ -82,6 +82,13 @@ public:
   FileSpec GetClangModulesCachePath() const;
   bool SetClangModulesCachePath(llvm::StringRef path);
   bool GetEnableExternalLookup() const;
+
+  // Zero means one thread per CPU.
+  uint32_t GetParallelThreadCount() const;
+
+private:
+  static void ParallelThreadCountValueChangedCallback(void *baton,
+                                                      OptionValue *option_value);
 }; 
 
 //----------------------------------------------------------------------
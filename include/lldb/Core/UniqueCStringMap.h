@@ -61,6 +61,14 @@ public:
 
   void Append(const Entry &e) { m_map.push_back(e); }
 
+  //------------------------------------------------------------------
+  // Append all of the entries in "map" to this map. Sort() must be
+  // called before doing any searches by name.
+  //------------------------------------------------------------------
+  void Append(const UniqueCStringMap<T> &map) {
+    m_map.insert(m_map.end(), map.m_map.begin(), map.m_map.end());
+  }
+
   void Clear() { m_map.clear(); }
 
   //------------------------------------------------------------------
@@ -38,6 +38,7 @@
 #include <mutex>   // for recursive_mutex
 #include <string>  // for string
 #include <utility> // for pair
+#include <vector>
 
 #include <stddef.h> // for size_t
 #include <stdint.h> // for uint32_t
@@ -488,6 +489,13 @@ public:
 
   virtual lldb::ValueObjectSP GetChildAtIndex(size_t idx, bool can_create);
 
+  // Append the children at indexes [start, start + count) to "children",
+  // creating them if necessary. The range is clamped to the number of
+  // children, and children that can't be made are appended as null shared
+  // pointers. Returns the number of entries appended.
+  virtual size_t GetChildrenRange(size_t start, size_t count,
+                                  std::vector<lldb::ValueObjectSP> &children);
+
   // this will always create the children if necessary
   lldb::ValueObjectSP GetChildAtIndexPath(llvm::ArrayRef<size_t> idxs,
                                           size_t *index_of_error = nullptr);
@@ -63,6 +63,9 @@ public:
 
   lldb::ValueObjectSP GetChildAtIndex(size_t idx, bool can_create) override;
 
+  size_t GetChildrenRange(size_t start, size_t count,
+                          std::vector<lldb::ValueObjectSP> &children) override;
+
   lldb::ValueObjectSP GetChildMemberWithName(const ConstString &name,
                                              bool can_create) override;
 
@@ -170,6 +173,8 @@ private:
 
   void CopyValueData(ValueObject *source);
 
+  void CacheChild(size_t idx, lldb::ValueObjectSP &child_sp);
+
   DISALLOW_COPY_AND_ASSIGN(ValueObjectSynthetic);
 };
 
@@ -52,6 +52,14 @@ public:
 
   virtual lldb::ValueObjectSP GetChildAtIndex(size_t idx) = 0;
 
+  // Append the children at indexes [start, start + count) to "children",
+  // using a null shared pointer for any that can't be made. The caller has
+  // already clamped the range to the number of children. Front ends whose
+  // children are laid out contiguously in memory should override this to
+  // read the whole range at once.
+  virtual void GetChildrenRange(size_t start, size_t count,
+                                std::vector<lldb::ValueObjectSP> &children);
+
   virtual size_t GetIndexOfChildWithName(const ConstString &name) = 0;
 
   // this function is assumed to always succeed and it if fails, the front-end
@@ -104,6 +112,17 @@ protected:
                                                 const ExecutionContext &exe_ctx,
                                                 CompilerType type);
 
+  // Append children named "[start]" onwards for the "count" elements of
+  // "type" found every "stride" bytes from "address". The elements are read
+  // from the process in a few large memory reads that fill its memory cache;
+  // the children themselves stay at their load addresses. Callers must not
+  // ask for more elements than the array has.
+  void CreateValueObjectsFromArray(size_t start, size_t count,
+                                   lldb::addr_t address, uint64_t stride,
+                                   const ExecutionContext &exe_ctx,
+                                   CompilerType type,
+                                   std::vector<lldb::ValueObjectSP> &children);
+
 private:
   bool m_valid;
   DISALLOW_COPY_AND_ASSIGN(SyntheticChildrenFrontEnd);
@@ -26,6 +26,14 @@
 
 #cmakedefine01 HAVE_NR_PROCESS_VM_READV
 
+#cmakedefine01 HAVE_PROCESS_VM_WRITEV
+
+#cmakedefine01 HAVE_NR_PROCESS_VM_WRITEV
+
 #cmakedefine HAVE_LIBCOMPRESSION
 
+#cmakedefine HAVE_LIBZ
+
+#cmakedefine HAVE_LIBLZ4
+
 #endif // #ifndef LLDB_HOST_CONFIG_H
@@ -11,6 +11,7 @@
 #define utility_TaskPool_h_
 
 #include "llvm/ADT/STLExtras.h"
+#include <chrono>     // for milliseconds
 #include <functional> // for bind, function
 #include <future>
 #include <list>
@@ -24,11 +25,23 @@ namespace lldb_private {
 // created the first
 // time the task pool is used. The TaskPool provide no guarantee about the order
 // the task will be run
-// and about what tasks will run in parallel. None of the task added to the task
-// pool should block
-// on something (mutex, future, condition variable) what will be set only by the
-// completion of an
-// other task on the task pool as they may run on the same thread sequentally.
+// and about what tasks will run in parallel.
+//
+// Every worker thread owns a queue of tasks. Tasks added from a worker thread
+// go to that worker's queue and are run in last in, first out order by the
+// worker itself, while idle workers steal the oldest tasks from the queues of
+// the other workers. Worker threads stay around and sleep when there is
+// nothing to do.
+//
+// A task may add more tasks and wait for them to finish, but it must use
+// TaskPool::Wait (or RunTasks/TaskMapOverInt, which use it) to do so. The
+// tasks a thread (or a running task) adds form a group, and Wait runs the
+// queued tasks of the caller's own group on the calling thread before it
+// blocks, so the pool can't deadlock when all of its workers are waiting.
+// Wait never runs tasks of other groups: the caller may hold locks that
+// those tasks need. Tasks should not block on anything else (mutex,
+// condition variable) that will only be released by the completion of
+// another task on the task pool.
 class TaskPool {
 public:
   // Add a new task to the task pool and return a std::future belonging to the
@@ -45,15 +58,30 @@ public:
   // where listing
   // them as function arguments is acceptable. For running large number of tasks
   // you should use
-  // AddTask for each task and then call wait() on each returned future.
+  // AddTask for each task and then call Wait() on each returned future.
   template <typename... T> static void RunTasks(T &&... tasks);
 
+  // Wait until "future" is ready, running tasks that the calling thread
+  // added itself on the calling thread in the meantime.
+  template <typename T> static void Wait(const std::future<T> &future);
+
+  // Set the maximum number of worker threads. Zero selects the number of
+  // hardware threads. Worker threads that are already running stop taking
+  // new tasks when the count is lowered.
+  static void SetThreadCount(unsigned thread_count);
+
+  static unsigned GetThreadCount();
+
 private:
   TaskPool() = delete;
 
   template <typename... T> struct RunTaskImpl;
 
   static void AddTaskImpl(std::function<void()> &&task_fn);
+
+  // Run a single queued task of the calling thread's group on the calling
+  // thread. Returns false if there were no such tasks.
+  static bool RunGroupTaskImpl();
 };
 
 template <typename F, typename... Args>
@@ -72,12 +100,24 @@ template <typename... T> void TaskPool::RunTasks(T &&... tasks) {
   RunTaskImpl<T...>::Run(std::forward<T>(tasks)...);
 }
 
+template <typename T> void TaskPool::Wait(const std::future<T> &future) {
+  while (future.wait_for(std::chrono::seconds(0)) !=
+         std::future_status::ready) {
+    // The rest of our tasks are already running on other threads and no new
+    // ones can show up while we are in here, so just block.
+    if (!RunGroupTaskImpl()) {
+      future.wait();
+      return;
+    }
+  }
+}
+
 template <typename Head, typename... Tail>
 struct TaskPool::RunTaskImpl<Head, Tail...> {
   static void Run(Head &&h, Tail &&... t) {
     auto f = AddTask(std::forward<Head>(h));
     RunTaskImpl<Tail...>::Run(std::forward<Tail>(t)...);
-    f.wait();
+    Wait(f);
   }
 };
 
@@ -85,9 +125,9 @@ template <> struct TaskPool::RunTaskImpl<> {
   static void Run() {}
 };
 
-// Run 'func' on every value from begin .. end-1.  Each worker will grab
-// 'batch_size' numbers at a time to work on, so for very fast functions, batch
-// should be large enough to avoid too much cache line contention.
+// Run 'func' on every value from begin .. end-1.  The calling thread works on
+// the values together with the workers, so this may be called from a task
+// that is running on the task pool.
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func);
 
@@ -10,10 +10,14 @@
 #ifndef liblldb_NativeBreakpoint_h_
 #define liblldb_NativeBreakpoint_h_
 
+#include "lldb/Host/common/NativeBreakpointCondition.h"
 #include "lldb/lldb-types.h"
 
+#include <vector>
+
 namespace lldb_private {
 class NativeBreakpointList;
+class NativeThreadProtocol;
 
 class NativeBreakpoint {
   friend class NativeBreakpointList;
@@ -34,6 +38,39 @@ public:
 
   virtual bool IsSoftwareBreakpoint() const = 0;
 
+  // Replace the conditions the debugger attached to this breakpoint. An empty
+  // list makes the breakpoint unconditional again.
+  void SetConditions(std::vector<NativeBreakpointCondition> conditions) {
+    m_conditions = std::move(conditions);
+  }
+
+  bool HasConditions() const { return !m_conditions.empty(); }
+
+  // Returns true if a thread that hit this breakpoint has to be reported to
+  // the debugger: the breakpoint is unconditional, one of its conditions is
+  // true for the thread or a condition couldn't be evaluated.
+  bool ConditionsSayStop(NativeThreadProtocol &thread) const;
+
+  // The number of hits to skip before the conditions are even looked at,
+  // like the debugger's own ignore counts.
+  void SetIgnoreCount(uint32_t ignore_count) { m_ignore_count = ignore_count; }
+
+  uint32_t GetIgnoreCount() const { return m_ignore_count; }
+
+  // Returns true if a thread that hit this breakpoint has to be reported to
+  // the debugger, taking both the ignore count and the conditions into
+  // account. This doesn't change any state; call RecordSkippedHit() once the
+  // hit has actually been skipped.
+  bool HitShouldStop(NativeThreadProtocol &thread) const;
+
+  // Count a hit that wasn't reported, using up one of the ignored hits if
+  // there are any left.
+  void RecordSkippedHit();
+
+  // The number of hits skipped since the last call because of the ignore
+  // count, and because the conditions were false. Resets both counts.
+  void TakeSkippedHitCounts(uint32_t &ignored, uint32_t &condition_false);
+
 protected:
   const lldb::addr_t m_addr;
   int32_t m_ref_count;
@@ -44,6 +81,10 @@ protected:
 
 private:
   bool m_enabled;
+  std::vector<NativeBreakpointCondition> m_conditions;
+  uint32_t m_ignore_count;
+  uint32_t m_ignored_hit_count;
+  uint32_t m_condition_false_hit_count;
 
   // -----------------------------------------------------------
   // interface for NativeBreakpointList
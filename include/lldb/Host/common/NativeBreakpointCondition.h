@@ -0,0 +1,123 @@
+//===-- NativeBreakpointCondition.h -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_NativeBreakpointCondition_h_
+#define liblldb_NativeBreakpointCondition_h_
+
+#include "lldb/Utility/Status.h"
+#include "lldb/lldb-types.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+
+#include <vector>
+
+namespace lldb_private {
+class NativeThreadProtocol;
+
+//----------------------------------------------------------------------
+/// @class NativeBreakpointCondition NativeBreakpointCondition.h
+/// A breakpoint condition that the debug server evaluates itself.
+///
+/// Conditions are compiled by the debugger into the bytecode of GDB's
+/// agent expressions and sent along with the "Z0" packet that inserts the
+/// breakpoint. Only the opcodes needed for simple conditions are
+/// implemented: constants, register and memory loads, integer arithmetic,
+/// comparisons and jumps. When the breakpoint is hit the stub can then
+/// resume the thread right away if the condition is false instead of
+/// reporting the stop to the debugger.
+//----------------------------------------------------------------------
+class NativeBreakpointCondition {
+public:
+  enum Opcode : uint8_t {
+    eOpAdd = 0x02,
+    eOpSub = 0x03,
+    eOpMul = 0x04,
+    eOpDivSigned = 0x05,
+    eOpDivUnsigned = 0x06,
+    eOpRemSigned = 0x07,
+    eOpRemUnsigned = 0x08,
+    eOpLsh = 0x09,
+    eOpRshSigned = 0x0a,
+    eOpRshUnsigned = 0x0b,
+    eOpLogNot = 0x0e,
+    eOpBitAnd = 0x0f,
+    eOpBitOr = 0x10,
+    eOpBitXor = 0x11,
+    eOpBitNot = 0x12,
+    eOpEqual = 0x13,
+    eOpLessSigned = 0x14,
+    eOpLessUnsigned = 0x15,
+    eOpExt = 0x16,     // 1 byte operand: number of bits to sign extend from
+    eOpRef8 = 0x17,
+    eOpRef16 = 0x18,
+    eOpRef32 = 0x19,
+    eOpRef64 = 0x1a,
+    eOpIfGoto = 0x20,  // 2 byte operand: offset from the start of the code
+    eOpGoto = 0x21,    // 2 byte operand: offset from the start of the code
+    eOpConst8 = 0x22,  // 1 byte operand
+    eOpConst16 = 0x23, // 2 byte big endian operand
+    eOpConst32 = 0x24, // 4 byte big endian operand
+    eOpConst64 = 0x25, // 8 byte big endian operand
+    eOpReg = 0x26,     // 2 byte big endian register number
+    eOpEnd = 0x27,
+    eOpDup = 0x28,
+    eOpPop = 0x29,
+    eOpZeroExt = 0x2a, // 1 byte operand: number of bits to keep
+    eOpSwap = 0x2b,
+  };
+
+  typedef llvm::function_ref<bool(uint32_t regnum, uint64_t &value)>
+      ReadRegisterCallback;
+  typedef llvm::function_ref<bool(lldb::addr_t addr, void *buf, size_t size)>
+      ReadMemoryCallback;
+
+  NativeBreakpointCondition(std::vector<uint8_t> bytecode);
+
+  //------------------------------------------------------------------
+  /// Check that the bytecode only uses supported opcodes, that all
+  /// operands are complete and that jumps stay inside the expression.
+  //------------------------------------------------------------------
+  Status Validate() const;
+
+  //------------------------------------------------------------------
+  /// Evaluate the condition.
+  ///
+  /// @param[in] read_register
+  ///     Reads a register by the number the gdb-remote protocol uses for
+  ///     it.
+  ///
+  /// @param[in] read_memory
+  ///     Reads memory from the inferior, returning false unless all the
+  ///     requested bytes could be read.
+  ///
+  /// @param[out] result
+  ///     Set to true if the value left on top of the stack is non-zero.
+  ///
+  /// @return
+  ///     An error if the expression couldn't be evaluated, e.g. because
+  ///     it read unreadable memory or divided by zero.
+  //------------------------------------------------------------------
+  Status Evaluate(ReadRegisterCallback read_register,
+                  ReadMemoryCallback read_memory, bool &result) const;
+
+  //------------------------------------------------------------------
+  /// Evaluate the condition with the registers of \a thread and the
+  /// memory of its process.
+  //------------------------------------------------------------------
+  Status Evaluate(NativeThreadProtocol &thread, bool &result) const;
+
+  llvm::ArrayRef<uint8_t> GetBytecode() const { return m_bytecode; }
+
+private:
+  std::vector<uint8_t> m_bytecode;
+};
+
+} // namespace lldb_private
+
+#endif // ifndef liblldb_NativeBreakpointCondition_h_
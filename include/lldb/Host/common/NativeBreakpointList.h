@@ -17,6 +17,8 @@
 #include <functional>
 #include <map>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 namespace lldb_private {
 
@@ -27,6 +29,13 @@ struct HardwareBreakpoint {
 
 using HardwareBreakpointMap = std::map<lldb::addr_t, HardwareBreakpoint>;
 
+// The hits of a breakpoint that weren't reported to the debugger.
+struct SkippedBreakpointHits {
+  lldb::addr_t m_addr;
+  uint32_t m_ignored;         // Because of the ignore count.
+  uint32_t m_condition_false; // Because the conditions were false.
+};
+
 class NativeBreakpointList {
 public:
   typedef std::function<Status(lldb::addr_t addr, size_t size_hint,
@@ -49,6 +58,13 @@ public:
 
   Status RemoveTrapsFromBuffer(lldb::addr_t addr, void *buf, size_t size) const;
 
+  // Whether any breakpoint lies, even partly, in [addr, addr + size).
+  bool HasBreakpointInRange(lldb::addr_t addr, size_t size);
+
+  // Collect the number of hits each breakpoint skipped because of its ignore
+  // count or conditions since the last call, and reset them.
+  std::vector<SkippedBreakpointHits> TakeSkippedHitCounts();
+
 private:
   typedef std::map<lldb::addr_t, NativeBreakpointSP> BreakpointMap;
 
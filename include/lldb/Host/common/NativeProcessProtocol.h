@@ -10,6 +10,7 @@
 #ifndef liblldb_NativeProcessProtocol_h_
 #define liblldb_NativeProcessProtocol_h_
 
+#include "NativeBreakpointCondition.h"
 #include "NativeBreakpointList.h"
 #include "NativeThreadProtocol.h"
 #include "NativeWatchpointList.h"
@@ -87,6 +88,25 @@ public:
   virtual Status ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf,
                                        size_t size, size_t &bytes_read) = 0;
 
+  //------------------------------------------------------------------
+  /// Read a list of memory ranges.
+  ///
+  /// Each range is read independently: the \a bytes_read member of a
+  /// range that can't be read in full is set to the number of bytes at
+  /// its start that could be read. The default implementation calls
+  /// ReadMemory() for each range; subclasses should override it when
+  /// they can read several ranges at once.
+  ///
+  /// @return
+  ///     An error if the ranges couldn't be read at all, for example
+  ///     because the process is gone.
+  //------------------------------------------------------------------
+  virtual Status
+  ReadMemoryRanges(llvm::MutableArrayRef<MemoryReadRange> ranges);
+
+  Status
+  ReadMemoryRangesWithoutTrap(llvm::MutableArrayRef<MemoryReadRange> ranges);
+
   virtual Status WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                              size_t &bytes_written) = 0;
 
@@ -115,6 +135,33 @@ public:
 
   virtual Status DisableBreakpoint(lldb::addr_t addr);
 
+  //------------------------------------------------------------------
+  /// Replace the conditions of the software breakpoint at \a addr.
+  ///
+  /// Threads that hit a conditional breakpoint are only reported when
+  /// one of the conditions is true; an empty list makes the breakpoint
+  /// unconditional again.
+  //------------------------------------------------------------------
+  Status SetBreakpointConditions(
+      lldb::addr_t addr, std::vector<NativeBreakpointCondition> conditions);
+
+  //------------------------------------------------------------------
+  /// Set the number of hits of the software breakpoint at \a addr that
+  /// are skipped before its conditions are looked at.
+  //------------------------------------------------------------------
+  Status SetBreakpointIgnoreCount(lldb::addr_t addr, uint32_t ignore_count);
+
+  //------------------------------------------------------------------
+  /// Get the number of hits each breakpoint skipped because of its
+  /// ignore count or conditions since the last call.
+  ///
+  /// @return
+  ///     The skipped hit counts of the breakpoints that skipped any.
+  //------------------------------------------------------------------
+  std::vector<SkippedBreakpointHits> TakeSkippedBreakpointHitCounts() {
+    return m_breakpoint_list.TakeSkippedHitCounts();
+  }
+
   //----------------------------------------------------------------------
   // Hardware Breakpoint functions
   //----------------------------------------------------------------------
@@ -159,6 +206,33 @@ public:
   virtual llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>>
   GetAuxvData() const = 0;
 
+  //------------------------------------------------------------------
+  /// A shared library in the dynamic linker's link map, with the
+  /// fields that qXfer:libraries-svr4:read reports.
+  //------------------------------------------------------------------
+  struct SVR4LibraryInfo {
+    std::string name;
+    lldb::addr_t link_map;
+    lldb::addr_t base_addr;
+    lldb::addr_t ld_addr;
+  };
+
+  //------------------------------------------------------------------
+  /// Walk the dynamic linker's list of loaded shared libraries.
+  ///
+  /// @param[out] libraries
+  ///     The libraries in link map order. The main executable is not
+  ///     included.
+  ///
+  /// @param[out] main_lm
+  ///     The address of the link map entry of the main executable.
+  ///
+  /// @return
+  ///     An error if the process has no link map, or it can't be read.
+  //------------------------------------------------------------------
+  virtual Status GetLoadedSVR4Libraries(std::vector<SVR4LibraryInfo> &libraries,
+                                        lldb::addr_t &main_lm);
+
   //----------------------------------------------------------------------
   // Exit Status
   //----------------------------------------------------------------------
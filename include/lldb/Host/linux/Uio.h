@@ -13,12 +13,19 @@
 #include "lldb/Host/Config.h"
 #include <sys/uio.h>
 
-// We shall provide our own implementation of process_vm_readv if it is not
-// present
+// We shall provide our own implementation of process_vm_readv and
+// process_vm_writev if they are not present
 #if !HAVE_PROCESS_VM_READV
 ssize_t process_vm_readv(::pid_t pid, const struct iovec *local_iov,
                          unsigned long liovcnt, const struct iovec *remote_iov,
                          unsigned long riovcnt, unsigned long flags);
 #endif
 
+#if !HAVE_PROCESS_VM_WRITEV
+ssize_t process_vm_writev(::pid_t pid, const struct iovec *local_iov,
+                          unsigned long liovcnt,
+                          const struct iovec *remote_iov,
+                          unsigned long riovcnt, unsigned long flags);
+#endif
+
 #endif // liblldb_Host_linux_Uio_h_
@@ -15,6 +15,7 @@
 #include "lldb/Symbol/CompilerDeclContext.h"
 #include "lldb/Symbol/CompilerType.h"
 #include "lldb/Symbol/Type.h"
+#include "lldb/Target/Statistics.h"
 #include "lldb/lldb-private.h"
 
 #include "llvm/ADT/DenseSet.h"
@@ -200,6 +201,29 @@ public:
   //------------------------------------------------------------------
   virtual void SectionFileAddressesChanged() {}
 
+  //------------------------------------------------------------------
+  /// Statistics about the work done on the debug information so far,
+  /// for "statistics dump". Symbol files that don't keep track of
+  /// them report nothing.
+  //------------------------------------------------------------------
+  virtual StatsDuration::Duration GetDebugInfoParseTime() {
+    return StatsDuration::Duration(0);
+  }
+
+  virtual StatsDuration::Duration GetDebugInfoIndexTime() {
+    return StatsDuration::Duration(0);
+  }
+
+  virtual uint64_t GetDebugInfoBytesParsed() { return 0; }
+
+  virtual uint32_t GetNumTypesCompleted() { return 0; }
+
+  //------------------------------------------------------------------
+  /// Add any statistics specific to this kind of symbol file to the
+  /// module's entry in \a dict.
+  //------------------------------------------------------------------
+  virtual void AddStatistics(StructuredData::Dictionary &dict) {}
+
 protected:
   ObjectFile *m_obj_file; // The object file that symbols can be extracted from.
   uint32_t m_abilities;
@@ -12,11 +12,13 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
+#include "llvm/ADT/ArrayRef.h"
 
 // Project includes
 #include "lldb/Core/RangeMap.h"
@@ -42,6 +44,12 @@ public:
 
   size_t Read(lldb::addr_t addr, void *dst, size_t dst_len, Status &error);
 
+  // Read a list of ranges, fetching all of the cache lines (and the ranges
+  // too large to be cached) that are missing with a single call to
+  // Process::ReadMemoryRangesFromInferior(). Returns the total number of
+  // bytes read and sets the "bytes_read" member of each range.
+  size_t ReadRanges(llvm::MutableArrayRef<MemoryReadRange> ranges);
+
   uint32_t GetMemoryCacheLineSize() const { return m_L2_cache_line_byte_size; }
 
   void AddInvalidRange(lldb::addr_t base_addr, lldb::addr_t byte_size);
@@ -54,7 +62,17 @@ public:
   void AddL1CacheData(lldb::addr_t addr,
                       const lldb::DataBufferSP &data_buffer_sp);
 
+  // The number of reads that were served entirely from the cache, and the
+  // number of reads that had to go to the process. Clearing the cache
+  // doesn't reset them.
+  uint64_t GetNumHits() const { return m_num_hits; }
+
+  uint64_t GetNumMisses() const { return m_num_misses; }
+
 protected:
+  size_t ReadLocked(lldb::addr_t addr, void *dst, size_t dst_len,
+                    Status &error, bool &missed);
+
   typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
   typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
   typedef Range<lldb::addr_t, lldb::addr_t> AddrRange;
@@ -70,6 +88,8 @@ protected:
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  std::atomic<uint64_t> m_num_hits{0};
+  std::atomic<uint64_t> m_num_misses{0};
 
 private:
   DISALLOW_COPY_AND_ASSIGN(MemoryCache);
@@ -31,14 +31,30 @@ class UUID;
 /// @brief A module cache class.
 ///
 /// Caches locally modules that are downloaded from remote targets.
-/// Each cached module maintains 2 views:
+/// The contents of the modules are kept once in a store that is shared by
+/// all the platforms, and each cached module maintains 2 views of them:
+///  - Content store:
+///  /${CACHE_ROOT}/.blobs/${MD5}
 ///  - UUID view:
 ///  /${CACHE_ROOT}/${PLATFORM_NAME}/.cache/${UUID}/${MODULE_FILENAME}
 ///  - Sysroot view:
 ///  /${CACHE_ROOT}/${PLATFORM_NAME}/${HOSTNAME}/${MODULE_FULL_FILEPATH}
 ///
-/// UUID views stores a real module file, whereas Sysroot view holds a symbolic
-/// link to UUID-view file.
+/// The store holds the real module files, named by the MD5 of their
+/// contents, so that identical modules downloaded for several UUIDs,
+/// platforms or hosts take up space only once. UUID views hold a symbolic
+/// link to a file in the store, and Sysroot views a symbolic link to the
+/// UUID-view file. A real file found in a UUID view, as created by older
+/// versions of the cache, is used as is.
+///
+/// Each file in the store has a ${MD5}.used stamp next to it, whose
+/// modification time is updated whenever the module is used. When the
+/// store grows over its size limit, the least recently used files are
+/// deleted and the views left dangling are removed.
+///
+/// Several debuggers can share a cache: they hold a shared lock on
+/// /${CACHE_ROOT}/.blobs/.lock while they look up and add modules, and
+/// pruning only happens under an exclusive lock on it.
 ///
 /// Example:
 /// UUID view   :
@@ -53,13 +69,50 @@ public:
   using SymfileDownloader =
       std::function<Status(const lldb::ModuleSP &, const FileSpec &)>;
 
+  //------------------------------------------------------------------
+  /// The contents of a cache, or the part of them that was pruned.
+  //------------------------------------------------------------------
+  struct Statistics {
+    uint64_t num_blobs = 0;  // Files in the content store.
+    uint64_t total_size = 0; // Their size in bytes.
+    uint64_t num_views = 0;  // Links in UUID and Sysroot views.
+  };
+
+  //------------------------------------------------------------------
+  /// Look up a module in the cache below \a root_dir_spec, downloading it
+  /// if it is not there yet. If \a max_cache_size is not zero, the
+  /// cache is pruned to that many bytes after a download.
+  //------------------------------------------------------------------
   Status GetAndPut(const FileSpec &root_dir_spec, const char *hostname,
                    const ModuleSpec &module_spec,
                    const ModuleDownloader &module_downloader,
                    const SymfileDownloader &symfile_downloader,
-                   lldb::ModuleSP &cached_module_sp, bool *did_create_ptr);
+                   lldb::ModuleSP &cached_module_sp, bool *did_create_ptr,
+                   uint64_t max_cache_size = 0);
+
+  //------------------------------------------------------------------
+  /// Delete the least recently used files from the content store of the
+  /// cache in \a cache_root until it takes up no more than \a max_size
+  /// bytes, or none of them if \a max_size is zero, and then remove the
+  /// views that no longer lead to a file.
+  ///
+  /// Fails without deleting anything if another debugger is using the
+  /// cache. What was removed is added to \a removed.
+  //------------------------------------------------------------------
+  static Status Prune(const FileSpec &cache_root, uint64_t max_size,
+                      Statistics &removed);
+
+  static Status GetStatistics(const FileSpec &cache_root, Statistics &stats);
 
 private:
+  // Called with a shared lock on the store.
+  Status GetAndPutLocked(const FileSpec &root_dir_spec, const char *hostname,
+                         const ModuleSpec &module_spec,
+                         const ModuleDownloader &module_downloader,
+                         const SymfileDownloader &symfile_downloader,
+                         lldb::ModuleSP &cached_module_sp,
+                         bool *did_create_ptr, bool &did_put);
+
   Status Put(const FileSpec &root_dir_spec, const char *hostname,
              const ModuleSpec &module_spec, const FileSpec &tmp_file,
              const FileSpec &target_file);
@@ -29,6 +29,8 @@
 #include "lldb/Utility/FileSpec.h"
 #include "lldb/lldb-private-forward.h"
 #include "lldb/lldb-public.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
 
 // TODO pull NativeDelegate class out of NativeProcessProtocol so we
 // can just forward ref the NativeDelegate rather than include it here.
@@ -50,6 +52,12 @@ public:
 
   FileSpec GetModuleCacheDirectory() const;
   bool SetModuleCacheDirectory(const FileSpec &dir_spec);
+
+  uint64_t GetModuleCacheMaxSize() const;
+
+  uint64_t GetFileTransferChunkSize() const;
+
+  uint32_t GetFileTransferWindow() const;
 };
 
 typedef std::shared_ptr<PlatformProperties> PlatformPropertiesSP;
@@ -590,6 +598,22 @@ public:
     return -1;
   }
 
+  //------------------------------------------------------------------
+  /// Read \a size bytes of the open file \a fd starting at \a offset,
+  /// and pass them to \a callback in file order. The transfer stops at
+  /// the end of the file, or when \a callback returns false.
+  ///
+  /// This reads one chunk at a time with ReadFile. Remote platforms can
+  /// override it to keep several reads in flight.
+  ///
+  /// @return
+  ///     The number of bytes passed to \a callback.
+  //------------------------------------------------------------------
+  virtual uint64_t
+  ReadFileRange(lldb::user_id_t fd, uint64_t offset, uint64_t size,
+                llvm::function_ref<bool(llvm::ArrayRef<uint8_t>)> callback,
+                Status &error);
+
   virtual uint64_t WriteFile(lldb::user_id_t fd, uint64_t offset,
                              const void *src, uint64_t src_len, Status &error) {
     error.SetErrorStringWithFormat(
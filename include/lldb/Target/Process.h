@@ -1584,6 +1584,13 @@ public:
     return StructuredData::ObjectSP();
   }
 
+  //------------------------------------------------------------------
+  /// Add the statistics this process keeps to \a dict, for
+  /// "statistics dump". Subclasses that talk to a debug server should
+  /// call this and then add statistics about the connection.
+  //------------------------------------------------------------------
+  virtual void AddStatistics(StructuredData::Dictionary &dict);
+
   //------------------------------------------------------------------
   /// Print a user-visible warning about a module being built with optimization
   ///
@@ -1711,6 +1718,23 @@ public:
   virtual size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                               Status &error) = 0;
 
+  //------------------------------------------------------------------
+  /// Actually do the reading of a list of memory ranges from a process.
+  ///
+  /// Subclasses that can read several ranges with a single request
+  /// (a single system call or a single packet) should override this
+  /// function. The default implementation reads each range with
+  /// Process::DoReadMemory().
+  ///
+  /// @param[in,out] ranges
+  ///     The ranges to read. The \a bytes_read member of each range is
+  ///     zero on entry and must be set to the number of bytes that were
+  ///     read into the range's buffer. Ranges that can't be read in
+  ///     full must still have as much as possible of their start read.
+  //------------------------------------------------------------------
+  virtual void
+  DoReadMemoryRanges(llvm::MutableArrayRef<MemoryReadRange> ranges);
+
   //------------------------------------------------------------------
   /// Read of memory from a process.
   ///
@@ -1743,6 +1767,54 @@ public:
   virtual size_t ReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                             Status &error);
 
+  //------------------------------------------------------------------
+  /// Read a list of memory ranges from a process.
+  ///
+  /// This is the scatter/gather version of Process::ReadMemory(). All
+  /// of the ranges that aren't in the memory cache are fetched from the
+  /// process at once, which lets the process plug-in coalesce them into
+  /// a single request instead of paying for a round trip per range.
+  /// Any traps that were inserted into the memory are removed.
+  ///
+  /// @param[in,out] ranges
+  ///     The ranges to read. On return, the \a bytes_read member of each
+  ///     range holds the number of bytes that were read into its
+  ///     buffer.
+  ///
+  /// @return
+  ///     The total number of bytes that were read.
+  //------------------------------------------------------------------
+  virtual size_t
+  ReadMemoryRanges(llvm::MutableArrayRef<MemoryReadRange> ranges);
+
+  //------------------------------------------------------------------
+  /// Get process memory without copying it.
+  ///
+  /// Processes that have their memory mapped into the debugger already,
+  /// like core files, can hand out extractors that reference it directly
+  /// instead of reading it into a buffer.
+  ///
+  /// @param[in] vm_addr
+  ///     A virtual load address that indicates where to start reading
+  ///     memory from.
+  ///
+  /// @param[in] size
+  ///     The number of bytes to get.
+  ///
+  /// @param[out] data
+  ///     Set to reference the memory on success. The bytes must not be
+  ///     modified.
+  ///
+  /// @return
+  ///     The number of bytes \a data references, which is zero if the
+  ///     memory isn't available this way. Callers then fall back to
+  ///     Process::ReadMemory().
+  //------------------------------------------------------------------
+  virtual size_t GetMemoryData(lldb::addr_t vm_addr, size_t size,
+                               DataExtractor &data) {
+    return 0;
+  }
+
   //------------------------------------------------------------------
   /// Read a NULL terminated string from memory
   ///
@@ -1793,6 +1865,9 @@ public:
   size_t ReadMemoryFromInferior(lldb::addr_t vm_addr, void *buf, size_t size,
                                 Status &error);
 
+  size_t
+  ReadMemoryRangesFromInferior(llvm::MutableArrayRef<MemoryReadRange> ranges);
+
   //------------------------------------------------------------------
   /// Reads an unsigned integer of the specified byte size from
   /// process memory.
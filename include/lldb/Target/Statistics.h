@@ -0,0 +1,133 @@
+//===-- Statistics.h --------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_Statistics_h_
+#define liblldb_Statistics_h_
+
+// C Includes
+#include <stdint.h>
+
+// C++ Includes
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Utility/StructuredData.h"
+#include "lldb/lldb-defines.h"
+#include "lldb/lldb-forward.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class StatsDuration Statistics.h "lldb/Target/Statistics.h"
+/// An accumulated amount of time that can be added to from several
+/// threads at once.
+//----------------------------------------------------------------------
+class StatsDuration {
+public:
+  typedef std::chrono::duration<double> Duration;
+
+  Duration get() const {
+    return std::chrono::nanoseconds(m_nanos.load(std::memory_order_relaxed));
+  }
+
+  StatsDuration &operator+=(Duration dur) {
+    m_nanos +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(dur).count();
+    return *this;
+  }
+
+private:
+  std::atomic<uint64_t> m_nanos{0};
+};
+
+//----------------------------------------------------------------------
+/// @class ElapsedTime Statistics.h "lldb/Target/Statistics.h"
+/// Adds the time between its construction and its destruction to a
+/// StatsDuration.
+//----------------------------------------------------------------------
+class ElapsedTime {
+public:
+  explicit ElapsedTime(StatsDuration &duration)
+      : m_duration(duration), m_start(std::chrono::steady_clock::now()) {}
+
+  ~ElapsedTime() { m_duration += std::chrono::steady_clock::now() - m_start; }
+
+private:
+  StatsDuration &m_duration;
+  std::chrono::steady_clock::time_point m_start;
+
+  DISALLOW_COPY_AND_ASSIGN(ElapsedTime);
+};
+
+//----------------------------------------------------------------------
+/// @class LatencyHistogram Statistics.h "lldb/Target/Statistics.h"
+/// Counts durations in buckets that are a power of two microseconds
+/// wide: bucket N holds the durations in [2^(N-1), 2^N) microseconds,
+/// and bucket 0 those under a microsecond.
+//----------------------------------------------------------------------
+class LatencyHistogram {
+public:
+  void Add(StatsDuration::Duration duration);
+
+  uint64_t GetCount() const;
+
+  //------------------------------------------------------------------
+  /// Return a dictionary with the count, the total, mean and maximum
+  /// durations in seconds, and a "buckets" dictionary that maps the
+  /// upper bound of each non-empty bucket, in microseconds, to its
+  /// count.
+  //------------------------------------------------------------------
+  StructuredData::DictionarySP ToStructuredData() const;
+
+private:
+  static constexpr size_t kNumBuckets = 40;
+
+  mutable std::mutex m_mutex;
+  std::array<uint64_t, kNumBuckets> m_buckets{};
+  uint64_t m_count = 0;
+  StatsDuration::Duration m_total{0};
+  StatsDuration::Duration m_max{0};
+};
+
+//----------------------------------------------------------------------
+/// @class TargetStats Statistics.h "lldb/Target/Statistics.h"
+/// The statistics a target collects while "statistics enable" is in
+/// effect, and the report that "statistics dump" prints.
+//----------------------------------------------------------------------
+class TargetStats {
+public:
+  void SetCollectingStats(bool collect) { m_collecting_stats = collect; }
+
+  bool GetCollectingStats() const { return m_collecting_stats; }
+
+  void RecordExpressionEvaluation(bool success,
+                                  StatsDuration::Duration duration);
+
+  //------------------------------------------------------------------
+  /// Build the report for \a target. The subsystem counters (module
+  /// timings, DWARF parsing, the memory cache and the remote
+  /// connection) are cheap enough to always be kept, so they are
+  /// reported whether or not collection is enabled.
+  //------------------------------------------------------------------
+  StructuredData::ObjectSP ToStructuredData(Target &target) const;
+
+private:
+  std::atomic<bool> m_collecting_stats{false};
+  std::atomic<uint64_t> m_expression_successes{0};
+  std::atomic<uint64_t> m_expression_failures{0};
+  LatencyHistogram m_expression_latency;
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_Statistics_h_
@@ -34,6 +34,7 @@
 #include "lldb/Target/PathMappingList.h"
 #include "lldb/Target/ProcessLaunchInfo.h"
 #include "lldb/Target/SectionLoadHistory.h"
+#include "lldb/Target/Statistics.h"
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/Timeout.h"
 #include "lldb/lldb-public.h"
@@ -1227,6 +1228,15 @@ public:
 
   void SetREPL(lldb::LanguageType language, lldb::REPLSP repl_sp);
 
+  TargetStats &GetStatistics() { return m_stats; }
+
+  //------------------------------------------------------------------
+  /// Return the report printed by "statistics dump" for this target.
+  //------------------------------------------------------------------
+  StructuredData::ObjectSP GetStatisticsReport() {
+    return m_stats.ToStructuredData(*this);
+  }
+
 protected:
   //------------------------------------------------------------------
   /// Implementing of ModuleList::Notifier.
@@ -1296,6 +1306,7 @@ protected:
   bool m_valid;
   bool m_suppress_stop_hooks;
   bool m_is_dummy_target;
+  TargetStats m_stats;
 
   static void ImageSearchPathsChanged(const PathMappingList &path_list,
                                       void *baton);
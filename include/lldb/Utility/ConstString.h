@@ -14,6 +14,8 @@
 #include "llvm/Support/FormatVariadic.h" // for format_provider
 
 #include <stddef.h> // for size_t
+#include <stdint.h> // for uint64_t
+#include <vector>
 
 namespace lldb_private {
 class Stream;
@@ -466,6 +468,34 @@ public:
   //------------------------------------------------------------------
   static size_t StaticMemorySize();
 
+  //------------------------------------------------------------------
+  /// Usage statistics for one of the shards of the global string
+  /// pool.
+  //------------------------------------------------------------------
+  struct ShardStats {
+    size_t string_count = 0;      ///< Unique strings in this shard.
+    size_t string_bytes = 0;      ///< Bytes of string data in this shard.
+    uint64_t contended_reads = 0; ///< Lookups that had to wait for a writer.
+    uint64_t contended_writes = 0; ///< Inserts that had to wait for the lock.
+  };
+
+  struct Stats {
+    size_t memory_size = 0;  ///< Same as ConstString::StaticMemorySize().
+    size_t string_count = 0; ///< Unique strings in the pool.
+    uint64_t contended_reads = 0;
+    uint64_t contended_writes = 0;
+    std::vector<ShardStats> shards;
+  };
+
+  //------------------------------------------------------------------
+  /// Get statistics about the global string pool.
+  ///
+  /// The contention counts tell how often interning a string had to
+  /// wait for another thread that was holding the lock of the same
+  /// shard.
+  //------------------------------------------------------------------
+  static Stats GetStats();
+
 protected:
   //------------------------------------------------------------------
   // Member variables
@@ -44,6 +44,7 @@ class raw_ostream;
 #define LLDB_LOG_OPTION_BACKTRACE (1U << 7)
 #define LLDB_LOG_OPTION_APPEND (1U << 8)
 #define LLDB_LOG_OPTION_PREPEND_FILE_FUNCTION (1U << 9)
+#define LLDB_LOG_OPTION_ASYNC (1U << 10)
 
 //----------------------------------------------------------------------
 // Logging Functions
@@ -100,6 +101,10 @@ public:
 
   static void Initialize();
 
+  // Stop the thread writing out the messages of channels with
+  // LLDB_LOG_OPTION_ASYNC, once it has written everything they queued.
+  static void Terminate();
+
   //------------------------------------------------------------------
   // Static accessors for logging channels
   //------------------------------------------------------------------
@@ -122,6 +127,10 @@ public:
 
   static void ListAllLogChannels(llvm::raw_ostream &stream);
 
+  // Write out everything the channels with LLDB_LOG_OPTION_ASYNC have queued
+  // so far.
+  static void FlushAsyncLogs();
+
   //------------------------------------------------------------------
   // Member functions
   //
@@ -181,9 +190,12 @@ private:
   std::atomic<uint32_t> m_options{0};
   std::atomic<uint32_t> m_mask{0};
 
-  void WriteHeader(llvm::raw_ostream &OS, llvm::StringRef file,
-                   llvm::StringRef function);
-  void WriteMessage(const std::string &message);
+  // Returns where the timestamp goes if it is left for the asynchronous
+  // writer to add, std::string::npos otherwise.
+  size_t WriteHeader(llvm::raw_ostream &OS, llvm::StringRef file,
+                     llvm::StringRef function);
+  void WriteMessage(const std::string &message,
+                    size_t timestamp_offset = std::string::npos);
 
   void Format(llvm::StringRef file, llvm::StringRef function,
               const llvm::formatv_object_base &payload);
@@ -74,6 +74,7 @@ public:
     eServerPacketType_qFileLoadAddress,
     eServerPacketType_QEnvironment,
     eServerPacketType_QEnableErrorStrings,
+    eServerPacketType_QEnableCompression,
     eServerPacketType_QLaunchArch,
     eServerPacketType_QSetDisableASLR,
     eServerPacketType_QSetDetachOnError,
@@ -130,9 +131,11 @@ public:
     eServerPacketType_qWatchpointSupportInfo,
     eServerPacketType_qWatchpointSupportInfoSupported,
     eServerPacketType_qXfer_auxv_read,
+    eServerPacketType_qXfer_libraries_svr4_read,
 
     eServerPacketType_jSignalsInfo,
     eServerPacketType_jModulesInfo,
+    eServerPacketType_jMemoryReadMulti,
 
     eServerPacketType_vAttach,
     eServerPacketType_vAttachWait,
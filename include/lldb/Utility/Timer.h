@@ -13,6 +13,7 @@
 #include "lldb/lldb-defines.h" // for DISALLOW_COPY_AND_ASSIGN
 #include "llvm/Support/Chrono.h"
 #include <atomic>
+#include <string>
 #include <stdint.h> // for uint32_t
 
 namespace lldb_private {
@@ -59,6 +60,24 @@ public:
 
   static void ResetCategoryTimes();
 
+  //--------------------------------------------------------------
+  /// Start or stop recording an event for every timer that is
+  /// started while tracing is on. Each thread records its events
+  /// into its own buffer, so timers on different threads don't
+  /// contend with each other.
+  //--------------------------------------------------------------
+  static void SetTracing(bool value);
+
+  static bool GetTracing();
+
+  //--------------------------------------------------------------
+  /// Write the recorded events in the Chrome trace event format,
+  /// which chrome://tracing and most flame graph viewers can load.
+  //--------------------------------------------------------------
+  static void DumpTrace(Stream &s);
+
+  static void ResetTrace();
+
 protected:
   using TimePoint = std::chrono::steady_clock::time_point;
   void ChildDuration(TimePoint::duration dur) { m_child_duration += dur; }
@@ -66,9 +85,13 @@ protected:
   Category &m_category;
   TimePoint m_total_start;
   TimePoint::duration m_child_duration{0};
+  // Only filled in when tracing was on when the timer started.
+  bool m_traced = false;
+  std::string m_trace_name;
 
   static std::atomic<bool> g_quiet;
   static std::atomic<unsigned> g_display_depth;
+  static std::atomic<bool> g_tracing;
 
 private:
   DISALLOW_COPY_AND_ASSIGN(Timer);
@@ -89,6 +89,22 @@ struct RegisterSet {
   // by adding the value 4.  Not by adding the value lldb_eax_i386.
 };
 
+//----------------------------------------------------------------------
+// One element of a scatter/gather memory read. "buf" must be at least
+// "size" bytes long; "bytes_read" is filled in by the read and is less
+// than "size" when only the start of the range (or none of it) could be
+// read.
+//----------------------------------------------------------------------
+struct MemoryReadRange {
+  MemoryReadRange(lldb::addr_t addr, void *buf, size_t size)
+      : addr(addr), buf(buf), size(size), bytes_read(0) {}
+
+  lldb::addr_t addr; // Address in the inferior to read from
+  void *buf;         // Buffer that receives the bytes
+  size_t size;       // Number of bytes to read
+  size_t bytes_read; // Number of bytes that were actually read
+};
+
 struct OptionEnumValueElement {
   int64_t value;
   const char *string_value;
@@ -0,0 +1,77 @@
+"""
+Test that an ignore count hit by many threads at once skips exactly that many
+hits.
+"""
+
+from __future__ import print_function
+
+
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class BreakpointIgnoreCountThreadsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # The threads hit the breakpoint 8 * 10 times in total.
+    num_hits = 80
+    ignore_count = 50
+
+    @add_test_categories(['pyapi'])
+    def test_ignore_count_with_threads(self):
+        """Test that no hit past the ignore count is lost, or reported early,
+        when several threads hit the breakpoint at the same time."""
+        self.build()
+        exe = self.getBuildArtifact("a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateBySourceRegex(
+            "Set break point at this line.", lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(breakpoint and
+                        breakpoint.GetNumLocations() == 1,
+                        VALID_BREAKPOINT)
+        breakpoint.SetIgnoreCount(self.ignore_count)
+
+        end_breakpoint = target.BreakpointCreateBySourceRegex(
+            "Set break point after the threads at this line.",
+            lldb.SBFileSpec("main.cpp"))
+        self.assertTrue(end_breakpoint and
+                        end_breakpoint.GetNumLocations() == 1,
+                        VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(
+            None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        # Every stop before the ignore count ran out would be reported early,
+        # and each one reports every thread that is sitting at the breakpoint.
+        reported_hits = 0
+        first_stop = True
+        while process.GetState() == lldb.eStateStopped:
+            threads = lldbutil.get_stopped_threads(
+                process, lldb.eStopReasonBreakpoint)
+            self.assertTrue(len(threads) > 0,
+                            "Stopped without a breakpoint hit")
+            if any(thread.GetStopReasonDataAtIndex(0) ==
+                   end_breakpoint.GetID() for thread in threads):
+                break
+            if first_stop:
+                self.assertTrue(
+                    breakpoint.GetHitCount() > self.ignore_count,
+                    "Stopped at hit %d, before the ignore count ran out" %
+                    breakpoint.GetHitCount())
+                first_stop = False
+            reported_hits += len(threads)
+            process.Continue()
+
+        self.assertEqual(process.GetState(), lldb.eStateStopped)
+        self.assertEqual(breakpoint.GetHitCount(), self.num_hits)
+        self.assertEqual(reported_hits, self.num_hits - self.ignore_count)
+
+        process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
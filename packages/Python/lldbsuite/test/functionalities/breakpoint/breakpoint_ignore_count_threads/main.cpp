@@ -0,0 +1,38 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "pseudo_barrier.h"
+#include <thread>
+#include <vector>
+
+pseudo_barrier_t g_barrier;
+volatile int g_sum = 0;
+
+void hit(int i) {
+  g_sum += i; // Set break point at this line.
+}
+
+void thread_func(int i) {
+  pseudo_barrier_wait(g_barrier);
+  for (int j = 0; j < 10; ++j)
+    hit(i);
+}
+
+int main() {
+  const int num_threads = 8;
+  pseudo_barrier_init(g_barrier, num_threads);
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; ++i)
+    threads.push_back(std::thread(thread_func, i));
+  for (std::thread &thread : threads)
+    thread.join();
+
+  return 0; // Set break point after the threads at this line.
+}
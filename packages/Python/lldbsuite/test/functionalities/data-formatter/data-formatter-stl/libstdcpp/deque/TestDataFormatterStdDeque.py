@@ -0,0 +1,52 @@
+"""
+Test lldb data formatter subsystem.
+"""
+
+from __future__ import print_function
+
+import os
+import time
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class StdDequeDataFormatterTestCase(TestBase):
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfFreeBSD
+    @skipIfWindows  # libstdcpp not ported to Windows
+    @skipIfDarwin  # doesn't compile on Darwin
+    @skipIfwatchOS  # libstdcpp not ported to watchos
+    def test_with_run_command(self):
+        self.build()
+        self.runCmd("file " + self.getBuildArtifact("a.out"), CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_source_regexp(
+            self, "Set break point at this line.")
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+                    substrs=['stopped', 'stop reason = breakpoint'])
+
+        frame = self.frame()
+        self.assertTrue(frame.IsValid())
+
+        self.expect("frame variable empty", substrs=['size=0'])
+        self.assertEqual(0, frame.FindVariable("empty").GetNumChildren())
+
+        self.expect("frame variable numbers",
+                    substrs=['size=301', '[0] = -1', '[1] = 0', '[2] = 1'])
+        self.assertEqual(301, frame.FindVariable("numbers").GetNumChildren())
+        # Elements from the middle and the end live in other buffers than
+        # the first one.
+        self.assertEqual(149, frame.GetValueForVariablePath(
+            "numbers[150]").GetValueAsSigned())
+        self.assertEqual(299, frame.GetValueForVariablePath(
+            "numbers[300]").GetValueAsSigned())
+        self.assertFalse(frame.GetValueForVariablePath("numbers[301]").IsValid())
+
+        self.expect("frame variable strings",
+                    substrs=['size=2', '[0] = "world"', '[1] = "hello"'])
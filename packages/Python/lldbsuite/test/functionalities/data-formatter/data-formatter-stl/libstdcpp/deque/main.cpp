@@ -0,0 +1,15 @@
+#include <deque>
+#include <string>
+
+int main() {
+  std::deque<int> empty;
+  std::deque<int> numbers;
+  // Enough elements to span several of the deque's buffers.
+  for (int i = 0; i < 300; ++i)
+    numbers.push_back(i);
+  numbers.push_front(-1);
+  std::deque<std::string> strings;
+  strings.push_back("hello");
+  strings.push_front("world");
+  return 0; // Set break point at this line.
+}
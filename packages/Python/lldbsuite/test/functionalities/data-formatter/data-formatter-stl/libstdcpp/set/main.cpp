@@ -0,0 +1,12 @@
+#include <map>
+#include <set>
+#include <string>
+
+int main() {
+  std::set<int> empty;
+  std::set<int> iset{5, 3, 1, 4, 2};
+  std::set<std::string> sset{"world", "hello"};
+  std::multiset<int> imset{3, 1, 3};
+  std::multimap<int, std::string> mmap{{2, "world"}, {1, "hello"}, {2, "is"}};
+  return 0; // Set break point at this line.
+}
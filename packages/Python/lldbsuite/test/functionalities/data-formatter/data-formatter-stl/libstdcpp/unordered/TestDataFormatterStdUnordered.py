@@ -0,0 +1,54 @@
+"""
+Test lldb data formatter subsystem.
+"""
+
+from __future__ import print_function
+
+import os
+import time
+import lldb
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class StdUnorderedDataFormatterTestCase(TestBase):
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipIfFreeBSD
+    @skipIfWindows  # libstdcpp not ported to Windows
+    @skipIfDarwin  # doesn't compile on Darwin
+    @skipIfwatchOS  # libstdcpp not ported to watchos
+    def test_with_run_command(self):
+        self.build()
+        self.runCmd("file " + self.getBuildArtifact("a.out"), CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_source_regexp(
+            self, "Set break point at this line.")
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+                    substrs=['stopped', 'stop reason = breakpoint'])
+
+        frame = self.frame()
+        self.assertTrue(frame.IsValid())
+
+        self.expect("frame variable empty", substrs=['size=0'])
+        self.assertEqual(0, frame.FindVariable("empty").GetNumChildren())
+
+        self.expect("frame variable map",
+                    substrs=['size=2', 'first = 1', 'second = "hello"',
+                             'first = 2', 'second = "world"'])
+        self.expect("frame variable mmap",
+                    substrs=['size=3', 'second = "hello"', 'second = "world"',
+                             'second = "is"'])
+        self.expect("frame variable iset",
+                    patterns=['size=3 {', '\[\d\] = 1', '\[\d\] = 2',
+                              '\[\d\] = 3'])
+        self.expect("frame variable smset",
+                    patterns=['size=3 {', '(\[\d\] = "is"(\n|.)+){2}',
+                              '\[\d\] = "hello"'])
+
+        self.assertEqual(3, frame.FindVariable("iset").GetNumChildren())
+        self.assertFalse(frame.GetValueForVariablePath("iset[3]").IsValid())
@@ -0,0 +1,13 @@
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+int main() {
+  std::unordered_map<int, std::string> empty;
+  std::unordered_map<int, std::string> map{{1, "hello"}, {2, "world"}};
+  std::unordered_multimap<int, std::string> mmap{
+      {1, "hello"}, {2, "world"}, {2, "is"}};
+  std::unordered_set<int> iset{1, 2, 3};
+  std::unordered_multiset<std::string> smset{"hello", "is", "is"};
+  return 0; // Set break point at this line.
+}
@@ -148,6 +148,28 @@ class StdVectorDataFormatterTestCase(TestBase):
             self.frame().FindVariable("numbers").MightHaveChildren(),
             "numbers.MightHaveChildren() says False for non empty!")
 
+        # check that a window of children matches access-by-index, and is
+        # clamped to the size of the vector
+        window = self.frame().FindVariable("numbers").GetChildrenRange(2, 10)
+        self.assertEqual(window.GetSize(), 5)
+        self.assertEqual(window.GetValueAtIndex(0).GetName(), "[2]")
+        self.assertEqual(window.GetValueAtIndex(0).GetValueAsSigned(), 123)
+        self.assertEqual(window.GetValueAtIndex(4).GetName(), "[6]")
+        self.assertEqual(window.GetValueAtIndex(4).GetValueAsSigned(), 1234567)
+        self.assertEqual(
+            window.GetValueAtIndex(4).GetLoadAddress(),
+            self.frame().FindVariable("numbers").GetChildAtIndex(6).GetLoadAddress())
+        self.assertEqual(
+            self.frame().FindVariable("numbers").GetChildrenRange(
+                0, 0xffffffff).GetSize(), 7)
+
+        # check that writing to a child of the window changes the inferior
+        error = lldb.SBError()
+        self.assertTrue(window.GetValueAtIndex(0).SetValueFromCString("42", error))
+        self.assertEqual(self.process().ReadUnsignedFromMemory(
+            window.GetValueAtIndex(0).GetLoadAddress(), 4, error), 42)
+        self.assertTrue(window.GetValueAtIndex(0).SetValueFromCString("123", error))
+
         # clear out the vector and see that we do the right thing once again
         self.runCmd("c")
 
@@ -6,6 +6,7 @@ from __future__ import print_function
 
 import shutil
 import struct
+import sys
 
 import lldb
 from lldbsuite.test.decorators import *
@@ -140,6 +141,114 @@ class LinuxCoreTestCase(TestBase):
         self.do_test("linux-x86_64", self._x86_64_pid, self._x86_64_regions,
                 "a.out")
 
+    @skipIf(oslist=['windows'])
+    @skipIf(triple='^mips')
+    def test_analyze_core_files(self):
+        """Test that SBDebugger.AnalyzeCoreFiles reports on each core, in
+        order, with the platform of the debugger it was called on."""
+        self.runCmd("platform select remote-linux")
+
+        core_files = lldb.SBStringList()
+        for core_file in ["linux-x86_64.core", "does-not-exist.core",
+                          "linux-x86_64.core"]:
+            core_files.AppendString(core_file)
+        commands = lldb.SBStringList()
+        for command in ["bt", "frame variable F", "platform status"]:
+            commands.AppendString(command)
+
+        reports = self.dbg.AnalyzeCoreFiles("linux-x86_64.out", core_files,
+                                            commands)
+        self.assertEqual(reports.GetSize(), 3)
+        self.assertTrue(reports.GetStringAtIndex(1).startswith("error:"))
+        for i in [0, 2]:
+            report = reports.GetStringAtIndex(i)
+            for substr in ["(lldb) bt", "bar", "foo", "_start",
+                           "(lldb) frame variable F", "F = 'b'",
+                           "Platform: remote-linux"]:
+                self.assertTrue(substr in report,
+                                "'%s' missing from report:\n%s" %
+                                (substr, report))
+
+        # The cores were analyzed by debuggers of their own.
+        self.assertEqual(self.dbg.GetNumTargets(), 0)
+
+    @skipIf(oslist=['windows'])
+    @skipIf(triple='^mips')
+    @expectedFailureAll(
+        hostoslist=["windows"],
+        bugnumber="llvm.org/pr22274: need a pexpect replacement for windows")
+    def test_core_list(self):
+        """Test that the driver analyzes each core listed with --core-list,
+        with commands that don't fit in a path."""
+        import pexpect
+        core_list = self.getBuildArtifact("cores.txt")
+        with open(core_list, "w") as f:
+            f.write("linux-x86_64.core\n\nlinux-x86_64.core\n")
+        # An expression longer than PATH_MAX that adds up to 5000.
+        long_command = "expr -- " + "+".join(["1"] * 5000)
+        command_file = self.getBuildArtifact("commands.txt")
+        with open(command_file, "w") as f:
+            f.write("bt\n" + long_command + "\n")
+
+        child = pexpect.spawn(
+            '%s %s -x -f linux-x86_64.out -C %s -s %s' %
+            (lldbtest_config.lldbExec, self.lldbOption, core_list,
+             command_file))
+        # Turn on logging for what the child sends back.
+        if self.TraceOn():
+            child.logfile_read = sys.stdout
+        # So that the spawned lldb session gets shutdown durng teardown.
+        self.child = child
+
+        for i in range(2):
+            child.expect_exact("Core file 'linux-x86_64.core':")
+            child.expect_exact("(lldb) bt")
+            child.expect_exact("bar")
+            child.expect_exact("(lldb) " + long_command)
+            child.expect_exact("= 5000")
+        child.expect(pexpect.EOF)
+
+    @skipIf(oslist=['windows'])
+    @skipIf(triple='^mips')
+    def test_values_match_read_memory(self):
+        """Test that values, which reference the core file's memory in place,
+        hold the same bytes that ReadMemory copies out."""
+        target = self.dbg.CreateTarget("linux-x86_64.out")
+        process = target.LoadCore("linux-x86_64.core")
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = process.GetSelectedThread()
+
+        def check_value(value, size):
+            self.assertTrue(value.IsValid())
+            self.assertEqual(value.GetByteSize(), size)
+            error = lldb.SBError()
+            memory = process.ReadMemory(value.GetLoadAddress(), size, error)
+            self.assertTrue(error.Success(), error.GetCString())
+            data = value.GetData()
+            self.assertEqual(data.GetByteSize(), size)
+            self.assertEqual(
+                bytearray(data.ReadRawData(error, 0, size)),
+                bytearray(memory))
+
+        # The variables of every frame live on the stack.
+        for frame in thread.frames:
+            check_value(frame.FindVariable("F"), 1)
+
+        # The two segments of the vDSO are adjacent in memory and in the core
+        # file, so a range across them can be referenced in place as well.
+        boundary = 0x7ffe0c16d000
+        char_array = target.FindFirstType("char").GetArrayType(64)
+        check_value(
+            target.CreateValueFromAddress(
+                "across", lldb.SBAddress(boundary - 32, target), char_array),
+            64)
+        check_value(
+            target.CreateValueFromAddress(
+                "within", lldb.SBAddress(boundary - 64, target), char_array),
+            64)
+
+        self.dbg.DeleteTarget(target)
+
     @skipIf(oslist=['windows'])
     @skipIf(triple='^mips')
     def test_FPR_SSE(self):
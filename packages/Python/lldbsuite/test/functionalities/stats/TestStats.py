@@ -0,0 +1,68 @@
+"""
+Test the statistics command and SBTarget.GetStatistics().
+"""
+
+from __future__ import print_function
+
+
+import json
+import lldb
+import lldbsuite.test.lldbutil as lldbutil
+from lldbsuite.test.lldbtest import *
+
+
+class TestStats(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NO_DEBUG_INFO_TESTCASE = True
+
+    def get_stats(self, target):
+        stream = lldb.SBStream()
+        self.assertTrue(target.GetStatistics().GetAsJSON(stream).Success())
+        return json.loads(stream.GetData())
+
+    def test_statistics(self):
+        self.build()
+        (target, process, thread, bkpt) = lldbutil.run_to_source_breakpoint(
+            self, "Set a breakpoint here", lldb.SBFileSpec("main.c"))
+
+        self.expect("statistics disable", error=True,
+                    substrs=['need to enable statistics before disabling'])
+        self.runCmd("statistics enable")
+        self.expect("statistics enable", error=True,
+                    substrs=['already enabled'])
+
+        self.expect("expr foo(1)", substrs=['2'])
+        self.expect("expr this_is_not_a_variable", error=True)
+
+        self.expect("statistics dump",
+                    substrs=['Number of expr evaluation successes: 1',
+                             'Number of expr evaluation failures: 1'])
+        self.expect("statistics dump --json",
+                    substrs=['"expressionEvaluation"', '"modules"'])
+
+        stats = self.get_stats(target)
+        self.assertTrue(stats["collectingStats"])
+        expressions = stats["expressionEvaluation"]
+        self.assertEqual(expressions["successes"], 1)
+        self.assertEqual(expressions["failures"], 1)
+        self.assertEqual(expressions["count"], 2)
+
+        exe_path = self.getBuildArtifact("a.out")
+        paths = [module["path"] for module in stats["modules"]]
+        self.assertTrue(exe_path in paths)
+        exe_module = stats["modules"][paths.index(exe_path)]
+        self.assertTrue(exe_module["dieArena"]["numDIEs"] > 0)
+        self.assertTrue(exe_module["dieArena"]["bytesAllocated"] >=
+                        exe_module["dieArena"]["bytesUsed"])
+        self.assertTrue("memoryCache" in stats["process"])
+        self.assertTrue(stats["constStringPool"]["stringCount"] > 0)
+        self.assertTrue(stats["constStringPool"]["memorySize"] > 0)
+
+        # Expressions are only counted while statistics are enabled.
+        self.runCmd("statistics disable")
+        self.expect("expr foo(2)", substrs=['3'])
+        stats = self.get_stats(target)
+        self.assertFalse(stats["collectingStats"])
+        self.assertEqual(stats["expressionEvaluation"]["successes"], 1)
@@ -0,0 +1,5 @@
+int foo(int x) { return x + 1; }
+
+int main(int argc, char const *argv[]) {
+  return foo(argc); // Set a breakpoint here
+}
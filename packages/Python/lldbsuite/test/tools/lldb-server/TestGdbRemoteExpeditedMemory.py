@@ -0,0 +1,114 @@
+from __future__ import print_function
+
+import json
+import re
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestGdbRemoteExpeditedMemory(
+        gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    def stop_inferior(self):
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["sleep:5"])
+        self.test_sequence.add_log_lines([
+            # Start up the inferior.
+            "read packet: $c#63",
+            # Immediately tell it to stop.  We want to see what it reports.
+            "read packet: {}".format(chr(3)),
+            {"direction": "send",
+             "regex": r"^\$T([0-9a-fA-F]+)([^#]+)#[0-9a-fA-F]{2}$",
+             "capture": {1: "stop_result",
+                         2: "key_vals_text"}},
+        ], True)
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context.get("key_vals_text")
+
+    def read_memory(self, address, size):
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $m{0:x},{1:x}#00".format(address, size),
+             {"direction": "send",
+              "regex": r"^\$([0-9a-fA-F]+)#[0-9a-fA-F]{2}$",
+              "capture": {1: "read_contents"}}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context.get("read_contents")
+
+    def verify_expedited_memory(self, address, hex_bytes):
+        # The expedited records are whole pointers of stack memory, and must
+        # match what a plain memory read returns.
+        self.assertTrue(len(hex_bytes) > 0)
+        self.assertEqual(len(hex_bytes) % 8, 0)
+        self.assertEqual(address % 4, 0)
+        self.assertEqual(self.read_memory(address, len(hex_bytes) // 2),
+                         hex_bytes)
+
+    def stop_reply_memory_matches_inferior(self):
+        key_vals_text = self.stop_inferior()
+        self.assertIsNotNone(key_vals_text)
+
+        kv_dict = self.parse_key_val_dict(key_vals_text)
+        memory = kv_dict.get("memory", [])
+        if not isinstance(memory, list):
+            memory = [memory]
+        for entry in memory:
+            (address, hex_bytes) = entry.split("=")
+            self.verify_expedited_memory(int(address, 0), hex_bytes)
+
+    @debugserver_test
+    def test_stop_reply_memory_matches_inferior_debugserver(self):
+        self.init_debugserver_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.stop_reply_memory_matches_inferior()
+
+    @llgs_test
+    def test_stop_reply_memory_matches_inferior_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.stop_reply_memory_matches_inferior()
+
+    def threads_info_memory_matches_inferior(self):
+        self.stop_inferior()
+
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $jThreadsInfo#c1",
+             {"direction": "send",
+              "regex": r"^\$(.*)#[0-9a-fA-F]{2}$",
+              "capture": {1: "threads_info"}}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        # The jThreadsInfo response is not valid JSON data, so we have to
+        # clean it up first.
+        threads_info = json.loads(
+            re.sub(r"}]", "}", context.get("threads_info")))
+        for thread_info in threads_info:
+            for entry in thread_info.get("memory", []):
+                self.verify_expedited_memory(entry["address"], entry["bytes"])
+
+    @debugserver_test
+    def test_threads_info_memory_matches_inferior_debugserver(self):
+        self.init_debugserver_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.threads_info_memory_matches_inferior()
+
+    @llgs_test
+    def test_threads_info_memory_matches_inferior_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.threads_info_memory_matches_inferior()
@@ -0,0 +1,78 @@
+from __future__ import print_function
+
+import xml.etree.ElementTree as ET
+
+import gdbremote_testcase
+from lldbsuite.test.decorators import *
+from lldbsuite.test.lldbtest import *
+from lldbsuite.test import lldbutil
+
+
+class TestGdbRemoteLibrariesSvr4Support(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    FEATURE_NAME = "qXfer:libraries-svr4:read"
+
+    def setup_test(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+
+        # Stop in main, once the dynamic linker has loaded the libraries.
+        inferior_args = ["message:main entered", "sleep:5"]
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=inferior_args)
+        self.test_sequence.add_log_lines([
+            "read packet: $c#63",
+            {"type": "output_match", "regex": self.maybe_strict_output_regex(
+                r"message:main entered\r\n")},
+        ], True)
+        self.add_interrupt_packets()
+        self.add_qSupported_packets()
+
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        features = self.parse_qSupported_response(context)
+        self.assertEqual(features.get(self.FEATURE_NAME), "+")
+
+    def get_libraries_svr4_xml(self, chunk_length):
+        data = self.read_binary_data_in_chunks(
+            "qXfer:libraries-svr4:read::", chunk_length)
+        self.assertIsNotNone(data)
+        return data
+
+    def libraries_svr4_well_formed(self):
+        xml_root = ET.fromstring(self.get_libraries_svr4_xml(0x10000))
+        self.assertEqual(xml_root.tag, "library-list-svr4")
+        self.assertTrue(int(xml_root.get("main-lm"), 16) != 0)
+
+        libraries = xml_root.findall("library")
+        self.assertTrue(len(libraries) > 0)
+        for library in libraries:
+            self.assertTrue("name" in library.attrib)
+            self.assertTrue(int(library.get("lm"), 16) != 0)
+            self.assertTrue("l_addr" in library.attrib)
+            self.assertTrue(int(library.get("l_ld"), 16) != 0)
+
+        # The inferior links against the C library.
+        names = [library.get("name") for library in libraries]
+        self.assertTrue(any("libc." in name for name in names), str(names))
+
+    @llgs_test
+    @skipUnlessPlatform(["linux"])
+    def test_libraries_svr4_well_formed_llgs(self):
+        self.setup_test()
+        self.libraries_svr4_well_formed()
+
+    def libraries_svr4_chunked_reads_work(self):
+        whole = self.get_libraries_svr4_xml(0x10000)
+        chunked = self.get_libraries_svr4_xml(0x40)
+        self.assertEqual(whole, chunked)
+
+    @llgs_test
+    @skipUnlessPlatform(["linux"])
+    def test_libraries_svr4_chunked_reads_work_llgs(self):
+        self.setup_test()
+        self.libraries_svr4_chunked_reads_work()
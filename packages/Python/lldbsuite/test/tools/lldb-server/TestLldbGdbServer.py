@@ -627,6 +627,72 @@ class LldbGdbServerTestCase(gdbremote_testcase.GdbRemoteTestCaseBase, DwarfOpcod
         self.set_inferior_startup_attach()
         self.p_returns_correct_data_size_for_each_qRegisterInfo()
 
+    def g_returns_register_file_matching_p(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.add_register_info_collection_packets()
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        # Gather register info entries.
+        reg_infos = self.parse_register_info_packets(context)
+        self.assertIsNotNone(reg_infos)
+        self.assertTrue(len(reg_infos) > 0)
+
+        # Read the whole register file.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $g#67",
+             {"direction": "send", "regex": r"^\$([0-9a-fA-F]+)#", "capture": {1: "g_response"}}],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        g_response = context.get("g_response")
+        self.assertIsNotNone(g_response)
+
+        # The registers are laid out at their qRegisterInfo offsets.
+        file_size = max(int(reg_info["offset"]) + int(reg_info["bitsize"]) // 8
+                        for reg_info in reg_infos)
+        self.assertEqual(len(g_response), 2 * file_size)
+
+        # Each register must hold what p reads for it.
+        for (reg_index, reg_info) in enumerate(reg_infos):
+            # Skip registers that don't have a register set, as
+            # p_returns_correct_data_size_for_each_qRegisterInfo does.
+            if not "set" in reg_info:
+                continue
+
+            self.reset_test_sequence()
+            self.test_sequence.add_log_lines(
+                ["read packet: $p{0:x}#00".format(reg_index),
+                 {"direction": "send", "regex": r"^\$([0-9a-fA-F]+)#", "capture": {1: "p_response"}}],
+                True)
+            context = self.expect_gdbremote_sequence()
+            self.assertIsNotNone(context)
+            p_response = context.get("p_response")
+            self.assertIsNotNone(p_response)
+
+            offset = 2 * int(reg_info["offset"])
+            self.assertEqual(
+                g_response[offset:offset + len(p_response)], p_response)
+
+        # Writing back the register file must succeed.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $G{0}#00".format(g_response),
+             "send packet: $OK#00"],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    def test_g_returns_register_file_matching_p_llgs(self):
+        self.init_llgs_test()
+        self.build()
+        self.set_inferior_startup_launch()
+        self.g_returns_register_file_matching_p()
+
     def Hg_switches_to_3_threads(self):
         # Startup the inferior with three threads (main + 2 new ones).
         procs = self.prep_debug_monitor_and_inferior(
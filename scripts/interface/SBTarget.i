@@ -909,6 +909,9 @@ public:
     lldb::addr_t
     GetStackRedZoneSize();
 
+    lldb::SBStructuredData
+    GetStatistics();
+
     lldb::SBLaunchInfo
     GetLaunchInfo () const;
 
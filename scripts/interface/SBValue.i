@@ -250,6 +250,19 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
 
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Get the children at indexes [start, start + count) of a value.
+    ///
+    /// This is the same as calling GetChildAtIndex() for each index in
+    /// the range, except that synthetic child providers can fetch the
+    /// whole range at once. The range is clamped to the number of
+    /// children the value has.
+    //------------------------------------------------------------------
+    ") GetChildrenRange;
+    lldb::SBValueList
+    GetChildrenRange (uint32_t start, uint32_t count);
+
     lldb::SBValue
     CreateChildAtOffset (const char *name, uint32_t offset, lldb::SBType type);
     
@@ -38,24 +38,33 @@
 #include "lldb/API/SystemInitializerFull.h"
 
 #include "lldb/Core/Debugger.h"
+#include "lldb/Core/Module.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StructuredDataImpl.h"
 #include "lldb/DataFormatters/DataVisualization.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Host/XML.h"
 #include "lldb/Initialization/SystemLifetimeManager.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/OptionGroupPlatform.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
 #include "lldb/Target/TargetList.h"
+#include "lldb/Utility/StreamString.h"
 
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DynamicLibrary.h"
 #include "llvm/Support/ManagedStatic.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -680,6 +689,120 @@ bool SBDebugger::DeleteTarget(lldb::SBTarget &target) {
   return result;
 }
 
+static std::string AnalyzeCoreFile(Debugger &debugger, const char *filename,
+                                   const char *core_file,
+                                   const SBStringList &commands) {
+  StreamString report;
+  TargetSP target_sp;
+  const bool add_dependent_modules = true;
+  Status error = debugger.GetTargetList().CreateTarget(
+      debugger, filename, "", add_dependent_modules, nullptr, target_sp);
+  if (error.Success()) {
+    FileSpec core_spec(core_file, true);
+    ProcessSP process_sp(
+        target_sp->CreateProcess(debugger.GetListener(), "", &core_spec));
+    if (process_sp)
+      error = process_sp->LoadCore();
+    else
+      error.SetErrorStringWithFormat("unable to find a plug-in for core file "
+                                     "'%s'",
+                                     core_file);
+  }
+
+  if (error.Success()) {
+    debugger.GetTargetList().SetSelectedTarget(target_sp.get());
+    CommandInterpreter &interpreter = debugger.GetCommandInterpreter();
+    for (uint32_t i = 0; i < commands.GetSize(); ++i) {
+      const char *command = commands.GetStringAtIndex(i);
+      CommandReturnObject result;
+      interpreter.HandleCommand(command, eLazyBoolNo, result);
+      report.Printf("(lldb) %s\n", command);
+      report << result.GetOutputData() << result.GetErrorData();
+    }
+  } else
+    report.Printf("error: %s\n", error.AsCString());
+
+  // Unlike SBDebugger::DeleteTarget, leave the modules that are no longer
+  // used in the global module list for the next cores.
+  if (target_sp) {
+    debugger.GetTargetList().DeleteTarget(target_sp);
+    target_sp->Destroy();
+  }
+  return report.GetString();
+}
+
+SBStringList SBDebugger::AnalyzeCoreFiles(const char *filename,
+                                          const SBStringList &core_files,
+                                          const SBStringList &commands) {
+  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_API));
+  if (log)
+    log->Printf("SBDebugger(%p)::AnalyzeCoreFiles (filename=\"%s\", "
+                "%u core files)",
+                static_cast<void *>(m_opaque_sp.get()), filename,
+                core_files.GetSize());
+
+  SBStringList sb_reports;
+  if (!m_opaque_sp || !filename)
+    return sb_reports;
+
+  // Load the executable and its dependents and index them once up front.
+  // The target keeps them in the global module list, where the targets of
+  // the cores find them.
+  TargetSP shared_target_sp;
+  const bool add_dependent_modules = true;
+  m_opaque_sp->GetTargetList().CreateTarget(*m_opaque_sp, filename, "",
+                                            add_dependent_modules, nullptr,
+                                            shared_target_sp);
+  if (shared_target_sp) {
+    const ModuleList &images = shared_target_sp->GetImages();
+    TaskMapOverInt(0, images.GetSize(), [&images](size_t idx) {
+      if (ModuleSP module_sp = images.GetModuleAtIndex(idx))
+        module_sp->PreloadSymbols();
+    });
+  }
+
+  // Each thread has a debugger of its own, so that the commands it runs see
+  // its core as the selected target. They use the platform selected here,
+  // which holds the sysroot; the target settings, exec-search-paths among
+  // them, are global and apply to their targets as well.
+  PlatformSP platform_sp = m_opaque_sp->GetPlatformList().GetSelectedPlatform();
+  const size_t num_cores = core_files.GetSize();
+  const size_t num_threads =
+      std::min<size_t>(num_cores, GetHardwareConcurrencyHint());
+  std::vector<std::string> reports(num_cores);
+  std::atomic<size_t> next_core(0);
+  std::vector<DebuggerSP> debuggers;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    DebuggerSP debugger_sp = Debugger::CreateInstance();
+    debugger_sp->SetAsyncExecution(false);
+    if (platform_sp)
+      debugger_sp->GetPlatformList().Append(platform_sp, true);
+    debuggers.push_back(debugger_sp);
+    threads.emplace_back([&, debugger_sp] {
+      for (size_t idx = next_core++; idx < num_cores; idx = next_core++)
+        reports[idx] =
+            AnalyzeCoreFile(*debugger_sp, filename,
+                            core_files.GetStringAtIndex(idx), commands);
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+  for (DebuggerSP &debugger_sp : debuggers)
+    Debugger::Destroy(debugger_sp);
+
+  if (shared_target_sp) {
+    m_opaque_sp->GetTargetList().DeleteTarget(shared_target_sp);
+    shared_target_sp->Destroy();
+  }
+  const bool mandatory = true;
+  ModuleList::RemoveOrphanSharedModules(mandatory);
+
+  for (const std::string &report : reports)
+    sb_reports.AppendString(report.c_str());
+  return sb_reports;
+}
+
 SBTarget SBDebugger::GetTargetAtIndex(uint32_t idx) {
   SBTarget sb_target;
   if (m_opaque_sp) {
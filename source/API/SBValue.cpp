@@ -46,6 +46,7 @@
 #include "lldb/API/SBProcess.h"
 #include "lldb/API/SBTarget.h"
 #include "lldb/API/SBThread.h"
+#include "lldb/API/SBValueList.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -844,6 +845,34 @@ SBValue SBValue::GetChildAtIndex(uint32_t idx,
   return sb_value;
 }
 
+SBValueList SBValue::GetChildrenRange(uint32_t start, uint32_t count) {
+  SBValueList sb_value_list;
+  Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_API));
+
+  ValueLocker locker;
+  lldb::ValueObjectSP value_sp(GetSP(locker));
+  if (value_sp) {
+    lldb::DynamicValueType use_dynamic = eNoDynamicValues;
+    if (TargetSP target_sp = value_sp->GetTargetSP())
+      use_dynamic = target_sp->GetPreferDynamicValue();
+
+    std::vector<lldb::ValueObjectSP> children;
+    value_sp->GetChildrenRange(start, count, children);
+    for (const lldb::ValueObjectSP &child_sp : children) {
+      SBValue sb_value;
+      sb_value.SetSP(child_sp, use_dynamic, GetPreferSyntheticValue());
+      sb_value_list.Append(sb_value);
+    }
+  }
+
+  if (log)
+    log->Printf("SBValue(%p)::GetChildrenRange (%u, %u) => %u children",
+                static_cast<void *>(value_sp.get()), start, count,
+                sb_value_list.GetSize());
+
+  return sb_value_list;
+}
+
 uint32_t SBValue::GetIndexOfChildWithName(const char *name) {
   uint32_t idx = UINT32_MAX;
   ValueLocker locker;
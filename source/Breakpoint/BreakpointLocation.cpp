@@ -438,6 +438,14 @@ void BreakpointLocation::UndoBumpHitCount() {
   }
 }
 
+void BreakpointLocation::SkippedHit() {
+  if (!IsEnabled())
+    return;
+  BumpHitCount();
+  if (IgnoreCountShouldStop())
+    m_owner.IgnoreCountShouldStop();
+}
+
 bool BreakpointLocation::IsResolved() const {
   return m_bp_site_sp.get() != nullptr;
 }
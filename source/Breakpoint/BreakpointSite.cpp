@@ -153,6 +153,14 @@ void BreakpointSite::BumpHitCounts() {
   }
 }
 
+void BreakpointSite::AddSkippedHits(uint32_t count) {
+  std::lock_guard<std::recursive_mutex> guard(m_owners_mutex);
+  for (BreakpointLocationSP loc_sp : m_owners.BreakpointLocations()) {
+    for (uint32_t i = 0; i < count; ++i)
+      loc_sp->SkippedHit();
+  }
+}
+
 bool BreakpointSite::IntersectsRange(lldb::addr_t addr, size_t size,
                                      lldb::addr_t *intersect_addr,
                                      size_t *intersect_size,
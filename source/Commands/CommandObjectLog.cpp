@@ -47,6 +47,7 @@ static OptionDefinition g_log_options[] = {
   { LLDB_OPT_SET_1, false, "stack",      'S', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone,     "Append a stack backtrace to each log line." },
   { LLDB_OPT_SET_1, false, "append",     'a', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone,     "Append to the log file instead of overwriting." },
   { LLDB_OPT_SET_1, false, "file-function",'F',OptionParser::eNoArgument,      nullptr, nullptr, 0, eArgTypeNone,     "Prepend the names of files and function that generate the logs." },
+  { LLDB_OPT_SET_1, false, "async",      'A', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone,     "Queue log lines and write them from a background thread so that logging doesn't wait on the log file. Lines are dropped if a thread logs faster than they can be written." },
     // clang-format on
 };
 
@@ -129,6 +130,9 @@ public:
       case 'F':
         log_options |= LLDB_LOG_OPTION_PREPEND_FILE_FUNCTION;
         break;
+      case 'A':
+        log_options |= LLDB_LOG_OPTION_ASYNC;
+        break;
       default:
         error.SetErrorStringWithFormat("unrecognized option '%c'",
                                        short_option);
@@ -303,9 +307,12 @@ public:
   CommandObjectLogTimer(CommandInterpreter &interpreter)
       : CommandObjectParsed(interpreter, "log timers",
                             "Enable, disable, dump, and reset LLDB internal "
-                            "performance timers.",
+                            "performance timers. While tracing is on, every "
+                            "timer is recorded, and dump-trace writes them "
+                            "out in the Chrome trace event format.",
                             "log timers < enable <depth> | disable | dump | "
-                            "increment <bool> | reset >") {}
+                            "increment <bool> | trace <bool> | "
+                            "dump-trace <file> | reset >") {}
 
   ~CommandObjectLogTimer() override = default;
 
@@ -328,6 +335,7 @@ protected:
         result.SetStatus(eReturnStatusSuccessFinishResult);
       } else if (sub_command.equals_lower("reset")) {
         Timer::ResetCategoryTimes();
+        Timer::ResetTrace();
         result.SetStatus(eReturnStatusSuccessFinishResult);
       }
     } else if (args.GetArgumentCount() == 2) {
@@ -351,6 +359,28 @@ protected:
           result.SetStatus(eReturnStatusSuccessFinishNoResult);
         } else
           result.AppendError("Could not convert increment value to boolean.");
+      } else if (sub_command.equals_lower("trace")) {
+        bool success;
+        bool trace = Args::StringToBoolean(param, false, &success);
+        if (success) {
+          Timer::SetTracing(trace);
+          result.SetStatus(eReturnStatusSuccessFinishNoResult);
+        } else
+          result.AppendError("Could not convert trace value to boolean.");
+      } else if (sub_command.equals_lower("dump-trace")) {
+        FileSpec trace_spec(param, true);
+        StreamFile trace_stream;
+        Status error = trace_stream.GetFile().Open(
+            trace_spec.GetPath().c_str(),
+            File::eOpenOptionWrite | File::eOpenOptionCanCreate |
+                File::eOpenOptionTruncate | File::eOpenOptionCloseOnExec);
+        if (error.Success()) {
+          Timer::DumpTrace(trace_stream);
+          result.SetStatus(eReturnStatusSuccessFinishNoResult);
+        } else
+          result.AppendErrorWithFormat("Failed to open file '%s': %s\n",
+                                       trace_spec.GetPath().c_str(),
+                                       error.AsCString());
       }
     }
 
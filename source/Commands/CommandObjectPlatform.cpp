@@ -25,6 +25,7 @@
 #include "lldb/Interpreter/OptionGroupFile.h"
 #include "lldb/Interpreter/OptionGroupPlatform.h"
 #include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/ModuleCache.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Utility/DataExtractor.h"
@@ -833,6 +834,167 @@ private:
   DISALLOW_COPY_AND_ASSIGN(CommandObjectPlatformFile);
 };
 
+//----------------------------------------------------------------------
+// "platform cache stats"
+//----------------------------------------------------------------------
+class CommandObjectPlatformCacheStats : public CommandObjectParsed {
+public:
+  CommandObjectPlatformCacheStats(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "platform cache stats",
+                            "Show how much space the cache of modules "
+                            "downloaded from remote platforms takes up.",
+                            nullptr, 0) {}
+
+  ~CommandObjectPlatformCacheStats() override = default;
+
+protected:
+  bool DoExecute(Args &args, CommandReturnObject &result) override {
+    const PlatformPropertiesSP &properties =
+        Platform::GetGlobalPlatformProperties();
+    const FileSpec cache_root = properties->GetModuleCacheDirectory();
+    ModuleCache::Statistics stats;
+    Status error = ModuleCache::GetStatistics(cache_root, stats);
+    if (error.Fail()) {
+      result.AppendError(error.AsCString());
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+
+    Stream &ostrm = result.GetOutputStream();
+    ostrm.Printf("Module cache: %s\n", cache_root.GetPath().c_str());
+    ostrm.Printf("  Files: %" PRIu64 " (%" PRIu64 " bytes)\n",
+                 stats.num_blobs, stats.total_size);
+    ostrm.Printf("  Links: %" PRIu64 "\n", stats.num_views);
+    const uint64_t max_size = properties->GetModuleCacheMaxSize();
+    if (max_size)
+      ostrm.Printf("  Limit: %" PRIu64 " bytes\n", max_size);
+    else
+      ostrm.PutCString("  Limit: none\n");
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return true;
+  }
+};
+
+//----------------------------------------------------------------------
+// "platform cache prune"
+//----------------------------------------------------------------------
+
+static OptionDefinition g_platform_cache_prune_options[] = {
+    // clang-format off
+  { LLDB_OPT_SET_1, false, "max-size", 's', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeByteSize, "The number of bytes to shrink the cache to, instead of platform.module-cache-max-size." },
+    // clang-format on
+};
+
+class CommandObjectPlatformCachePrune : public CommandObjectParsed {
+public:
+  CommandObjectPlatformCachePrune(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "platform cache prune",
+                            "Delete the least recently used modules from the "
+                            "cache of modules downloaded from remote "
+                            "platforms until it fits its size limit.",
+                            nullptr, 0),
+        m_options() {}
+
+  ~CommandObjectPlatformCachePrune() override = default;
+
+  Options *GetOptions() override { return &m_options; }
+
+protected:
+  class CommandOptions : public Options {
+  public:
+    CommandOptions() : Options() {}
+
+    ~CommandOptions() override = default;
+
+    Status SetOptionValue(uint32_t option_idx, llvm::StringRef option_arg,
+                          ExecutionContext *execution_context) override {
+      Status error;
+      char short_option = (char)m_getopt_table[option_idx].val;
+
+      switch (short_option) {
+      case 's':
+        if (option_arg.getAsInteger(0, m_max_size))
+          error.SetErrorStringWithFormat("invalid size: '%s'",
+                                         option_arg.str().c_str());
+        else
+          m_max_size_set = true;
+        break;
+      default:
+        error.SetErrorStringWithFormat("unrecognized option '%c'",
+                                       short_option);
+        break;
+      }
+
+      return error;
+    }
+
+    void OptionParsingStarting(ExecutionContext *execution_context) override {
+      m_max_size = 0;
+      m_max_size_set = false;
+    }
+
+    llvm::ArrayRef<OptionDefinition> GetDefinitions() override {
+      return llvm::makeArrayRef(g_platform_cache_prune_options);
+    }
+
+    // Instance variables to hold the values for command options.
+
+    uint64_t m_max_size;
+    bool m_max_size_set;
+  };
+
+  bool DoExecute(Args &args, CommandReturnObject &result) override {
+    const PlatformPropertiesSP &properties =
+        Platform::GetGlobalPlatformProperties();
+    const uint64_t max_size = m_options.m_max_size_set
+                                  ? m_options.m_max_size
+                                  : properties->GetModuleCacheMaxSize();
+    ModuleCache::Statistics removed;
+    Status error = ModuleCache::Prune(properties->GetModuleCacheDirectory(),
+                                      max_size, removed);
+    if (error.Fail()) {
+      result.AppendError(error.AsCString());
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+
+    result.AppendMessageWithFormat(
+        "Removed %" PRIu64 " files (%" PRIu64 " bytes) and %" PRIu64
+        " links from the module cache.\n",
+        removed.num_blobs, removed.total_size, removed.num_views);
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return true;
+  }
+
+  CommandOptions m_options;
+};
+
+class CommandObjectPlatformCache : public CommandObjectMultiword {
+public:
+  //------------------------------------------------------------------
+  // Constructors and Destructors
+  //------------------------------------------------------------------
+  CommandObjectPlatformCache(CommandInterpreter &interpreter)
+      : CommandObjectMultiword(
+            interpreter, "platform cache",
+            "Commands to manage the cache of modules downloaded from remote "
+            "platforms.",
+            "platform cache [stats|prune] ...") {
+    LoadSubCommand("stats", CommandObjectSP(new CommandObjectPlatformCacheStats(
+                                interpreter)));
+    LoadSubCommand("prune", CommandObjectSP(new CommandObjectPlatformCachePrune(
+                                interpreter)));
+  }
+
+  ~CommandObjectPlatformCache() override = default;
+
+private:
+  //------------------------------------------------------------------
+  // For CommandObjectPlatform only
+  //------------------------------------------------------------------
+  DISALLOW_COPY_AND_ASSIGN(CommandObjectPlatformCache);
+};
+
 //----------------------------------------------------------------------
 // "platform get-file remote-file-path host-file-path"
 //----------------------------------------------------------------------
@@ -1894,6 +2056,8 @@ CommandObjectPlatform::CommandObjectPlatform(CommandInterpreter &interpreter)
                  CommandObjectSP(new CommandObjectPlatformMkDir(interpreter)));
   LoadSubCommand("file",
                  CommandObjectSP(new CommandObjectPlatformFile(interpreter)));
+  LoadSubCommand("cache",
+                 CommandObjectSP(new CommandObjectPlatformCache(interpreter)));
   LoadSubCommand("get-file", CommandObjectSP(new CommandObjectPlatformGetFile(
                                  interpreter)));
   LoadSubCommand("get-size", CommandObjectSP(new CommandObjectPlatformGetSize(
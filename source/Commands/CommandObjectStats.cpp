@@ -8,21 +8,253 @@
 //===----------------------------------------------------------------------===//
 
 #include "CommandObjectStats.h"
-#include "lldb/Host/Host.h"
+#include "lldb/Host/OptionParser.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Interpreter/Options.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
-CommandObjectStats::CommandObjectStats(CommandInterpreter &interpreter)
-    : CommandObjectParsed(
-          interpreter, "stats", "Print statistics about a debugging session",
-          nullptr) {
-}
+class CommandObjectStatsEnable : public CommandObjectParsed {
+public:
+  CommandObjectStatsEnable(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "enable",
+                            "Enable statistics collection", nullptr,
+                            eCommandRequiresTarget) {}
+
+  ~CommandObjectStatsEnable() override = default;
+
+protected:
+  bool DoExecute(Args &command, CommandReturnObject &result) override {
+    TargetStats &stats = m_exe_ctx.GetTargetRef().GetStatistics();
+    if (stats.GetCollectingStats()) {
+      result.AppendError("statistics already enabled");
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+
+    stats.SetCollectingStats(true);
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return true;
+  }
+};
+
+class CommandObjectStatsDisable : public CommandObjectParsed {
+public:
+  CommandObjectStatsDisable(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "disable",
+                            "Disable statistics collection", nullptr,
+                            eCommandRequiresTarget) {}
+
+  ~CommandObjectStatsDisable() override = default;
+
+protected:
+  bool DoExecute(Args &command, CommandReturnObject &result) override {
+    TargetStats &stats = m_exe_ctx.GetTargetRef().GetStatistics();
+    if (!stats.GetCollectingStats()) {
+      result.AppendError("need to enable statistics before disabling them");
+      result.SetStatus(eReturnStatusFailed);
+      return false;
+    }
+
+    stats.SetCollectingStats(false);
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return true;
+  }
+};
+
+static OptionDefinition g_statistics_dump_options[] = {
+    // clang-format off
+  { LLDB_OPT_SET_1, false, "json", 'j', OptionParser::eNoArgument, nullptr, nullptr, 0, eArgTypeNone, "Print the statistics as JSON." },
+    // clang-format on
+};
+
+class CommandObjectStatsDump : public CommandObjectParsed {
+public:
+  class CommandOptions : public Options {
+  public:
+    CommandOptions() : Options() {}
+
+    ~CommandOptions() override = default;
+
+    Status SetOptionValue(uint32_t option_idx, llvm::StringRef option_arg,
+                          ExecutionContext *execution_context) override {
+      Status error;
+      const int short_option = m_getopt_table[option_idx].val;
+
+      switch (short_option) {
+      case 'j':
+        m_json = true;
+        break;
+      default:
+        error.SetErrorStringWithFormat("unrecognized option '%c'",
+                                       short_option);
+        break;
+      }
+      return error;
+    }
 
-bool CommandObjectStats::DoExecute(Args &command, CommandReturnObject &result) {
-  return true;
+    void OptionParsingStarting(ExecutionContext *execution_context) override {
+      m_json = false;
+    }
+
+    llvm::ArrayRef<OptionDefinition> GetDefinitions() override {
+      return llvm::makeArrayRef(g_statistics_dump_options);
+    }
+
+    bool m_json = false;
+  };
+
+  CommandObjectStatsDump(CommandInterpreter &interpreter)
+      : CommandObjectParsed(interpreter, "dump", "Dump statistics results",
+                            nullptr, eCommandRequiresTarget),
+        m_options() {}
+
+  ~CommandObjectStatsDump() override = default;
+
+  Options *GetOptions() override { return &m_options; }
+
+protected:
+  bool DoExecute(Args &command, CommandReturnObject &result) override {
+    StructuredData::ObjectSP stats_sp =
+        m_exe_ctx.GetTargetRef().GetStatisticsReport();
+    Stream &strm = result.GetOutputStream();
+    if (m_options.m_json) {
+      stats_sp->Dump(strm, true);
+      strm.EOL();
+    } else {
+      DumpSummary(*stats_sp->GetAsDictionary(), strm);
+    }
+    result.SetStatus(eReturnStatusSuccessFinishResult);
+    return true;
+  }
+
+private:
+  static void DumpLatency(StructuredData::Dictionary &dict, Stream &strm) {
+    uint64_t count = 0;
+    double mean = 0, max = 0;
+    dict.GetValueForKeyAsInteger("count", count);
+    if (auto mean_sp = dict.GetValueForKey("meanTime"))
+      mean = mean_sp->GetFloatValue();
+    if (auto max_sp = dict.GetValueForKey("maxTime"))
+      max = max_sp->GetFloatValue();
+    strm.Printf("%" PRIu64 " (mean %.3fms, max %.3fms)", count, mean * 1000,
+                max * 1000);
+  }
+
+  static void DumpSummary(StructuredData::Dictionary &stats, Stream &strm) {
+    StructuredData::Dictionary *expr = nullptr;
+    if (stats.GetValueForKeyAsDictionary("expressionEvaluation", expr)) {
+      uint64_t successes = 0, failures = 0;
+      expr->GetValueForKeyAsInteger("successes", successes);
+      expr->GetValueForKeyAsInteger("failures", failures);
+      strm.Printf("Number of expr evaluation successes: %" PRIu64 "\n",
+                  successes);
+      strm.Printf("Number of expr evaluation failures: %" PRIu64 "\n",
+                  failures);
+      strm.PutCString("Expression evaluations: ");
+      DumpLatency(*expr, strm);
+      strm.EOL();
+    }
+
+    StructuredData::Array *modules = nullptr;
+    if (stats.GetValueForKeyAsArray("modules", modules)) {
+      modules->ForEach([&strm](StructuredData::Object *object) -> bool {
+        StructuredData::Dictionary *module = object->GetAsDictionary();
+        if (!module)
+          return true;
+        llvm::StringRef path;
+        module->GetValueForKeyAsString("path", path);
+        strm.Printf("%s:\n", path.str().c_str());
+        auto dump_time = [&](llvm::StringRef key, const char *label) {
+          if (auto time_sp = module->GetValueForKey(key))
+            strm.Printf("  %s: %.3fs\n", label, time_sp->GetFloatValue());
+        };
+        dump_time("symbolTableParseTime", "Symbol table parse time");
+        dump_time("symbolTableIndexTime", "Symbol table index time");
+        dump_time("debugInfoParseTime", "Debug info parse time");
+        dump_time("debugInfoIndexTime", "Debug info index time");
+        uint64_t value = 0;
+        if (module->GetValueForKeyAsInteger("debugInfoByteSize", value))
+          strm.Printf("  Debug info bytes parsed: %" PRIu64 "\n", value);
+        if (module->GetValueForKeyAsInteger("typesCompleted", value))
+          strm.Printf("  Types completed: %" PRIu64 "\n", value);
+        StructuredData::Dictionary *arena = nullptr;
+        if (module->GetValueForKeyAsDictionary("dieArena", arena)) {
+          uint64_t allocated = 0, used = 0, num_dies = 0;
+          arena->GetValueForKeyAsInteger("bytesAllocated", allocated);
+          arena->GetValueForKeyAsInteger("bytesUsed", used);
+          arena->GetValueForKeyAsInteger("numDIEs", num_dies);
+          strm.Printf("  DIEs in memory: %" PRIu64 " (%" PRIu64
+                      " bytes used, %" PRIu64 " bytes allocated)\n",
+                      num_dies, used, allocated);
+        }
+        return true;
+      });
+    }
+
+    StructuredData::Dictionary *strings = nullptr;
+    if (stats.GetValueForKeyAsDictionary("constStringPool", strings)) {
+      uint64_t count = 0, size = 0, contended_reads = 0, contended_writes = 0;
+      strings->GetValueForKeyAsInteger("stringCount", count);
+      strings->GetValueForKeyAsInteger("memorySize", size);
+      strings->GetValueForKeyAsInteger("contendedReads", contended_reads);
+      strings->GetValueForKeyAsInteger("contendedWrites", contended_writes);
+      strm.Printf("String pool: %" PRIu64 " strings (%" PRIu64
+                  " bytes), %" PRIu64 " contended reads, %" PRIu64
+                  " contended writes\n",
+                  count, size, contended_reads, contended_writes);
+    }
+
+    StructuredData::Dictionary *process = nullptr;
+    if (!stats.GetValueForKeyAsDictionary("process", process))
+      return;
+    StructuredData::Dictionary *memory_cache = nullptr;
+    if (process->GetValueForKeyAsDictionary("memoryCache", memory_cache)) {
+      uint64_t hits = 0, misses = 0;
+      memory_cache->GetValueForKeyAsInteger("hits", hits);
+      memory_cache->GetValueForKeyAsInteger("misses", misses);
+      strm.Printf("Memory cache: %" PRIu64 " hits, %" PRIu64 " misses\n", hits,
+                  misses);
+    }
+    StructuredData::Dictionary *gdb_remote = nullptr;
+    if (process->GetValueForKeyAsDictionary("gdbRemote", gdb_remote)) {
+      uint64_t packets_sent = 0, bytes_sent = 0;
+      uint64_t packets_received = 0, bytes_received = 0;
+      gdb_remote->GetValueForKeyAsInteger("packetsSent", packets_sent);
+      gdb_remote->GetValueForKeyAsInteger("bytesSent", bytes_sent);
+      gdb_remote->GetValueForKeyAsInteger("packetsReceived", packets_received);
+      gdb_remote->GetValueForKeyAsInteger("bytesReceived", bytes_received);
+      strm.Printf("GDB remote packets sent: %" PRIu64 " (%" PRIu64 " bytes)\n",
+                  packets_sent, bytes_sent);
+      strm.Printf("GDB remote packets received: %" PRIu64 " (%" PRIu64
+                  " bytes)\n",
+                  packets_received, bytes_received);
+      StructuredData::Dictionary *round_trip = nullptr;
+      if (gdb_remote->GetValueForKeyAsDictionary("roundTripTime",
+                                                 round_trip)) {
+        strm.PutCString("GDB remote round trips: ");
+        DumpLatency(*round_trip, strm);
+        strm.EOL();
+      }
+    }
+  }
+
+  CommandOptions m_options;
+};
+
+CommandObjectStats::CommandObjectStats(CommandInterpreter &interpreter)
+    : CommandObjectMultiword(interpreter, "statistics",
+                             "Print statistics about a debugging session",
+                             "statistics <subcommand> [<subcommand-options>]") {
+  LoadSubCommand("enable",
+                 CommandObjectSP(new CommandObjectStatsEnable(interpreter)));
+  LoadSubCommand("disable",
+                 CommandObjectSP(new CommandObjectStatsDisable(interpreter)));
+  LoadSubCommand("dump",
+                 CommandObjectSP(new CommandObjectStatsDump(interpreter)));
 }
 
-CommandObjectStats::~CommandObjectStats() {}
+CommandObjectStats::~CommandObjectStats() = default;
@@ -10,18 +10,15 @@
 #ifndef liblldb_CommandObjectStats_h_
 #define liblldb_CommandObjectStats_h_
 
-#include "lldb/Interpreter/CommandObject.h"
+#include "lldb/Interpreter/CommandObjectMultiword.h"
 
 namespace lldb_private {
-class CommandObjectStats : public CommandObjectParsed {
+class CommandObjectStats : public CommandObjectMultiword {
 public:
   CommandObjectStats(CommandInterpreter &interpreter);
 
   ~CommandObjectStats() override;
-
-protected:
-  bool DoExecute(Args &command, CommandReturnObject &result) override;
 };
 } // namespace lldb_private
 
-#endif // liblldb_CommandObjectLanguage_h_
+#endif // liblldb_CommandObjectStats_h_
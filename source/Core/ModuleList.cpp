@@ -13,6 +13,7 @@
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/Symbols.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
 #include "lldb/Interpreter/OptionValueFileSpec.h"
 #include "lldb/Interpreter/Property.h"
@@ -75,9 +76,16 @@ PropertyDefinition g_properties[] = {
     {"clang-modules-cache-path", OptionValue::eTypeFileSpec, true, 0, nullptr,
      nullptr,
      "The path to the clang modules cache directory (-fmodules-cache-path)."},
+    {"parallel-thread-count", OptionValue::eTypeUInt64, true, 0, nullptr,
+     nullptr, "The maximum number of threads used to parse and index symbol "
+              "files in parallel. Zero uses one thread per CPU."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
-enum { ePropertyEnableExternalLookup, ePropertyClangModulesCachePath };
+enum {
+  ePropertyEnableExternalLookup,
+  ePropertyClangModulesCachePath,
+  ePropertyParallelThreadCount
+};
 
 } // namespace
 
@@ -88,6 +96,10 @@ ModuleListProperties::ModuleListProperties() {
   llvm::SmallString<128> path;
   clang::driver::Driver::getDefaultModuleCachePath(path);
   SetClangModulesCachePath(path);
+
+  m_collection_sp->SetValueChangedCallback(
+      ePropertyParallelThreadCount,
+      ModuleListProperties::ParallelThreadCountValueChangedCallback, this);
 }
 
 bool ModuleListProperties::GetEnableExternalLookup() const {
@@ -108,6 +120,18 @@ bool ModuleListProperties::SetClangModulesCachePath(llvm::StringRef path) {
       nullptr, ePropertyClangModulesCachePath, path);
 }
 
+uint32_t ModuleListProperties::GetParallelThreadCount() const {
+  const uint32_t idx = ePropertyParallelThreadCount;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_properties[idx].default_uint_value);
+}
+
+void ModuleListProperties::ParallelThreadCountValueChangedCallback(
+    void *baton, OptionValue *) {
+  ModuleListProperties *this_ = reinterpret_cast<ModuleListProperties *>(baton);
+  TaskPool::SetThreadCount(this_->GetParallelThreadCount());
+}
+
 
 ModuleList::ModuleList()
     : m_modules(), m_modules_mutex(), m_notifier(nullptr) {}
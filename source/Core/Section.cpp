@@ -105,6 +105,8 @@ static const char *GetSectionTypeAsCString(lldb::SectionType sect_type) {
     return "apple-namespaces";
   case eSectionTypeDWARFAppleObjC:
     return "apple-objc";
+  case eSectionTypeDWARFDebugNames:
+    return "dwarf-names";
   case eSectionTypeEHFrame:
     return "eh-frame";
   case eSectionTypeARMexidx:
@@ -520,9 +520,30 @@ Status Value::GetValueAsData(ExecutionContext *exe_ctx, DataExtractor &data,
   if (error.Fail())
     return error;
 
+  // Processes that have their memory mapped into the debugger already, like
+  // core files, can hand it out without a copy.
+  if (data_offset == 0 && address_type == eAddressTypeLoad &&
+      !file_so_addr.IsValid() && exe_ctx) {
+    if (Process *process = exe_ctx->GetProcessPtr()) {
+      DataExtractor memory_data;
+      if (process->GetMemoryData(address, byte_size, memory_data) ==
+          byte_size) {
+        const lldb::ByteOrder byte_order = data.GetByteOrder();
+        const uint32_t addr_byte_size = data.GetAddressByteSize();
+        data = memory_data;
+        data.SetByteOrder(byte_order);
+        data.SetAddressByteSize(addr_byte_size);
+        return error;
+      }
+    }
+  }
+
   // Make sure we have enough room within "data", and if we don't make
-  // something large enough that does
-  if (!data.ValidOffsetForDataOfSize(data_offset, byte_size)) {
+  // something large enough that does. Don't write into a buffer that is
+  // shared, it may be memory handed out by the process.
+  const DataBufferSP &data_buffer_sp = data.GetSharedDataBuffer();
+  if (!data.ValidOffsetForDataOfSize(data_offset, byte_size) ||
+      (data_buffer_sp && data_buffer_sp.use_count() > 1)) {
     auto data_sp =
         std::make_shared<DataBufferHeap>(data_offset + byte_size, '\0');
     data.SetData(data_sp);
@@ -481,6 +481,19 @@ ValueObjectSP ValueObject::GetChildAtIndex(size_t idx, bool can_create) {
   return child_sp;
 }
 
+size_t
+ValueObject::GetChildrenRange(size_t start, size_t count,
+                              std::vector<lldb::ValueObjectSP> &children) {
+  const size_t num_children = GetNumChildren();
+  if (start >= num_children)
+    return 0;
+  count = std::min(count, num_children - start);
+  children.reserve(children.size() + count);
+  for (size_t idx = start; idx < start + count; ++idx)
+    children.push_back(GetChildAtIndex(idx, true));
+  return count;
+}
+
 lldb::ValueObjectSP
 ValueObject::GetChildAtIndexPath(llvm::ArrayRef<size_t> idxs,
                                  size_t *index_of_error) {
@@ -20,6 +20,8 @@
 
 #include "llvm/ADT/STLExtras.h"
 
+#include <algorithm>
+
 namespace lldb_private {
 class Declaration;
 }
@@ -246,11 +248,7 @@ lldb::ValueObjectSP ValueObjectSynthetic::GetChildAtIndex(size_t idx,
       if (!synth_guy)
         return synth_guy;
 
-      if (synth_guy->IsSyntheticChildrenGenerated())
-        m_synthetic_children_cache.AppendObject(synth_guy);
-      m_children_byindex.SetValueForKey(idx, synth_guy.get());
-      synth_guy->SetPreferredDisplayLanguageIfNeeded(
-          GetPreferredDisplayLanguage());
+      CacheChild(idx, synth_guy);
       return synth_guy;
     } else {
       if (log)
@@ -272,6 +270,55 @@ lldb::ValueObjectSP ValueObjectSynthetic::GetChildAtIndex(size_t idx,
   }
 }
 
+size_t ValueObjectSynthetic::GetChildrenRange(
+    size_t start, size_t count, std::vector<lldb::ValueObjectSP> &children) {
+  UpdateValueIfNeeded();
+
+  if (m_synth_filter_ap.get() == nullptr)
+    return 0;
+  const size_t num_children = GetNumChildren();
+  if (start >= num_children)
+    return 0;
+  count = std::min(count, num_children - start);
+  const size_t end = start + count;
+  const size_t first = children.size();
+  children.resize(first + count);
+
+  // Hand each run of children that aren't cached yet to the front end in one
+  // call, so that it can fetch them together.
+  ValueObject *valobj;
+  size_t idx = start;
+  while (idx < end) {
+    if (m_children_byindex.GetValueForKey(idx, valobj)) {
+      children[first + idx - start] = valobj->GetSP();
+      ++idx;
+      continue;
+    }
+    size_t run_end = idx + 1;
+    while (run_end < end && !m_children_byindex.GetValueForKey(run_end, valobj))
+      ++run_end;
+
+    std::vector<lldb::ValueObjectSP> run;
+    m_synth_filter_ap->GetChildrenRange(idx, run_end - idx, run);
+    for (size_t i = 0; i < run.size() && idx + i < run_end; ++i) {
+      if (!run[i])
+        continue;
+      CacheChild(idx + i, run[i]);
+      children[first + idx + i - start] = run[i];
+    }
+    idx = run_end;
+  }
+  return count;
+}
+
+void ValueObjectSynthetic::CacheChild(size_t idx,
+                                      lldb::ValueObjectSP &child_sp) {
+  if (child_sp->IsSyntheticChildrenGenerated())
+    m_synthetic_children_cache.AppendObject(child_sp);
+  m_children_byindex.SetValueForKey(idx, child_sp.get());
+  child_sp->SetPreferredDisplayLanguageIfNeeded(GetPreferredDisplayLanguage());
+}
+
 lldb::ValueObjectSP
 ValueObjectSynthetic::GetChildMemberWithName(const ConstString &name,
                                              bool can_create) {
@@ -11,6 +11,7 @@
 // C Includes
 
 // C++ Includes
+#include <algorithm>
 
 // Other libraries and framework includes
 
@@ -23,6 +24,7 @@
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/ScriptInterpreter.h"
 #include "lldb/Symbol/CompilerType.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/StreamString.h"
 
@@ -130,6 +132,53 @@ lldb::ValueObjectSP SyntheticChildrenFrontEnd::CreateValueObjectFromData(
   return valobj_sp;
 }
 
+void SyntheticChildrenFrontEnd::GetChildrenRange(
+    size_t start, size_t count, std::vector<lldb::ValueObjectSP> &children) {
+  children.reserve(children.size() + count);
+  for (size_t idx = start; idx < start + count; ++idx)
+    children.push_back(GetChildAtIndex(idx));
+}
+
+void SyntheticChildrenFrontEnd::CreateValueObjectsFromArray(
+    size_t start, size_t count, lldb::addr_t address, uint64_t stride,
+    const ExecutionContext &exe_ctx, CompilerType type,
+    std::vector<lldb::ValueObjectSP> &children) {
+  if (count == 0)
+    return;
+
+  // Read the elements through the process memory cache, so that the children
+  // find their values there instead of reading them one by one. Do it a
+  // chunk at a time, so that a large range doesn't need a buffer that big.
+  // The children still live in the inferior's memory: writing to them goes
+  // to the process, which flushes the cache.
+  static const uint64_t g_max_read_size = 64 * 1024;
+  Process *process = exe_ctx.GetProcessPtr();
+  const uint64_t element_size = type.GetByteSize(nullptr);
+  const bool read_ahead = process && !process->GetDisableMemoryCache() &&
+                          element_size != 0 && stride >= element_size;
+  const size_t chunk_count =
+      stride ? std::max<uint64_t>(1, g_max_read_size / stride) : count;
+  std::vector<uint8_t> buffer;
+
+  children.reserve(children.size() + count);
+  StreamString name;
+  for (size_t first = 0; first < count; first += chunk_count) {
+    const size_t last = std::min(count, first + chunk_count);
+    if (read_ahead) {
+      buffer.resize((last - first - 1) * stride + element_size);
+      Status error;
+      process->ReadMemory(address + first * stride, buffer.data(),
+                          buffer.size(), error);
+    }
+    for (size_t i = first; i < last; ++i) {
+      name.Clear();
+      name.Printf("[%" PRIu64 "]", (uint64_t)(start + i));
+      children.push_back(CreateValueObjectFromAddress(
+          name.GetString(), address + i * stride, exe_ctx, type));
+    }
+  }
+}
+
 #ifndef LLDB_DISABLE_PYTHON
 
 ScriptedSyntheticChildren::FrontEnd::FrontEnd(std::string pclass,
@@ -676,8 +676,17 @@ void ValueObjectPrinter::PrintChildren(
   if (num_children) {
     bool any_children_printed = false;
 
+    // Ask for all the children at once, so that a synthetic child provider
+    // can fetch their data together instead of one child at a time.
+    std::vector<ValueObjectSP> children;
+    if (!m_options.m_pointer_as_array)
+      synth_m_valobj->GetChildrenRange(0, num_children, children);
+
     for (size_t idx = 0; idx < num_children; ++idx) {
-      if (ValueObjectSP child_sp = GenerateChild(synth_m_valobj, idx)) {
+      ValueObjectSP child_sp = idx < children.size()
+                                   ? children[idx]
+                                   : GenerateChild(synth_m_valobj, idx);
+      if (child_sp) {
         if (!any_children_printed) {
           PrintChildrenPreamble();
           any_children_printed = true;
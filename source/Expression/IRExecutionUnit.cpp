@@ -562,6 +562,11 @@ lldb::SectionType IRExecutionUnit::GetSectionTypeFromSectionName(
           sect_type = lldb::eSectionTypeDWARFDebugMacInfo;
         break;
 
+      case 'n':
+        if (dwarf_name.equals("names"))
+          sect_type = lldb::eSectionTypeDWARFDebugNames;
+        break;
+
       case 'p':
         if (dwarf_name.equals("pubnames"))
           sect_type = lldb::eSectionTypeDWARFDebugPubNames;
@@ -1100,6 +1105,7 @@ bool IRExecutionUnit::CommitOneAllocation(lldb::ProcessSP &process_sp,
   case lldb::eSectionTypeDWARFAppleTypes:
   case lldb::eSectionTypeDWARFAppleNamespaces:
   case lldb::eSectionTypeDWARFAppleObjC:
+  case lldb::eSectionTypeDWARFDebugNames:
     error.Clear();
     break;
   default:
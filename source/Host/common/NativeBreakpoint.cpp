@@ -9,6 +9,8 @@
 
 #include "lldb/Host/common/NativeBreakpoint.h"
 
+#include "lldb/Host/common/NativeThreadProtocol.h"
+
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/lldb-defines.h"
@@ -16,7 +18,8 @@
 using namespace lldb_private;
 
 NativeBreakpoint::NativeBreakpoint(lldb::addr_t addr)
-    : m_addr(addr), m_ref_count(1), m_enabled(true) {
+    : m_addr(addr), m_ref_count(1), m_enabled(true), m_ignore_count(0),
+      m_ignored_hit_count(0), m_condition_false_hit_count(0) {
   assert(addr != LLDB_INVALID_ADDRESS && "breakpoint set for invalid address");
 }
 
@@ -44,6 +47,49 @@ int32_t NativeBreakpoint::DecRef() {
   return m_ref_count;
 }
 
+bool NativeBreakpoint::ConditionsSayStop(NativeThreadProtocol &thread) const {
+  if (m_conditions.empty())
+    return true;
+
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+  for (const NativeBreakpointCondition &condition : m_conditions) {
+    bool result = false;
+    Status error = condition.Evaluate(thread, result);
+    if (error.Fail()) {
+      if (log)
+        log->Printf("NativeBreakpoint::%s addr = 0x%" PRIx64
+                    " tid = %" PRIu64 " condition failed: %s",
+                    __FUNCTION__, m_addr, thread.GetID(), error.AsCString());
+      return true;
+    }
+    if (result)
+      return true;
+  }
+  return false;
+}
+
+bool NativeBreakpoint::HitShouldStop(NativeThreadProtocol &thread) const {
+  if (m_ignore_count > 0)
+    return false;
+  return ConditionsSayStop(thread);
+}
+
+void NativeBreakpoint::RecordSkippedHit() {
+  if (m_ignore_count > 0) {
+    --m_ignore_count;
+    ++m_ignored_hit_count;
+  } else
+    ++m_condition_false_hit_count;
+}
+
+void NativeBreakpoint::TakeSkippedHitCounts(uint32_t &ignored,
+                                            uint32_t &condition_false) {
+  ignored = m_ignored_hit_count;
+  condition_false = m_condition_false_hit_count;
+  m_ignored_hit_count = 0;
+  m_condition_false_hit_count = 0;
+}
+
 Status NativeBreakpoint::Enable() {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
 
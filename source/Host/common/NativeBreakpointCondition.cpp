@@ -0,0 +1,376 @@
+//===-- NativeBreakpointCondition.cpp ---------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/common/NativeBreakpointCondition.h"
+
+#include "lldb/Core/RegisterValue.h"
+#include "lldb/Host/common/NativeProcessProtocol.h"
+#include "lldb/Host/common/NativeRegisterContext.h"
+#include "lldb/Host/common/NativeThreadProtocol.h"
+
+#include <string.h>
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Limits that keep a bad expression from running away: agent expressions can
+// jump backwards and push without bounds.
+static const size_t kMaxStackDepth = 64;
+static const size_t kMaxSteps = 10000;
+
+static bool GetOperandSize(uint8_t opcode, size_t &size) {
+  switch (opcode) {
+  case NativeBreakpointCondition::eOpAdd:
+  case NativeBreakpointCondition::eOpSub:
+  case NativeBreakpointCondition::eOpMul:
+  case NativeBreakpointCondition::eOpDivSigned:
+  case NativeBreakpointCondition::eOpDivUnsigned:
+  case NativeBreakpointCondition::eOpRemSigned:
+  case NativeBreakpointCondition::eOpRemUnsigned:
+  case NativeBreakpointCondition::eOpLsh:
+  case NativeBreakpointCondition::eOpRshSigned:
+  case NativeBreakpointCondition::eOpRshUnsigned:
+  case NativeBreakpointCondition::eOpLogNot:
+  case NativeBreakpointCondition::eOpBitAnd:
+  case NativeBreakpointCondition::eOpBitOr:
+  case NativeBreakpointCondition::eOpBitXor:
+  case NativeBreakpointCondition::eOpBitNot:
+  case NativeBreakpointCondition::eOpEqual:
+  case NativeBreakpointCondition::eOpLessSigned:
+  case NativeBreakpointCondition::eOpLessUnsigned:
+  case NativeBreakpointCondition::eOpRef8:
+  case NativeBreakpointCondition::eOpRef16:
+  case NativeBreakpointCondition::eOpRef32:
+  case NativeBreakpointCondition::eOpRef64:
+  case NativeBreakpointCondition::eOpEnd:
+  case NativeBreakpointCondition::eOpDup:
+  case NativeBreakpointCondition::eOpPop:
+  case NativeBreakpointCondition::eOpSwap:
+    size = 0;
+    return true;
+  case NativeBreakpointCondition::eOpExt:
+  case NativeBreakpointCondition::eOpZeroExt:
+  case NativeBreakpointCondition::eOpConst8:
+    size = 1;
+    return true;
+  case NativeBreakpointCondition::eOpIfGoto:
+  case NativeBreakpointCondition::eOpGoto:
+  case NativeBreakpointCondition::eOpConst16:
+  case NativeBreakpointCondition::eOpReg:
+    size = 2;
+    return true;
+  case NativeBreakpointCondition::eOpConst32:
+    size = 4;
+    return true;
+  case NativeBreakpointCondition::eOpConst64:
+    size = 8;
+    return true;
+  }
+  return false;
+}
+
+static uint64_t ReadBigEndian(const uint8_t *bytes, size_t size) {
+  uint64_t value = 0;
+  for (size_t i = 0; i < size; ++i)
+    value = (value << 8) | bytes[i];
+  return value;
+}
+
+NativeBreakpointCondition::NativeBreakpointCondition(
+    std::vector<uint8_t> bytecode)
+    : m_bytecode(std::move(bytecode)) {}
+
+Status NativeBreakpointCondition::Validate() const {
+  if (m_bytecode.empty())
+    return Status("empty condition expression");
+
+  size_t pc = 0;
+  while (pc < m_bytecode.size()) {
+    const uint8_t opcode = m_bytecode[pc];
+    size_t operand_size = 0;
+    if (!GetOperandSize(opcode, operand_size))
+      return Status("unsupported opcode 0x%2.2x at offset %" PRIu64, opcode,
+                    (uint64_t)pc);
+    if (pc + 1 + operand_size > m_bytecode.size())
+      return Status("truncated operand at offset %" PRIu64, (uint64_t)pc);
+
+    const uint64_t operand = ReadBigEndian(&m_bytecode[pc + 1], operand_size);
+    switch (opcode) {
+    case eOpIfGoto:
+    case eOpGoto:
+      if (operand >= m_bytecode.size())
+        return Status("jump target %" PRIu64 " at offset %" PRIu64
+                      " is outside the expression",
+                      operand, (uint64_t)pc);
+      break;
+    case eOpExt:
+    case eOpZeroExt:
+      if (operand == 0 || operand > 64)
+        return Status("invalid bit count %" PRIu64 " at offset %" PRIu64,
+                      operand, (uint64_t)pc);
+      break;
+    default:
+      break;
+    }
+    pc += 1 + operand_size;
+  }
+  return Status();
+}
+
+Status NativeBreakpointCondition::Evaluate(ReadRegisterCallback read_register,
+                                           ReadMemoryCallback read_memory,
+                                           bool &result) const {
+  std::vector<uint64_t> stack;
+  size_t pc = 0;
+
+  for (size_t steps = 0; steps < kMaxSteps; ++steps) {
+    if (pc >= m_bytecode.size())
+      return Status("ran past the end of the condition expression");
+
+    const uint8_t opcode = m_bytecode[pc];
+    size_t operand_size = 0;
+    if (!GetOperandSize(opcode, operand_size) ||
+        pc + 1 + operand_size > m_bytecode.size())
+      return Status("invalid opcode 0x%2.2x at offset %" PRIu64, opcode,
+                    (uint64_t)pc);
+    const uint64_t operand = ReadBigEndian(&m_bytecode[pc + 1], operand_size);
+    size_t next_pc = pc + 1 + operand_size;
+
+    // Every opcode but the constants, the register loads and the jumps
+    // consumes at least one value, the binary operators two.
+    size_t min_stack_size = 2;
+    switch (opcode) {
+    case eOpConst8:
+    case eOpConst16:
+    case eOpConst32:
+    case eOpConst64:
+    case eOpReg:
+    case eOpGoto:
+      min_stack_size = 0;
+      break;
+    case eOpLogNot:
+    case eOpBitNot:
+    case eOpExt:
+    case eOpZeroExt:
+    case eOpRef8:
+    case eOpRef16:
+    case eOpRef32:
+    case eOpRef64:
+    case eOpIfGoto:
+    case eOpEnd:
+    case eOpDup:
+    case eOpPop:
+      min_stack_size = 1;
+      break;
+    default:
+      break;
+    }
+    if (stack.size() < min_stack_size)
+      return Status("stack underflow at offset %" PRIu64, (uint64_t)pc);
+
+    switch (opcode) {
+    case eOpEnd:
+      result = stack.back() != 0;
+      return Status();
+
+    case eOpConst8:
+    case eOpConst16:
+    case eOpConst32:
+    case eOpConst64:
+      stack.push_back(operand);
+      break;
+
+    case eOpReg: {
+      uint64_t value = 0;
+      if (!read_register(operand, value))
+        return Status("failed to read register %" PRIu64, operand);
+      stack.push_back(value);
+      break;
+    }
+
+    case eOpRef8:
+    case eOpRef16:
+    case eOpRef32:
+    case eOpRef64: {
+      const size_t size = 1u << (opcode - eOpRef8);
+      const addr_t addr = stack.back();
+      uint8_t buf[8];
+      if (!read_memory(addr, buf, size))
+        return Status("failed to read %" PRIu64 " bytes at 0x%" PRIx64,
+                      (uint64_t)size, addr);
+      switch (size) {
+      case 1:
+        stack.back() = buf[0];
+        break;
+      case 2: {
+        uint16_t value;
+        memcpy(&value, buf, sizeof(value));
+        stack.back() = value;
+        break;
+      }
+      case 4: {
+        uint32_t value;
+        memcpy(&value, buf, sizeof(value));
+        stack.back() = value;
+        break;
+      }
+      default: {
+        uint64_t value;
+        memcpy(&value, buf, sizeof(value));
+        stack.back() = value;
+        break;
+      }
+      }
+      break;
+    }
+
+    case eOpExt:
+      if (operand < 64) {
+        const unsigned shift = 64 - operand;
+        stack.back() = (uint64_t)((int64_t)(stack.back() << shift) >> shift);
+      }
+      break;
+
+    case eOpZeroExt:
+      if (operand < 64)
+        stack.back() &= (1ull << operand) - 1;
+      break;
+
+    case eOpLogNot:
+      stack.back() = stack.back() == 0;
+      break;
+
+    case eOpBitNot:
+      stack.back() = ~stack.back();
+      break;
+
+    case eOpDup:
+      stack.push_back(stack.back());
+      break;
+
+    case eOpPop:
+      stack.pop_back();
+      break;
+
+    case eOpSwap:
+      std::swap(stack[stack.size() - 1], stack[stack.size() - 2]);
+      break;
+
+    case eOpIfGoto: {
+      const uint64_t value = stack.back();
+      stack.pop_back();
+      if (value)
+        next_pc = operand;
+      break;
+    }
+
+    case eOpGoto:
+      next_pc = operand;
+      break;
+
+    default: {
+      // Binary operators: "a" was pushed before "b".
+      const uint64_t b = stack.back();
+      stack.pop_back();
+      const uint64_t a = stack.back();
+      const int64_t sa = (int64_t)a;
+      const int64_t sb = (int64_t)b;
+      uint64_t value = 0;
+      switch (opcode) {
+      case eOpAdd:
+        value = a + b;
+        break;
+      case eOpSub:
+        value = a - b;
+        break;
+      case eOpMul:
+        value = a * b;
+        break;
+      case eOpDivSigned:
+      case eOpRemSigned:
+        if (b == 0)
+          return Status("division by zero");
+        if (sa == INT64_MIN && sb == -1)
+          value = opcode == eOpDivSigned ? a : 0;
+        else
+          value = opcode == eOpDivSigned ? sa / sb : sa % sb;
+        break;
+      case eOpDivUnsigned:
+      case eOpRemUnsigned:
+        if (b == 0)
+          return Status("division by zero");
+        value = opcode == eOpDivUnsigned ? a / b : a % b;
+        break;
+      case eOpLsh:
+        value = b < 64 ? a << b : 0;
+        break;
+      case eOpRshSigned:
+        value = (uint64_t)(sa >> (b < 64 ? b : 63));
+        break;
+      case eOpRshUnsigned:
+        value = b < 64 ? a >> b : 0;
+        break;
+      case eOpBitAnd:
+        value = a & b;
+        break;
+      case eOpBitOr:
+        value = a | b;
+        break;
+      case eOpBitXor:
+        value = a ^ b;
+        break;
+      case eOpEqual:
+        value = a == b;
+        break;
+      case eOpLessSigned:
+        value = sa < sb;
+        break;
+      case eOpLessUnsigned:
+        value = a < b;
+        break;
+      }
+      stack.back() = value;
+      break;
+    }
+    }
+
+    if (stack.size() > kMaxStackDepth)
+      return Status("stack overflow at offset %" PRIu64, (uint64_t)pc);
+    pc = next_pc;
+  }
+
+  return Status("condition expression did not terminate");
+}
+
+Status NativeBreakpointCondition::Evaluate(NativeThreadProtocol &thread,
+                                           bool &result) const {
+  NativeRegisterContext &reg_ctx = thread.GetRegisterContext();
+  NativeProcessProtocol &process = thread.GetProcess();
+
+  auto read_register = [&reg_ctx](uint32_t regnum, uint64_t &value) {
+    const RegisterInfo *reg_info = reg_ctx.GetRegisterInfoAtIndex(regnum);
+    if (!reg_info || reg_info->byte_size > sizeof(value))
+      return false;
+    RegisterValue reg_value;
+    if (reg_ctx.ReadRegister(reg_info, reg_value).Fail())
+      return false;
+    bool success = false;
+    value = reg_value.GetAsUInt64(0, &success);
+    return success;
+  };
+
+  auto read_memory = [&process](addr_t addr, void *buf, size_t size) {
+    size_t bytes_read = 0;
+    return process.ReadMemoryWithoutTrap(addr, buf, size, bytes_read)
+               .Success() &&
+           bytes_read == size;
+  };
+
+  return Evaluate(read_register, read_memory, result);
+}
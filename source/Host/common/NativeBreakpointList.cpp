@@ -227,3 +227,32 @@ Status NativeBreakpointList::RemoveTrapsFromBuffer(lldb::addr_t addr, void *buf,
   }
   return Status();
 }
+
+bool NativeBreakpointList::HasBreakpointInRange(lldb::addr_t addr,
+                                                size_t size) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  for (const auto &map_entry : m_breakpoints) {
+    const lldb::addr_t bp_addr = map_entry.first;
+    size_t bp_size = 1;
+    if (map_entry.second->IsSoftwareBreakpoint())
+      bp_size = std::static_pointer_cast<SoftwareBreakpoint>(map_entry.second)
+                    ->m_opcode_size;
+    if (bp_addr < addr + size && addr < bp_addr + bp_size)
+      return true;
+  }
+  return false;
+}
+
+std::vector<SkippedBreakpointHits>
+NativeBreakpointList::TakeSkippedHitCounts() {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  std::vector<SkippedBreakpointHits> counts;
+  for (const auto &map_entry : m_breakpoints) {
+    SkippedBreakpointHits hits = {map_entry.first, 0, 0};
+    map_entry.second->TakeSkippedHitCounts(hits.m_ignored,
+                                           hits.m_condition_false);
+    if (hits.m_ignored > 0 || hits.m_condition_false > 0)
+      counts.push_back(hits);
+  }
+  return counts;
+}
@@ -56,6 +56,36 @@ NativeProcessProtocol::GetMemoryRegionInfo(lldb::addr_t load_addr,
   return Status("not implemented");
 }
 
+Status NativeProcessProtocol::GetLoadedSVR4Libraries(
+    std::vector<SVR4LibraryInfo> &libraries, lldb::addr_t &main_lm) {
+  // Default: not implemented.
+  return Status("not implemented");
+}
+
+Status NativeProcessProtocol::ReadMemoryRanges(
+    llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  for (MemoryReadRange &range : ranges) {
+    size_t bytes_read = 0;
+    // A failed read may still have read the start of the range.
+    ReadMemory(range.addr, range.buf, range.size, bytes_read);
+    range.bytes_read = std::min(bytes_read, range.size);
+  }
+  return Status();
+}
+
+Status NativeProcessProtocol::ReadMemoryRangesWithoutTrap(
+    llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  Status error = ReadMemoryRanges(ranges);
+  if (error.Fail())
+    return error;
+  for (const MemoryReadRange &range : ranges) {
+    if (range.bytes_read > 0)
+      m_breakpoint_list.RemoveTrapsFromBuffer(range.addr, range.buf,
+                                              range.bytes_read);
+  }
+  return Status();
+}
+
 llvm::Optional<WaitStatus> NativeProcessProtocol::GetExitStatus() {
   if (m_state == lldb::eStateExited)
     return m_exit_status;
@@ -391,6 +421,30 @@ Status NativeProcessProtocol::DisableBreakpoint(lldb::addr_t addr) {
   return m_breakpoint_list.DisableBreakpoint(addr);
 }
 
+Status NativeProcessProtocol::SetBreakpointConditions(
+    lldb::addr_t addr, std::vector<NativeBreakpointCondition> conditions) {
+  NativeBreakpointSP breakpoint_sp;
+  Status error = m_breakpoint_list.GetBreakpoint(addr, breakpoint_sp);
+  if (error.Fail())
+    return error;
+  if (!breakpoint_sp->IsSoftwareBreakpoint())
+    return Status("conditions are only supported for software breakpoints");
+  breakpoint_sp->SetConditions(std::move(conditions));
+  return Status();
+}
+
+Status NativeProcessProtocol::SetBreakpointIgnoreCount(lldb::addr_t addr,
+                                                       uint32_t ignore_count) {
+  NativeBreakpointSP breakpoint_sp;
+  Status error = m_breakpoint_list.GetBreakpoint(addr, breakpoint_sp);
+  if (error.Fail())
+    return error;
+  if (!breakpoint_sp->IsSoftwareBreakpoint())
+    return Status("ignore counts are only supported for software breakpoints");
+  breakpoint_sp->SetIgnoreCount(ignore_count);
+  return Status();
+}
+
 lldb::StateType NativeProcessProtocol::GetState() const {
   std::lock_guard<std::recursive_mutex> guard(m_state_mutex);
   return m_state;
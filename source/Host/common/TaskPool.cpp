@@ -10,95 +10,306 @@
 #include "lldb/Host/TaskPool.h"
 #include "lldb/Host/ThreadLauncher.h"
 
-#include <cstdint> // for uint32_t
-#include <queue>   // for queue
-#include <thread>  // for thread
+#include <algorithm>          // for find_if
+#include <atomic>             // for atomic
+#include <condition_variable> // for condition_variable
+#include <cstdint>            // for uint32_t
+#include <deque>              // for deque
+#include <thread>             // for thread
+#include <vector>             // for vector
 
 namespace lldb_private {
 
 namespace {
+// Upper bound for the number of worker threads. The work queues live in a
+// fixed size array so that they can be scanned without taking a lock while
+// new workers are being started.
+const uint32_t kMaxThreadCount = 256;
+
 class TaskPoolImpl {
 public:
   static TaskPoolImpl &GetInstance();
 
   void AddTask(std::function<void()> &&task_fn);
 
+  bool RunGroupTask();
+
+  void SetThreadCount(unsigned thread_count);
+
+  unsigned GetThreadCount() const { return m_max_thread_count; }
+
 private:
+  struct QueuedTask {
+    // The group of the thread or task that added this task.
+    uint64_t group;
+    std::function<void()> fn;
+  };
+
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<QueuedTask> tasks;
+  };
+
   TaskPoolImpl();
 
-  static lldb::thread_result_t WorkerPtr(void *pool);
+  static lldb::thread_result_t WorkerPtr(void *queue_idx);
+
+  void Worker(uint32_t queue_idx);
+
+  bool PopTask(uint32_t queue_idx, std::function<void()> &task_fn);
+
+  bool StealTask(uint32_t start_idx, std::function<void()> &task_fn);
+
+  void RunTask(std::function<void()> &task_fn);
 
-  static void Worker(TaskPoolImpl *pool);
+  // Index of the queue that belongs to the current thread or UINT32_MAX if
+  // the current thread isn't a worker thread.
+  static uint32_t &CurrentQueueIndex();
 
-  std::queue<std::function<void()>> m_tasks;
-  std::mutex m_tasks_mutex;
-  uint32_t m_thread_count;
+  // Group of the tasks added by the current thread, zero if it hasn't been
+  // assigned yet. Every running task gets a group of its own.
+  static uint64_t &CurrentGroup();
+
+  std::unique_ptr<WorkQueue> m_queues[kMaxThreadCount];
+  std::atomic<uint32_t> m_queue_count;
+  std::atomic<uint32_t> m_max_thread_count;
+  std::atomic<uint32_t> m_next_queue;
+  std::atomic<uint64_t> m_next_group;
+  // Number of tasks in all queues and the number of workers that are about
+  // to go to sleep or are sleeping on m_idle_cond.
+  std::atomic<size_t> m_pending_count;
+  std::atomic<uint32_t> m_idle_count;
+  std::mutex m_mutex;
+  std::condition_variable m_idle_cond;
+  // Workers above the current thread count limit sleep here.
+  std::condition_variable m_parked_cond;
 };
 
 } // end of anonymous namespace
 
 TaskPoolImpl &TaskPoolImpl::GetInstance() {
-  static TaskPoolImpl g_task_pool_impl;
-  return g_task_pool_impl;
+  // Leaked intentionally: the worker threads never exit and may still be
+  // sleeping on the condition variables when static destructors run.
+  static TaskPoolImpl *g_task_pool_impl = new TaskPoolImpl();
+  return *g_task_pool_impl;
 }
 
 void TaskPool::AddTaskImpl(std::function<void()> &&task_fn) {
   TaskPoolImpl::GetInstance().AddTask(std::move(task_fn));
 }
 
-TaskPoolImpl::TaskPoolImpl() : m_thread_count(0) {}
+bool TaskPool::RunGroupTaskImpl() {
+  return TaskPoolImpl::GetInstance().RunGroupTask();
+}
+
+void TaskPool::SetThreadCount(unsigned thread_count) {
+  TaskPoolImpl::GetInstance().SetThreadCount(thread_count);
+}
+
+unsigned TaskPool::GetThreadCount() {
+  return TaskPoolImpl::GetInstance().GetThreadCount();
+}
+
+TaskPoolImpl::TaskPoolImpl()
+    : m_queue_count(0), m_max_thread_count(0), m_next_queue(0),
+      m_next_group(1), m_pending_count(0), m_idle_count(0) {
+  SetThreadCount(0);
+}
 
 unsigned GetHardwareConcurrencyHint() {
   // std::thread::hardware_concurrency may return 0
   // if the value is not well defined or not computable.
-  static const unsigned g_hardware_concurrency = 
+  static const unsigned g_hardware_concurrency =
     std::max(1u, std::thread::hardware_concurrency());
   return g_hardware_concurrency;
 }
 
+uint32_t &TaskPoolImpl::CurrentQueueIndex() {
+  static thread_local uint32_t g_queue_idx = UINT32_MAX;
+  return g_queue_idx;
+}
+
+uint64_t &TaskPoolImpl::CurrentGroup() {
+  static thread_local uint64_t g_group = 0;
+  return g_group;
+}
+
+void TaskPoolImpl::SetThreadCount(unsigned thread_count) {
+  if (thread_count == 0)
+    thread_count = GetHardwareConcurrencyHint();
+  m_max_thread_count = std::min<uint32_t>(thread_count, kMaxThreadCount);
+  // Let idle workers that are now above the limit park themselves and the
+  // ones that were parked because of the old limit run again.
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_idle_cond.notify_all();
+  m_parked_cond.notify_all();
+}
+
 void TaskPoolImpl::AddTask(std::function<void()> &&task_fn) {
   const size_t min_stack_size = 8 * 1024 * 1024;
 
-  std::unique_lock<std::mutex> lock(m_tasks_mutex);
-  m_tasks.emplace(std::move(task_fn));
-  if (m_thread_count < GetHardwareConcurrencyHint()) {
-    m_thread_count++;
-    // Note that this detach call needs to happen with the m_tasks_mutex held.
-    // This prevents the thread
-    // from exiting prematurely and triggering a linux libc bug
-    // (https://sourceware.org/bugzilla/show_bug.cgi?id=19951).
-    lldb_private::ThreadLauncher::LaunchThread("task-pool.worker", WorkerPtr,
-                                               this, nullptr, min_stack_size)
-        .Release();
+  uint32_t queue_idx = CurrentQueueIndex();
+  if (queue_idx == UINT32_MAX) {
+    // Start a new worker for every task until we have enough of them and
+    // spread the tasks from other threads over the workers' queues.
+    if (m_queue_count < m_max_thread_count) {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      const uint32_t queue_count = m_queue_count;
+      if (queue_count < m_max_thread_count) {
+        m_queues[queue_count].reset(new WorkQueue());
+        m_queue_count = queue_count + 1;
+        // Note that this detach call needs to happen with the m_mutex held.
+        // This prevents the thread from exiting prematurely and triggering a
+        // linux libc bug
+        // (https://sourceware.org/bugzilla/show_bug.cgi?id=19951).
+        lldb_private::ThreadLauncher::LaunchThread(
+            "task-pool.worker", WorkerPtr,
+            reinterpret_cast<void *>(static_cast<uintptr_t>(queue_count)),
+            nullptr, min_stack_size)
+            .Release();
+      }
+    }
+    queue_idx = m_next_queue.fetch_add(1) %
+                std::min<uint32_t>(m_queue_count, m_max_thread_count);
+  }
+
+  uint64_t &group = CurrentGroup();
+  if (group == 0)
+    group = m_next_group.fetch_add(1);
+
+  WorkQueue &queue = *m_queues[queue_idx];
+  {
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    queue.tasks.push_back({group, std::move(task_fn)});
+    ++m_pending_count;
+  }
+
+  // Only touch the global mutex when a worker is, or is about to go, asleep.
+  // Workers increment m_idle_count before they check m_pending_count, so
+  // either we see them here or they see our task.
+  if (m_idle_count > 0) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_idle_cond.notify_one();
+  }
+}
+
+bool TaskPoolImpl::PopTask(uint32_t queue_idx,
+                           std::function<void()> &task_fn) {
+  // Run the most recently added task of our own queue first, it is the most
+  // likely one to still have its data in the cache.
+  if (queue_idx < m_queue_count) {
+    WorkQueue &queue = *m_queues[queue_idx];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    if (!queue.tasks.empty()) {
+      task_fn = std::move(queue.tasks.back().fn);
+      queue.tasks.pop_back();
+      --m_pending_count;
+      return true;
+    }
+  }
+  return StealTask(queue_idx == UINT32_MAX ? 0 : queue_idx + 1, task_fn);
+}
+
+bool TaskPoolImpl::StealTask(uint32_t start_idx,
+                             std::function<void()> &task_fn) {
+  // The queue locks are only ever held for a push or a pop, so block on them
+  // instead of skipping busy queues. Skipping them would make an idle worker
+  // spin while m_pending_count says there is work.
+  const uint32_t queue_count = m_queue_count;
+  for (uint32_t i = 0; i < queue_count && m_pending_count > 0; ++i) {
+    WorkQueue &queue = *m_queues[(start_idx + i) % queue_count];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    if (queue.tasks.empty())
+      continue;
+    task_fn = std::move(queue.tasks.front().fn);
+    queue.tasks.pop_front();
+    --m_pending_count;
+    return true;
+  }
+  return false;
+}
+
+void TaskPoolImpl::RunTask(std::function<void()> &task_fn) {
+  // Tasks added by this task form a new group, so that a Wait inside of it
+  // only runs the task's own sub-tasks.
+  uint64_t &group = CurrentGroup();
+  const uint64_t saved_group = group;
+  group = 0;
+  task_fn();
+  task_fn = nullptr;
+  group = saved_group;
+}
+
+bool TaskPoolImpl::RunGroupTask() {
+  const uint64_t group = CurrentGroup();
+  if (group == 0)
+    return false;
+
+  // Only this thread adds tasks to its group and it is busy waiting, so once
+  // none of them are queued any more they are all running or finished.
+  const uint32_t own_idx = CurrentQueueIndex();
+  const uint32_t queue_count = m_queue_count;
+  std::function<void()> task_fn;
+  for (uint32_t i = 0; i < queue_count && m_pending_count > 0 && !task_fn;
+       ++i) {
+    WorkQueue &queue =
+        *m_queues[own_idx < queue_count ? (own_idx + i) % queue_count : i];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    auto pos = std::find_if(
+        queue.tasks.rbegin(), queue.tasks.rend(),
+        [group](const QueuedTask &task) { return task.group == group; });
+    if (pos == queue.tasks.rend())
+      continue;
+    task_fn = std::move(pos->fn);
+    queue.tasks.erase(std::next(pos).base());
+    --m_pending_count;
   }
+  if (!task_fn)
+    return false;
+  RunTask(task_fn);
+  return true;
 }
 
-lldb::thread_result_t TaskPoolImpl::WorkerPtr(void *pool) {
-  Worker((TaskPoolImpl *)pool);
+lldb::thread_result_t TaskPoolImpl::WorkerPtr(void *queue_idx) {
+  GetInstance().Worker(
+      static_cast<uint32_t>(reinterpret_cast<uintptr_t>(queue_idx)));
   return 0;
 }
 
-void TaskPoolImpl::Worker(TaskPoolImpl *pool) {
+void TaskPoolImpl::Worker(uint32_t queue_idx) {
+  CurrentQueueIndex() = queue_idx;
+  std::function<void()> task_fn;
   while (true) {
-    std::unique_lock<std::mutex> lock(pool->m_tasks_mutex);
-    if (pool->m_tasks.empty()) {
-      pool->m_thread_count--;
-      break;
+    if (queue_idx < m_max_thread_count && PopTask(queue_idx, task_fn)) {
+      RunTask(task_fn);
+      continue;
     }
 
-    std::function<void()> f = std::move(pool->m_tasks.front());
-    pool->m_tasks.pop();
-    lock.unlock();
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (queue_idx >= m_max_thread_count) {
+      m_parked_cond.wait(
+          lock, [this, queue_idx] { return queue_idx < m_max_thread_count; });
+      continue;
+    }
 
-    f();
+    // A task may have been added after PopTask looked at its queue, so check
+    // m_pending_count again before going to sleep.
+    ++m_idle_count;
+    m_idle_cond.wait(lock, [this, queue_idx] {
+      return m_pending_count > 0 || queue_idx >= m_max_thread_count;
+    });
+    --m_idle_count;
   }
 }
 
 void TaskMapOverInt(size_t begin, size_t end,
                     const llvm::function_ref<void(size_t)> &func) {
-  const size_t num_workers = std::min<size_t>(end, GetHardwareConcurrencyHint());
+  if (begin >= end)
+    return;
+  const size_t num_workers =
+      std::min<size_t>(end - begin, TaskPool::GetThreadCount());
   std::atomic<size_t> idx{begin};
-  
+
   auto wrapper = [&idx, end, &func]() {
     while (true) {
       size_t i = idx.fetch_add(1);
@@ -109,12 +320,12 @@ void TaskMapOverInt(size_t begin, size_t end,
   };
 
   std::vector<std::future<void>> futures;
-  futures.reserve(num_workers);
-  for (size_t i = 0; i < num_workers; i++)
+  futures.reserve(num_workers - 1);
+  for (size_t i = 1; i < num_workers; i++)
     futures.push_back(TaskPool::AddTask(wrapper));
-  for (size_t i = 0; i < num_workers; i++)
-    futures[i].wait();
+  wrapper();
+  for (std::future<void> &future : futures)
+    TaskPool::Wait(future);
 }
 
 } // namespace lldb_private
-
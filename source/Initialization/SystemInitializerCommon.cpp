@@ -126,4 +126,5 @@ void SystemInitializerCommon::Terminate() {
 
   HostInfo::Terminate();
   Log::DisableAllLogChannels();
+  Log::Terminate();
 }
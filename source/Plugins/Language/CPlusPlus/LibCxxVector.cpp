@@ -33,6 +33,9 @@ public:
 
   lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
 
+  void GetChildrenRange(size_t start, size_t count,
+                        std::vector<lldb::ValueObjectSP> &children) override;
+
   bool Update() override;
 
   bool MightHaveChildren() override;
@@ -121,6 +124,22 @@ lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::GetChildAtIndex(
                                       m_element_type);
 }
 
+void lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::
+    GetChildrenRange(size_t start, size_t count,
+                     std::vector<lldb::ValueObjectSP> &children) {
+  if (!m_start || !m_finish)
+    return;
+  const size_t num_children = CalculateNumChildren();
+  if (start >= num_children)
+    return;
+  count = std::min(count, num_children - start);
+
+  CreateValueObjectsFromArray(
+      start, count, m_start->GetValueAsUnsigned(0) + start * m_element_size,
+      m_element_size, m_backend.GetExecutionContextRef(), m_element_type,
+      children);
+}
+
 bool lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::Update() {
   m_start = m_finish = nullptr;
   ValueObjectSP data_type_finder_sp(
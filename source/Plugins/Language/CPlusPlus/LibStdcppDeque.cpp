@@ -0,0 +1,202 @@
+//===-- LibStdcppDeque.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibStdcpp.h"
+
+#include "lldb/Core/ValueObject.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
+#include "lldb/DataFormatters/TypeSynthetic.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/Utility/Stream.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::formatters;
+
+namespace {
+
+/*
+ (std::deque<int, std::allocator<int> >) d = {
+   _M_impl = {
+     _M_map = 0x0000000000614c20
+     _M_map_size = 8
+     _M_start = {
+       _M_cur = 0x0000000000614c80
+       _M_first = 0x0000000000614c80
+       _M_last = 0x0000000000614e80
+       _M_node = 0x0000000000614c38
+     }
+     _M_finish = {
+       _M_cur = 0x0000000000614c8c
+       _M_first = 0x0000000000614c80
+       _M_last = 0x0000000000614e80
+       _M_node = 0x0000000000614c38
+     }
+   }
+ }
+
+ The elements live in fixed size buffers, and _M_node points to the entry
+ for the iterator's buffer in the map of buffer pointers.
+ */
+class LibStdcppDequeSyntheticFrontEnd : public SyntheticChildrenFrontEnd {
+public:
+  explicit LibStdcppDequeSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp);
+
+  size_t CalculateNumChildren() override { return m_count; }
+
+  lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
+
+  bool Update() override;
+
+  bool MightHaveChildren() override { return true; }
+
+  size_t GetIndexOfChildWithName(const ConstString &name) override;
+
+private:
+  ExecutionContextRef m_exe_ctx_ref;
+  CompilerType m_element_type;
+  uint64_t m_element_size = 0;
+  uint32_t m_ptr_size = 0;
+  // The number of elements in each buffer, as __deque_buf_size computes it.
+  size_t m_buffer_size = 0;
+  // The map entry for the first buffer, and the index of the first element
+  // in that buffer.
+  lldb::addr_t m_start_node = 0;
+  size_t m_start_offset = 0;
+  size_t m_count = 0;
+};
+
+struct DequeIterator {
+  lldb::addr_t cur = 0;
+  lldb::addr_t first = 0;
+  lldb::addr_t last = 0;
+  lldb::addr_t node = 0;
+
+  bool Read(ValueObject &iter) {
+    ValueObjectSP cur_sp(
+        iter.GetChildMemberWithName(ConstString("_M_cur"), true));
+    ValueObjectSP first_sp(
+        iter.GetChildMemberWithName(ConstString("_M_first"), true));
+    ValueObjectSP last_sp(
+        iter.GetChildMemberWithName(ConstString("_M_last"), true));
+    ValueObjectSP node_sp(
+        iter.GetChildMemberWithName(ConstString("_M_node"), true));
+    if (!cur_sp || !first_sp || !last_sp || !node_sp)
+      return false;
+    cur = cur_sp->GetValueAsUnsigned(0);
+    first = first_sp->GetValueAsUnsigned(0);
+    last = last_sp->GetValueAsUnsigned(0);
+    node = node_sp->GetValueAsUnsigned(0);
+    return first != 0 && node != 0 && first <= cur && cur <= last;
+  }
+};
+
+} // end of anonymous namespace
+
+LibStdcppDequeSyntheticFrontEnd::LibStdcppDequeSyntheticFrontEnd(
+    lldb::ValueObjectSP valobj_sp)
+    : SyntheticChildrenFrontEnd(*valobj_sp) {
+  if (valobj_sp)
+    Update();
+}
+
+bool LibStdcppDequeSyntheticFrontEnd::Update() {
+  m_count = 0;
+  m_start_node = 0;
+  m_exe_ctx_ref = m_backend.GetExecutionContextRef();
+
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return false;
+
+  CompilerType deque_type = m_backend.GetCompilerType();
+  if (deque_type.IsReferenceType())
+    deque_type = deque_type.GetNonReferenceType();
+  if (deque_type.GetNumTemplateArguments() == 0)
+    return false;
+  m_element_type = deque_type.GetTypeTemplateArgument(0);
+  m_element_size = m_element_type.GetByteSize(nullptr);
+  if (m_element_size == 0)
+    return false;
+  m_buffer_size = m_element_size < 512 ? 512 / m_element_size : 1;
+  m_ptr_size = process_sp->GetAddressByteSize();
+
+  ValueObjectSP impl_sp(
+      m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+  if (!impl_sp)
+    return false;
+  ValueObjectSP start_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_start"), true));
+  ValueObjectSP finish_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_finish"), true));
+  if (!start_sp || !finish_sp)
+    return false;
+  DequeIterator start, finish;
+  if (!start.Read(*start_sp) || !finish.Read(*finish_sp))
+    return false;
+
+  // Before a deque has been constructed it contains garbage, so be careful
+  // not to come up with a huge number of children.
+  if (finish.node < start.node || (finish.node - start.node) % m_ptr_size ||
+      (start.cur - start.first) % m_element_size ||
+      (finish.cur - finish.first) % m_element_size ||
+      (start.last - start.cur) % m_element_size)
+    return false;
+  const size_t num_nodes = (finish.node - start.node) / m_ptr_size;
+  const size_t finish_count = (finish.cur - finish.first) / m_element_size;
+  const size_t start_count = (start.last - start.cur) / m_element_size;
+  // Both iterators in the same buffer is the common case for small deques.
+  if (num_nodes == 0) {
+    if (finish.cur < start.cur)
+      return false;
+    m_count = (finish.cur - start.cur) / m_element_size;
+  } else {
+    m_count = m_buffer_size * (num_nodes - 1) + finish_count + start_count;
+  }
+
+  m_start_node = start.node;
+  m_start_offset = (start.cur - start.first) / m_element_size;
+  return false;
+}
+
+lldb::ValueObjectSP
+LibStdcppDequeSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
+  if (idx >= m_count || m_start_node == 0)
+    return lldb::ValueObjectSP();
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return lldb::ValueObjectSP();
+
+  const size_t offset = idx + m_start_offset;
+  Status error;
+  lldb::addr_t buffer = process_sp->ReadPointerFromMemory(
+      m_start_node + (offset / m_buffer_size) * m_ptr_size, error);
+  if (error.Fail() || buffer == 0)
+    return lldb::ValueObjectSP();
+
+  StreamString name;
+  name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+  return CreateValueObjectFromAddress(
+      name.GetString(), buffer + (offset % m_buffer_size) * m_element_size,
+      m_exe_ctx_ref, m_element_type);
+}
+
+size_t LibStdcppDequeSyntheticFrontEnd::GetIndexOfChildWithName(
+    const ConstString &name) {
+  return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd *
+lldb_private::formatters::LibStdcppDequeSyntheticFrontEndCreator(
+    CXXSyntheticChildren *, lldb::ValueObjectSP valobj_sp) {
+  return (valobj_sp ? new LibStdcppDequeSyntheticFrontEnd(valobj_sp)
+                    : nullptr);
+}
@@ -0,0 +1,185 @@
+//===-- LibStdcppList.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibStdcpp.h"
+
+#include "lldb/Core/ValueObject.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
+#include "lldb/DataFormatters/TypeSynthetic.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/Utility/Stream.h"
+
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::formatters;
+
+namespace {
+
+/*
+ (std::__cxx11::list<int, std::allocator<int> >) l = {
+   _M_impl = {
+     _M_node = {
+       _M_next = 0x0000000000614c20
+       _M_prev = 0x0000000000614c60
+       _M_size = 3
+     }
+   }
+ }
+
+ The nodes are _List_node_base { _M_next, _M_prev } followed by the
+ element. The list's own _M_node is the sentinel the last node points back
+ to.
+ */
+class LibStdcppListSyntheticFrontEnd : public SyntheticChildrenFrontEnd {
+public:
+  explicit LibStdcppListSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp);
+
+  size_t CalculateNumChildren() override { return m_count; }
+
+  lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
+
+  bool Update() override;
+
+  bool MightHaveChildren() override { return true; }
+
+  size_t GetIndexOfChildWithName(const ConstString &name) override;
+
+private:
+  // Follow the _M_next pointers until the node at "idx" is known.
+  lldb::addr_t GetNodeAtIndex(size_t idx);
+
+  ExecutionContextRef m_exe_ctx_ref;
+  lldb::addr_t m_sentinel = LLDB_INVALID_ADDRESS;
+  size_t m_count = 0;
+  CompilerType m_element_type;
+  uint64_t m_data_offset = 0;
+  // The addresses of the nodes found so far, in list order.
+  std::vector<lldb::addr_t> m_nodes;
+};
+
+} // end of anonymous namespace
+
+LibStdcppListSyntheticFrontEnd::LibStdcppListSyntheticFrontEnd(
+    lldb::ValueObjectSP valobj_sp)
+    : SyntheticChildrenFrontEnd(*valobj_sp) {
+  if (valobj_sp)
+    Update();
+}
+
+bool LibStdcppListSyntheticFrontEnd::Update() {
+  m_sentinel = LLDB_INVALID_ADDRESS;
+  m_count = 0;
+  m_nodes.clear();
+  m_exe_ctx_ref = m_backend.GetExecutionContextRef();
+
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return false;
+
+  CompilerType list_type = m_backend.GetCompilerType();
+  if (list_type.IsReferenceType())
+    list_type = list_type.GetNonReferenceType();
+  if (list_type.GetNumTemplateArguments() == 0)
+    return false;
+  m_element_type = list_type.GetTypeTemplateArgument(0);
+  if (!m_element_type)
+    return false;
+
+  ValueObjectSP impl_sp(
+      m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+  if (!impl_sp)
+    return false;
+  ValueObjectSP node_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_node"), true));
+  if (!node_sp)
+    return false;
+  AddressType address_type;
+  m_sentinel = node_sp->GetAddressOf(true, &address_type);
+  if (m_sentinel == LLDB_INVALID_ADDRESS || address_type != eAddressTypeLoad) {
+    m_sentinel = LLDB_INVALID_ADDRESS;
+    return false;
+  }
+
+  const uint32_t ptr_size = process_sp->GetAddressByteSize();
+  m_data_offset = llvm::alignTo(
+      2 * ptr_size, std::max<size_t>(m_element_type.GetTypeBitAlign() / 8, 1));
+
+  // libstdc++ keeps the size in the sentinel since GCC 5 (as _M_data) and
+  // GCC 7 (as _M_size). Older versions need the list to be walked.
+  ValueObjectSP size_sp(
+      node_sp->GetChildMemberWithName(ConstString("_M_size"), true));
+  if (!size_sp)
+    size_sp = node_sp->GetChildMemberWithName(ConstString("_M_data"), true);
+  if (size_sp) {
+    m_count = size_sp->GetValueAsUnsigned(0);
+    return false;
+  }
+
+  size_t max_count = 0;
+  if (TargetSP target_sp = m_backend.GetTargetSP())
+    max_count = target_sp->GetMaximumNumberOfChildrenToDisplay();
+  if (max_count == 0)
+    max_count = 255;
+  m_count = max_count;
+  size_t count = 0;
+  while (count < max_count && GetNodeAtIndex(count) != LLDB_INVALID_ADDRESS)
+    ++count;
+  m_count = count;
+  return false;
+}
+
+lldb::addr_t LibStdcppListSyntheticFrontEnd::GetNodeAtIndex(size_t idx) {
+  if (idx >= m_count || m_sentinel == LLDB_INVALID_ADDRESS)
+    return LLDB_INVALID_ADDRESS;
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return LLDB_INVALID_ADDRESS;
+
+  while (m_nodes.size() <= idx) {
+    lldb::addr_t prev = m_nodes.empty() ? m_sentinel : m_nodes.back();
+    Status error;
+    lldb::addr_t next = process_sp->ReadPointerFromMemory(prev, error);
+    // A list that is corrupt, or not constructed yet, ends early.
+    if (error.Fail() || next == 0 || next == m_sentinel)
+      return LLDB_INVALID_ADDRESS;
+    m_nodes.push_back(next);
+  }
+  return m_nodes[idx];
+}
+
+lldb::ValueObjectSP
+LibStdcppListSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
+  lldb::addr_t node = GetNodeAtIndex(idx);
+  if (node == LLDB_INVALID_ADDRESS)
+    return lldb::ValueObjectSP();
+
+  StreamString name;
+  name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+  return CreateValueObjectFromAddress(name.GetString(), node + m_data_offset,
+                                      m_exe_ctx_ref, m_element_type);
+}
+
+size_t LibStdcppListSyntheticFrontEnd::GetIndexOfChildWithName(
+    const ConstString &name) {
+  return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd *
+lldb_private::formatters::LibStdcppListSyntheticFrontEndCreator(
+    CXXSyntheticChildren *, lldb::ValueObjectSP valobj_sp) {
+  return (valobj_sp ? new LibStdcppListSyntheticFrontEnd(valobj_sp) : nullptr);
+}
@@ -0,0 +1,235 @@
+//===-- LibStdcppMap.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibStdcpp.h"
+
+#include "lldb/Core/ValueObject.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
+#include "lldb/DataFormatters/TypeSynthetic.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/Utility/Stream.h"
+
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::formatters;
+
+namespace {
+
+/*
+ (std::map<int, int, std::less<int>,
+           std::allocator<std::pair<const int, int> > >) m = {
+   _M_t = {
+     _M_impl = {
+       _M_header = {
+         _M_color = _S_red
+         _M_parent = 0x0000000000614c20
+         _M_left = 0x0000000000614c20
+         _M_right = 0x0000000000614c50
+       }
+       _M_node_count = 2
+     }
+   }
+ }
+
+ The nodes are _Rb_tree_node_base { _M_color, _M_parent, _M_left, _M_right }
+ followed by the value. The leftmost node is the first one, and the header
+ is the parent of the root.
+ */
+class LibStdcppMapSyntheticFrontEnd : public SyntheticChildrenFrontEnd {
+public:
+  explicit LibStdcppMapSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp);
+
+  size_t CalculateNumChildren() override { return m_count; }
+
+  lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
+
+  bool Update() override;
+
+  bool MightHaveChildren() override { return true; }
+
+  size_t GetIndexOfChildWithName(const ConstString &name) override;
+
+private:
+  // Walk the tree in order until the node at "idx" is known.
+  lldb::addr_t GetNodeAtIndex(size_t idx);
+
+  // The in-order successor of "node", as _Rb_tree_increment finds it.
+  lldb::addr_t Increment(Process &process, lldb::addr_t node);
+
+  lldb::addr_t ReadLink(Process &process, lldb::addr_t node, size_t link);
+
+  ExecutionContextRef m_exe_ctx_ref;
+  lldb::addr_t m_header = LLDB_INVALID_ADDRESS;
+  size_t m_count = 0;
+  CompilerType m_value_type;
+  uint32_t m_ptr_size = 0;
+  uint64_t m_data_offset = 0;
+  // The addresses of the nodes found so far, in order.
+  std::vector<lldb::addr_t> m_nodes;
+};
+
+// The positions of the links in a node, in pointer sized units. _M_color,
+// an enum, takes up the first one.
+enum { eLinkParent = 1, eLinkLeft = 2, eLinkRight = 3, eLinkCount = 4 };
+
+} // end of anonymous namespace
+
+LibStdcppMapSyntheticFrontEnd::LibStdcppMapSyntheticFrontEnd(
+    lldb::ValueObjectSP valobj_sp)
+    : SyntheticChildrenFrontEnd(*valobj_sp) {
+  if (valobj_sp)
+    Update();
+}
+
+bool LibStdcppMapSyntheticFrontEnd::Update() {
+  m_header = LLDB_INVALID_ADDRESS;
+  m_count = 0;
+  m_nodes.clear();
+  m_exe_ctx_ref = m_backend.GetExecutionContextRef();
+
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return false;
+
+  ValueObjectSP tree_sp(
+      m_backend.GetChildMemberWithName(ConstString("_M_t"), true));
+  if (!tree_sp)
+    return false;
+
+  // The value type is the second template argument of the _Rb_tree, or that
+  // of the allocator, the last template argument of the container.
+  m_value_type =
+      tree_sp->GetCompilerType().GetCanonicalType().GetTypeTemplateArgument(1);
+  if (!m_value_type) {
+    CompilerType type = m_backend.GetCompilerType();
+    if (type.IsReferenceType())
+      type = type.GetNonReferenceType();
+    const size_t num_args = type.GetNumTemplateArguments();
+    if (num_args > 0)
+      m_value_type = type.GetTypeTemplateArgument(num_args - 1)
+                         .GetTypeTemplateArgument(0);
+  }
+  if (!m_value_type)
+    return false;
+
+  ValueObjectSP impl_sp(
+      tree_sp->GetChildMemberWithName(ConstString("_M_impl"), true));
+  if (!impl_sp)
+    return false;
+  ValueObjectSP header_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_header"), true));
+  ValueObjectSP count_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_node_count"), true));
+  if (!header_sp || !count_sp)
+    return false;
+  AddressType address_type;
+  lldb::addr_t header = header_sp->GetAddressOf(true, &address_type);
+  if (header == LLDB_INVALID_ADDRESS || address_type != eAddressTypeLoad)
+    return false;
+
+  m_ptr_size = process_sp->GetAddressByteSize();
+  m_data_offset = llvm::alignTo(
+      eLinkCount * m_ptr_size,
+      std::max<size_t>(m_value_type.GetTypeBitAlign() / 8, 1));
+
+  // An empty tree has no root.
+  if (ReadLink(*process_sp, header, eLinkParent) == 0)
+    return false;
+  m_header = header;
+  m_count = count_sp->GetValueAsUnsigned(0);
+  return false;
+}
+
+lldb::addr_t LibStdcppMapSyntheticFrontEnd::ReadLink(Process &process,
+                                                     lldb::addr_t node,
+                                                     size_t link) {
+  Status error;
+  lldb::addr_t value =
+      process.ReadPointerFromMemory(node + link * m_ptr_size, error);
+  return error.Success() ? value : 0;
+}
+
+lldb::addr_t LibStdcppMapSyntheticFrontEnd::Increment(Process &process,
+                                                      lldb::addr_t node) {
+  // No path in a tree of m_count nodes is longer than m_count, so taking more
+  // steps than that means the tree is garbage.
+  size_t steps = 0;
+  lldb::addr_t right = ReadLink(process, node, eLinkRight);
+  if (right != 0) {
+    node = right;
+    for (lldb::addr_t left = ReadLink(process, node, eLinkLeft); left != 0;
+         left = ReadLink(process, node, eLinkLeft)) {
+      if (++steps > m_count)
+        return 0;
+      node = left;
+    }
+    return node;
+  }
+
+  lldb::addr_t parent = ReadLink(process, node, eLinkParent);
+  while (parent != 0 && node == ReadLink(process, parent, eLinkRight)) {
+    if (++steps > m_count)
+      return 0;
+    node = parent;
+    parent = ReadLink(process, parent, eLinkParent);
+  }
+  if (parent == 0)
+    return 0;
+  if (ReadLink(process, node, eLinkRight) != parent)
+    node = parent;
+  return node;
+}
+
+lldb::addr_t LibStdcppMapSyntheticFrontEnd::GetNodeAtIndex(size_t idx) {
+  if (idx >= m_count || m_header == LLDB_INVALID_ADDRESS)
+    return LLDB_INVALID_ADDRESS;
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return LLDB_INVALID_ADDRESS;
+
+  while (m_nodes.size() <= idx) {
+    lldb::addr_t next =
+        m_nodes.empty() ? ReadLink(*process_sp, m_header, eLinkLeft)
+                        : Increment(*process_sp, m_nodes.back());
+    if (next == 0 || next == m_header)
+      return LLDB_INVALID_ADDRESS;
+    m_nodes.push_back(next);
+  }
+  return m_nodes[idx];
+}
+
+lldb::ValueObjectSP
+LibStdcppMapSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
+  lldb::addr_t node = GetNodeAtIndex(idx);
+  if (node == LLDB_INVALID_ADDRESS)
+    return lldb::ValueObjectSP();
+
+  StreamString name;
+  name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+  return CreateValueObjectFromAddress(name.GetString(), node + m_data_offset,
+                                      m_exe_ctx_ref, m_value_type);
+}
+
+size_t LibStdcppMapSyntheticFrontEnd::GetIndexOfChildWithName(
+    const ConstString &name) {
+  return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd *
+lldb_private::formatters::LibStdcppMapSyntheticFrontEndCreator(
+    CXXSyntheticChildren *, lldb::ValueObjectSP valobj_sp) {
+  return (valobj_sp ? new LibStdcppMapSyntheticFrontEnd(valobj_sp) : nullptr);
+}
@@ -0,0 +1,178 @@
+//===-- LibStdcppUnorderedMap.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibStdcpp.h"
+
+#include "lldb/Core/ValueObject.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
+#include "lldb/DataFormatters/TypeSynthetic.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/Utility/Stream.h"
+
+#include "llvm/Support/MathExtras.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::formatters;
+
+namespace {
+
+/*
+ (std::unordered_map<int, int, ...>) um = {
+   _M_h = {
+     _M_buckets = 0x0000000000614c20
+     _M_bucket_count = 13
+     _M_before_begin = {
+       _M_nxt = 0x0000000000614c90
+     }
+     _M_element_count = 2
+     ...
+   }
+ }
+
+ All the elements are in a single list that starts at _M_before_begin. The
+ nodes are _Hash_node_base { _M_nxt } followed by the value, and possibly by
+ the cached hash code.
+ */
+class LibStdcppUnorderedMapSyntheticFrontEnd
+    : public SyntheticChildrenFrontEnd {
+public:
+  explicit LibStdcppUnorderedMapSyntheticFrontEnd(
+      lldb::ValueObjectSP valobj_sp);
+
+  size_t CalculateNumChildren() override { return m_count; }
+
+  lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
+
+  bool Update() override;
+
+  bool MightHaveChildren() override { return true; }
+
+  size_t GetIndexOfChildWithName(const ConstString &name) override;
+
+private:
+  // Follow the _M_nxt pointers until the node at "idx" is known.
+  lldb::addr_t GetNodeAtIndex(size_t idx);
+
+  ExecutionContextRef m_exe_ctx_ref;
+  lldb::addr_t m_before_begin = LLDB_INVALID_ADDRESS;
+  size_t m_count = 0;
+  CompilerType m_value_type;
+  uint64_t m_data_offset = 0;
+  // The addresses of the nodes found so far, in iteration order.
+  std::vector<lldb::addr_t> m_nodes;
+};
+
+} // end of anonymous namespace
+
+LibStdcppUnorderedMapSyntheticFrontEnd::LibStdcppUnorderedMapSyntheticFrontEnd(
+    lldb::ValueObjectSP valobj_sp)
+    : SyntheticChildrenFrontEnd(*valobj_sp) {
+  if (valobj_sp)
+    Update();
+}
+
+bool LibStdcppUnorderedMapSyntheticFrontEnd::Update() {
+  m_before_begin = LLDB_INVALID_ADDRESS;
+  m_count = 0;
+  m_nodes.clear();
+  m_exe_ctx_ref = m_backend.GetExecutionContextRef();
+
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return false;
+
+  ValueObjectSP table_sp(
+      m_backend.GetChildMemberWithName(ConstString("_M_h"), true));
+  if (!table_sp)
+    return false;
+
+  // The value type is the second template argument of the _Hashtable, or
+  // that of the allocator, the last template argument of the container.
+  m_value_type =
+      table_sp->GetCompilerType().GetCanonicalType().GetTypeTemplateArgument(1);
+  if (!m_value_type) {
+    CompilerType type = m_backend.GetCompilerType();
+    if (type.IsReferenceType())
+      type = type.GetNonReferenceType();
+    const size_t num_args = type.GetNumTemplateArguments();
+    if (num_args > 0)
+      m_value_type = type.GetTypeTemplateArgument(num_args - 1)
+                         .GetTypeTemplateArgument(0);
+  }
+  if (!m_value_type)
+    return false;
+
+  ValueObjectSP before_begin_sp(
+      table_sp->GetChildMemberWithName(ConstString("_M_before_begin"), true));
+  ValueObjectSP count_sp(
+      table_sp->GetChildMemberWithName(ConstString("_M_element_count"), true));
+  if (!before_begin_sp || !count_sp)
+    return false;
+  AddressType address_type;
+  lldb::addr_t before_begin =
+      before_begin_sp->GetAddressOf(true, &address_type);
+  if (before_begin == LLDB_INVALID_ADDRESS || address_type != eAddressTypeLoad)
+    return false;
+
+  m_data_offset = llvm::alignTo(
+      process_sp->GetAddressByteSize(),
+      std::max<size_t>(m_value_type.GetTypeBitAlign() / 8, 1));
+  m_before_begin = before_begin;
+  m_count = count_sp->GetValueAsUnsigned(0);
+  return false;
+}
+
+lldb::addr_t
+LibStdcppUnorderedMapSyntheticFrontEnd::GetNodeAtIndex(size_t idx) {
+  if (idx >= m_count || m_before_begin == LLDB_INVALID_ADDRESS)
+    return LLDB_INVALID_ADDRESS;
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return LLDB_INVALID_ADDRESS;
+
+  while (m_nodes.size() <= idx) {
+    lldb::addr_t prev = m_nodes.empty() ? m_before_begin : m_nodes.back();
+    Status error;
+    lldb::addr_t next = process_sp->ReadPointerFromMemory(prev, error);
+    if (error.Fail() || next == 0)
+      return LLDB_INVALID_ADDRESS;
+    m_nodes.push_back(next);
+  }
+  return m_nodes[idx];
+}
+
+lldb::ValueObjectSP
+LibStdcppUnorderedMapSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
+  lldb::addr_t node = GetNodeAtIndex(idx);
+  if (node == LLDB_INVALID_ADDRESS)
+    return lldb::ValueObjectSP();
+
+  StreamString name;
+  name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+  return CreateValueObjectFromAddress(name.GetString(), node + m_data_offset,
+                                      m_exe_ctx_ref, m_value_type);
+}
+
+size_t LibStdcppUnorderedMapSyntheticFrontEnd::GetIndexOfChildWithName(
+    const ConstString &name) {
+  return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd *
+lldb_private::formatters::LibStdcppUnorderedMapSyntheticFrontEndCreator(
+    CXXSyntheticChildren *, lldb::ValueObjectSP valobj_sp) {
+  return (valobj_sp ? new LibStdcppUnorderedMapSyntheticFrontEnd(valobj_sp)
+                    : nullptr);
+}
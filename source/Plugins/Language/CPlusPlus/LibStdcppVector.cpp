@@ -0,0 +1,270 @@
+//===-- LibStdcppVector.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibStdcpp.h"
+
+#include "lldb/Core/ValueObject.h"
+#include "lldb/DataFormatters/FormattersHelpers.h"
+#include "lldb/DataFormatters/TypeSynthetic.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataBufferHeap.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Status.h"
+#include "lldb/Utility/Stream.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::formatters;
+
+namespace {
+
+/*
+ (std::vector<int, std::allocator<int> >) v = {
+   _M_impl = {
+     _M_start = 0x0000000000614c20
+     _M_finish = 0x0000000000614c2c
+     _M_end_of_storage = 0x0000000000614c2c
+   }
+ }
+ */
+class LibStdcppVectorSyntheticFrontEnd : public SyntheticChildrenFrontEnd {
+public:
+  explicit LibStdcppVectorSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp);
+
+  size_t CalculateNumChildren() override;
+
+  lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
+
+  void GetChildrenRange(size_t start, size_t count,
+                        std::vector<lldb::ValueObjectSP> &children) override;
+
+  bool Update() override;
+
+  bool MightHaveChildren() override { return true; }
+
+  size_t GetIndexOfChildWithName(const ConstString &name) override;
+
+private:
+  lldb::addr_t m_start = 0;
+  size_t m_count = 0;
+  CompilerType m_element_type;
+  uint64_t m_element_size = 0;
+};
+
+/*
+ (std::vector<bool, std::allocator<bool> >) vb = {
+   _M_impl = {
+     _M_start = (_M_p = 0x0000000000614c20, _M_offset = 0)
+     _M_finish = (_M_p = 0x0000000000614c20, _M_offset = 5)
+     _M_end_of_storage = 0x0000000000614c28
+   }
+ }
+ */
+class LibStdcppVectorBoolSyntheticFrontEnd : public SyntheticChildrenFrontEnd {
+public:
+  explicit LibStdcppVectorBoolSyntheticFrontEnd(lldb::ValueObjectSP valobj_sp);
+
+  size_t CalculateNumChildren() override { return m_count; }
+
+  lldb::ValueObjectSP GetChildAtIndex(size_t idx) override;
+
+  bool Update() override;
+
+  bool MightHaveChildren() override { return true; }
+
+  size_t GetIndexOfChildWithName(const ConstString &name) override;
+
+private:
+  CompilerType m_bool_type;
+  ExecutionContextRef m_exe_ctx_ref;
+  lldb::addr_t m_start = 0;
+  size_t m_count = 0;
+  // The size of the words (_Bit_type) the bits are stored in.
+  uint32_t m_word_size = 0;
+};
+
+} // end of anonymous namespace
+
+LibStdcppVectorSyntheticFrontEnd::LibStdcppVectorSyntheticFrontEnd(
+    lldb::ValueObjectSP valobj_sp)
+    : SyntheticChildrenFrontEnd(*valobj_sp) {
+  if (valobj_sp)
+    Update();
+}
+
+bool LibStdcppVectorSyntheticFrontEnd::Update() {
+  m_start = 0;
+  m_count = 0;
+
+  ValueObjectSP impl_sp(
+      m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+  if (!impl_sp)
+    return false;
+  ValueObjectSP start_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_start"), true));
+  ValueObjectSP finish_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_finish"), true));
+  ValueObjectSP end_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_end_of_storage"), true));
+  if (!start_sp || !finish_sp || !end_sp)
+    return false;
+
+  m_element_type = start_sp->GetCompilerType().GetPointeeType();
+  m_element_size = m_element_type.GetByteSize(nullptr);
+  if (m_element_size == 0)
+    return false;
+
+  // Before a vector has been constructed it contains garbage, so be careful
+  // not to come up with a huge number of children.
+  lldb::addr_t start = start_sp->GetValueAsUnsigned(0);
+  lldb::addr_t finish = finish_sp->GetValueAsUnsigned(0);
+  lldb::addr_t end = end_sp->GetValueAsUnsigned(0);
+  if (start == 0 || start >= finish || finish > end ||
+      (finish - start) % m_element_size)
+    return false;
+
+  m_start = start;
+  m_count = (finish - start) / m_element_size;
+  return false;
+}
+
+size_t LibStdcppVectorSyntheticFrontEnd::CalculateNumChildren() {
+  return m_count;
+}
+
+lldb::ValueObjectSP
+LibStdcppVectorSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
+  if (idx >= m_count)
+    return lldb::ValueObjectSP();
+
+  StreamString name;
+  name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+  return CreateValueObjectFromAddress(name.GetString(),
+                                      m_start + idx * m_element_size,
+                                      m_backend.GetExecutionContextRef(),
+                                      m_element_type);
+}
+
+void LibStdcppVectorSyntheticFrontEnd::GetChildrenRange(
+    size_t start, size_t count, std::vector<lldb::ValueObjectSP> &children) {
+  if (start >= m_count)
+    return;
+  count = std::min(count, m_count - start);
+  CreateValueObjectsFromArray(start, count, m_start + start * m_element_size,
+                              m_element_size,
+                              m_backend.GetExecutionContextRef(),
+                              m_element_type, children);
+}
+
+size_t LibStdcppVectorSyntheticFrontEnd::GetIndexOfChildWithName(
+    const ConstString &name) {
+  return ExtractIndexFromString(name.GetCString());
+}
+
+LibStdcppVectorBoolSyntheticFrontEnd::LibStdcppVectorBoolSyntheticFrontEnd(
+    lldb::ValueObjectSP valobj_sp)
+    : SyntheticChildrenFrontEnd(*valobj_sp) {
+  if (valobj_sp) {
+    m_bool_type =
+        valobj_sp->GetCompilerType().GetBasicTypeFromAST(lldb::eBasicTypeBool);
+    Update();
+  }
+}
+
+bool LibStdcppVectorBoolSyntheticFrontEnd::Update() {
+  m_start = 0;
+  m_count = 0;
+  m_exe_ctx_ref = m_backend.GetExecutionContextRef();
+
+  ValueObjectSP impl_sp(
+      m_backend.GetChildMemberWithName(ConstString("_M_impl"), true));
+  if (!impl_sp)
+    return false;
+  ValueObjectSP start_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_start"), true));
+  ValueObjectSP finish_sp(
+      impl_sp->GetChildMemberWithName(ConstString("_M_finish"), true));
+  if (!start_sp || !finish_sp)
+    return false;
+  ValueObjectSP start_p_sp(
+      start_sp->GetChildMemberWithName(ConstString("_M_p"), true));
+  ValueObjectSP finish_p_sp(
+      finish_sp->GetChildMemberWithName(ConstString("_M_p"), true));
+  ValueObjectSP finish_offset_sp(
+      finish_sp->GetChildMemberWithName(ConstString("_M_offset"), true));
+  if (!start_p_sp || !finish_p_sp || !finish_offset_sp)
+    return false;
+
+  m_word_size =
+      start_p_sp->GetCompilerType().GetPointeeType().GetByteSize(nullptr);
+  if (m_word_size == 0 || m_word_size > sizeof(uint64_t))
+    return false;
+
+  lldb::addr_t start = start_p_sp->GetValueAsUnsigned(0);
+  lldb::addr_t finish = finish_p_sp->GetValueAsUnsigned(0);
+  uint64_t finish_offset = finish_offset_sp->GetValueAsUnsigned(0);
+  if (start == 0 || finish < start || (finish - start) % m_word_size ||
+      finish_offset >= m_word_size * 8)
+    return false;
+
+  m_start = start;
+  m_count = (finish - start) * 8 + finish_offset;
+  return false;
+}
+
+lldb::ValueObjectSP
+LibStdcppVectorBoolSyntheticFrontEnd::GetChildAtIndex(size_t idx) {
+  if (idx >= m_count || !m_bool_type)
+    return ValueObjectSP();
+  ProcessSP process_sp(m_exe_ctx_ref.GetProcessSP());
+  if (!process_sp)
+    return ValueObjectSP();
+
+  const size_t word_bits = m_word_size * 8;
+  Status error;
+  uint64_t word = process_sp->ReadUnsignedIntegerFromMemory(
+      m_start + (idx / word_bits) * m_word_size, m_word_size, 0, error);
+  if (error.Fail())
+    return ValueObjectSP();
+  bool bit_set = (word >> (idx % word_bits)) & 1;
+
+  DataBufferSP buffer_sp(
+      new DataBufferHeap(m_bool_type.GetByteSize(nullptr), 0));
+  if (bit_set && buffer_sp->GetByteSize())
+    // regardless of endianness, anything non-zero is true
+    *(buffer_sp->GetBytes()) = 1;
+  StreamString name;
+  name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+  return CreateValueObjectFromData(
+      name.GetString(),
+      DataExtractor(buffer_sp, process_sp->GetByteOrder(),
+                    process_sp->GetAddressByteSize()),
+      m_exe_ctx_ref, m_bool_type);
+}
+
+size_t LibStdcppVectorBoolSyntheticFrontEnd::GetIndexOfChildWithName(
+    const ConstString &name) {
+  return ExtractIndexFromString(name.GetCString());
+}
+
+SyntheticChildrenFrontEnd *
+lldb_private::formatters::LibStdcppVectorSyntheticFrontEndCreator(
+    CXXSyntheticChildren *, lldb::ValueObjectSP valobj_sp) {
+  if (!valobj_sp)
+    return nullptr;
+  CompilerType type = valobj_sp->GetCompilerType();
+  if (type.IsReferenceType())
+    type = type.GetNonReferenceType();
+  if (!type.IsValid() || type.GetNumTemplateArguments() == 0)
+    return nullptr;
+  if (type.GetTypeTemplateArgument(0).GetTypeName() == ConstString("bool"))
+    return new LibStdcppVectorBoolSyntheticFrontEnd(valobj_sp);
+  return new LibStdcppVectorSyntheticFrontEnd(valobj_sp);
+}
@@ -339,6 +339,16 @@ uint64_t PlatformPOSIX::ReadFile(lldb::user_id_t fd, uint64_t offset, void *dst,
     return Platform::ReadFile(fd, offset, dst, dst_len, error);
 }
 
+uint64_t PlatformPOSIX::ReadFileRange(
+    lldb::user_id_t fd, uint64_t offset, uint64_t size,
+    llvm::function_ref<bool(llvm::ArrayRef<uint8_t>)> callback,
+    Status &error) {
+  if (!IsHost() && m_remote_platform_sp)
+    return m_remote_platform_sp->ReadFileRange(fd, offset, size, callback,
+                                               error);
+  return Platform::ReadFileRange(fd, offset, size, callback, error);
+}
+
 uint64_t PlatformPOSIX::WriteFile(lldb::user_id_t fd, uint64_t offset,
                                   const void *src, uint64_t src_len,
                                   Status &error) {
@@ -552,25 +562,21 @@ lldb_private::Status PlatformPOSIX::GetFile(
     }
 
     if (error.Success()) {
-      lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024, 0));
       uint64_t offset = 0;
-      error.Clear();
-      while (error.Success()) {
-        const uint64_t n_read = ReadFile(fd_src, offset, buffer_sp->GetBytes(),
-                                         buffer_sp->GetByteSize(), error);
-        if (error.Fail())
-          break;
-        if (n_read == 0)
-          break;
-        if (FileCache::GetInstance().WriteFile(fd_dst, offset,
-                                               buffer_sp->GetBytes(), n_read,
-                                               error) != n_read) {
-          if (!error.Fail())
-            error.SetErrorString("unable to write to destination file");
-          break;
-        }
-        offset += n_read;
-      }
+      ReadFileRange(fd_src, 0, UINT64_MAX,
+                    [&](llvm::ArrayRef<uint8_t> data) {
+                      if (FileCache::GetInstance().WriteFile(
+                              fd_dst, offset, data.data(), data.size(),
+                              error) != data.size()) {
+                        if (!error.Fail())
+                          error.SetErrorString(
+                              "unable to write to destination file");
+                        return false;
+                      }
+                      offset += data.size();
+                      return true;
+                    },
+                    error);
     }
     // Ignore the close error of src.
     if (fd_src != UINT64_MAX)
@@ -57,6 +57,11 @@ public:
   uint64_t ReadFile(lldb::user_id_t fd, uint64_t offset, void *dst,
                     uint64_t dst_len, lldb_private::Status &error) override;
 
+  uint64_t
+  ReadFileRange(lldb::user_id_t fd, uint64_t offset, uint64_t size,
+                llvm::function_ref<bool(llvm::ArrayRef<uint8_t>)> callback,
+                lldb_private::Status &error) override;
+
   uint64_t WriteFile(lldb::user_id_t fd, uint64_t offset, const void *src,
                      uint64_t src_len, lldb_private::Status &error) override;
 
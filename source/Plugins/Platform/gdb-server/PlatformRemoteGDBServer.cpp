@@ -674,6 +674,16 @@ uint64_t PlatformRemoteGDBServer::ReadFile(lldb::user_id_t fd, uint64_t offset,
   return m_gdb_client.ReadFile(fd, offset, dst, dst_len, error);
 }
 
+uint64_t PlatformRemoteGDBServer::ReadFileRange(
+    lldb::user_id_t fd, uint64_t offset, uint64_t size,
+    llvm::function_ref<bool(llvm::ArrayRef<uint8_t>)> callback,
+    Status &error) {
+  const PlatformPropertiesSP &properties = GetGlobalPlatformProperties();
+  return m_gdb_client.ReadFileRange(
+      fd, offset, size, properties->GetFileTransferChunkSize(),
+      properties->GetFileTransferWindow(), callback, error);
+}
+
 uint64_t PlatformRemoteGDBServer::WriteFile(lldb::user_id_t fd, uint64_t offset,
                                             const void *src, uint64_t src_len,
                                             Status &error) {
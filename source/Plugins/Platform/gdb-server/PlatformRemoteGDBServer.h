@@ -132,6 +132,11 @@ public:
   uint64_t ReadFile(lldb::user_id_t fd, uint64_t offset, void *data_ptr,
                     uint64_t len, Status &error) override;
 
+  uint64_t
+  ReadFileRange(lldb::user_id_t fd, uint64_t offset, uint64_t size,
+                llvm::function_ref<bool(llvm::ArrayRef<uint8_t>)> callback,
+                Status &error) override;
+
   uint64_t WriteFile(lldb::user_id_t fd, uint64_t offset, const void *data,
                      uint64_t len, Status &error) override;
 
@@ -0,0 +1,482 @@
+//===-- DisplacedStepping.cpp --------------------------------- -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DisplacedStepping.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace process_linux;
+
+static llvm::Error MakeError(const char *message) {
+  return llvm::make_error<llvm::StringError>(message,
+                                             llvm::inconvertibleErrorCode());
+}
+
+llvm::Expected<DisplacedInstruction>
+DisplacedInstruction::DecodeX86_64(llvm::ArrayRef<uint8_t> bytes, addr_t from,
+                                   addr_t to) {
+  if (bytes.size() > kMaxInstructionSize)
+    bytes = bytes.take_front(kMaxInstructionSize);
+  const size_t size = bytes.size();
+  size_t pos = 0;
+
+  // Legacy prefixes, in any order.
+  bool operand_size_prefix = false;
+  bool address_size_prefix = false;
+  for (; pos < size; ++pos) {
+    const uint8_t prefix = bytes[pos];
+    if (prefix == 0x66)
+      operand_size_prefix = true;
+    else if (prefix == 0x67)
+      address_size_prefix = true;
+    else if (prefix != 0xf0 && prefix != 0xf2 && prefix != 0xf3 &&
+             prefix != 0x26 && prefix != 0x2e && prefix != 0x36 &&
+             prefix != 0x3e && prefix != 0x64 && prefix != 0x65)
+      break;
+  }
+
+  // A REX prefix has to come right before the opcode.
+  uint8_t rex = 0;
+  if (pos < size && (bytes[pos] & 0xf0) == 0x40)
+    rex = bytes[pos++];
+  const bool rex_w = (rex & 0x08) != 0;
+
+  if (pos >= size)
+    return MakeError("truncated instruction");
+
+  // Immediates of "z" size are 16 bits with an operand size prefix and 32
+  // bits otherwise, even with REX.W.
+  const size_t imm_z = operand_size_prefix ? 2 : 4;
+  bool has_modrm = false;
+  size_t imm_size = 0;
+  bool is_relative_branch = false;
+  bool is_call = false;
+  // Opcodes whose immediate or meaning depends on the reg field of ModRM.
+  enum { eGroupNone, eGroupTest8, eGroupTestZ, eGroupFF, eGroupC7 } group =
+      eGroupNone;
+
+  const uint8_t opcode = bytes[pos++];
+  if (opcode == 0x0f) {
+    if (pos >= size)
+      return MakeError("truncated instruction");
+    const uint8_t opcode2 = bytes[pos++];
+    switch (opcode2) {
+    case 0x38: // three byte opcodes
+    case 0x3a:
+      if (pos >= size)
+        return MakeError("truncated instruction");
+      ++pos;
+      has_modrm = true;
+      imm_size = opcode2 == 0x3a ? 1 : 0;
+      break;
+
+    case 0x05: // syscall
+    case 0x07: // sysret
+    case 0x0b: // ud2
+    case 0x0f: // 3DNow!
+    case 0x20: // mov from/to control and debug registers
+    case 0x21:
+    case 0x22:
+    case 0x23:
+    case 0x34: // sysenter
+    case 0x35: // sysexit
+    case 0x37: // getsec
+    case 0xaa: // rsm
+    case 0xb9: // ud1
+    case 0xff: // ud0
+      return MakeError("instruction can't be executed out of line");
+
+    case 0x06: // clts
+    case 0x08: // invd
+    case 0x09: // wbinvd
+    case 0x0e: // femms
+    case 0x30: // wrmsr
+    case 0x31: // rdtsc
+    case 0x32: // rdmsr
+    case 0x33: // rdpmc
+    case 0x77: // emms
+    case 0xa0: // push fs
+    case 0xa1: // pop fs
+    case 0xa2: // cpuid
+    case 0xa8: // push gs
+    case 0xa9: // pop gs
+      break;
+
+    case 0x70: // pshuf*, shift by immediate
+    case 0x71:
+    case 0x72:
+    case 0x73:
+    case 0xa4: // shld
+    case 0xac: // shrd
+    case 0xba: // bt* with immediate
+    case 0xc2: // cmp*ps
+    case 0xc4: // pinsrw
+    case 0xc5: // pextrw
+    case 0xc6: // shufps
+      has_modrm = true;
+      imm_size = 1;
+      break;
+
+    default:
+      if (opcode2 >= 0x80 && opcode2 <= 0x8f) { // jcc rel32
+        imm_size = 4;
+        is_relative_branch = true;
+      } else if (opcode2 >= 0xc8 && opcode2 <= 0xcf) { // bswap
+        break;
+      } else if ((opcode2 >= 0x24 && opcode2 <= 0x27) || opcode2 == 0x04 ||
+                 opcode2 == 0x0a || opcode2 == 0x0c || opcode2 == 0x36 ||
+                 opcode2 == 0x39 || (opcode2 >= 0x3b && opcode2 <= 0x3f)) {
+        return MakeError("invalid opcode");
+      } else {
+        has_modrm = true;
+      }
+      break;
+    }
+  } else if (opcode < 0x40) {
+    // The classic ALU operations; the remaining opcodes in this range are
+    // prefixes or invalid in 64-bit mode.
+    switch (opcode & 0x07) {
+    case 0:
+    case 1:
+    case 2:
+    case 3:
+      has_modrm = true;
+      break;
+    case 4:
+      imm_size = 1;
+      break;
+    case 5:
+      imm_size = imm_z;
+      break;
+    default:
+      return MakeError("invalid opcode");
+    }
+  } else {
+    switch (opcode) {
+    case 0x63: // movsxd
+    case 0x84: // test
+    case 0x85:
+    case 0x86: // xchg
+    case 0x87:
+    case 0x88: // mov
+    case 0x89:
+    case 0x8a:
+    case 0x8b:
+    case 0x8c:
+    case 0x8d: // lea
+    case 0x8e:
+    case 0x8f: // pop
+    case 0xd0: // shifts
+    case 0xd1:
+    case 0xd2:
+    case 0xd3:
+    case 0xd8: // x87
+    case 0xd9:
+    case 0xda:
+    case 0xdb:
+    case 0xdc:
+    case 0xdd:
+    case 0xde:
+    case 0xdf:
+    case 0xfe: // inc, dec
+      has_modrm = true;
+      break;
+
+    case 0x69: // imul
+    case 0x81:
+      has_modrm = true;
+      imm_size = imm_z;
+      break;
+
+    case 0x6b: // imul
+    case 0x80:
+    case 0x83:
+    case 0xc0: // shifts
+    case 0xc1:
+    case 0xc6: // mov
+      has_modrm = true;
+      imm_size = 1;
+      break;
+
+    case 0x68: // push
+    case 0xa9: // test
+      imm_size = imm_z;
+      break;
+
+    case 0x6a: // push
+    case 0xa8: // test
+    case 0xe4: // in, out
+    case 0xe5:
+    case 0xe6:
+    case 0xe7:
+      imm_size = 1;
+      break;
+
+    case 0xa0: // mov with an absolute address
+    case 0xa1:
+    case 0xa2:
+    case 0xa3:
+      imm_size = address_size_prefix ? 4 : 8;
+      break;
+
+    case 0xc2: // ret imm16
+      imm_size = 2;
+      break;
+
+    case 0xc8: // enter
+      imm_size = 3;
+      break;
+
+    case 0xe0: // loopne, loope, loop, jrcxz
+    case 0xe1:
+    case 0xe2:
+    case 0xe3:
+    case 0xeb: // jmp rel8
+      imm_size = 1;
+      is_relative_branch = true;
+      break;
+
+    case 0xe8: // call rel32
+      is_call = true;
+      LLVM_FALLTHROUGH;
+    case 0xe9: // jmp rel32
+      imm_size = 4;
+      is_relative_branch = true;
+      break;
+
+    case 0xc7: // mov, xbegin
+      has_modrm = true;
+      imm_size = imm_z;
+      group = eGroupC7;
+      break;
+
+    case 0xf6: // test, not, neg, mul, div
+      has_modrm = true;
+      group = eGroupTest8;
+      break;
+
+    case 0xf7:
+      has_modrm = true;
+      group = eGroupTestZ;
+      break;
+
+    case 0xff: // inc, dec, call, jmp, push
+      has_modrm = true;
+      group = eGroupFF;
+      break;
+
+    case 0x9c: // pushf pushes the trap flag we step with
+    case 0xc4: // VEX
+    case 0xc5:
+    case 0x62: // EVEX
+    case 0xca: // far return
+    case 0xcb:
+    case 0xcc: // int3
+    case 0xcd: // int
+    case 0xcf: // iret
+    case 0xf1: // int1
+    case 0xf4: // hlt
+      return MakeError("instruction can't be executed out of line");
+
+    default:
+      if ((opcode >= 0x50 && opcode <= 0x5f) || // push, pop
+          (opcode >= 0x6c && opcode <= 0x6f) || // ins, outs
+          (opcode >= 0x90 && opcode <= 0x9f && opcode != 0x9a) ||
+          (opcode >= 0xa4 && opcode <= 0xaf) || // string instructions
+          opcode == 0xc3 || opcode == 0xc9 || opcode == 0xd7 ||
+          (opcode >= 0xec && opcode <= 0xef) || opcode == 0xf5 ||
+          (opcode >= 0xf8 && opcode <= 0xfd)) {
+        break;
+      } else if (opcode >= 0x70 && opcode <= 0x7f) { // jcc rel8
+        imm_size = 1;
+        is_relative_branch = true;
+      } else if (opcode >= 0xb0 && opcode <= 0xb7) { // mov reg8, imm8
+        imm_size = 1;
+      } else if (opcode >= 0xb8 && opcode <= 0xbf) { // mov reg, imm
+        imm_size = rex_w ? 8 : imm_z;
+      } else {
+        return MakeError("invalid opcode");
+      }
+      break;
+    }
+  }
+
+  // The operand size prefix truncates the target of near branches on some
+  // processors and not on others.
+  if (is_relative_branch && operand_size_prefix)
+    return MakeError("branch with an operand size prefix");
+
+  size_t disp_offset = 0;
+  size_t disp_size = 0;
+  bool is_rip_relative = false;
+  if (has_modrm) {
+    if (pos >= size)
+      return MakeError("truncated instruction");
+    const uint8_t modrm = bytes[pos++];
+    const uint8_t mod = modrm >> 6;
+    const uint8_t reg = (modrm >> 3) & 0x07;
+    const uint8_t rm = modrm & 0x07;
+    if (mod != 3) {
+      if (rm == 4) {
+        if (pos >= size)
+          return MakeError("truncated instruction");
+        const uint8_t sib = bytes[pos++];
+        if (mod == 0 && (sib & 0x07) == 5)
+          disp_size = 4;
+      } else if (mod == 0 && rm == 5) {
+        is_rip_relative = true;
+        disp_size = 4;
+      }
+      if (mod == 1)
+        disp_size = 1;
+      else if (mod == 2)
+        disp_size = 4;
+    }
+    disp_offset = pos;
+    pos += disp_size;
+
+    switch (group) {
+    case eGroupNone:
+      break;
+    case eGroupTest8:
+      imm_size = reg < 2 ? 1 : 0;
+      break;
+    case eGroupTestZ:
+      imm_size = reg < 2 ? imm_z : 0;
+      break;
+    case eGroupFF:
+      if (reg == 3 || reg == 5)
+        return MakeError("far transfers can't be executed out of line");
+      if (reg == 7)
+        return MakeError("invalid opcode");
+      is_call = reg == 2;
+      break;
+    case eGroupC7:
+      if (modrm == 0xf8)
+        return MakeError("transactions can't be executed out of line");
+      break;
+    }
+  }
+
+  pos += imm_size;
+  if (pos > size)
+    return MakeError("truncated instruction");
+
+  DisplacedInstruction insn;
+  insn.m_bytes.assign(bytes.begin(), bytes.begin() + pos);
+  insn.m_from = from;
+  insn.m_to = to;
+  insn.m_is_relative_branch = is_relative_branch;
+  insn.m_is_call = is_call;
+
+  if (is_rip_relative) {
+    if (address_size_prefix)
+      return MakeError("eip relative addressing");
+    // Keep pointing at the same memory from the new address.
+    int32_t disp = 0;
+    for (size_t i = 0; i < 4; ++i)
+      disp |= (int32_t)((uint32_t)bytes[disp_offset + i] << (8 * i));
+    const int64_t new_disp = (int64_t)disp + (int64_t)(from - to);
+    if (new_disp < INT32_MIN || new_disp > INT32_MAX)
+      return MakeError("rip relative operand out of reach of the scratch "
+                       "area");
+    for (size_t i = 0; i < 4; ++i)
+      insn.m_bytes[disp_offset + i] = (uint8_t)((uint64_t)new_disp >> (8 * i));
+  }
+
+  return std::move(insn);
+}
+
+llvm::Expected<DisplacedInstruction>
+DisplacedInstruction::DecodePPC64LE(llvm::ArrayRef<uint8_t> bytes,
+                                    addr_t from, addr_t to) {
+  if (bytes.size() < 4)
+    return MakeError("truncated instruction");
+  const uint32_t word = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+                        ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+  const uint32_t opcode = word >> 26;
+  // The extended opcode of X and XL form instructions.
+  const uint32_t xo = (word >> 1) & 0x3ff;
+  const bool aa = (word & 2) != 0;
+  const bool lk = (word & 1) != 0;
+
+  bool is_relative_branch = false;
+  bool sets_link_register = false;
+  switch (opcode) {
+  case 1:
+    return MakeError("prefixed instructions can't be executed out of line");
+  case 2:  // tdi
+  case 3:  // twi
+    return MakeError("traps can't be executed out of line");
+  case 17: // sc, scv
+    return MakeError("system calls can't be executed out of line");
+  case 16: // bc
+  case 18: // b
+    // Relative branches land at the same distance from the copy, and
+    // FixupPC() moves them back. Absolute ones need nothing.
+    is_relative_branch = !aa;
+    sets_link_register = lk;
+    break;
+  case 19:
+    // addpcis is DX form, with a 5-bit extended opcode.
+    if (((word >> 1) & 0x1f) == 2)
+      return MakeError("addpcis can't be executed out of line");
+    switch (xo) {
+    case 16:  // bclr
+    case 528: // bcctr
+    case 560: // bctar
+      // The target comes from a register.
+      sets_link_register = lk;
+      break;
+    case 18:  // rfid
+    case 274: // hrfid
+      return MakeError("interrupt returns can't be executed out of line");
+    }
+    break;
+  case 31:
+    switch (xo) {
+    case 4:  // tw
+    case 68: // td
+      return MakeError("traps can't be executed out of line");
+    case 20:  // lwarx
+    case 52:  // lbarx
+    case 84:  // ldarx
+    case 116: // lharx
+    case 276: // lqarx
+    case 150: // stwcx.
+    case 182: // stqcx.
+    case 214: // stdcx.
+    case 694: // stbcx.
+    case 726: // sthcx.
+      // A single step loses the reservation.
+      return MakeError("atomic sequences can't be executed out of line");
+    }
+    break;
+  }
+
+  DisplacedInstruction insn;
+  insn.m_bytes.assign(bytes.begin(), bytes.begin() + 4);
+  insn.m_from = from;
+  insn.m_to = to;
+  insn.m_is_relative_branch = is_relative_branch;
+  insn.m_sets_link_register = sets_link_register;
+  return std::move(insn);
+}
+
+addr_t DisplacedInstruction::FixupPC(addr_t pc) const {
+  // Relative branches land at the same distance from the copy as they
+  // would have from the original, whether they're taken or not.
+  if (m_is_relative_branch)
+    return pc - m_to + m_from;
+  // Everything else falls through to the next instruction, or goes to an
+  // absolute address.
+  if (pc == m_to + m_bytes.size())
+    return m_from + m_bytes.size();
+  return pc;
+}
@@ -0,0 +1,102 @@
+//===-- DisplacedStepping.h ----------------------------------- -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_DisplacedStepping_H_
+#define liblldb_DisplacedStepping_H_
+
+#include <stdint.h>
+#include <vector>
+
+#include "lldb/lldb-defines.h"
+#include "lldb/lldb-types.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Error.h"
+
+namespace lldb_private {
+namespace process_linux {
+
+// An instruction copied out of line so that a thread can execute it without
+// the breakpoint at its original address being removed, and therefore
+// without stopping the other threads.
+//
+// The copy is single-stepped at the scratch address; afterwards the program
+// counter, and the return address of calls, are moved back to where they
+// would be had the instruction run in place. Instructions addressing memory
+// relative to the program counter are rewritten to reach the same memory
+// from the scratch address, or refused where that isn't possible.
+class DisplacedInstruction {
+public:
+  // The longest x86 instruction, which is also longer than any PowerPC
+  // instruction.
+  static const size_t kMaxInstructionSize = 15;
+
+  // Decode the x86-64 instruction at the start of "bytes", which were read
+  // from "from", and prepare it to run at "to". Fails for instructions that
+  // can't be executed out of line: system calls, traps, far transfers,
+  // instructions whose effects depend on the trap flag and anything the
+  // decoder doesn't know.
+  static llvm::Expected<DisplacedInstruction>
+  DecodeX86_64(llvm::ArrayRef<uint8_t> bytes, lldb::addr_t from,
+               lldb::addr_t to);
+
+  // Decode the little endian 64-bit PowerPC instruction at the start of
+  // "bytes", which were read from "from", and prepare it to run at "to".
+  // Instructions are always 4 bytes long, and only branches and addpcis
+  // depend on their address. Fails for system calls, traps, load reserve
+  // and store conditional instructions, addpcis, and prefixed
+  // instructions.
+  static llvm::Expected<DisplacedInstruction>
+  DecodePPC64LE(llvm::ArrayRef<uint8_t> bytes, lldb::addr_t from,
+                lldb::addr_t to);
+
+  // The bytes to write at the scratch address.
+  llvm::ArrayRef<uint8_t> GetBytes() const { return m_bytes; }
+
+  size_t GetSize() const { return m_bytes.size(); }
+
+  lldb::addr_t GetFrom() const { return m_from; }
+
+  lldb::addr_t GetTo() const { return m_to; }
+
+  // Returns true if "pc" is still inside the copy, i.e. the instruction
+  // didn't complete (a fault, or a repeated string instruction that has
+  // iterations left).
+  bool IsInside(lldb::addr_t pc) const {
+    return pc >= m_to && pc < m_to + m_bytes.size();
+  }
+
+  // Translate the program counter after the copy executed.
+  lldb::addr_t FixupPC(lldb::addr_t pc) const;
+
+  // Whether the instruction pushed its own address plus its size as a
+  // return address, which then has to be replaced by GetReturnAddress().
+  bool IsCall() const { return m_is_call; }
+
+  // Whether the instruction set the link register to its own address plus
+  // its size, which then has to be replaced by GetReturnAddress().
+  bool SetsLinkRegister() const { return m_sets_link_register; }
+
+  lldb::addr_t GetReturnAddress() const { return m_from + m_bytes.size(); }
+
+private:
+  DisplacedInstruction() = default;
+
+  std::vector<uint8_t> m_bytes;
+  lldb::addr_t m_from = LLDB_INVALID_ADDRESS;
+  lldb::addr_t m_to = LLDB_INVALID_ADDRESS;
+  // The target of the instruction is relative to its address.
+  bool m_is_relative_branch = false;
+  bool m_is_call = false;
+  bool m_sets_link_register = false;
+};
+
+} // namespace process_linux
+} // namespace lldb_private
+
+#endif // #ifndef liblldb_DisplacedStepping_H_
@@ -11,11 +11,14 @@
 
 // C Includes
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 
 // C++ Includes
+#include <algorithm>
 #include <fstream>
 #include <mutex>
 #include <sstream>
@@ -40,9 +43,11 @@
 #include "lldb/Target/Process.h"
 #include "lldb/Target/ProcessLaunchInfo.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/LLDBAssert.h"
 #include "lldb/Utility/Status.h"
 #include "lldb/Utility/StringExtractor.h"
+#include "llvm/BinaryFormat/ELF.h"
 #include "llvm/Support/Errno.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Threading.h"
@@ -51,6 +56,7 @@
 #include "Plugins/Process/POSIX/ProcessPOSIXLog.h"
 #include "Procfs.h"
 
+#include <linux/auxvec.h>
 #include <linux/unistd.h>
 #include <sys/socket.h>
 #include <sys/syscall.h>
@@ -103,6 +109,38 @@ static bool ProcessVmReadvSupported() {
   return is_supported;
 }
 
+static bool ProcessVmWritevSupported() {
+  static bool is_supported;
+  static llvm::once_flag flag;
+
+  llvm::call_once(flag, [] {
+    Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
+
+    uint32_t source = 0x47424742;
+    uint32_t dest = 0;
+
+    struct iovec local, remote;
+    local.iov_base = &source;
+    remote.iov_base = &dest;
+    remote.iov_len = local.iov_len = sizeof source;
+
+    // Same as for process_vm_readv: try writing a value into our own process.
+    ssize_t res = process_vm_writev(getpid(), &local, 1, &remote, 1, 0);
+    is_supported = (res == sizeof(source) && source == dest);
+    if (is_supported)
+      LLDB_LOG(log,
+               "Detected kernel support for process_vm_writev syscall. "
+               "Fast memory writes enabled.");
+    else
+      LLDB_LOG(log,
+               "syscall process_vm_writev failed (error: {0}). Fast memory "
+               "writes disabled.",
+               llvm::sys::StrError());
+  });
+
+  return is_supported;
+}
+
 namespace {
 void MaybeLogLaunchInfo(const ProcessLaunchInfo &info) {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
@@ -608,6 +646,12 @@ void NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info,
     // Exec clears any pending notifications.
     m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 
+    // The scratch area went away with the old program.
+    m_displaced_step = DisplacedStep();
+    m_displaced_step_queue.clear();
+    m_displaced_step_scratch = LLDB_INVALID_ADDRESS;
+    m_shared_library_info_addr = LLDB_INVALID_ADDRESS;
+
     // Remove all but the main thread here.  Linux fork creates a new process
     // which only copies the main thread.
     LLDB_LOG(log, "exec received, stop tracking all but main thread");
@@ -751,6 +795,61 @@ void NativeProcessLinux::MonitorTrace(NativeThreadLinux &thread) {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
   LLDB_LOG(log, "received trace event, pid = {0}", thread.GetID());
 
+  if (m_displaced_step.tid == thread.GetID()) {
+    // The thread has executed the copy of the instruction under a breakpoint
+    // it didn't have to stop at.
+    if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID &&
+        m_displaced_step.insn->IsInside(thread.GetRegisterContext().GetPC())) {
+      // Repeated string instructions trap after every iteration.
+      Status error =
+          ResumeThread(thread, eStateStepping, LLDB_INVALID_SIGNAL_NUMBER);
+      if (error.Success())
+        return;
+      LLDB_LOG(log, "failed to step thread {0}: {1}", thread.GetID(), error);
+    }
+    FinishDisplacedStep(thread, true);
+    if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID) {
+      // Somebody asked for a stop in the meantime.
+      thread.SetStoppedWithNoReason();
+      SignalIfAllThreadsStopped();
+      return;
+    }
+    Status error =
+        ResumeThread(thread, eStateRunning, LLDB_INVALID_SIGNAL_NUMBER);
+    if (error.Fail())
+      LLDB_LOG(log, "failed to resume thread {0}: {1}", thread.GetID(), error);
+    StartNextDisplacedStep();
+    return;
+  }
+
+  if (m_breakpoint_step_over.stepping &&
+      m_breakpoint_step_over.tid == thread.GetID()) {
+    // The thread has stepped over a breakpoint it didn't have to stop at.
+    // Put the breakpoint back and let everybody run again.
+    EndBreakpointStepOver();
+    if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID) {
+      // Somebody asked for a stop in the meantime.
+      m_breakpoint_step_over.threads_to_resume.clear();
+      thread.SetStoppedWithNoReason();
+      SignalIfAllThreadsStopped();
+      return;
+    }
+    decltype(m_breakpoint_step_over.threads_to_resume) threads_to_resume;
+    threads_to_resume.swap(m_breakpoint_step_over.threads_to_resume);
+    threads_to_resume.emplace_back(thread.GetID(), eStateRunning);
+    for (const auto &tid_and_state : threads_to_resume) {
+      NativeThreadLinux *thread_to_resume = GetThreadByID(tid_and_state.first);
+      if (!thread_to_resume)
+        continue;
+      Status error = ResumeThread(*thread_to_resume, tid_and_state.second,
+                                  LLDB_INVALID_SIGNAL_NUMBER);
+      if (error.Fail())
+        LLDB_LOG(log, "failed to resume thread {0}: {1}", tid_and_state.first,
+                 error);
+    }
+    return;
+  }
+
   // This thread is currently stopped.
   thread.SetStoppedByTrace();
 
@@ -762,6 +861,10 @@ void NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread) {
       GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
   LLDB_LOG(log, "received breakpoint event, pid = {0}", thread.GetID());
 
+  // Only a thread that was running freely can skip a breakpoint on its own;
+  // a thread the debugger was stepping has to report back.
+  const bool was_running = thread.GetState() == eStateRunning;
+
   // Mark the thread as stopped at breakpoint.
   thread.SetStoppedByBreakpoint();
   Status error = FixupBreakpointPCAsNeeded(thread);
@@ -771,10 +874,294 @@ void NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread) {
   if (m_threads_stepping_with_breakpoint.find(thread.GetID()) !=
       m_threads_stepping_with_breakpoint.end())
     thread.SetStoppedByTrace();
+  else if (was_running && ShouldSkipBreakpointHit(thread)) {
+    if (m_displaced_step.tid != LLDB_INVALID_THREAD_ID) {
+      LLDB_LOG(log, "tid {0}: skipping breakpoint hit, waiting for the "
+                    "scratch area",
+               thread.GetID());
+      m_displaced_step_queue.push_back(thread.GetID());
+      return;
+    }
+    if (StartDisplacedStep(thread)) {
+      LLDB_LOG(log, "tid {0}: skipping breakpoint hit, stepping over it out "
+                    "of line",
+               thread.GetID());
+      return;
+    }
+    LLDB_LOG(log, "tid {0}: skipping breakpoint hit, stepping over it",
+             thread.GetID());
+    m_breakpoint_step_over.tid = thread.GetID();
+    m_breakpoint_step_over.addr = thread.GetRegisterContext().GetPC();
+    m_breakpoint_step_over.stepping = false;
+    m_breakpoint_step_over.threads_to_resume.clear();
+    for (const auto &thread_sp : m_threads) {
+      if (thread_sp->GetID() != thread.GetID() &&
+          StateIsRunningState(thread_sp->GetState()))
+        m_breakpoint_step_over.threads_to_resume.emplace_back(
+            thread_sp->GetID(), thread_sp->GetState() == eStateStepping
+                                    ? eStateStepping
+                                    : eStateRunning);
+    }
+  }
 
   StopRunningThreads(thread.GetID());
 }
 
+bool NativeProcessLinux::ShouldSkipBreakpointHit(
+    NativeThreadLinux &thread) {
+  // Without hardware single stepping, stepping over the breakpoint would
+  // itself need temporary breakpoints; leave that to the debugger.
+  if (!SupportHardwareSingleStepping())
+    return false;
+
+  // Some other stop is already on its way to the debugger.
+  if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID ||
+      m_breakpoint_step_over.tid != LLDB_INVALID_THREAD_ID)
+    return false;
+
+  NativeBreakpointSP breakpoint_sp;
+  if (m_breakpoint_list
+          .GetBreakpoint(thread.GetRegisterContext().GetPC(), breakpoint_sp)
+          .Fail() ||
+      !breakpoint_sp || !breakpoint_sp->IsSoftwareBreakpoint())
+    return false;
+
+  return !breakpoint_sp->HitShouldStop(thread);
+}
+
+bool NativeProcessLinux::StartBreakpointStepOver() {
+  Log *log(
+      GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+
+  NativeThreadLinux *thread = GetThreadByID(m_breakpoint_step_over.tid);
+  bool can_step = thread != nullptr;
+
+  // If any of the threads we stopped has something to report itself, give up
+  // and report everything; the debugger steps over the breakpoint then.
+  for (const auto &tid_and_state : m_breakpoint_step_over.threads_to_resume) {
+    NativeThreadLinux *other = GetThreadByID(tid_and_state.first);
+    if (!other)
+      continue;
+    ThreadStopInfo stop_info;
+    std::string description;
+    if (other->GetStopReason(stop_info, description) &&
+        stop_info.reason != eStopReasonNone)
+      can_step = false;
+  }
+
+  if (can_step) {
+    Status error = DisableBreakpoint(m_breakpoint_step_over.addr);
+    if (error.Fail()) {
+      LLDB_LOG(log, "failed to remove breakpoint at {0:x}: {1}",
+               m_breakpoint_step_over.addr, error);
+      can_step = false;
+    }
+  }
+
+  if (can_step) {
+    Status error =
+        ResumeThread(*thread, eStateStepping, LLDB_INVALID_SIGNAL_NUMBER);
+    if (error.Fail()) {
+      LLDB_LOG(log, "failed to step thread {0}: {1}", thread->GetID(), error);
+      EnableBreakpoint(m_breakpoint_step_over.addr);
+      can_step = false;
+    }
+  }
+
+  if (!can_step) {
+    m_breakpoint_step_over = BreakpointStepOver();
+    return false;
+  }
+
+  // The hit is skipped for good now; the debugger learns about it with the
+  // next stop.
+  NativeBreakpointSP breakpoint_sp;
+  if (m_breakpoint_list.GetBreakpoint(m_breakpoint_step_over.addr,
+                                      breakpoint_sp)
+          .Success())
+    breakpoint_sp->RecordSkippedHit();
+
+  m_breakpoint_step_over.stepping = true;
+  return true;
+}
+
+void NativeProcessLinux::EndBreakpointStepOver() {
+  if (m_breakpoint_step_over.stepping) {
+    Status error = EnableBreakpoint(m_breakpoint_step_over.addr);
+    if (error.Fail()) {
+      Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS |
+                                        LIBLLDB_LOG_BREAKPOINTS));
+      LLDB_LOG(log, "failed to reinsert breakpoint at {0:x}: {1}",
+               m_breakpoint_step_over.addr, error);
+    }
+  }
+  m_breakpoint_step_over.tid = LLDB_INVALID_THREAD_ID;
+  m_breakpoint_step_over.addr = LLDB_INVALID_ADDRESS;
+  m_breakpoint_step_over.stepping = false;
+}
+
+lldb::addr_t NativeProcessLinux::GetDisplacedStepScratch() {
+  if (m_displaced_step_scratch != LLDB_INVALID_ADDRESS)
+    return m_displaced_step_scratch;
+
+  // The code at the entry point runs once, before any other thread exists.
+  m_displaced_step_scratch = GetAuxvValue(AT_ENTRY).getValueOr(0);
+  return m_displaced_step_scratch;
+}
+
+bool NativeProcessLinux::StartDisplacedStep(NativeThreadLinux &thread) {
+  Log *log(
+      GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+
+  const llvm::Triple::ArchType machine = m_arch.GetMachine();
+  if (machine != llvm::Triple::x86_64 && machine != llvm::Triple::ppc64le)
+    return false;
+  const lldb::addr_t scratch = GetDisplacedStepScratch();
+  if (scratch == 0)
+    return false;
+
+  NativeRegisterContext &reg_ctx = thread.GetRegisterContext();
+  const lldb::addr_t pc = reg_ctx.GetPC();
+  const size_t max_size = DisplacedInstruction::kMaxInstructionSize;
+  if (pc < scratch + max_size && scratch < pc + max_size)
+    return false;
+
+  // The debugger plants breakpoints at the entry point too, e.g. to catch
+  // the return of expressions it calls; the copy would overwrite them.
+  bool scratch_has_breakpoint =
+      m_breakpoint_list.HasBreakpointInRange(scratch, max_size);
+  for (const auto &hw_bp : GetHardwareBreakpointMap()) {
+    const HardwareBreakpoint &bp = hw_bp.second;
+    if (bp.m_addr < scratch + max_size && scratch < bp.m_addr + bp.m_size)
+      scratch_has_breakpoint = true;
+  }
+  if (scratch_has_breakpoint) {
+    LLDB_LOG(log, "a breakpoint lies in the scratch area at {0:x}", scratch);
+    return false;
+  }
+
+  uint8_t bytes[DisplacedInstruction::kMaxInstructionSize];
+  size_t bytes_read = 0;
+  Status error = ReadMemoryWithoutTrap(pc, bytes, sizeof(bytes), bytes_read);
+  if (error.Fail() || bytes_read == 0)
+    return false;
+  llvm::ArrayRef<uint8_t> insn_bytes = llvm::makeArrayRef(bytes, bytes_read);
+  llvm::Expected<DisplacedInstruction> insn =
+      machine == llvm::Triple::x86_64
+          ? DisplacedInstruction::DecodeX86_64(insn_bytes, pc, scratch)
+          : DisplacedInstruction::DecodePPC64LE(insn_bytes, pc, scratch);
+  if (!insn) {
+    LLDB_LOG(log, "can't step over the instruction at {0:x} out of line: {1}",
+             pc, llvm::toString(insn.takeError()));
+    return false;
+  }
+
+  std::vector<uint8_t> saved_bytes(insn->GetSize());
+  size_t bytes_transferred = 0;
+  error = ReadMemory(scratch, saved_bytes.data(), saved_bytes.size(),
+                     bytes_transferred);
+  if (error.Fail() || bytes_transferred != saved_bytes.size())
+    return false;
+  error = WriteMemory(scratch, insn->GetBytes().data(), insn->GetSize(),
+                      bytes_transferred);
+  if (error.Success() && bytes_transferred == insn->GetSize()) {
+    error = reg_ctx.SetPC(scratch);
+    if (error.Success())
+      error = ResumeThread(thread, eStateStepping, LLDB_INVALID_SIGNAL_NUMBER);
+  } else if (error.Success())
+    error.SetErrorString("short write");
+
+  if (error.Fail()) {
+    LLDB_LOG(log, "failed to step thread {0} out of line: {1}",
+             thread.GetID(), error);
+    reg_ctx.SetPC(pc);
+    WriteMemory(scratch, saved_bytes.data(), saved_bytes.size(),
+                bytes_transferred);
+    return false;
+  }
+
+  m_displaced_step.tid = thread.GetID();
+  m_displaced_step.insn = std::move(*insn);
+  m_displaced_step.saved_bytes = std::move(saved_bytes);
+  return true;
+}
+
+void NativeProcessLinux::FinishDisplacedStep(NativeThreadLinux &thread,
+                                             bool count_incomplete) {
+  Log *log(
+      GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+  const DisplacedInstruction &insn = *m_displaced_step.insn;
+  NativeRegisterContext &reg_ctx = thread.GetRegisterContext();
+  const lldb::addr_t pc = reg_ctx.GetPC();
+  const bool completed = !insn.IsInside(pc);
+
+  Status error = reg_ctx.SetPC(completed ? insn.FixupPC(pc) : insn.GetFrom());
+  if (error.Fail())
+    LLDB_LOG(log, "failed to set the pc of thread {0}: {1}", thread.GetID(),
+             error);
+  if (completed && insn.IsCall()) {
+    const uint64_t return_address = insn.GetReturnAddress();
+    size_t bytes_written = 0;
+    error = WriteMemory(reg_ctx.GetSP(), &return_address,
+                        sizeof(return_address), bytes_written);
+    if (error.Fail())
+      LLDB_LOG(log, "failed to fix the return address of thread {0}: {1}",
+               thread.GetID(), error);
+  }
+  if (completed && insn.SetsLinkRegister()) {
+    const uint32_t lr = reg_ctx.ConvertRegisterKindToRegisterNumber(
+        eRegisterKindGeneric, LLDB_REGNUM_GENERIC_RA);
+    error = reg_ctx.WriteRegisterFromUnsigned(lr, insn.GetReturnAddress());
+    if (error.Fail())
+      LLDB_LOG(log, "failed to fix the link register of thread {0}: {1}",
+               thread.GetID(), error);
+  }
+
+  // The hit is skipped for good now; the debugger learns about it with the
+  // next stop.
+  NativeBreakpointSP breakpoint_sp;
+  if ((completed || count_incomplete) &&
+      m_breakpoint_list.GetBreakpoint(insn.GetFrom(), breakpoint_sp)
+          .Success())
+    breakpoint_sp->RecordSkippedHit();
+
+  RestoreDisplacedStepScratch();
+}
+
+void NativeProcessLinux::RestoreDisplacedStepScratch() {
+  if (m_displaced_step.insn) {
+    size_t bytes_written = 0;
+    Status error = WriteMemory(m_displaced_step.insn->GetTo(),
+                               m_displaced_step.saved_bytes.data(),
+                               m_displaced_step.saved_bytes.size(),
+                               bytes_written);
+    if (error.Fail()) {
+      Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS |
+                                        LIBLLDB_LOG_BREAKPOINTS));
+      LLDB_LOG(log, "failed to restore the scratch area at {0:x}: {1}",
+               m_displaced_step.insn->GetTo(), error);
+    }
+  }
+  m_displaced_step = DisplacedStep();
+}
+
+void NativeProcessLinux::StartNextDisplacedStep() {
+  while (m_displaced_step.tid == LLDB_INVALID_THREAD_ID &&
+         m_pending_notification_tid == LLDB_INVALID_THREAD_ID &&
+         !m_displaced_step_queue.empty()) {
+    NativeThreadLinux *thread = GetThreadByID(m_displaced_step_queue.front());
+    m_displaced_step_queue.pop_front();
+    if (!thread)
+      continue;
+    // The thread was queued while the previous step still held on to its
+    // skipped hit, so the ignore count may have run out since; look again.
+    if (ShouldSkipBreakpointHit(*thread) && StartDisplacedStep(*thread))
+      continue;
+    // Let the debugger deal with the hit after all.
+    StopRunningThreads(thread->GetID());
+  }
+}
+
 void NativeProcessLinux::MonitorWatchpoint(NativeThreadLinux &thread,
                                            uint32_t wp_index) {
   Log *log(
@@ -863,6 +1250,20 @@ void NativeProcessLinux::MonitorSignal(const siginfo_t &info,
     return;
   }
 
+  if (m_displaced_step.tid == thread.GetID()) {
+    // The signal interrupted a step over a breakpoint. Unless the signal is
+    // passed on right away, the debugger sees the thread at the breakpoint
+    // and steps over it when resuming.
+    const bool ignored =
+        m_signals_to_ignore.find(signo) != m_signals_to_ignore.end();
+    FinishDisplacedStep(thread, !ignored);
+    if (ignored) {
+      ResumeThread(thread, eStateRunning, signo);
+      StartNextDisplacedStep();
+      return;
+    }
+  }
+
   // Check if debugger should stop at this signal or just ignore it
   // and resume the inferior.
   if (m_signals_to_ignore.find(signo) != m_signals_to_ignore.end()) {
@@ -1499,9 +1900,188 @@ Status NativeProcessLinux::DeallocateMemory(lldb::addr_t addr) {
   return Status("not implemented");
 }
 
+llvm::Optional<uint64_t> NativeProcessLinux::GetAuxvValue(uint64_t type) {
+  auto buffer_or_error = GetAuxvData();
+  if (!buffer_or_error)
+    return llvm::None;
+  const llvm::MemoryBuffer &auxv = **buffer_or_error;
+  const uint32_t ptr_size = m_arch.GetAddressByteSize();
+  DataExtractor data(auxv.getBufferStart(), auxv.getBufferSize(),
+                     GetByteOrder(), ptr_size);
+  lldb::offset_t offset = 0;
+  while (data.ValidOffsetForDataOfSize(offset, 2 * ptr_size)) {
+    const uint64_t entry_type = data.GetMaxU64(&offset, ptr_size);
+    const uint64_t entry_value = data.GetMaxU64(&offset, ptr_size);
+    if (entry_type == AT_NULL)
+      break;
+    if (entry_type == type)
+      return entry_value;
+  }
+  return llvm::None;
+}
+
+Status NativeProcessLinux::ReadPointer(lldb::addr_t addr, lldb::addr_t &value) {
+  const uint32_t ptr_size = m_arch.GetAddressByteSize();
+  uint8_t buffer[8];
+  size_t bytes_read = 0;
+  Status error = ReadMemory(addr, buffer, ptr_size, bytes_read);
+  if (error.Fail())
+    return error;
+  if (bytes_read != ptr_size)
+    return Status("could not read a pointer at 0x%" PRIx64, addr);
+  DataExtractor data(buffer, ptr_size, GetByteOrder(), ptr_size);
+  lldb::offset_t offset = 0;
+  value = data.GetMaxU64(&offset, ptr_size);
+  return Status();
+}
+
 lldb::addr_t NativeProcessLinux::GetSharedLibraryInfoAddress() {
-  // punt on this for now
-  return LLDB_INVALID_ADDRESS;
+  if (m_shared_library_info_addr != LLDB_INVALID_ADDRESS)
+    return m_shared_library_info_addr;
+
+  // Find the dynamic section through the program headers, which the kernel
+  // passes in the auxiliary vector.
+  llvm::Optional<uint64_t> phdr_addr = GetAuxvValue(AT_PHDR);
+  llvm::Optional<uint64_t> phdr_entsize = GetAuxvValue(AT_PHENT);
+  llvm::Optional<uint64_t> phdr_count = GetAuxvValue(AT_PHNUM);
+  if (!phdr_addr || !phdr_entsize || !phdr_count)
+    return LLDB_INVALID_ADDRESS;
+
+  const uint32_t ptr_size = m_arch.GetAddressByteSize();
+  // The offsets of p_vaddr and p_memsz differ between ELF32 and ELF64.
+  const lldb::offset_t vaddr_offset = ptr_size == 4 ? 8 : 16;
+  const lldb::offset_t memsz_offset = ptr_size == 4 ? 20 : 40;
+  if (*phdr_entsize < memsz_offset + ptr_size)
+    return LLDB_INVALID_ADDRESS;
+
+  std::vector<uint8_t> phdrs(*phdr_entsize * *phdr_count);
+  size_t bytes_read = 0;
+  if (ReadMemory(*phdr_addr, phdrs.data(), phdrs.size(), bytes_read).Fail() ||
+      bytes_read != phdrs.size())
+    return LLDB_INVALID_ADDRESS;
+  DataExtractor phdr_data(phdrs.data(), phdrs.size(), GetByteOrder(),
+                          ptr_size);
+
+  lldb::addr_t load_bias = 0;
+  lldb::addr_t dynamic_vaddr = LLDB_INVALID_ADDRESS;
+  uint64_t dynamic_size = 0;
+  for (uint64_t i = 0; i < *phdr_count; ++i) {
+    const lldb::offset_t phdr_offset = i * *phdr_entsize;
+    lldb::offset_t offset = phdr_offset;
+    const uint32_t p_type = phdr_data.GetU32(&offset);
+    offset = phdr_offset + vaddr_offset;
+    const lldb::addr_t p_vaddr = phdr_data.GetMaxU64(&offset, ptr_size);
+    offset = phdr_offset + memsz_offset;
+    const uint64_t p_memsz = phdr_data.GetMaxU64(&offset, ptr_size);
+    if (p_type == llvm::ELF::PT_PHDR)
+      load_bias = *phdr_addr - p_vaddr;
+    else if (p_type == llvm::ELF::PT_DYNAMIC) {
+      dynamic_vaddr = p_vaddr;
+      dynamic_size = p_memsz;
+    }
+  }
+  if (dynamic_vaddr == LLDB_INVALID_ADDRESS)
+    return LLDB_INVALID_ADDRESS;
+
+  const lldb::addr_t dynamic_addr = load_bias + dynamic_vaddr;
+  std::vector<uint8_t> dynamic(dynamic_size);
+  if (ReadMemory(dynamic_addr, dynamic.data(), dynamic.size(), bytes_read)
+          .Fail())
+    return LLDB_INVALID_ADDRESS;
+  DataExtractor dynamic_data(dynamic.data(), bytes_read, GetByteOrder(),
+                             ptr_size);
+  lldb::offset_t offset = 0;
+  while (dynamic_data.ValidOffsetForDataOfSize(offset, 2 * ptr_size)) {
+    const uint64_t d_tag = dynamic_data.GetMaxU64(&offset, ptr_size);
+    if (d_tag == llvm::ELF::DT_NULL)
+      break;
+    // Like ObjectFileELF::GetImageInfoAddress, report where the dynamic
+    // linker stores the address of r_debug, as it is only filled in once
+    // the dynamic linker has run.
+    if (d_tag == llvm::ELF::DT_DEBUG) {
+      m_shared_library_info_addr = dynamic_addr + offset;
+      break;
+    }
+    offset += ptr_size;
+  }
+  return m_shared_library_info_addr;
+}
+
+Status NativeProcessLinux::GetLoadedSVR4Libraries(
+    std::vector<SVR4LibraryInfo> &libraries, lldb::addr_t &main_lm) {
+  libraries.clear();
+  main_lm = LLDB_INVALID_ADDRESS;
+
+  const lldb::addr_t info_addr = GetSharedLibraryInfoAddress();
+  if (info_addr == LLDB_INVALID_ADDRESS)
+    return Status("the executable has no DT_DEBUG entry");
+  lldb::addr_t r_debug = 0;
+  Status error = ReadPointer(info_addr, r_debug);
+  if (error.Fail())
+    return error;
+  if (r_debug == 0)
+    return Status("the dynamic linker has not initialized r_debug yet");
+
+  // struct r_debug { int r_version; struct link_map *r_map; ... };
+  const uint32_t ptr_size = m_arch.GetAddressByteSize();
+  lldb::addr_t link_map = 0;
+  error = ReadPointer(r_debug + ptr_size, link_map);
+  if (error.Fail())
+    return error;
+
+  // struct link_map { l_addr; l_name; l_ld; l_next; l_prev; }, all of
+  // them pointer sized. Read each entry with a single read, and the names
+  // in one go once the whole list is known.
+  const size_t num_fields = 5;
+  std::vector<lldb::addr_t> name_addrs;
+  // A bound on the number of entries, in case the list is being modified
+  // and has a cycle in it right now.
+  const size_t max_entries = 1 << 16;
+  while (link_map != 0 && libraries.size() < max_entries) {
+    uint8_t buffer[num_fields * 8];
+    size_t bytes_read = 0;
+    error = ReadMemory(link_map, buffer, num_fields * ptr_size, bytes_read);
+    if (error.Fail())
+      return error;
+    if (bytes_read != num_fields * ptr_size)
+      return Status("could not read the link map entry at 0x%" PRIx64,
+                    link_map);
+    DataExtractor data(buffer, bytes_read, GetByteOrder(), ptr_size);
+    lldb::offset_t offset = 0;
+    SVR4LibraryInfo info;
+    info.link_map = link_map;
+    info.base_addr = data.GetMaxU64(&offset, ptr_size);
+    const lldb::addr_t name_addr = data.GetMaxU64(&offset, ptr_size);
+    info.ld_addr = data.GetMaxU64(&offset, ptr_size);
+    link_map = data.GetMaxU64(&offset, ptr_size);
+
+    // The first entry is the main executable.
+    if (main_lm == LLDB_INVALID_ADDRESS) {
+      main_lm = info.link_map;
+      continue;
+    }
+    libraries.push_back(info);
+    name_addrs.push_back(name_addr);
+  }
+
+  std::vector<char> names(name_addrs.size() * PATH_MAX);
+  std::vector<MemoryReadRange> ranges;
+  for (size_t i = 0; i < name_addrs.size(); ++i) {
+    if (name_addrs[i] != 0)
+      ranges.emplace_back(name_addrs[i], &names[i * PATH_MAX], PATH_MAX);
+  }
+  error = ReadMemoryRanges(ranges);
+  if (error.Fail())
+    return error;
+  auto range_it = ranges.begin();
+  for (size_t i = 0; i < name_addrs.size(); ++i) {
+    if (name_addrs[i] == 0)
+      continue;
+    const char *name = static_cast<const char *>(range_it->buf);
+    libraries[i].name.assign(name, strnlen(name, range_it->bytes_read));
+    ++range_it;
+  }
+  return Status();
 }
 
 size_t NativeProcessLinux::UpdateThreads() {
@@ -1837,6 +2417,60 @@ Status NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
   return Status();
 }
 
+Status NativeProcessLinux::ReadMemoryRanges(
+    llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  if (!ProcessVmReadvSupported())
+    return NativeProcessProtocol::ReadMemoryRanges(ranges);
+
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
+  const ::pid_t pid = GetID();
+  std::vector<struct iovec> local_iov, remote_iov;
+  size_t idx = 0;
+  while (idx < ranges.size()) {
+    // Hand as many ranges to the kernel at once as it accepts.
+    const size_t end_idx = std::min<size_t>(ranges.size(), idx + IOV_MAX);
+    local_iov.clear();
+    remote_iov.clear();
+    for (size_t i = idx; i < end_idx; ++i) {
+      ranges[i].bytes_read = 0;
+      struct iovec iov;
+      iov.iov_base = ranges[i].buf;
+      iov.iov_len = ranges[i].size;
+      local_iov.push_back(iov);
+      iov.iov_base = reinterpret_cast<void *>(ranges[i].addr);
+      remote_iov.push_back(iov);
+    }
+
+    const ssize_t result =
+        process_vm_readv(pid, local_iov.data(), local_iov.size(),
+                         remote_iov.data(), remote_iov.size(), 0);
+    LLDB_LOG(log,
+             "using process_vm_readv to read {0} ranges from inferior: {1}",
+             end_idx - idx,
+             result < 0 ? llvm::sys::StrError(errno) : "Success");
+
+    // The transfer stops at the first range that can't be read in full, so
+    // all ranges before it have been read completely.
+    size_t bytes_left = result < 0 ? 0 : result;
+    while (idx < end_idx && bytes_left >= ranges[idx].size) {
+      ranges[idx].bytes_read = ranges[idx].size;
+      bytes_left -= ranges[idx].size;
+      ++idx;
+    }
+    if (idx == end_idx)
+      continue;
+
+    // Find out how much of the failed range is readable on its own and go on
+    // with the ranges after it.
+    size_t bytes_read = 0;
+    ReadMemory(ranges[idx].addr, ranges[idx].buf, ranges[idx].size,
+               bytes_read);
+    ranges[idx].bytes_read = std::min(bytes_read, ranges[idx].size);
+    ++idx;
+  }
+  return Status();
+}
+
 Status NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf,
                                                  size_t size,
                                                  size_t &bytes_read) {
@@ -1846,16 +2480,92 @@ Status NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf,
   return m_breakpoint_list.RemoveTrapsFromBuffer(addr, buf, size);
 }
 
-Status NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf,
-                                       size_t size, size_t &bytes_written) {
+size_t NativeProcessLinux::WriteMemoryWithProcessVmWritev(lldb::addr_t addr,
+                                                          const void *buf,
+                                                          size_t size) {
+  if (!ProcessVmWritevSupported())
+    return 0;
+
+  struct iovec local_iov, remote_iov;
+  local_iov.iov_base = const_cast<void *>(buf);
+  local_iov.iov_len = size;
+  remote_iov.iov_base = reinterpret_cast<void *>(addr);
+  remote_iov.iov_len = size;
+
+  const ssize_t res =
+      process_vm_writev(GetID(), &local_iov, 1, &remote_iov, 1, 0);
+
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
+  LLDB_LOG(log,
+           "using process_vm_writev to write {0} bytes to inferior "
+           "address {1:x}: {2}",
+           size, addr, res < 0 ? llvm::sys::StrError(errno) : "Success");
+  return res < 0 ? 0 : res;
+}
+
+size_t NativeProcessLinux::WriteMemoryWithProcMem(lldb::addr_t addr,
+                                                  const void *buf,
+                                                  size_t size) {
+  Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_PROCESS));
+
+  // The file is opened for every write: a descriptor that was opened before
+  // the inferior exec'ed would still refer to the old address space.
+  char mem_path[64];
+  ::snprintf(mem_path, sizeof(mem_path), "/proc/%" PRIu64 "/mem", GetID());
+  const int fd = ::open(mem_path, O_WRONLY | O_CLOEXEC);
+  if (fd == -1) {
+    LLDB_LOG(log, "failed to open {0}: {1}", mem_path,
+             llvm::sys::StrError());
+    return 0;
+  }
+
   const unsigned char *src = static_cast<const unsigned char *>(buf);
-  size_t remainder;
-  Status error;
+  size_t bytes_written = 0;
+  while (bytes_written < size) {
+    const ssize_t res = ::pwrite(fd, src + bytes_written, size - bytes_written,
+                                 addr + bytes_written);
+    if (res < 0 && errno == EINTR)
+      continue;
+    if (res <= 0) {
+      LLDB_LOG(log, "failed to write to {0} at address {1:x}: {2}", mem_path,
+               addr + bytes_written, llvm::sys::StrError());
+      break;
+    }
+    bytes_written += res;
+  }
+  ::close(fd);
+
+  LLDB_LOG(log, "wrote {0} of {1} bytes through {2} to address {3:x}",
+           bytes_written, size, mem_path, addr);
+  return bytes_written;
+}
 
+Status NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf,
+                                       size_t size, size_t &bytes_written) {
   Log *log(ProcessPOSIXLog::GetLogIfAllCategoriesSet(POSIX_LOG_MEMORY));
   LLDB_LOG(log, "addr = {0}, buf = {1}, size = {2}", addr, buf, size);
 
-  for (bytes_written = 0; bytes_written < size; bytes_written += remainder) {
+  // process_vm_writev writes the whole buffer with one system call but,
+  // unlike ptrace, it honors the page protections of the inferior, so it
+  // fails for read-only mappings such as the text pages breakpoints go into.
+  // Writing to /proc/<pid>/mem doesn't have that restriction. Whatever is left
+  // after both of them is written with ptrace, a word at a time.
+  bytes_written = WriteMemoryWithProcessVmWritev(addr, buf, size);
+  if (bytes_written < size)
+    bytes_written += WriteMemoryWithProcMem(
+        addr + bytes_written,
+        static_cast<const unsigned char *>(buf) + bytes_written,
+        size - bytes_written);
+  if (bytes_written == size)
+    return Status();
+
+  const unsigned char *src =
+      static_cast<const unsigned char *>(buf) + bytes_written;
+  addr += bytes_written;
+  size_t remainder;
+  Status error;
+
+  for (; bytes_written < size; bytes_written += remainder) {
     remainder = size - bytes_written;
     remainder = remainder > k_ptrace_word_size ? k_ptrace_word_size : remainder;
 
@@ -1877,8 +2587,10 @@ Status NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf,
 
       memcpy(buff, src, remainder);
 
-      size_t bytes_written_rec;
-      error = WriteMemory(addr, buff, k_ptrace_word_size, bytes_written_rec);
+      unsigned long data = 0;
+      memcpy(&data, buff, k_ptrace_word_size);
+      error = NativeProcessLinux::PtraceWrapper(PTRACE_POKEDATA, GetID(),
+                                                (void *)addr, (void *)data);
       if (error.Fail())
         return error;
 
@@ -1936,6 +2648,32 @@ bool NativeProcessLinux::StopTrackingThread(lldb::tid_t thread_id) {
 
   if (found)
     StopTracingForThread(thread_id);
+
+  m_displaced_step_queue.erase(std::remove(m_displaced_step_queue.begin(),
+                                           m_displaced_step_queue.end(),
+                                           thread_id),
+                               m_displaced_step_queue.end());
+  if (m_displaced_step.tid == thread_id) {
+    RestoreDisplacedStepScratch();
+    StartNextDisplacedStep();
+  }
+
+  if (m_breakpoint_step_over.tid == thread_id) {
+    // The thread went away while it was stepping over a breakpoint, so the
+    // step will never complete.
+    const bool was_stepping = m_breakpoint_step_over.stepping;
+    decltype(m_breakpoint_step_over.threads_to_resume) threads_to_resume;
+    threads_to_resume.swap(m_breakpoint_step_over.threads_to_resume);
+    EndBreakpointStepOver();
+    if (was_stepping && m_pending_notification_tid == LLDB_INVALID_THREAD_ID) {
+      for (const auto &tid_and_state : threads_to_resume) {
+        if (NativeThreadLinux *thread = GetThreadByID(tid_and_state.first))
+          ResumeThread(*thread, tid_and_state.second,
+                       LLDB_INVALID_SIGNAL_NUMBER);
+      }
+    }
+  }
+
   SignalIfAllThreadsStopped();
   return found;
 }
@@ -2161,6 +2899,35 @@ void NativeProcessLinux::SignalIfAllThreadsStopped() {
   Log *log(
       GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
 
+  // A thread stopped in the middle of a step out of line goes back to its
+  // breakpoint, and the threads waiting to step are reported as having hit
+  // theirs.
+  if (m_displaced_step.tid != LLDB_INVALID_THREAD_ID) {
+    if (NativeThreadLinux *thread = GetThreadByID(m_displaced_step.tid))
+      FinishDisplacedStep(*thread, true);
+    else
+      RestoreDisplacedStepScratch();
+  }
+  m_displaced_step_queue.clear();
+
+  if (m_breakpoint_step_over.tid != LLDB_INVALID_THREAD_ID) {
+    if (!m_breakpoint_step_over.stepping &&
+        m_breakpoint_step_over.tid == m_pending_notification_tid) {
+      // Everybody stopped for a breakpoint hit we skip. Step over it
+      // instead of reporting the stop.
+      const lldb::tid_t pending_tid = m_pending_notification_tid;
+      m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
+      if (StartBreakpointStepOver())
+        return;
+      m_pending_notification_tid = pending_tid;
+    } else {
+      // Something else stopped us while stepping over the breakpoint; it has
+      // to be back in place before the debugger sees the process.
+      EndBreakpointStepOver();
+      m_breakpoint_step_over.threads_to_resume.clear();
+    }
+  }
+
   // Clear any temporary breakpoints we used to implement software single
   // stepping.
   for (const auto &thread_info : m_threads_stepping_with_breakpoint) {
@@ -11,6 +11,7 @@
 #define liblldb_NativeProcessLinux_H_
 
 #include <csignal>
+#include <deque>
 #include <unordered_set>
 
 #include "lldb/Host/Debug.h"
@@ -20,7 +21,9 @@
 #include "lldb/Utility/ArchSpec.h"
 #include "lldb/Utility/FileSpec.h"
 #include "lldb/lldb-types.h"
+#include "llvm/ADT/Optional.h"
 
+#include "DisplacedStepping.h"
 #include "NativeThreadLinux.h"
 #include "ProcessorTrace.h"
 #include "lldb/Host/common/NativeProcessProtocol.h"
@@ -74,6 +77,9 @@ public:
   Status ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size,
                                size_t &bytes_read) override;
 
+  Status
+  ReadMemoryRanges(llvm::MutableArrayRef<MemoryReadRange> ranges) override;
+
   Status WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
                      size_t &bytes_written) override;
 
@@ -108,6 +114,9 @@ public:
     return getProcFile(GetID(), "auxv");
   }
 
+  Status GetLoadedSVR4Libraries(std::vector<SVR4LibraryInfo> &libraries,
+                                lldb::addr_t &main_lm) override;
+
   lldb::user_id_t StartTrace(const TraceOptions &config,
                              Status &error) override;
 
@@ -155,6 +164,44 @@ private:
   // the relevan breakpoint
   std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_with_breakpoint;
 
+  // A thread that hit a breakpoint whose ignore count isn't used up yet or
+  // whose conditions are all false is stepped over it without telling the
+  // debugger. Where the instruction can't be displaced (see below), the
+  // breakpoint is removed for the step. The other threads are stopped
+  // first so they can't run through the breakpoint while it is removed, and
+  // are resumed once the step is done.
+  struct BreakpointStepOver {
+    lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+    lldb::addr_t addr = LLDB_INVALID_ADDRESS;
+    // True once the breakpoint is removed and the thread is stepping.
+    bool stepping = false;
+    // The threads stopped for the step, and how they were resumed before:
+    // a thread the debugger was single stepping keeps stepping.
+    std::vector<std::pair<lldb::tid_t, lldb::StateType>> threads_to_resume;
+  };
+  BreakpointStepOver m_breakpoint_step_over;
+
+  // On x86-64 and ppc64le the thread rather steps a copy of the instruction
+  // under the breakpoint, placed at the program's entry point, which doesn't
+  // run again, unless a breakpoint was set there. The breakpoint stays in
+  // place and the other threads keep running. Only one thread can use the
+  // scratch area at a time; threads that hit a breakpoint meanwhile wait for
+  // their turn in m_displaced_step_queue.
+  struct DisplacedStep {
+    lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+    llvm::Optional<DisplacedInstruction> insn;
+    // What the copy overwrote.
+    std::vector<uint8_t> saved_bytes;
+  };
+  DisplacedStep m_displaced_step;
+  std::deque<lldb::tid_t> m_displaced_step_queue;
+  // LLDB_INVALID_ADDRESS until looked up, 0 if there is no scratch area.
+  lldb::addr_t m_displaced_step_scratch = LLDB_INVALID_ADDRESS;
+
+  // The address of the DT_DEBUG value in the executable's dynamic section,
+  // which points to the dynamic linker's r_debug structure.
+  lldb::addr_t m_shared_library_info_addr = LLDB_INVALID_ADDRESS;
+
   // ---------------------------------------------------------------------
   // Private Instance Methods
   // ---------------------------------------------------------------------
@@ -184,6 +231,31 @@ private:
 
   Status SetupSoftwareSingleStepping(NativeThreadLinux &thread);
 
+  bool ShouldSkipBreakpointHit(NativeThreadLinux &thread);
+
+  bool StartBreakpointStepOver();
+
+  void EndBreakpointStepOver();
+
+  lldb::addr_t GetDisplacedStepScratch();
+
+  llvm::Optional<uint64_t> GetAuxvValue(uint64_t type);
+
+  // Read a pointer sized value, in the inferior's byte order.
+  Status ReadPointer(lldb::addr_t addr, lldb::addr_t &value);
+
+  bool StartDisplacedStep(NativeThreadLinux &thread);
+
+  // Move "thread" out of the scratch area: to where the instruction took it
+  // if it completed, back to the breakpoint otherwise. "count_incomplete"
+  // says whether the hit still counts as skipped in the latter case, i.e.
+  // the thread won't execute the breakpoint again.
+  void FinishDisplacedStep(NativeThreadLinux &thread, bool count_incomplete);
+
+  void RestoreDisplacedStepScratch();
+
+  void StartNextDisplacedStep();
+
 #if 0
         static ::ProcessMessage::CrashReason
         GetCrashReasonForSIGSEGV(const siginfo_t *info);
@@ -243,6 +315,14 @@ private:
 
   Status PopulateMemoryRegionCache();
 
+  // Fast paths for WriteMemory(). Both return the number of bytes that were
+  // written, which can be less than "size" if the write failed part way.
+  size_t WriteMemoryWithProcessVmWritev(lldb::addr_t addr, const void *buf,
+                                        size_t size);
+
+  size_t WriteMemoryWithProcMem(lldb::addr_t addr, const void *buf,
+                                size_t size);
+
   lldb::user_id_t StartTraceGroup(const TraceOptions &config,
                                          Status &error);
 
@@ -302,6 +302,12 @@ size_t ProcessElfCore::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
   return DoReadMemory(addr, buf, size, error);
 }
 
+size_t ProcessElfCore::ReadMemoryRanges(
+    llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  // Same as above, the memory cache would only add another copy.
+  return ReadMemoryRangesFromInferior(ranges);
+}
+
 Status ProcessElfCore::GetMemoryRegionInfo(lldb::addr_t load_addr,
                                            MemoryRegionInfo &region_info) {
   region_info.Clear();
@@ -397,6 +403,30 @@ size_t ProcessElfCore::DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
   return bytes_copied + zero_fill_size;
 }
 
+size_t ProcessElfCore::GetMemoryData(lldb::addr_t addr, size_t size,
+                                     DataExtractor &data) {
+  ObjectFile *core_objfile = m_core_module_sp->GetObjectFile();
+
+  if (core_objfile == NULL)
+    return 0;
+
+  const VMRangeToFileOffset::Entry *address_range =
+      m_core_aranges.FindEntryThatContains(addr);
+  if (address_range == NULL)
+    return 0;
+
+  // The core file is mapped in its entirety, so memory that is all in the
+  // file can be referenced in place. Memory that isn't, and would have to be
+  // zero filled, needs a copy.
+  const lldb::addr_t offset = addr - address_range->GetRangeBase();
+  const lldb::addr_t file_start = address_range->data.GetRangeBase();
+  const lldb::addr_t file_end = address_range->data.GetRangeEnd();
+  if (file_start + offset > file_end || size > file_end - (file_start + offset))
+    return 0;
+
+  return core_objfile->GetData(file_start + offset, size, data);
+}
+
 void ProcessElfCore::Clear() {
   m_thread_list.Clear();
 
@@ -106,9 +106,15 @@ public:
   size_t ReadMemory(lldb::addr_t addr, void *buf, size_t size,
                     lldb_private::Status &error) override;
 
+  size_t ReadMemoryRanges(
+      llvm::MutableArrayRef<lldb_private::MemoryReadRange> ranges) override;
+
   size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                       lldb_private::Status &error) override;
 
+  size_t GetMemoryData(lldb::addr_t addr, size_t size,
+                       lldb_private::DataExtractor &data) override;
+
   lldb_private::Status
   GetMemoryRegionInfo(lldb::addr_t load_addr,
                       lldb_private::MemoryRegionInfo &region_info) override;
@@ -192,17 +192,22 @@ GDBRemoteClientBase::SendPacketAndReceiveResponseWithOutputSupport(
     return PacketResult::ErrorSendFailed;
   }
 
+  const auto start = std::chrono::steady_clock::now();
   PacketResult packet_result = SendPacketNoLock(payload);
   if (packet_result != PacketResult::Success)
     return packet_result;
 
-  return ReadPacketWithOutputSupport(response, GetPacketTimeout(), true,
-                                     output_callback);
+  packet_result = ReadPacketWithOutputSupport(response, GetPacketTimeout(),
+                                              true, output_callback);
+  if (packet_result == PacketResult::Success)
+    m_round_trip_times.Add(std::chrono::steady_clock::now() - start);
+  return packet_result;
 }
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteClientBase::SendPacketAndWaitForResponseNoLock(
     llvm::StringRef payload, StringExtractorGDBRemote &response) {
+  const auto start = std::chrono::steady_clock::now();
   PacketResult packet_result = SendPacketNoLock(payload);
   if (packet_result != PacketResult::Success)
     return packet_result;
@@ -214,8 +219,10 @@ GDBRemoteClientBase::SendPacketAndWaitForResponseNoLock(
     if (packet_result != PacketResult::Success)
       return packet_result;
     // Make sure our response is valid for the payload that was sent
-    if (response.ValidateResponse())
+    if (response.ValidateResponse()) {
+      m_round_trip_times.Add(std::chrono::steady_clock::now() - start);
       return packet_result;
+    }
     // Response says it wasn't valid
     Log *log = ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS);
     if (log)
@@ -12,6 +12,8 @@
 
 #include "GDBRemoteCommunication.h"
 
+#include "lldb/Target/Statistics.h"
+
 #include <condition_variable>
 
 namespace lldb_private {
@@ -56,6 +58,12 @@ public:
   bool SendvContPacket(llvm::StringRef payload,
                        StringExtractorGDBRemote &response);
 
+  // The time between sending a packet and receiving its response, for the
+  // packets that expect one right away.
+  const LatencyHistogram &GetRoundTripTimes() const {
+    return m_round_trip_times;
+  }
+
   class Lock {
   public:
     Lock(GDBRemoteClientBase &comm, bool interrupt);
@@ -104,6 +112,9 @@ private:
   //   thread needs to wait for them to finish (m_async_count goes down to 0).
   std::mutex m_mutex;
   std::condition_variable m_cv;
+
+  LatencyHistogram m_round_trip_times;
+
   // Packet with which to resume after an async interrupt. Can be changed by an
   // async thread
   // e.g. to inject a signal.
@@ -17,6 +17,7 @@
 // C++ Includes
 // Other libraries and framework includes
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Host/Config.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/HostInfo.h"
@@ -50,6 +51,10 @@
 #include <zlib.h>
 #endif
 
+#if defined(HAVE_LIBLZ4)
+#include <lz4.h>
+#endif
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::process_gdb_remote;
@@ -139,7 +144,8 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
 #endif
       m_echo_number(0), m_supports_qEcho(eLazyBoolCalculate), m_history(512),
       m_send_acks(true), m_compression_type(CompressionType::None),
-      m_listen_url() {
+      m_send_compression_type(CompressionType::None),
+      m_send_compression_min_size(384), m_listen_url() {
 }
 
 //----------------------------------------------------------------------
@@ -193,6 +199,12 @@ GDBRemoteCommunication::SendPacketNoLock(llvm::StringRef payload) {
   if (IsConnected()) {
     StreamString packet(0, 4, eByteOrderBig);
 
+    std::string compressed_payload;
+    if (m_send_compression_type != CompressionType::None) {
+      compressed_payload = CompressPayload(payload);
+      payload = compressed_payload;
+    }
+
     packet.PutChar('$');
     packet.Write(payload.data(), payload.size());
     packet.PutChar('#');
@@ -246,6 +258,8 @@ GDBRemoteCommunication::SendPacketNoLock(llvm::StringRef payload) {
 
     m_history.AddPacket(packet.GetString(), packet_length,
                         History::ePacketTypeSend, bytes_written);
+    ++m_packets_sent;
+    m_bytes_sent += bytes_written;
 
     if (bytes_written == packet_length) {
       if (GetSendAcks())
@@ -672,6 +686,19 @@ bool GDBRemoteCommunication::DecompressPacket() {
   }
 #endif
 
+#if defined(HAVE_LIBLZ4)
+  if (decompressed_bytes == 0 && decompressed_bufsize != ULONG_MAX &&
+      decompressed_buffer != nullptr &&
+      m_compression_type == CompressionType::LZ4) {
+    int status = LZ4_decompress_safe((const char *)unescaped_content.data(),
+                                     (char *)decompressed_buffer,
+                                     (int)unescaped_content.size(),
+                                     (int)decompressed_bufsize);
+    if (status > 0)
+      decompressed_bytes = status;
+  }
+#endif
+
   if (decompressed_bytes == 0 || decompressed_buffer == nullptr) {
     if (decompressed_buffer)
       free(decompressed_buffer);
@@ -702,6 +729,87 @@ bool GDBRemoteCommunication::DecompressPacket() {
   return true;
 }
 
+bool GDBRemoteCommunication::CanCompressWith(CompressionType type) {
+  switch (type) {
+  case CompressionType::None:
+    return true;
+#if defined(HAVE_LIBZ)
+  case CompressionType::ZlibDeflate:
+    return true;
+#endif
+#if defined(HAVE_LIBLZ4)
+  case CompressionType::LZ4:
+    return true;
+#endif
+  default:
+    return false;
+  }
+}
+
+std::string GDBRemoteCommunication::CompressPayload(llvm::StringRef payload) {
+  std::string body;
+  if (payload.size() >= m_send_compression_min_size) {
+    std::vector<uint8_t> compressed;
+    size_t compressed_size = 0;
+
+#if defined(HAVE_LIBZ)
+    if (m_send_compression_type == CompressionType::ZlibDeflate) {
+      // Raw deflate (no zlib header) which is what the receiving side and
+      // libcompression's COMPRESSION_ZLIB expect. Favor speed over ratio, the
+      // packet is on the critical path of every stop.
+      z_stream stream;
+      memset(&stream, 0, sizeof(z_stream));
+      if (deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, -15, 8,
+                       Z_DEFAULT_STRATEGY) == Z_OK) {
+        compressed.resize(deflateBound(&stream, payload.size()));
+        stream.next_in = (Bytef *)payload.data();
+        stream.avail_in = (uInt)payload.size();
+        stream.next_out = (Bytef *)compressed.data();
+        stream.avail_out = (uInt)compressed.size();
+        if (deflate(&stream, Z_FINISH) == Z_STREAM_END)
+          compressed_size = stream.total_out;
+        deflateEnd(&stream);
+      }
+    }
+#endif
+
+#if defined(HAVE_LIBLZ4)
+    if (m_send_compression_type == CompressionType::LZ4) {
+      compressed.resize(LZ4_compressBound((int)payload.size()));
+      int status = LZ4_compress_default(payload.data(),
+                                        (char *)compressed.data(),
+                                        (int)payload.size(),
+                                        (int)compressed.size());
+      if (status > 0)
+        compressed_size = status;
+    }
+#endif
+
+    if (compressed_size > 0 && compressed_size < payload.size()) {
+      body.reserve(compressed_size + compressed_size / 16 + 24);
+      body.push_back('C');
+      body.append(std::to_string(payload.size()));
+      body.push_back(':');
+      // Escape the characters that would end or corrupt the packet, the
+      // receiver reverses this before decompressing.
+      for (size_t i = 0; i < compressed_size; ++i) {
+        const char ch = compressed[i];
+        if (ch == '#' || ch == '$' || ch == '}' || ch == '*') {
+          body.push_back('}');
+          body.push_back(ch ^ 0x20);
+        } else
+          body.push_back(ch);
+      }
+      return body;
+    }
+  }
+
+  body.reserve(payload.size() + 1);
+  body.push_back('N');
+  body.append(payload.data(), payload.size());
+  return body;
+}
+
 GDBRemoteCommunication::PacketType
 GDBRemoteCommunication::CheckForPacket(const uint8_t *src, size_t src_len,
                                        StringExtractorGDBRemote &packet) {
@@ -877,6 +985,8 @@ GDBRemoteCommunication::CheckForPacket(const uint8_t *src, size_t src_len,
 
       m_history.AddPacket(m_bytes, total_length, History::ePacketTypeRecv,
                           total_length);
+      ++m_packets_received;
+      m_bytes_received += total_length;
 
       // Clear packet_str in case there is some existing data in it.
       packet_str.clear();
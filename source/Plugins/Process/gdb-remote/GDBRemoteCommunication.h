@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
@@ -141,6 +142,13 @@ public:
 
   void DumpHistory(Stream &strm);
 
+  // Totals for the packets that went over this connection, not counting
+  // acks. Received packets are counted after decompression.
+  uint64_t GetNumPacketsSent() const { return m_packets_sent; }
+  uint64_t GetNumBytesSent() const { return m_bytes_sent; }
+  uint64_t GetNumPacketsReceived() const { return m_packets_received; }
+  uint64_t GetNumBytesReceived() const { return m_bytes_received; }
+
 protected:
   class History {
   public:
@@ -220,12 +228,22 @@ protected:
   uint32_t m_echo_number;
   LazyBool m_supports_qEcho;
   History m_history;
+  std::atomic<uint64_t> m_packets_sent{0};
+  std::atomic<uint64_t> m_bytes_sent{0};
+  std::atomic<uint64_t> m_packets_received{0};
+  std::atomic<uint64_t> m_bytes_received{0};
   bool m_send_acks;
   bool m_is_platform; // Set to true if this class represents a platform,
                       // false if this class represents a debug session for
                       // a single process
 
   CompressionType m_compression_type;
+  // Compression used for the packets we send. Only a stub sets this, after
+  // the client asked for it with QEnableCompression; the client's packets are
+  // never compressed. Payloads shorter than m_send_compression_min_size are
+  // sent as "$N<payload>" because compressing them doesn't pay off.
+  CompressionType m_send_compression_type;
+  size_t m_send_compression_min_size;
 
   PacketResult SendPacketNoLock(llvm::StringRef payload);
 
@@ -260,6 +278,15 @@ protected:
   // on m_bytes.  The checksum was for the compressed packet.
   bool DecompressPacket();
 
+  // Returns true if packets can be compressed with "type" before they are
+  // sent, i.e. the library that implements it was available at build time.
+  static bool CanCompressWith(CompressionType type);
+
+  // Turn "payload" into the body of a packet that is sent with
+  // m_send_compression_type enabled: "C<decompressed size>:<escaped data>"
+  // if it compressed well, "N<payload>" otherwise.
+  std::string CompressPayload(llvm::StringRef payload);
+
   Status StartListenThread(const char *hostname = "127.0.0.1",
                            uint16_t port = 0);
 
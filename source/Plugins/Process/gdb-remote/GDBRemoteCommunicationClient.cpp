@@ -14,6 +14,7 @@
 #include <sys/stat.h>
 
 // C++ Includes
+#include <deque>
 #include <numeric>
 #include <sstream>
 
@@ -77,6 +78,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_prepare_for_reg_writing_reply(eLazyBoolCalculate),
       m_supports_p(eLazyBoolCalculate), m_supports_x(eLazyBoolCalculate),
       m_avoid_g_packets(eLazyBoolCalculate),
+      m_read_registers_with_g_packet(eLazyBoolCalculate),
       m_supports_QSaveRegisterState(eLazyBoolCalculate),
       m_supports_qXfer_auxv_read(eLazyBoolCalculate),
       m_supports_qXfer_libraries_read(eLazyBoolCalculate),
@@ -89,6 +91,9 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_supports_jGetSharedCacheInfo(eLazyBoolCalculate),
       m_supports_QPassSignals(eLazyBoolCalculate),
       m_supports_error_string_reply(eLazyBoolCalculate),
+      m_supports_jMemoryReadMulti(eLazyBoolCalculate),
+      m_supports_conditional_breakpoints(eLazyBoolCalculate),
+      m_supports_breakpoint_ignore_counts(eLazyBoolCalculate),
       m_supports_qProcessInfoPID(true), m_supports_qfProcessInfo(true),
       m_supports_qUserName(true), m_supports_qGroupName(true),
       m_supports_qThreadStopInfo(true), m_supports_z0(true),
@@ -104,7 +109,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_os_version_update(UINT32_MAX), m_os_build(), m_os_kernel(),
       m_hostname(), m_gdb_server_name(), m_gdb_server_version(UINT32_MAX),
       m_default_packet_timeout(0), m_max_packet_size(0),
-      m_qSupported_response(), m_supported_async_json_packets_is_valid(false),
+      m_qSupported_response(), m_use_packet_compression(true),
+      m_supported_async_json_packets_is_valid(false),
       m_supported_async_json_packets_sp(), m_qXfer_memory_map(),
       m_qXfer_memory_map_loaded(false) {}
 
@@ -202,6 +208,27 @@ bool GDBRemoteCommunicationClient::GetQXferMemoryMapReadSupported() {
   return m_supports_qXfer_memory_map_read == eLazyBoolYes;
 }
 
+bool GDBRemoteCommunicationClient::GetMemoryReadMultiSupported() {
+  if (m_supports_jMemoryReadMulti == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_jMemoryReadMulti == eLazyBoolYes;
+}
+
+bool GDBRemoteCommunicationClient::GetConditionalBreakpointsSupported() {
+  if (m_supports_conditional_breakpoints == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_conditional_breakpoints == eLazyBoolYes;
+}
+
+bool GDBRemoteCommunicationClient::GetBreakpointIgnoreCountsSupported() {
+  if (m_supports_breakpoint_ignore_counts == eLazyBoolCalculate) {
+    GetRemoteQSupported();
+  }
+  return m_supports_breakpoint_ignore_counts == eLazyBoolYes;
+}
+
 uint64_t GDBRemoteCommunicationClient::GetRemoteMaxPacketSize() {
   if (m_max_packet_size == 0) {
     GetRemoteQSupported();
@@ -302,11 +329,15 @@ void GDBRemoteCommunicationClient::ResetDiscoverableSettings(bool did_exec) {
     m_prepare_for_reg_writing_reply = eLazyBoolCalculate;
     m_attach_or_wait_reply = eLazyBoolCalculate;
     m_avoid_g_packets = eLazyBoolCalculate;
+    m_read_registers_with_g_packet = eLazyBoolCalculate;
     m_supports_qXfer_auxv_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_read = eLazyBoolCalculate;
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
     m_supports_qXfer_features_read = eLazyBoolCalculate;
     m_supports_qXfer_memory_map_read = eLazyBoolCalculate;
+    m_supports_jMemoryReadMulti = eLazyBoolCalculate;
+    m_supports_conditional_breakpoints = eLazyBoolCalculate;
+    m_supports_breakpoint_ignore_counts = eLazyBoolCalculate;
     m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
@@ -354,6 +385,9 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
   m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
   m_supports_qXfer_features_read = eLazyBoolNo;
   m_supports_qXfer_memory_map_read = eLazyBoolNo;
+  m_supports_jMemoryReadMulti = eLazyBoolNo;
+  m_supports_conditional_breakpoints = eLazyBoolNo;
+  m_supports_breakpoint_ignore_counts = eLazyBoolNo;
   m_max_packet_size = UINT64_MAX; // It's supposed to always be there, but if
                                   // not, we assume no limit
 
@@ -391,47 +425,49 @@ void GDBRemoteCommunicationClient::GetRemoteQSupported() {
       m_supports_qXfer_features_read = eLazyBoolYes;
     if (::strstr(response_cstr, "qXfer:memory-map:read+"))
       m_supports_qXfer_memory_map_read = eLazyBoolYes;
+    if (::strstr(response_cstr, "jMemoryReadMulti+"))
+      m_supports_jMemoryReadMulti = eLazyBoolYes;
+    if (::strstr(response_cstr, "ConditionalBreakpoints+"))
+      m_supports_conditional_breakpoints = eLazyBoolYes;
+    if (::strstr(response_cstr, "BreakpointIgnoreCounts+"))
+      m_supports_breakpoint_ignore_counts = eLazyBoolYes;
 
     // Look for a list of compressions in the features list e.g.
     // qXfer:features:read+;PacketSize=20000;qEcho+;SupportedCompressions=zlib-deflate,lzma
-    const char *features_list = ::strstr(response_cstr, "qXfer:features:");
-    if (features_list) {
-      const char *compressions =
-          ::strstr(features_list, "SupportedCompressions=");
-      if (compressions) {
-        std::vector<std::string> supported_compressions;
-        compressions += sizeof("SupportedCompressions=") - 1;
-        const char *end_of_compressions = strchr(compressions, ';');
-        if (end_of_compressions == NULL) {
-          end_of_compressions = strchr(compressions, '\0');
+    const char *compressions = ::strstr(response_cstr, "SupportedCompressions=");
+    if (compressions) {
+      std::vector<std::string> supported_compressions;
+      compressions += sizeof("SupportedCompressions=") - 1;
+      const char *end_of_compressions = strchr(compressions, ';');
+      if (end_of_compressions == NULL) {
+        end_of_compressions = strchr(compressions, '\0');
+      }
+      const char *current_compression = compressions;
+      while (current_compression < end_of_compressions) {
+        const char *next_compression_name = strchr(current_compression, ',');
+        const char *end_of_this_word = next_compression_name;
+        if (next_compression_name == NULL ||
+            end_of_compressions < next_compression_name) {
+          end_of_this_word = end_of_compressions;
         }
-        const char *current_compression = compressions;
-        while (current_compression < end_of_compressions) {
-          const char *next_compression_name = strchr(current_compression, ',');
-          const char *end_of_this_word = next_compression_name;
-          if (next_compression_name == NULL ||
-              end_of_compressions < next_compression_name) {
-            end_of_this_word = end_of_compressions;
-          }
 
-          if (end_of_this_word) {
-            if (end_of_this_word == current_compression) {
-              current_compression++;
-            } else {
-              std::string this_compression(
-                  current_compression, end_of_this_word - current_compression);
-              supported_compressions.push_back(this_compression);
-              current_compression = end_of_this_word + 1;
-            }
+        if (end_of_this_word) {
+          if (end_of_this_word == current_compression) {
+            current_compression++;
           } else {
-            supported_compressions.push_back(current_compression);
-            current_compression = end_of_compressions;
+            std::string this_compression(
+                current_compression, end_of_this_word - current_compression);
+            supported_compressions.push_back(this_compression);
+            current_compression = end_of_this_word + 1;
           }
+        } else {
+          supported_compressions.push_back(current_compression);
+          current_compression = end_of_compressions;
         }
+      }
 
-        if (supported_compressions.size() > 0) {
-          MaybeEnableCompression(supported_compressions);
-        }
+      if (supported_compressions.size() > 0) {
+        MaybeEnableCompression(supported_compressions);
       }
     }
 
@@ -1041,6 +1077,9 @@ bool GDBRemoteCommunicationClient::GetGDBServerVersion() {
 
 void GDBRemoteCommunicationClient::MaybeEnableCompression(
     std::vector<std::string> supported_compressions) {
+  if (!m_use_packet_compression)
+    return;
+
   CompressionType avail_type = CompressionType::None;
   std::string avail_name;
 
@@ -1092,6 +1131,18 @@ void GDBRemoteCommunicationClient::MaybeEnableCompression(
   }
 #endif
 
+#if defined(HAVE_LIBLZ4)
+  if (avail_type == CompressionType::None) {
+    for (auto compression : supported_compressions) {
+      if (compression == "lz4") {
+        avail_type = CompressionType::LZ4;
+        avail_name = compression;
+        break;
+      }
+    }
+  }
+#endif
+
 #if defined(HAVE_LIBCOMPRESSION)
   if (avail_type == CompressionType::None) {
     for (auto compression : supported_compressions) {
@@ -2667,7 +2718,8 @@ bool GDBRemoteCommunicationClient::GetThreadStopInfo(
 }
 
 uint8_t GDBRemoteCommunicationClient::SendGDBStoppointTypePacket(
-    GDBStoppointType type, bool insert, addr_t addr, uint32_t length) {
+    GDBStoppointType type, bool insert, addr_t addr, uint32_t length,
+    llvm::ArrayRef<std::vector<uint8_t>> conditions, uint32_t ignore_count) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
   if (log)
     log->Printf("GDBRemoteCommunicationClient::%s() %s at addr = 0x%" PRIx64,
@@ -2677,19 +2729,24 @@ uint8_t GDBRemoteCommunicationClient::SendGDBStoppointTypePacket(
   if (!SupportsGDBStoppointPacket(type))
     return UINT8_MAX;
   // Construct the breakpoint packet
-  char packet[64];
-  const int packet_len =
-      ::snprintf(packet, sizeof(packet), "%c%i,%" PRIx64 ",%x",
-                 insert ? 'Z' : 'z', type, addr, length);
-  // Check we haven't overwritten the end of the packet buffer
-  assert(packet_len + 1 < (int)sizeof(packet));
-  UNUSED_IF_ASSERT_DISABLED(packet_len);
+  StreamString packet;
+  packet.Printf("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', type, addr, length);
+  // Conditions and ignore counts are only understood when inserting a
+  // breakpoint.
+  if (insert) {
+    for (const std::vector<uint8_t> &condition : conditions) {
+      packet.Printf(";X%x,", (unsigned)condition.size());
+      packet.PutBytesAsRawHex8(condition.data(), condition.size());
+    }
+    if (ignore_count > 0)
+      packet.Printf(";I%x", ignore_count);
+  }
   StringExtractorGDBRemote response;
   // Make sure the response is either "OK", "EXX" where XX are two hex digits,
   // or "" (unsupported)
   response.SetResponseValidatorToOKErrorNotSupported();
   // Try to send the breakpoint packet, and check that it was correctly sent
-  if (SendPacketAndWaitForResponse(packet, response, true) ==
+  if (SendPacketAndWaitForResponse(packet.GetString(), response, true) ==
       PacketResult::Success) {
     // Receive and OK packet when the breakpoint successfully placed
     if (response.IsOKResponse())
@@ -2990,6 +3047,24 @@ GDBRemoteCommunicationClient::GetFilePermissions(const FileSpec &file_spec,
   return error;
 }
 
+// Parse the reply to a vFile:pread packet into \a buffer. Returns false
+// if the read failed.
+static bool ParseFileReadResponse(StringExtractorGDBRemote &response,
+                                  std::string &buffer) {
+  buffer.clear();
+  if (response.GetChar() != 'F')
+    return false;
+  uint32_t retcode = response.GetHexMaxU32(false, UINT32_MAX);
+  if (retcode == UINT32_MAX)
+    return false;
+  const char next = (response.Peek() ? *response.Peek() : 0);
+  if (next != ';')
+    return false;
+  response.GetChar(); // skip the semicolon
+  response.GetEscapedBinaryData(buffer);
+  return true;
+}
+
 uint64_t GDBRemoteCommunicationClient::ReadFile(lldb::user_id_t fd,
                                                 uint64_t offset, void *dst,
                                                 uint64_t dst_len,
@@ -3000,29 +3075,109 @@ uint64_t GDBRemoteCommunicationClient::ReadFile(lldb::user_id_t fd,
   StringExtractorGDBRemote response;
   if (SendPacketAndWaitForResponse(stream.GetString(), response, false) ==
       PacketResult::Success) {
-    if (response.GetChar() != 'F')
-      return 0;
-    uint32_t retcode = response.GetHexMaxU32(false, UINT32_MAX);
-    if (retcode == UINT32_MAX)
-      return retcode;
-    const char next = (response.Peek() ? *response.Peek() : 0);
-    if (next == ',')
-      return 0;
-    if (next == ';') {
-      response.GetChar(); // skip the semicolon
-      std::string buffer;
-      if (response.GetEscapedBinaryData(buffer)) {
-        const uint64_t data_to_write =
-            std::min<uint64_t>(dst_len, buffer.size());
-        if (data_to_write > 0)
-          memcpy(dst, &buffer[0], data_to_write);
-        return data_to_write;
-      }
+    std::string buffer;
+    if (ParseFileReadResponse(response, buffer)) {
+      const uint64_t data_to_write =
+          std::min<uint64_t>(dst_len, buffer.size());
+      if (data_to_write > 0)
+        memcpy(dst, &buffer[0], data_to_write);
+      return data_to_write;
     }
   }
   return 0;
 }
 
+uint64_t GDBRemoteCommunicationClient::ReadFileRange(
+    lldb::user_id_t fd, uint64_t offset, uint64_t size, uint64_t chunk_size,
+    uint32_t window, llvm::function_ref<bool(llvm::ArrayRef<uint8_t>)> callback,
+    Status &error) {
+  Lock lock(*this, false);
+  if (!lock) {
+    error.SetErrorString("failed to get the packet lock");
+    return 0;
+  }
+
+  // With acks on, a reply could arrive while we wait for the ack of a
+  // later request, so only pipeline without them.
+  if (GetSendAcks() || window == 0)
+    window = 1;
+  chunk_size = std::max<uint64_t>(chunk_size, 1);
+
+  // The replies come back in the order the requests went out. Remember
+  // what each one asked for, so a short read can be detected.
+  std::deque<uint64_t> in_flight;
+  const uint64_t end = size > UINT64_MAX - offset ? UINT64_MAX : offset + size;
+  uint64_t next_request = offset;
+  uint64_t bytes_read = 0;
+  bool done = false;
+  std::string buffer;
+  while (true) {
+    while (!done && in_flight.size() < window && next_request < end) {
+      const uint64_t length = std::min(chunk_size, end - next_request);
+      StreamString packet;
+      packet.Printf("vFile:pread:%i,%" PRId64 ",%" PRId64, (int)fd, length,
+                    next_request);
+      if (SendPacketNoLock(packet.GetString()) != PacketResult::Success) {
+        error.SetErrorStringWithFormat("failed to send '%s' packet",
+                                       packet.GetData());
+        done = true;
+        break;
+      }
+      in_flight.push_back(length);
+      next_request += length;
+    }
+    if (in_flight.empty())
+      break;
+
+    StringExtractorGDBRemote response;
+    if (ReadPacket(response, GetPacketTimeout(), true) !=
+        PacketResult::Success) {
+      // The remaining replies can't be told apart from whatever comes
+      // next, so give up on the connection's current state.
+      error.SetErrorString("failed to read vFile:pread response");
+      return bytes_read;
+    }
+    const uint64_t requested = in_flight.front();
+    in_flight.pop_front();
+    // Drain the replies to requests made before the transfer ended.
+    if (done)
+      continue;
+
+    if (!ParseFileReadResponse(response, buffer)) {
+      error.SetErrorString("vFile:pread failed");
+      done = true;
+      continue;
+    }
+    if (!buffer.empty()) {
+      const uint64_t length = std::min<uint64_t>(buffer.size(), requested);
+      if (!callback(llvm::ArrayRef<uint8_t>(
+              reinterpret_cast<const uint8_t *>(buffer.data()), length))) {
+        done = true;
+        continue;
+      }
+      bytes_read += length;
+    }
+    if (buffer.empty()) {
+      // End of file.
+      done = true;
+    } else if (buffer.size() < requested) {
+      // The server may return less than was asked for. The requests after
+      // this one have the wrong offsets, so drop their replies and carry
+      // on from here once they are in.
+      next_request = offset + bytes_read;
+      while (!in_flight.empty()) {
+        if (ReadPacket(response, GetPacketTimeout(), true) !=
+            PacketResult::Success) {
+          error.SetErrorString("failed to read vFile:pread response");
+          return bytes_read;
+        }
+        in_flight.pop_front();
+      }
+    }
+  }
+  return bytes_read;
+}
+
 uint64_t GDBRemoteCommunicationClient::WriteFile(lldb::user_id_t fd,
                                                  uint64_t offset,
                                                  const void *src,
@@ -3671,6 +3826,105 @@ GDBRemoteCommunicationClient::GetModulesInfo(
   return result;
 }
 
+bool GDBRemoteCommunicationClient::ReadMemoryRanges(
+    llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  if (m_supports_jMemoryReadMulti == eLazyBoolNo)
+    return false;
+  if (ranges.empty())
+    return true;
+
+  JSONArray::SP range_array_sp = std::make_shared<JSONArray>();
+  for (const MemoryReadRange &range : ranges) {
+    JSONObject::SP range_sp = std::make_shared<JSONObject>();
+    range_array_sp->AppendObject(range_sp);
+    range_sp->SetObject("address", std::make_shared<JSONNumber>(range.addr));
+    range_sp->SetObject("size",
+                        std::make_shared<JSONNumber>((uint64_t)range.size));
+  }
+  StreamString unescaped_payload;
+  unescaped_payload.PutCString("jMemoryReadMulti:");
+  range_array_sp->Write(unescaped_payload);
+  StreamGDBRemote payload;
+  payload.PutEscapedBytes(unescaped_payload.GetString().data(),
+                          unescaped_payload.GetSize());
+
+  Lock lock(*this, true);
+  if (!lock) {
+    if (Log *log = ProcessGDBRemoteLog::GetLogIfAnyCategoryIsSet(
+            GDBR_LOG_PROCESS | GDBR_LOG_MEMORY))
+      log->Printf("GDBRemoteCommunicationClient::%s failed to get mutex, not "
+                  "sending jMemoryReadMulti packet",
+                  __FUNCTION__);
+    return false;
+  }
+  if (SendPacketNoLock(payload.GetString()) != PacketResult::Success)
+    return false;
+
+  for (MemoryReadRange &range : ranges)
+    range.bytes_read = 0;
+
+  // The reply is a stream of 'b' packets terminated by "OK". Each 'b' packet
+  // holds one or more "<length>;<binary data>" records with the data of the
+  // ranges, in order. A range ends when all of its bytes have been received
+  // or with a zero length record. The packet receive layer has already
+  // removed the binary escaping.
+  size_t range_idx = 0;
+  bool first_packet = true;
+  bool valid = true;
+  while (true) {
+    StringExtractorGDBRemote response;
+    if (ReadPacket(response, GetPacketTimeout(), true) != PacketResult::Success)
+      return false;
+    if (response.IsOKResponse())
+      break;
+    if (first_packet) {
+      if (response.IsUnsupportedResponse())
+        m_supports_jMemoryReadMulti = eLazyBoolNo;
+      if (response.IsUnsupportedResponse() || response.IsErrorResponse())
+        return false;
+      first_packet = false;
+    }
+
+    // Keep reading until the end of the stream after an invalid packet so
+    // that the rest of it isn't taken as the reply to the next packet.
+    llvm::StringRef data(response.GetStringRef());
+    if (!data.consume_front("b"))
+      valid = false;
+    while (valid && !data.empty()) {
+      while (range_idx < ranges.size() &&
+             ranges[range_idx].bytes_read == ranges[range_idx].size)
+        ++range_idx;
+      const size_t separator_pos = data.find(';');
+      uint64_t length;
+      if (range_idx == ranges.size() ||
+          separator_pos == llvm::StringRef::npos ||
+          data.take_front(separator_pos).getAsInteger(16, length)) {
+        valid = false;
+        break;
+      }
+      data = data.drop_front(separator_pos + 1);
+
+      MemoryReadRange &range = ranges[range_idx];
+      if (length > range.size - range.bytes_read || length > data.size()) {
+        valid = false;
+        break;
+      }
+      memcpy(static_cast<uint8_t *>(range.buf) + range.bytes_read, data.data(),
+             length);
+      range.bytes_read += length;
+      data = data.drop_front(length);
+      if (length == 0)
+        ++range_idx;
+    }
+  }
+
+  if (!valid) {
+    for (MemoryReadRange &range : ranges)
+      range.bytes_read = 0;
+  }
+  return valid;
+}
+
 // query the target remote for extended information using the qXfer packet
 //
 // example: object='features', annex='target.xml', out=<xml output>
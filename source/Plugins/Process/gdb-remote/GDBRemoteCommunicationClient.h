@@ -25,7 +25,9 @@
 #include "lldb/Utility/StreamGDBRemote.h"
 #include "lldb/Utility/StructuredData.h"
 
+#include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 
 namespace lldb_private {
 namespace process_gdb_remote {
@@ -318,7 +320,12 @@ public:
       GDBStoppointType type, // Type of breakpoint or watchpoint
       bool insert,           // Insert or remove?
       lldb::addr_t addr,     // Address of breakpoint or watchpoint
-      uint32_t length);      // Byte Size of breakpoint or watchpoint
+      uint32_t length,       // Byte Size of breakpoint or watchpoint
+      // Agent expression bytecode of the conditions under which the stub
+      // should report a software breakpoint
+      llvm::ArrayRef<std::vector<uint8_t>> conditions = {},
+      // Number of hits of a software breakpoint the stub should skip
+      uint32_t ignore_count = 0);
 
   bool SetNonStopMode(const bool enable);
 
@@ -357,6 +364,23 @@ public:
 
   bool GetQXferMemoryMapReadSupported();
 
+  bool GetMemoryReadMultiSupported();
+
+  // Whether the stub can evaluate breakpoint conditions sent along with a
+  // "Z0" packet.
+  bool GetConditionalBreakpointsSupported();
+
+  // Whether the stub can skip the first hits of a software breakpoint
+  // itself, given an ignore count with the "Z0" packet.
+  bool GetBreakpointIgnoreCountsSupported();
+
+  // Whether to ask the stub to compress its packets when it offers to in its
+  // qSupported reply. Must be set before the reply is processed to have an
+  // effect.
+  void SetUsePacketCompression(bool enable) {
+    m_use_packet_compression = enable;
+  }
+
   LazyBool SupportsAllocDeallocMemory() // const
   {
     // Uncomment this to have lldb pretend the debug server doesn't respond to
@@ -384,6 +408,22 @@ public:
   uint64_t ReadFile(lldb::user_id_t fd, uint64_t offset, void *dst,
                     uint64_t dst_len, Status &error);
 
+  //------------------------------------------------------------------
+  /// Read \a size bytes of the open file \a fd starting at \a offset,
+  /// with up to \a window vFile:pread packets of \a chunk_size bytes
+  /// in flight at once, and pass the data to \a callback in file order.
+  /// The transfer stops at the end of the file, or when \a callback
+  /// returns false.
+  ///
+  /// @return
+  ///     The number of bytes passed to \a callback.
+  //------------------------------------------------------------------
+  uint64_t
+  ReadFileRange(lldb::user_id_t fd, uint64_t offset, uint64_t size,
+                uint64_t chunk_size, uint32_t window,
+                llvm::function_ref<bool(llvm::ArrayRef<uint8_t>)> callback,
+                Status &error);
+
   uint64_t WriteFile(lldb::user_id_t fd, uint64_t offset, const void *src,
                      uint64_t src_len, Status &error);
 
@@ -435,6 +475,17 @@ public:
 
   bool AvoidGPackets(ProcessGDBRemote *process);
 
+  // Whether registers that aren't cached may be fetched with a g packet
+  // for the whole register file. This is separate from AvoidGPackets(),
+  // which also covers register save and restore.
+  bool GetReadRegistersWithGPacket() const {
+    return m_read_registers_with_g_packet != eLazyBoolNo;
+  }
+
+  void SetReadRegistersWithGPacket(bool supported) {
+    m_read_registers_with_g_packet = supported ? eLazyBoolYes : eLazyBoolNo;
+  }
+
   StructuredData::ObjectSP GetThreadsInfo();
 
   bool GetThreadExtendedInfoSupported();
@@ -450,6 +501,12 @@ public:
   GetModulesInfo(llvm::ArrayRef<FileSpec> module_file_specs,
                  const llvm::Triple &triple);
 
+  // Read all of "ranges" with a single jMemoryReadMulti packet. The server
+  // streams the data back without waiting for further requests, so this
+  // works for ranges of any size. Returns false if the packet failed, in
+  // which case none of the ranges were read.
+  bool ReadMemoryRanges(llvm::MutableArrayRef<MemoryReadRange> ranges);
+
   bool ReadExtFeature(const lldb_private::ConstString object,
                       const lldb_private::ConstString annex, std::string &out,
                       lldb_private::Status &err);
@@ -542,6 +599,7 @@ protected:
   LazyBool m_supports_p;
   LazyBool m_supports_x;
   LazyBool m_avoid_g_packets;
+  LazyBool m_read_registers_with_g_packet;
   LazyBool m_supports_QSaveRegisterState;
   LazyBool m_supports_qXfer_auxv_read;
   LazyBool m_supports_qXfer_libraries_read;
@@ -554,6 +612,9 @@ protected:
   LazyBool m_supports_jGetSharedCacheInfo;
   LazyBool m_supports_QPassSignals;
   LazyBool m_supports_error_string_reply;
+  LazyBool m_supports_jMemoryReadMulti;
+  LazyBool m_supports_conditional_breakpoints;
+  LazyBool m_supports_breakpoint_ignore_counts;
 
   bool m_supports_qProcessInfoPID : 1, m_supports_qfProcessInfo : 1,
       m_supports_qUserName : 1, m_supports_qGroupName : 1,
@@ -587,6 +648,7 @@ protected:
   std::chrono::seconds m_default_packet_timeout;
   uint64_t m_max_packet_size;        // as returned by qSupported
   std::string m_qSupported_response; // the complete response to qSupported
+  bool m_use_packet_compression;
 
   bool m_supported_async_json_packets_is_valid;
   lldb_private::StructuredData::ObjectSP m_supported_async_json_packets_sp;
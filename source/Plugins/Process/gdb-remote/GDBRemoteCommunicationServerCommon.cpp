@@ -138,6 +138,9 @@ GDBRemoteCommunicationServerCommon::GDBRemoteCommunicationServerCommon(
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_QStartNoAckMode,
       &GDBRemoteCommunicationServerCommon::Handle_QStartNoAckMode);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+      &GDBRemoteCommunicationServerCommon::Handle_QEnableCompression);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qSupported,
       &GDBRemoteCommunicationServerCommon::Handle_qSupported);
@@ -585,7 +588,10 @@ GDBRemoteCommunicationServerCommon::Handle_vFile_pRead(
         return SendPacketNoLock(response.GetString());
       }
 
-      std::string buffer(count, 0);
+      // Don't let a bogus count make us allocate the world. Clients read
+      // the rest of the chunk with another request when this falls short.
+      const uint64_t max_count = 16 * 1024 * 1024;
+      std::string buffer(std::min(count, max_count), 0);
       const ssize_t bytes_read = ::pread(fd, &buffer[0], buffer.size(), offset);
       const int save_errno = bytes_read == -1 ? errno : 0;
       response.PutChar('F');
@@ -842,10 +848,28 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported(
   response.PutCString(";QThreadSuffixSupported+");
   response.PutCString(";QListThreadsInStopReply+");
   response.PutCString(";qEcho+");
+  response.PutCString(";jMemoryReadMulti+");
+
+  // Compressions are listed in the order we'd like the client to pick them.
+  std::vector<const char *> compressions;
+  if (CanCompressWith(CompressionType::ZlibDeflate))
+    compressions.push_back("zlib-deflate");
+  if (CanCompressWith(CompressionType::LZ4))
+    compressions.push_back("lz4");
+  if (!compressions.empty()) {
+    response.PutCString(";SupportedCompressions=");
+    for (size_t i = 0; i < compressions.size(); ++i)
+      response.Printf("%s%s", i > 0 ? "," : "", compressions[i]);
+  }
 #if defined(__linux__) || defined(__NetBSD__)
   response.PutCString(";QPassSignals+");
   response.PutCString(";qXfer:auxv:read+");
 #endif
+#if defined(__linux__)
+  response.PutCString(";qXfer:libraries-svr4:read+");
+  response.PutCString(";ConditionalBreakpoints+");
+  response.PutCString(";BreakpointIgnoreCounts+");
+#endif
 
   return SendPacketNoLock(response.GetString());
 }
@@ -884,6 +908,43 @@ GDBRemoteCommunicationServerCommon::Handle_QStartNoAckMode(
   return packet_result;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerCommon::Handle_QEnableCompression(
+    StringExtractorGDBRemote &packet) {
+  // QEnableCompression:type:<name>;[minsize:<bytes>;]
+  packet.SetFilePos(::strlen("QEnableCompression:"));
+
+  CompressionType type = CompressionType::None;
+  size_t min_size = m_send_compression_min_size;
+  llvm::StringRef key;
+  llvm::StringRef value;
+  while (packet.GetNameColonValue(key, value)) {
+    if (key == "type")
+      type = llvm::StringSwitch<CompressionType>(value)
+                 .Case("zlib-deflate", CompressionType::ZlibDeflate)
+                 .Case("lz4", CompressionType::LZ4)
+                 .Default(CompressionType::None);
+    else if (key == "minsize" && value.getAsInteger(10, min_size))
+      return SendIllFormedResponse(packet,
+                                   "QEnableCompression: invalid minsize");
+  }
+
+  if (type == CompressionType::None || !CanCompressWith(type))
+    return SendErrorResponse(0x4e);
+
+  // In ack mode the client verifies the checksum of the decompressed packet
+  // as well, which doesn't hold for "$N" packets.
+  if (GetSendAcks())
+    return SendErrorResponse(0x4f);
+
+  // The OK must go out uncompressed, the client only starts decompressing
+  // once it has seen it.
+  PacketResult packet_result = SendOKResponse();
+  m_send_compression_type = type;
+  m_send_compression_min_size = min_size;
+  return packet_result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QSetSTDIN(
     StringExtractorGDBRemote &packet) {
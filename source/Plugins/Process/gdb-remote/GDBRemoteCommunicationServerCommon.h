@@ -104,6 +104,8 @@ protected:
 
   PacketResult Handle_QStartNoAckMode(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_QEnableCompression(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_QSetSTDIN(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_QSetSTDOUT(StringExtractorGDBRemote &packet);
@@ -37,6 +37,7 @@
 #include "lldb/Target/FileAction.h"
 #include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Utility/DataBuffer.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Endian.h"
 #include "lldb/Utility/JSON.h"
 #include "lldb/Utility/LLDBAssert.h"
@@ -101,6 +102,10 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
       &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                 &GDBRemoteCommunicationServerLLGS::Handle_M);
+  RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_g,
+                                &GDBRemoteCommunicationServerLLGS::Handle_g);
+  RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_G,
+                                &GDBRemoteCommunicationServerLLGS::Handle_G);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_p,
                                 &GDBRemoteCommunicationServerLLGS::Handle_p);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_P,
@@ -128,6 +133,9 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qRegisterInfo,
       &GDBRemoteCommunicationServerLLGS::Handle_qRegisterInfo);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_qShlibInfoAddr,
+      &GDBRemoteCommunicationServerLLGS::Handle_qShlibInfoAddr);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_QRestoreRegisterState,
       &GDBRemoteCommunicationServerLLGS::Handle_QRestoreRegisterState);
@@ -149,12 +157,18 @@ void GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers() {
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_jThreadsInfo,
       &GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_jMemoryReadMulti,
+      &GDBRemoteCommunicationServerLLGS::Handle_jMemoryReadMulti);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qWatchpointSupportInfo,
       &GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo);
   RegisterMemberFunctionHandler(
       StringExtractorGDBRemote::eServerPacketType_qXfer_auxv_read,
       &GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read);
+  RegisterMemberFunctionHandler(
+      StringExtractorGDBRemote::eServerPacketType_qXfer_libraries_svr4_read,
+      &GDBRemoteCommunicationServerLLGS::Handle_qXfer_libraries_svr4_read);
   RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_s,
                                 &GDBRemoteCommunicationServerLLGS::Handle_s);
   RegisterMemberFunctionHandler(
@@ -495,6 +509,63 @@ static const char *GetStopReasonString(StopReason stop_reason) {
   return nullptr;
 }
 
+// Walk the chain of saved frame pointers (the back chain on PowerPC) of
+// \a thread and pass each stack record to \a callback. The client puts
+// these into its L1 memory cache, which lets it backtrace the thread
+// without a memory read per frame.
+static void ForEachExpeditedStackRecord(
+    NativeProcessProtocol &process, NativeThreadProtocol &thread,
+    llvm::function_ref<void(lldb::addr_t, llvm::ArrayRef<uint8_t>)> callback) {
+  const ArchSpec &arch = process.GetArchitecture();
+  const uint32_t ptr_size = arch.GetAddressByteSize();
+  if (ptr_size != 4 && ptr_size != 8)
+    return;
+
+  NativeRegisterContext &reg_ctx = thread.GetRegisterContext();
+  lldb::addr_t frame;
+  size_t record_size;
+  switch (arch.GetMachine()) {
+  case llvm::Triple::x86:
+  case llvm::Triple::x86_64:
+  case llvm::Triple::aarch64:
+    // The frame pointer points at the caller's frame pointer, followed by
+    // the return address.
+    frame = reg_ctx.GetFP(0);
+    record_size = 2 * ptr_size;
+    break;
+  case llvm::Triple::ppc64:
+  case llvm::Triple::ppc64le:
+    // The stack pointer points at the back chain word. The word after it
+    // is the CR save slot and the one after that the LR save slot, which
+    // holds the return address of the frame that the back chain points to.
+    frame = reg_ctx.GetSP(0);
+    record_size = 3 * ptr_size;
+    break;
+  default:
+    return;
+  }
+
+  // Cap the walk so a corrupt chain can't make the reply unbounded.
+  const size_t max_frames = 128;
+  uint8_t buffer[24];
+  for (size_t i = 0; i < max_frames && frame != 0 && frame % ptr_size == 0;
+       ++i) {
+    size_t bytes_read = 0;
+    Status error = process.ReadMemory(frame, buffer, record_size, bytes_read);
+    if (error.Fail() || bytes_read != record_size)
+      break;
+    callback(frame, llvm::makeArrayRef(buffer, record_size));
+
+    DataExtractor data(buffer, record_size, arch.GetByteOrder(), ptr_size);
+    lldb::offset_t offset = 0;
+    const lldb::addr_t next_frame = data.GetPointer(&offset);
+    // The stack grows down, so the caller's frame must be above this one.
+    if (next_frame <= frame)
+      break;
+    frame = next_frame;
+  }
+}
+
 static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
                                         bool abridged) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
@@ -564,7 +635,23 @@ static JSONArray::SP GetJSONThreadsInfo(NativeProcessProtocol &process,
       thread_obj_sp->SetObject("medata", medata_array_sp);
     }
 
-    // TODO: Expedite interesting regions of inferior memory
+    if (!abridged) {
+      JSONArray::SP memory_array_sp = std::make_shared<JSONArray>();
+      ForEachExpeditedStackRecord(
+          process, *thread,
+          [&memory_array_sp](lldb::addr_t addr, llvm::ArrayRef<uint8_t> bytes) {
+            JSONObject::SP memory_obj_sp = std::make_shared<JSONObject>();
+            memory_obj_sp->SetObject("address",
+                                     std::make_shared<JSONNumber>(addr));
+            StreamString hex;
+            hex.PutBytesAsRawHex8(bytes.data(), bytes.size());
+            memory_obj_sp->SetObject(
+                "bytes", std::make_shared<JSONString>(hex.GetString().str()));
+            memory_array_sp->AppendObject(memory_obj_sp);
+          });
+      if (memory_array_sp->GetNumElements() > 0)
+        thread_obj_sp->SetObject("memory", memory_array_sp);
+    }
   }
 
   return threads_array_sp;
@@ -762,6 +849,16 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
     }
   }
 
+  // Expedite the stack records of the stopped thread, so the client can
+  // backtrace it without reading them.
+  ForEachExpeditedStackRecord(
+      *m_debugged_process_up, *thread,
+      [&response](lldb::addr_t addr, llvm::ArrayRef<uint8_t> bytes) {
+        response.Printf("memory:0x%" PRIx64 "=", addr);
+        response.PutBytesAsRawHex8(bytes.data(), bytes.size());
+        response.PutChar(';');
+      });
+
   const char *reason_str = GetStopReasonString(tid_stop_info.reason);
   if (reason_str != nullptr) {
     response.Printf("reason:%s;", reason_str);
@@ -787,6 +884,20 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread(
     }
   }
 
+  // Breakpoint hits skipped because of ignore counts or false conditions
+  // since the last stop, so the debugger can keep its counts up to date:
+  // "skipped-hits:<addr>,<ignored>,<condition false>[,<addr>,...];".
+  const auto skipped_hits =
+      m_debugged_process_up->TakeSkippedBreakpointHitCounts();
+  if (!skipped_hits.empty()) {
+    response.PutCString("skipped-hits:");
+    for (size_t i = 0; i < skipped_hits.size(); ++i)
+      response.Printf("%s%" PRIx64 ",%" PRIx32 ",%" PRIx32, i > 0 ? "," : "",
+                      skipped_hits[i].m_addr, skipped_hits[i].m_ignored,
+                      skipped_hits[i].m_condition_false);
+    response.PutChar(';');
+  }
+
   return SendPacketNoLock(response.GetString());
 }
 
@@ -1280,6 +1391,23 @@ GDBRemoteCommunicationServerLLGS::Handle_qProcessInfo(
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qShlibInfoAddr(
+    StringExtractorGDBRemote &packet) {
+  // Fail if we don't have a current process.
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID))
+    return SendErrorResponse(68);
+
+  lldb::addr_t addr = m_debugged_process_up->GetSharedLibraryInfoAddress();
+  if (addr == LLDB_INVALID_ADDRESS)
+    return SendErrorResponse(1);
+
+  StreamString response;
+  response.Printf("%" PRIx64, addr);
+  return SendPacketNoLock(response.GetString());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_qC(StringExtractorGDBRemote &packet) {
   // Fail if we don't have a current process.
@@ -2069,6 +2197,141 @@ GDBRemoteCommunicationServerLLGS::Handle_P(StringExtractorGDBRemote &packet) {
   return SendOKResponse();
 }
 
+// The g and G packets lay the registers out at the byte offsets reported
+// by qRegisterInfo, so the register file is as large as the furthest
+// register.
+static size_t GetRegisterFileSize(NativeRegisterContext &reg_ctx) {
+  size_t size = 0;
+  for (uint32_t reg_num = 0; reg_num < reg_ctx.GetUserRegisterCount();
+       ++reg_num) {
+    if (const RegisterInfo *reg_info = reg_ctx.GetRegisterInfoAtIndex(reg_num))
+      size = std::max<size_t>(size,
+                              reg_info->byte_offset + reg_info->byte_size);
+  }
+  return size;
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_g(StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
+
+  // Get the thread to use.
+  packet.SetFilePos(strlen("g"));
+  NativeThreadProtocol *thread = GetThreadFromSuffix(packet);
+  if (!thread) {
+    LLDB_LOG(log, "failed, no thread available");
+    return SendErrorResponse(0x15);
+  }
+
+  // Get the thread's register context.
+  NativeRegisterContext &reg_ctx = thread->GetRegisterContext();
+
+  std::vector<uint8_t> regs_buffer(GetRegisterFileSize(reg_ctx), 0);
+  for (uint32_t reg_num = 0; reg_num < reg_ctx.GetUserRegisterCount();
+       ++reg_num) {
+    const RegisterInfo *reg_info = reg_ctx.GetRegisterInfoAtIndex(reg_num);
+    if (!reg_info) {
+      LLDB_LOG(log, "failed to get register info for register index {0}",
+               reg_num);
+      return SendErrorResponse(0x15);
+    }
+
+    // Registers that are contained in other registers are filled in along
+    // with the containing register.
+    if (reg_info->value_regs != nullptr)
+      continue;
+
+    // The client takes every register in the reply as valid, so fail
+    // rather than send made up values. It then reads the registers one by
+    // one with p.
+    RegisterValue reg_value;
+    Status error = reg_ctx.ReadRegister(reg_info, reg_value);
+    if (error.Fail()) {
+      LLDB_LOG(log, "failed to read register '{0}' index {1}: {2}",
+               reg_info->name, reg_num, error);
+      return SendErrorResponse(0x15);
+    }
+
+    const size_t size = std::min<size_t>(reg_value.GetByteSize(),
+                                         reg_info->byte_size);
+    if (size > 0 && reg_value.GetBytes())
+      ::memcpy(regs_buffer.data() + reg_info->byte_offset,
+               reg_value.GetBytes(), size);
+  }
+
+  StreamGDBRemote response;
+  response.PutBytesAsRawHex8(regs_buffer.data(), regs_buffer.size());
+  return SendPacketNoLock(response.GetString());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_G(StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
+
+  // Fail if we don't have a current process.
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    LLDB_LOG(log, "failed, no process available");
+    return SendErrorResponse(0x15);
+  }
+
+  // Parse out the register file. The thread suffix can only be found once
+  // the hex bytes have been consumed, so read as many as there are, and
+  // check the size once the register context is known.
+  packet.SetFilePos(strlen("G"));
+  std::vector<uint8_t> regs_buffer(packet.GetBytesLeft() / 2);
+  regs_buffer.resize(packet.GetHexBytesAvail(regs_buffer));
+
+  // Get the thread to use.
+  NativeThreadProtocol *thread = GetThreadFromSuffix(packet);
+  if (!thread) {
+    LLDB_LOG(log, "failed, no thread available");
+    return SendErrorResponse(0x15);
+  }
+
+  // Get the thread's register context.
+  NativeRegisterContext &reg_ctx = thread->GetRegisterContext();
+  if (regs_buffer.size() != GetRegisterFileSize(reg_ctx))
+    return SendIllFormedResponse(packet, "G packet register file size is "
+                                         "incorrect");
+
+  const lldb::ByteOrder byte_order =
+      m_debugged_process_up->GetArchitecture().GetByteOrder();
+  for (uint32_t reg_num = 0; reg_num < reg_ctx.GetUserRegisterCount();
+       ++reg_num) {
+    const RegisterInfo *reg_info = reg_ctx.GetRegisterInfoAtIndex(reg_num);
+    if (!reg_info) {
+      LLDB_LOG(log, "failed to get register info for register index {0}",
+               reg_num);
+      return SendErrorResponse(0x15);
+    }
+
+    // Writing the containing register writes these as well.
+    if (reg_info->value_regs != nullptr)
+      continue;
+
+    // Skip the registers that don't change. The ones that can't be read are
+    // always written, and the packet fails if that doesn't work either, so
+    // that the client never assumes a register value that wasn't set.
+    uint8_t *new_bytes = regs_buffer.data() + reg_info->byte_offset;
+    RegisterValue old_value;
+    if (reg_ctx.ReadRegister(reg_info, old_value).Success() &&
+        old_value.GetByteSize() == reg_info->byte_size &&
+        ::memcmp(old_value.GetBytes(), new_bytes, reg_info->byte_size) == 0)
+      continue;
+
+    RegisterValue reg_value(new_bytes, reg_info->byte_size, byte_order);
+    Status error = reg_ctx.WriteRegister(reg_info, reg_value);
+    if (error.Fail()) {
+      LLDB_LOG(log, "failed to write register '{0}' index {1}: {2}",
+               reg_info->name, reg_num, error);
+      return SendErrorResponse(0x32);
+    }
+  }
+
+  return SendOKResponse();
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_H(StringExtractorGDBRemote &packet) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
@@ -2290,6 +2553,133 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(
   return SendPacketNoLock(response.GetString());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jMemoryReadMulti(
+    StringExtractorGDBRemote &packet) {
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  if (!m_debugged_process_up ||
+      (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+    if (log)
+      log->Printf(
+          "GDBRemoteCommunicationServerLLGS::%s failed, no process available",
+          __FUNCTION__);
+    return SendErrorResponse(0x15);
+  }
+
+  // The packet is a JSON array of {"address":<addr>,"size":<size>} objects.
+  packet.SetFilePos(::strlen("jMemoryReadMulti:"));
+  StructuredData::ObjectSP object_sp = StructuredData::ParseJSON(packet.Peek());
+  if (!object_sp)
+    return SendIllFormedResponse(packet, "Malformed jMemoryReadMulti packet");
+  StructuredData::Array *packet_array = object_sp->GetAsArray();
+  if (!packet_array)
+    return SendIllFormedResponse(packet, "Malformed jMemoryReadMulti packet");
+
+  std::vector<std::pair<lldb::addr_t, uint64_t>> requests;
+  for (size_t i = 0; i < packet_array->GetSize(); ++i) {
+    StructuredData::Dictionary *request =
+        packet_array->GetItemAtIndex(i)->GetAsDictionary();
+    lldb::addr_t addr;
+    uint64_t size;
+    if (!request || !request->GetValueForKeyAsInteger("address", addr) ||
+        !request->GetValueForKeyAsInteger("size", size))
+      return SendIllFormedResponse(packet,
+                                   "Malformed jMemoryReadMulti range");
+    requests.emplace_back(addr, size);
+  }
+
+  // The reply is streamed: a series of 'b' packets, each holding the data of
+  // one or more "<length>;<binary data>" records, followed by "OK". The
+  // records of a range carry its bytes in order and the ranges are sent in
+  // the order they were requested. A range ends once all of its bytes have
+  // been sent or with a zero length record if it can't be read any further.
+  //
+  // Large ranges are split up and small ones are read together, so that
+  // every packet is filled with up to max_chunk_size bytes that are read
+  // from the process at once. The client can consume one packet while we
+  // read the next one, so it never waits for a round trip.
+  //
+  // Escaping can double the size of the binary data, keep the packets below
+  // the maximum packet size we advertise.
+  const size_t max_chunk_size = 60 * 1024;
+  std::string buf(max_chunk_size, '\0');
+  std::vector<MemoryReadRange> chunks;
+  std::vector<size_t> chunk_requests;
+  size_t request_idx = 0;
+  uint64_t request_offset = 0;
+  // Move on to the next range that still has bytes to send.
+  auto skip_finished_requests = [&]() {
+    while (request_idx < requests.size() &&
+           request_offset == requests[request_idx].second) {
+      ++request_idx;
+      request_offset = 0;
+    }
+  };
+  while (true) {
+    skip_finished_requests();
+    if (request_idx == requests.size())
+      break;
+
+    chunks.clear();
+    chunk_requests.clear();
+    size_t buf_offset = 0;
+    size_t idx = request_idx;
+    uint64_t offset = request_offset;
+    while (idx < requests.size() && buf_offset < max_chunk_size) {
+      const uint64_t size = std::min<uint64_t>(requests[idx].second - offset,
+                                               max_chunk_size - buf_offset);
+      if (size > 0) {
+        chunks.push_back(MemoryReadRange(requests[idx].first + offset,
+                                         &buf[buf_offset], size));
+        chunk_requests.push_back(idx);
+        buf_offset += size;
+        offset += size;
+      }
+      if (offset == requests[idx].second) {
+        ++idx;
+        offset = 0;
+      }
+    }
+
+    Status error = m_debugged_process_up->ReadMemoryRangesWithoutTrap(chunks);
+    if (error.Fail()) {
+      if (log)
+        log->Printf("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64
+                    ": failed to read memory. Error: %s",
+                    __FUNCTION__, m_debugged_process_up->GetID(),
+                    error.AsCString());
+      for (MemoryReadRange &chunk : chunks)
+        chunk.bytes_read = 0;
+    }
+
+    StreamGDBRemote response;
+    response.PutChar('b');
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      skip_finished_requests();
+      // The rest of a range that couldn't be read is dropped.
+      if (chunk_requests[i] != request_idx)
+        continue;
+      const MemoryReadRange &chunk = chunks[i];
+      response.Printf("%" PRIx64 ";", (uint64_t)chunk.bytes_read);
+      response.PutEscapedBytes(chunk.buf, chunk.bytes_read);
+      request_offset += chunk.bytes_read;
+      if (chunk.bytes_read < chunk.size) {
+        if (chunk.bytes_read > 0)
+          response.PutCString("0;");
+        ++request_idx;
+        request_offset = 0;
+      }
+    }
+
+    PacketResult result = SendPacketNoLock(response.GetString());
+    if (result != PacketResult::Success)
+      return result;
+  }
+
+  return SendOKResponse();
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_M(StringExtractorGDBRemote &packet) {
   Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
@@ -2545,10 +2935,60 @@ GDBRemoteCommunicationServerLLGS::Handle_Z(StringExtractorGDBRemote &packet) {
     return SendIllFormedResponse(
         packet, "Malformed Z packet, failed to parse size argument");
 
+  // Parse out the optional list of conditions of a software breakpoint, each
+  // one an agent expression: ";X<length>,<hex bytecode>". The breakpoint
+  // only stops when one of them is true. An ";I<hex count>" item sets the
+  // number of hits to ignore before the conditions are evaluated.
+  std::vector<NativeBreakpointCondition> conditions;
+  uint32_t ignore_count = 0;
+  while (packet.GetBytesLeft() > 0 && packet.PeekChar() == ';') {
+    packet.GetChar();
+    const char item = packet.GetBytesLeft() > 0 ? packet.GetChar() : '\0';
+    if (item != 'X' && item != 'I')
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, expecting a condition or ignore count");
+    if (stoppoint_type != eBreakpointSoftware)
+      return SendIllFormedResponse(
+          packet, "Conditions are only supported for software breakpoints");
+    if (item == 'I') {
+      ignore_count = packet.GetHexMaxU32(false, UINT32_MAX);
+      if (ignore_count == UINT32_MAX)
+        return SendIllFormedResponse(
+            packet, "Malformed Z packet, failed to parse ignore count");
+      continue;
+    }
+    const uint32_t length = packet.GetHexMaxU32(false, 0);
+    if (length == 0 || packet.GetBytesLeft() < 1 || packet.GetChar() != ',')
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, failed to parse condition length");
+    if (length > packet.GetBytesLeft() / 2)
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, condition shorter than its length");
+    std::vector<uint8_t> bytecode(length);
+    if (packet.GetHexBytes(bytecode, 0) != length)
+      return SendIllFormedResponse(
+          packet, "Malformed Z packet, condition shorter than its length");
+    NativeBreakpointCondition condition(std::move(bytecode));
+    const Status error = condition.Validate();
+    if (error.Fail()) {
+      Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+      LLDB_LOG(log, "invalid condition for breakpoint at {0:x}: {1}", addr,
+               error);
+      return SendIllFormedResponse(packet, "Z packet had invalid condition");
+    }
+    conditions.push_back(std::move(condition));
+  }
+
   if (want_breakpoint) {
     // Try to set the breakpoint.
-    const Status error =
+    Status error =
         m_debugged_process_up->SetBreakpoint(addr, size, want_hardware);
+    if (error.Success() && !want_hardware)
+      error = m_debugged_process_up->SetBreakpointConditions(
+          addr, std::move(conditions));
+    if (error.Success() && !want_hardware)
+      error = m_debugged_process_up->SetBreakpointIgnoreCount(addr,
+                                                              ignore_count);
     if (error.Success())
       return SendOKResponse();
     Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
@@ -2708,80 +3148,67 @@ GDBRemoteCommunicationServerLLGS::Handle_s(StringExtractorGDBRemote &packet) {
 }
 
 GDBRemoteCommunication::PacketResult
-GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read(
-    StringExtractorGDBRemote &packet) {
-// *BSD impls should be able to do this too.
-#if defined(__linux__) || defined(__NetBSD__)
-  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+GDBRemoteCommunicationServerLLGS::SendXferReadResponse(
+    StringExtractorGDBRemote &packet, llvm::StringRef object,
+    std::unique_ptr<llvm::MemoryBuffer> &buffer_up,
+    llvm::function_ref<PacketResult()> fill_buffer) {
+  const std::string prefix = ("qXfer:" + object + ":read::").str();
 
   // Parse out the offset.
-  packet.SetFilePos(strlen("qXfer:auxv:read::"));
+  packet.SetFilePos(prefix.size());
   if (packet.GetBytesLeft() < 1)
     return SendIllFormedResponse(packet,
-                                 "qXfer:auxv:read:: packet missing offset");
+                                 (prefix + " packet missing offset").c_str());
 
-  const uint64_t auxv_offset =
+  const uint64_t xfer_offset =
       packet.GetHexMaxU64(false, std::numeric_limits<uint64_t>::max());
-  if (auxv_offset == std::numeric_limits<uint64_t>::max())
+  if (xfer_offset == std::numeric_limits<uint64_t>::max())
     return SendIllFormedResponse(packet,
-                                 "qXfer:auxv:read:: packet missing offset");
+                                 (prefix + " packet missing offset").c_str());
 
   // Parse out comma.
   if (packet.GetBytesLeft() < 1 || packet.GetChar() != ',')
     return SendIllFormedResponse(
-        packet, "qXfer:auxv:read:: packet missing comma after offset");
+        packet, (prefix + " packet missing comma after offset").c_str());
 
   // Parse out the length.
-  const uint64_t auxv_length =
+  const uint64_t xfer_length =
       packet.GetHexMaxU64(false, std::numeric_limits<uint64_t>::max());
-  if (auxv_length == std::numeric_limits<uint64_t>::max())
+  if (xfer_length == std::numeric_limits<uint64_t>::max())
     return SendIllFormedResponse(packet,
-                                 "qXfer:auxv:read:: packet missing length");
+                                 (prefix + " packet missing length").c_str());
 
-  // Grab the auxv data if we need it.
-  if (!m_active_auxv_buffer_up) {
-    // Make sure we have a valid process.
-    if (!m_debugged_process_up ||
-        (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
-      if (log)
-        log->Printf(
-            "GDBRemoteCommunicationServerLLGS::%s failed, no process available",
-            __FUNCTION__);
-      return SendErrorResponse(0x10);
-    }
-
-    // Grab the auxv data.
-    auto buffer_or_error = m_debugged_process_up->GetAuxvData();
-    if (!buffer_or_error) {
-      std::error_code ec = buffer_or_error.getError();
-      LLDB_LOG(log, "no auxv data retrieved: {0}", ec.message());
-      return SendErrorResponse(ec.value());
-    }
-    m_active_auxv_buffer_up = std::move(*buffer_or_error);
+  // Grab the data if we need it.  A read starting at offset zero gets a
+  // fresh copy, as the object may have changed since the last read.
+  if (!buffer_up || xfer_offset == 0) {
+    buffer_up.reset();
+    PacketResult result = fill_buffer();
+    if (!buffer_up)
+      return result;
   }
 
   StreamGDBRemote response;
   bool done_with_buffer = false;
 
-  llvm::StringRef buffer = m_active_auxv_buffer_up->getBuffer();
-  if (auxv_offset >= buffer.size()) {
+  llvm::StringRef buffer = buffer_up->getBuffer();
+  if (xfer_offset >= buffer.size()) {
     // We have nothing left to send.  Mark the buffer as complete.
     response.PutChar('l');
     done_with_buffer = true;
   } else {
     // Figure out how many bytes are available starting at the given offset.
-    buffer = buffer.drop_front(auxv_offset);
+    buffer = buffer.drop_front(xfer_offset);
 
     // Mark the response type according to whether we're reading the remainder
-    // of the auxv data.
-    if (auxv_length >= buffer.size()) {
+    // of the data.
+    if (xfer_length >= buffer.size()) {
       // There will be nothing left to read after this
       response.PutChar('l');
       done_with_buffer = true;
     } else {
       // There will still be bytes to read after this request.
       response.PutChar('m');
-      buffer = buffer.take_front(auxv_length);
+      buffer = buffer.take_front(xfer_length);
     }
 
     // Now write the data in encoded binary form.
@@ -2789,9 +3216,118 @@ GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read(
   }
 
   if (done_with_buffer)
-    m_active_auxv_buffer_up.reset();
+    buffer_up.reset();
 
   return SendPacketNoLock(response.GetString());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read(
+    StringExtractorGDBRemote &packet) {
+// *BSD impls should be able to do this too.
+#if defined(__linux__) || defined(__NetBSD__)
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  return SendXferReadResponse(
+      packet, "auxv", m_active_auxv_buffer_up, [&]() -> PacketResult {
+        // Make sure we have a valid process.
+        if (!m_debugged_process_up ||
+            (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+          if (log)
+            log->Printf("GDBRemoteCommunicationServerLLGS::%s failed, no "
+                        "process available",
+                        __FUNCTION__);
+          return SendErrorResponse(0x10);
+        }
+
+        // Grab the auxv data.
+        auto buffer_or_error = m_debugged_process_up->GetAuxvData();
+        if (!buffer_or_error) {
+          std::error_code ec = buffer_or_error.getError();
+          LLDB_LOG(log, "no auxv data retrieved: {0}", ec.message());
+          return SendErrorResponse(ec.value());
+        }
+        m_active_auxv_buffer_up = std::move(*buffer_or_error);
+        return PacketResult::Success;
+      });
+#else
+  return SendUnimplementedResponse("not implemented on this platform");
+#endif
+}
+
+static void PutXMLEscaped(Stream &stream, llvm::StringRef str) {
+  for (char ch : str) {
+    switch (ch) {
+    case '&':
+      stream.PutCString("&amp;");
+      break;
+    case '<':
+      stream.PutCString("&lt;");
+      break;
+    case '>':
+      stream.PutCString("&gt;");
+      break;
+    case '"':
+      stream.PutCString("&quot;");
+      break;
+    case '\'':
+      stream.PutCString("&apos;");
+      break;
+    default:
+      stream.PutChar(ch);
+      break;
+    }
+  }
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qXfer_libraries_svr4_read(
+    StringExtractorGDBRemote &packet) {
+#if defined(__linux__)
+  Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+  return SendXferReadResponse(
+      packet, "libraries-svr4", m_active_svr4_buffer_up,
+      [&]() -> PacketResult {
+        // Make sure we have a valid process.
+        if (!m_debugged_process_up ||
+            (m_debugged_process_up->GetID() == LLDB_INVALID_PROCESS_ID)) {
+          if (log)
+            log->Printf("GDBRemoteCommunicationServerLLGS::%s failed, no "
+                        "process available",
+                        __FUNCTION__);
+          return SendErrorResponse(0x10);
+        }
+
+        // Walk the link map here, rather than have the debugger do it with
+        // several memory reads per library.
+        std::vector<NativeProcessProtocol::SVR4LibraryInfo> libraries;
+        lldb::addr_t main_lm = LLDB_INVALID_ADDRESS;
+        Status error =
+            m_debugged_process_up->GetLoadedSVR4Libraries(libraries, main_lm);
+        if (error.Fail()) {
+          LLDB_LOG(log, "no library list retrieved: {0}", error);
+          return SendErrorResponse(error);
+        }
+
+        StreamString xml;
+        xml.Printf("<library-list-svr4 version=\"1.0\" main-lm=\"0x%" PRIx64
+                   "\">",
+                   main_lm);
+        for (const auto &library : libraries) {
+          xml.PutCString("<library name=\"");
+          PutXMLEscaped(xml, library.name);
+          xml.Printf("\" lm=\"0x%" PRIx64 "\" l_addr=\"0x%" PRIx64
+                     "\" l_ld=\"0x%" PRIx64 "\" />",
+                     library.link_map, library.base_addr, library.ld_addr);
+        }
+        xml.PutCString("</library-list-svr4>");
+        LLDB_LOG(log, "found {0} libraries", libraries.size());
+
+        m_active_svr4_buffer_up = llvm::MemoryBuffer::getMemBufferCopy(
+            xml.GetString(), "libraries-svr4");
+        return PacketResult::Success;
+      });
 #else
   return SendUnimplementedResponse("not implemented on this platform");
 #endif
@@ -3222,6 +3758,7 @@ void GDBRemoteCommunicationServerLLGS::ClearProcessSpecificData() {
 
   LLDB_LOG(log, "clearing auxv buffer: {0}", m_active_auxv_buffer_up.get());
   m_active_auxv_buffer_up.reset();
+  m_active_svr4_buffer_up.reset();
 }
 
 FileSpec
@@ -96,6 +96,7 @@ protected:
 
   lldb::StateType m_inferior_prev_state = lldb::StateType::eStateInvalid;
   std::unique_ptr<llvm::MemoryBuffer> m_active_auxv_buffer_up;
+  std::unique_ptr<llvm::MemoryBuffer> m_active_svr4_buffer_up;
   std::mutex m_saved_registers_mutex;
   std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
   uint32_t m_next_saved_registers_id = 1;
@@ -113,6 +114,8 @@ protected:
 
   PacketResult Handle_qProcessInfo(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_qShlibInfoAddr(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_qC(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_QSetDisableASLR(StringExtractorGDBRemote &packet);
@@ -137,6 +140,10 @@ protected:
 
   PacketResult Handle_qsThreadInfo(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_g(StringExtractorGDBRemote &packet);
+
+  PacketResult Handle_G(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_p(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_P(StringExtractorGDBRemote &packet);
@@ -150,6 +157,8 @@ protected:
   // Handles $m and $x packets.
   PacketResult Handle_memory_read(StringExtractorGDBRemote &packet);
 
+  PacketResult Handle_jMemoryReadMulti(StringExtractorGDBRemote &packet);
+
   PacketResult Handle_M(StringExtractorGDBRemote &packet);
 
   PacketResult
@@ -165,6 +174,19 @@ protected:
 
   PacketResult Handle_qXfer_auxv_read(StringExtractorGDBRemote &packet);
 
+  PacketResult
+  Handle_qXfer_libraries_svr4_read(StringExtractorGDBRemote &packet);
+
+  // Send the part of "buffer_up" that a qXfer:<object>:read packet asks
+  // for. "fill_buffer" is called to (re)create the buffer when a read
+  // starts over at offset zero or the previous one was completed; it
+  // either fills in "buffer_up" or sends an error response.
+  PacketResult
+  SendXferReadResponse(StringExtractorGDBRemote &packet,
+                       llvm::StringRef object,
+                       std::unique_ptr<llvm::MemoryBuffer> &buffer_up,
+                       llvm::function_ref<PacketResult()> fill_buffer);
+
   PacketResult Handle_QSaveRegisterState(StringExtractorGDBRemote &packet);
 
   PacketResult Handle_jTraceStart(StringExtractorGDBRemote &packet);
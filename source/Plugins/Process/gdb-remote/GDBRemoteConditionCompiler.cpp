@@ -0,0 +1,423 @@
+//===-- GDBRemoteConditionCompiler.cpp --------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "GDBRemoteConditionCompiler.h"
+
+// C Includes
+#include <ctype.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Host/common/NativeBreakpointCondition.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+typedef NativeBreakpointCondition Op;
+
+static const GDBRemoteConditionCompiler::ValueType g_int_type =
+    GDBRemoteConditionCompiler::ValueType();
+
+GDBRemoteConditionCompiler::GDBRemoteConditionCompiler(
+    llvm::StringRef expression, IdentifierResolver resolver)
+    : m_expression(expression), m_resolver(std::move(resolver)) {}
+
+Status GDBRemoteConditionCompiler::Compile(std::vector<uint8_t> &bytecode) {
+  m_remaining = m_expression;
+  m_code.clear();
+
+  ValueType type;
+  Status error = ParseBinary(1, type);
+  if (error.Fail())
+    return error;
+
+  SkipSpaces();
+  if (!m_remaining.empty())
+    return Status("unexpected \"%s\" in condition", m_remaining.str().c_str());
+
+  EmitOpcode(Op::eOpEnd);
+  // Jump targets are 16 bit offsets.
+  if (m_code.size() > UINT16_MAX)
+    return Status("condition is too long");
+
+  bytecode = std::move(m_code);
+  return Status();
+}
+
+void GDBRemoteConditionCompiler::EmitConstant(uint64_t value) {
+  if (value <= UINT8_MAX) {
+    EmitOpcode(Op::eOpConst8);
+    EmitOperand(value, 1);
+  } else if (value <= UINT16_MAX) {
+    EmitOpcode(Op::eOpConst16);
+    EmitOperand(value, 2);
+  } else if (value <= UINT32_MAX) {
+    EmitOpcode(Op::eOpConst32);
+    EmitOperand(value, 4);
+  } else {
+    EmitOpcode(Op::eOpConst64);
+    EmitOperand(value, 8);
+  }
+}
+
+void GDBRemoteConditionCompiler::EmitRegister(uint32_t regnum) {
+  EmitOpcode(Op::eOpReg);
+  EmitOperand(regnum, 2);
+}
+
+void GDBRemoteConditionCompiler::EmitLoad(uint32_t byte_size) {
+  switch (byte_size) {
+  case 1:
+    EmitOpcode(Op::eOpRef8);
+    break;
+  case 2:
+    EmitOpcode(Op::eOpRef16);
+    break;
+  case 4:
+    EmitOpcode(Op::eOpRef32);
+    break;
+  default:
+    EmitOpcode(Op::eOpRef64);
+    break;
+  }
+}
+
+void GDBRemoteConditionCompiler::EmitAdd() { EmitOpcode(Op::eOpAdd); }
+
+void GDBRemoteConditionCompiler::EmitOpcode(uint8_t opcode) {
+  m_code.push_back(opcode);
+}
+
+void GDBRemoteConditionCompiler::EmitOperand(uint64_t value, size_t size) {
+  for (size_t i = size; i > 0; --i)
+    m_code.push_back((value >> (8 * (i - 1))) & 0xff);
+}
+
+size_t GDBRemoteConditionCompiler::EmitJump(uint8_t opcode) {
+  EmitOpcode(opcode);
+  const size_t operand_offset = m_code.size();
+  EmitOperand(0, 2);
+  return operand_offset;
+}
+
+void GDBRemoteConditionCompiler::PatchJump(size_t operand_offset,
+                                           size_t target) {
+  m_code[operand_offset] = (target >> 8) & 0xff;
+  m_code[operand_offset + 1] = target & 0xff;
+}
+
+void GDBRemoteConditionCompiler::EmitExtend(uint32_t bit_size,
+                                            bool is_signed) {
+  EmitOpcode(is_signed ? Op::eOpExt : Op::eOpZeroExt);
+  EmitOperand(bit_size, 1);
+}
+
+// Values on the stack are always kept as the 64 bit extension of their C
+// type, so anything that may have carried into the upper bits has to be
+// extended again.
+void GDBRemoteConditionCompiler::Normalize(const ValueType &type) {
+  if (type.bit_size < 64)
+    EmitExtend(type.bit_size, type.is_signed);
+}
+
+// C's integer promotions: anything narrower than int becomes an int. We
+// don't have types between 32 and 64 bits, so e.g. wide bitfields are
+// widened all the way; the value on the stack is the same.
+void GDBRemoteConditionCompiler::Promote(ValueType &type) {
+  if (type.bit_size < 32)
+    type = g_int_type;
+  else if (type.bit_size > 32)
+    type.bit_size = 64;
+}
+
+void GDBRemoteConditionCompiler::SkipSpaces() {
+  m_remaining = m_remaining.ltrim();
+}
+
+// Returns the precedence of the binary operator at the current position,
+// or 0 if there is none.
+int GDBRemoteConditionCompiler::PeekBinaryOperator(llvm::StringRef &op) {
+  static const struct {
+    const char *op;
+    int precedence;
+  } g_operators[] = {
+      // Two character operators first so that e.g. "<<" isn't taken for "<".
+      {"||", 1}, {"&&", 2}, {"==", 6}, {"!=", 6}, {"<=", 7}, {">=", 7},
+      {"<<", 8}, {">>", 8}, {"|", 3},  {"^", 4},  {"&", 5},  {"<", 7},
+      {">", 7},  {"+", 9},  {"-", 9},  {"*", 10}, {"/", 10}, {"%", 10},
+  };
+  for (const auto &entry : g_operators) {
+    if (m_remaining.startswith(entry.op)) {
+      op = m_remaining.take_front(strlen(entry.op));
+      return entry.precedence;
+    }
+  }
+  return 0;
+}
+
+Status GDBRemoteConditionCompiler::ParseBinary(int min_precedence,
+                                               ValueType &type) {
+  Status error = ParseUnary(type);
+  while (error.Success()) {
+    SkipSpaces();
+    llvm::StringRef op;
+    const int precedence = PeekBinaryOperator(op);
+    if (precedence == 0 || precedence < min_precedence)
+      break;
+    m_remaining = m_remaining.drop_front(op.size());
+
+    ValueType rhs;
+    if (op == "&&" || op == "||") {
+      // Short circuit like C does, so that the right hand side isn't
+      // evaluated (and can't fail) when it doesn't matter:
+      //   lhs [log_not] if_goto short; rhs log_not log_not goto done;
+      //   short: const 0|1; done:
+      const bool is_and = op == "&&";
+      if (is_and)
+        EmitOpcode(Op::eOpLogNot);
+      const size_t short_circuit = EmitJump(Op::eOpIfGoto);
+      error = ParseBinary(precedence + 1, rhs);
+      if (error.Fail())
+        break;
+      EmitOpcode(Op::eOpLogNot);
+      EmitOpcode(Op::eOpLogNot);
+      const size_t done = EmitJump(Op::eOpGoto);
+      PatchJump(short_circuit, m_code.size());
+      EmitConstant(is_and ? 0 : 1);
+      PatchJump(done, m_code.size());
+      type = g_int_type;
+      continue;
+    }
+
+    // All the remaining operators are left associative.
+    error = ParseBinary(precedence + 1, rhs);
+    if (error.Success())
+      error = EmitBinary(op, type, rhs);
+  }
+  return error;
+}
+
+Status GDBRemoteConditionCompiler::EmitBinary(llvm::StringRef op,
+                                              ValueType &lhs,
+                                              const ValueType &rhs) {
+  // The type of a shift is the (promoted) type of its left operand.
+  if (op == "<<" || op == ">>") {
+    if (op == "<<")
+      EmitOpcode(Op::eOpLsh);
+    else
+      EmitOpcode(lhs.is_signed ? Op::eOpRshSigned : Op::eOpRshUnsigned);
+    Normalize(lhs);
+    return Status();
+  }
+
+  // The usual arithmetic conversions. A 64 bit signed type can hold all the
+  // values of a 32 bit unsigned one, so only operands of the same size can
+  // turn unsigned.
+  ValueType common;
+  common.bit_size = std::max(lhs.bit_size, rhs.bit_size);
+  if (lhs.bit_size == rhs.bit_size)
+    common.is_signed = lhs.is_signed && rhs.is_signed;
+  else
+    common.is_signed =
+        lhs.bit_size > rhs.bit_size ? lhs.is_signed : rhs.is_signed;
+
+  // Sign extended 32 bit values are also correct as 64 bit values of either
+  // signedness; only the conversion to a 32 bit unsigned type needs code.
+  if (common.bit_size == 32 && !common.is_signed) {
+    if (rhs.is_signed)
+      EmitExtend(32, false);
+    if (lhs.is_signed) {
+      EmitOpcode(Op::eOpSwap);
+      EmitExtend(32, false);
+      EmitOpcode(Op::eOpSwap);
+    }
+  }
+
+  const uint8_t less =
+      common.is_signed ? Op::eOpLessSigned : Op::eOpLessUnsigned;
+  if (op == "==") {
+    EmitOpcode(Op::eOpEqual);
+  } else if (op == "!=") {
+    EmitOpcode(Op::eOpEqual);
+    EmitOpcode(Op::eOpLogNot);
+  } else if (op == "<") {
+    EmitOpcode(less);
+  } else if (op == ">") {
+    EmitOpcode(Op::eOpSwap);
+    EmitOpcode(less);
+  } else if (op == "<=") {
+    EmitOpcode(Op::eOpSwap);
+    EmitOpcode(less);
+    EmitOpcode(Op::eOpLogNot);
+  } else if (op == ">=") {
+    EmitOpcode(less);
+    EmitOpcode(Op::eOpLogNot);
+  } else {
+    if (op == "+")
+      EmitOpcode(Op::eOpAdd);
+    else if (op == "-")
+      EmitOpcode(Op::eOpSub);
+    else if (op == "*")
+      EmitOpcode(Op::eOpMul);
+    else if (op == "/")
+      EmitOpcode(common.is_signed ? Op::eOpDivSigned : Op::eOpDivUnsigned);
+    else if (op == "%")
+      EmitOpcode(common.is_signed ? Op::eOpRemSigned : Op::eOpRemUnsigned);
+    else if (op == "&")
+      EmitOpcode(Op::eOpBitAnd);
+    else if (op == "|")
+      EmitOpcode(Op::eOpBitOr);
+    else if (op == "^")
+      EmitOpcode(Op::eOpBitXor);
+    else
+      return Status("unsupported operator \"%s\"", op.str().c_str());
+    Normalize(common);
+    lhs = common;
+    return Status();
+  }
+
+  // Comparisons are ints.
+  lhs = g_int_type;
+  return Status();
+}
+
+Status GDBRemoteConditionCompiler::ParseUnary(ValueType &type) {
+  SkipSpaces();
+  if (m_remaining.empty())
+    return Status("expected an expression");
+
+  const char ch = m_remaining.front();
+  if (ch != '!' && ch != '-' && ch != '~' && ch != '+')
+    return ParsePrimary(type);
+
+  m_remaining = m_remaining.drop_front();
+  Status error = ParseUnary(type);
+  if (error.Fail())
+    return error;
+
+  switch (ch) {
+  case '!':
+    EmitOpcode(Op::eOpLogNot);
+    type = g_int_type;
+    break;
+  case '-':
+    EmitConstant(0);
+    EmitOpcode(Op::eOpSwap);
+    EmitOpcode(Op::eOpSub);
+    Normalize(type);
+    break;
+  case '~':
+    EmitOpcode(Op::eOpBitNot);
+    Normalize(type);
+    break;
+  default:
+    break;
+  }
+  return error;
+}
+
+Status GDBRemoteConditionCompiler::ParsePrimary(ValueType &type) {
+  SkipSpaces();
+  if (m_remaining.empty())
+    return Status("expected an expression");
+
+  const char ch = m_remaining.front();
+  if (ch == '(') {
+    m_remaining = m_remaining.drop_front();
+    Status error = ParseBinary(1, type);
+    if (error.Fail())
+      return error;
+    SkipSpaces();
+    if (!m_remaining.startswith(")"))
+      return Status("expected ')' in condition");
+    m_remaining = m_remaining.drop_front();
+    return error;
+  }
+
+  if (isdigit(ch))
+    return ParseNumber(type);
+
+  if (isalpha(ch) || ch == '_' || ch == '$') {
+    const size_t length = std::min(
+        m_remaining.size(), m_remaining.find_if([](char c) {
+          return !isalnum(c) && c != '_' && c != '$';
+        }));
+    llvm::StringRef name = m_remaining.take_front(length);
+    m_remaining = m_remaining.drop_front(length);
+
+    if (name == "true" || name == "false") {
+      EmitConstant(name == "true");
+      type = g_int_type;
+      return Status();
+    }
+
+    if (!m_resolver)
+      return Status("unknown identifier \"%s\"", name.str().c_str());
+    ValueType raw_type;
+    Status error = m_resolver(name, *this, raw_type);
+    if (error.Fail())
+      return error;
+    if (raw_type.bit_size == 0 || raw_type.bit_size > 64)
+      return Status("\"%s\" has an unsupported size", name.str().c_str());
+    Normalize(raw_type);
+    type = raw_type;
+    Promote(type);
+    return error;
+  }
+
+  return Status("unexpected \"%s\" in condition", m_remaining.str().c_str());
+}
+
+Status GDBRemoteConditionCompiler::ParseNumber(ValueType &type) {
+  const size_t length =
+      std::min(m_remaining.size(),
+               m_remaining.find_if([](char c) { return !isalnum(c); }));
+  llvm::StringRef token = m_remaining.take_front(length);
+  m_remaining = m_remaining.drop_front(length);
+  if (m_remaining.startswith("."))
+    return Status("floating point values are not supported");
+
+  // Integer suffixes.
+  bool has_u = false;
+  bool has_l = false;
+  while (!token.empty() && (token.back() == 'u' || token.back() == 'U' ||
+                            token.back() == 'l' || token.back() == 'L')) {
+    if (token.back() == 'u' || token.back() == 'U')
+      has_u = true;
+    else
+      has_l = true;
+    token = token.drop_back();
+  }
+
+  // A radix of 0 detects the "0x" and "0" prefixes.
+  uint64_t value = 0;
+  if (token.getAsInteger(0, value))
+    return Status("invalid number \"%s\"", token.str().c_str());
+  const bool is_decimal = token.size() == 1 || token.front() != '0';
+
+  // Pick the first type of int, unsigned, long, unsigned long that can hold
+  // the value; decimal literals without a 'u' suffix stay signed.
+  if (!has_l && value <= (has_u ? UINT32_MAX : INT32_MAX)) {
+    type.bit_size = 32;
+    type.is_signed = !has_u;
+  } else if (!has_l && !has_u && !is_decimal && value <= UINT32_MAX) {
+    type.bit_size = 32;
+    type.is_signed = false;
+  } else {
+    type.bit_size = 64;
+    type.is_signed = !has_u && value <= INT64_MAX;
+  }
+  EmitConstant(value);
+  return Status();
+}
@@ -0,0 +1,100 @@
+//===-- GDBRemoteConditionCompiler.h ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_GDBRemoteConditionCompiler_h_
+#define lldb_GDBRemoteConditionCompiler_h_
+
+// C Includes
+// C++ Includes
+#include <functional>
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/ADT/StringRef.h"
+
+// Project includes
+#include "lldb/Utility/Status.h"
+#include "lldb/lldb-types.h"
+
+namespace lldb_private {
+namespace process_gdb_remote {
+
+//----------------------------------------------------------------------
+// Compiles simple breakpoint conditions into agent expression bytecode
+// that a stub advertising "ConditionalBreakpoints+" evaluates itself.
+//
+// The accepted language is a small subset of C: integer literals,
+// identifiers, parentheses, the unary operators ! - ~ and the binary
+// operators || && | ^ & == != < <= > >= << >> + - * / %, with C's
+// precedence and integer conversion rules. Anything else (member access,
+// function calls, casts, floating point, ...) is rejected, in which case
+// the debugger evaluates the condition as usual.
+//
+// Identifiers are handed to a resolver that emits the code to push their
+// raw value and describes its type; the compiler takes care of extending
+// it to 64 bits.
+//----------------------------------------------------------------------
+class GDBRemoteConditionCompiler {
+public:
+  struct ValueType {
+    uint32_t bit_size = 32; // 1 to 64
+    bool is_signed = true;
+  };
+
+  typedef std::function<Status(llvm::StringRef name,
+                               GDBRemoteConditionCompiler &compiler,
+                               ValueType &type)>
+      IdentifierResolver;
+
+  GDBRemoteConditionCompiler(llvm::StringRef expression,
+                             IdentifierResolver resolver);
+
+  Status Compile(std::vector<uint8_t> &bytecode);
+
+  // Helpers for identifier resolvers.
+  void EmitConstant(uint64_t value);
+
+  // Push the value of the register the stub knows as "regnum".
+  void EmitRegister(uint32_t regnum);
+
+  // Replace the address on top of the stack with the "byte_size" bytes of
+  // memory it points to.
+  void EmitLoad(uint32_t byte_size);
+
+  // Add the two values on top of the stack.
+  void EmitAdd();
+
+private:
+  Status ParseBinary(int min_precedence, ValueType &type);
+  Status ParseUnary(ValueType &type);
+  Status ParsePrimary(ValueType &type);
+  Status ParseNumber(ValueType &type);
+
+  void SkipSpaces();
+  int PeekBinaryOperator(llvm::StringRef &op);
+
+  void EmitOpcode(uint8_t opcode);
+  void EmitOperand(uint64_t value, size_t size);
+  size_t EmitJump(uint8_t opcode);
+  void PatchJump(size_t operand_offset, size_t target);
+  void EmitExtend(uint32_t bit_size, bool is_signed);
+  void Normalize(const ValueType &type);
+  void Promote(ValueType &type);
+  Status EmitBinary(llvm::StringRef op, ValueType &lhs, const ValueType &rhs);
+
+  llvm::StringRef m_expression;
+  llvm::StringRef m_remaining;
+  IdentifierResolver m_resolver;
+  std::vector<uint8_t> m_code;
+};
+
+} // namespace process_gdb_remote
+} // namespace lldb_private
+
+#endif // lldb_GDBRemoteConditionCompiler_h_
@@ -102,6 +102,17 @@ bool GDBRemoteRegisterContext::ReadRegister(const RegisterInfo *reg_info,
   return false;
 }
 
+bool GDBRemoteRegisterContext::ReadCachedRegister(const RegisterInfo *reg_info,
+                                                  RegisterValue &value) {
+  if (reg_info == NULL ||
+      !GetRegisterIsValid(reg_info->kinds[eRegisterKindLLDB]))
+    return false;
+  const bool partial_data_ok = false;
+  Status error(value.SetValueFromData(reg_info, m_reg_data,
+                                      reg_info->byte_offset, partial_data_ok));
+  return error.Success();
+}
+
 bool GDBRemoteRegisterContext::PrivateSetRegisterValue(
     uint32_t reg, llvm::ArrayRef<uint8_t> data) {
   const RegisterInfo *reg_info = GetRegisterInfoAtIndex(reg);
@@ -217,7 +228,27 @@ bool GDBRemoteRegisterContext::ReadRegisterBytes(const RegisterInfo *reg_info,
       }
       return false;
     }
-    if (reg_info->value_regs) {
+    if (gdb_comm.GetReadRegistersWithGPacket() &&
+        !gdb_comm.AvoidGPackets((ProcessGDBRemote *)process)) {
+      // Fetch the whole register file in one round trip, rather than
+      // sending a p packet for this register and for each one read after
+      // it.
+      DataBufferSP buffer_sp =
+          gdb_comm.ReadAllRegisters(m_thread.GetProtocolID());
+      if (buffer_sp && buffer_sp->GetByteSize() >= m_reg_data.GetByteSize()) {
+        memcpy(const_cast<uint8_t *>(m_reg_data.GetDataStart()),
+               buffer_sp->GetBytes(), m_reg_data.GetByteSize());
+        SetAllRegisterValid(true);
+        gdb_comm.SetReadRegistersWithGPacket(true);
+      } else {
+        // The remote can't send us the whole register file, so read the
+        // registers one by one from now on.
+        gdb_comm.SetReadRegistersWithGPacket(false);
+      }
+    }
+    if (GetRegisterIsValid(reg)) {
+      // It came along with the rest of the register file.
+    } else if (reg_info->value_regs) {
       // Process this composite register request by delegating to the
       // constituent
       // primordial registers.
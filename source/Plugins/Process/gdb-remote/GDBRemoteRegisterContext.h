@@ -78,6 +78,10 @@ public:
   uint32_t ConvertRegisterKindToRegisterNumber(lldb::RegisterKind kind,
                                                uint32_t num) override;
 
+  // Like ReadRegister, but only succeeds if the value is already known, for
+  // example because it was expedited in a stop packet. Never sends a packet.
+  bool ReadCachedRegister(const RegisterInfo *reg_info, RegisterValue &value);
+
 protected:
   friend class ThreadGDBRemote;
 
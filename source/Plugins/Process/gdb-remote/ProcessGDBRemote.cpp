@@ -28,6 +28,7 @@
 #include <mutex>
 #include <sstream>
 
+#include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
@@ -36,7 +37,9 @@
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/Value.h"
+#include "lldb/Core/dwarf.h"
 #include "lldb/DataFormatters/FormatManager.h"
+#include "lldb/Expression/DWARFExpression.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/HostThread.h"
@@ -56,7 +59,16 @@
 #include "lldb/Interpreter/OptionValueProperties.h"
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Interpreter/Property.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/FuncUnwinders.h"
+#include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/DynamicLoader.h"
 #include "lldb/Target/MemoryRegionInfo.h"
@@ -70,6 +82,7 @@
 #include "lldb/Utility/Timer.h"
 
 // Project includes
+#include "GDBRemoteConditionCompiler.h"
 #include "GDBRemoteRegisterContext.h"
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
 #include "Plugins/Process/Utility/GDBRemoteSignals.h"
@@ -113,9 +126,28 @@ static PropertyDefinition g_properties[] = {
      "Specify the default packet timeout in seconds."},
     {"target-definition-file", OptionValue::eTypeFileSpec, true, 0, NULL, NULL,
      "The file that provides the description for remote target registers."},
+    {"use-packet-compression", OptionValue::eTypeBoolean, true, true, NULL,
+     NULL, "If true, ask the remote stub to compress the packets it sends when "
+           "it supports compression. This helps on slow connections but "
+           "mostly adds latency when debugging on the local machine."},
+    {"stub-breakpoint-conditions", OptionValue::eTypeBoolean, true, true, NULL,
+     NULL, "If true, send simple breakpoint conditions to remote stubs that "
+           "can evaluate them, so that breakpoints whose condition is false "
+           "don't stop the process."},
+    {"prefetch-thread-stacks", OptionValue::eTypeBoolean, true, true, NULL,
+     NULL, "If true, read the top of the stacks of all threads that reported "
+           "their stack pointer when the process stops with one "
+           "jMemoryReadMulti packet, so that unwinding them doesn't take a "
+           "round trip per thread."},
     {NULL, OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL}};
 
-enum { ePropertyPacketTimeout, ePropertyTargetDefinitionFile };
+enum {
+  ePropertyPacketTimeout,
+  ePropertyTargetDefinitionFile,
+  ePropertyUsePacketCompression,
+  ePropertyStubBreakpointConditions,
+  ePropertyPrefetchThreadStacks
+};
 
 class PluginProperties : public Properties {
 public:
@@ -145,6 +177,24 @@ public:
     const uint32_t idx = ePropertyTargetDefinitionFile;
     return m_collection_sp->GetPropertyAtIndexAsFileSpec(NULL, idx);
   }
+
+  bool GetUsePacketCompression() const {
+    const uint32_t idx = ePropertyUsePacketCompression;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        NULL, idx, g_properties[idx].default_uint_value != 0);
+  }
+
+  bool GetStubBreakpointConditions() const {
+    const uint32_t idx = ePropertyStubBreakpointConditions;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        NULL, idx, g_properties[idx].default_uint_value != 0);
+  }
+
+  bool GetPrefetchThreadStacks() const {
+    const uint32_t idx = ePropertyPrefetchThreadStacks;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        NULL, idx, g_properties[idx].default_uint_value != 0);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> ProcessKDPPropertiesSP;
@@ -293,6 +343,9 @@ ProcessGDBRemote::ProcessGDBRemote(lldb::TargetSP target_sp,
       GetGlobalPluginProperties()->GetPacketTimeout();
   if (timeout_seconds > 0)
     m_gdb_comm.SetPacketTimeout(std::chrono::seconds(timeout_seconds));
+
+  m_gdb_comm.SetUsePacketCompression(
+      GetGlobalPluginProperties()->GetUsePacketCompression());
 }
 
 //----------------------------------------------------------------------
@@ -1283,6 +1336,8 @@ Status ProcessGDBRemote::DoResume() {
   if (log)
     log->Printf("ProcessGDBRemote::Resume()");
 
+  UpdateBreakpointSiteStopOptions();
+
   ListenerSP listener_sp(
       Listener::MakeListener("gdb-remote.resume-packet-sent"));
   if (listener_sp->StartListeningForEvents(
@@ -2248,6 +2303,22 @@ StateType ProcessGDBRemote::SetThreadStopInfo(StringExtractor &stop_packet) {
             pc = LLDB_INVALID_ADDRESS;
           m_thread_pcs.push_back(pc);
         }
+      } else if (key.compare("skipped-hits") == 0) {
+        // The breakpoint hits the stub skipped since the last stop: the
+        // address, the hits ignored and the hits whose conditions were
+        // false.
+        while (!value.empty()) {
+          llvm::StringRef addr_str, ignored_str, condition_false_str;
+          std::tie(addr_str, value) = value.split(',');
+          std::tie(ignored_str, value) = value.split(',');
+          std::tie(condition_false_str, value) = value.split(',');
+          lldb::addr_t bp_addr;
+          uint32_t ignored, condition_false;
+          if (!addr_str.getAsInteger(16, bp_addr) &&
+              !ignored_str.getAsInteger(16, ignored) &&
+              !condition_false_str.getAsInteger(16, condition_false))
+            AddSkippedBreakpointHits(bp_addr, ignored, condition_false);
+        }
       } else if (key.compare("jstopinfo") == 0) {
         StringExtractor json_extractor(value);
         std::string json;
@@ -2418,6 +2489,51 @@ void ProcessGDBRemote::RefreshStateAfterStop() {
   // Let all threads recover from stopping and do any clean up based
   // on the previous thread state (if any).
   m_thread_list_real.RefreshStateAfterStop();
+
+  PrefetchThreadStacks();
+}
+
+void ProcessGDBRemote::PrefetchThreadStacks() {
+  if (!GetGlobalPluginProperties()->GetPrefetchThreadStacks() ||
+      GetDisableMemoryCache() || !m_gdb_comm.GetMemoryReadMultiSupported())
+    return;
+
+  // Only use the stack pointers that came with the stop packets, asking for
+  // the registers would cost the round trips we are trying to save.
+  std::vector<addr_t> stack_pointers;
+  const size_t num_threads = m_thread_list_real.GetSize(false);
+  for (size_t i = 0; i < num_threads; ++i) {
+    ThreadSP thread_sp = m_thread_list_real.GetThreadAtIndex(i, false);
+    if (!thread_sp)
+      continue;
+    GDBRemoteRegisterContext *reg_ctx = static_cast<GDBRemoteRegisterContext *>(
+        thread_sp->GetRegisterContext().get());
+    if (!reg_ctx)
+      continue;
+    const uint32_t sp_reg = reg_ctx->ConvertRegisterKindToRegisterNumber(
+        eRegisterKindGeneric, LLDB_REGNUM_GENERIC_SP);
+    RegisterValue sp_value;
+    if (reg_ctx->ReadCachedRegister(reg_ctx->GetRegisterInfoAtIndex(sp_reg),
+                                    sp_value))
+      stack_pointers.push_back(sp_value.GetAsUInt64(LLDB_INVALID_ADDRESS));
+  }
+  stack_pointers.erase(std::remove(stack_pointers.begin(), stack_pointers.end(),
+                                   LLDB_INVALID_ADDRESS),
+                       stack_pointers.end());
+  // A single thread is read on demand just as quickly.
+  if (stack_pointers.size() < 2)
+    return;
+
+  // Reading through the memory cache leaves the data in its L2 cache lines,
+  // where the unwinders will find it.
+  const size_t prefetch_size = GetMemoryCacheLineSize();
+  std::vector<uint8_t> buffer(stack_pointers.size() * prefetch_size);
+  std::vector<MemoryReadRange> ranges;
+  ranges.reserve(stack_pointers.size());
+  for (size_t i = 0; i < stack_pointers.size(); ++i)
+    ranges.emplace_back(stack_pointers[i], &buffer[i * prefetch_size],
+                        prefetch_size);
+  ReadMemoryRanges(ranges);
 }
 
 Status ProcessGDBRemote::DoHalt(bool &caused_stop) {
@@ -2748,6 +2864,22 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   // M and m packets take 2 bytes for 1 byte of memory
   size_t max_memory_size =
       binary_memory_read ? m_max_memory_size : m_max_memory_size / 2;
+
+  // Reads that don't fit into a single packet are streamed back by the stub
+  // with jMemoryReadMulti if it supports it, instead of taking a round trip
+  // for every packet sized piece.
+  if (size > max_memory_size && m_gdb_comm.GetMemoryReadMultiSupported()) {
+    MemoryReadRange range(addr, buf, size);
+    if (m_gdb_comm.ReadMemoryRanges(range)) {
+      if (range.bytes_read == 0)
+        error.SetErrorStringWithFormat("memory read failed for 0x%" PRIx64,
+                                       addr);
+      else
+        error.Clear();
+      return range.bytes_read;
+    }
+  }
+
   if (size > max_memory_size) {
     // Keep memory read sizes down to a sane limit. This function will be
     // called multiple times in order to complete the task by
@@ -2800,6 +2932,29 @@ size_t ProcessGDBRemote::DoReadMemory(addr_t addr, void *buf, size_t size,
   return 0;
 }
 
+void ProcessGDBRemote::DoReadMemoryRanges(
+    llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  if (!m_gdb_comm.GetMemoryReadMultiSupported()) {
+    Process::DoReadMemoryRanges(ranges);
+    return;
+  }
+
+  GetMaxMemorySize();
+  // The data is streamed back, so the size of the ranges doesn't matter. Only
+  // the request has to fit into a packet, every range costs at most this many
+  // bytes in it.
+  const size_t range_request_size = 64;
+  const size_t max_ranges_per_packet =
+      std::max<size_t>(1, m_max_memory_size / range_request_size);
+  while (!ranges.empty()) {
+    llvm::MutableArrayRef<MemoryReadRange> batch =
+        ranges.take_front(std::min(ranges.size(), max_ranges_per_packet));
+    if (!m_gdb_comm.ReadMemoryRanges(batch))
+      Process::DoReadMemoryRanges(batch);
+    ranges = ranges.drop_front(batch.size());
+  }
+}
+
 Status ProcessGDBRemote::WriteObjectFile(
     std::vector<ObjectFile::LoadableData> entries) {
   Status error;
@@ -3161,12 +3316,29 @@ Status ProcessGDBRemote::EnableBreakpointSite(BreakpointSite *bp_site) {
   if (m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware) &&
       (!bp_site->HardwareRequired())) {
     // Try to send off a software breakpoint packet ($Z0)
+    BreakpointSiteStopOptions options;
+    GetBreakpointSiteStopOptions(bp_site, options);
     uint8_t error_no = m_gdb_comm.SendGDBStoppointTypePacket(
-        eBreakpointSoftware, true, addr, bp_op_size);
+        eBreakpointSoftware, true, addr, bp_op_size, options.conditions,
+        options.ignore_count);
+    if (error_no != 0 && !options.IsEmpty()) {
+      // The stub didn't like the stop options, let the debugger handle them.
+      if (log)
+        log->Printf("ProcessGDBRemote::EnableBreakpointSite (site_id = %" PRIu64
+                    ") -- stop options rejected, retrying without them",
+                    site_id);
+      options = BreakpointSiteStopOptions();
+      error_no = m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware,
+                                                       true, addr, bp_op_size);
+    }
     if (error_no == 0) {
       // The breakpoint was placed successfully
       bp_site->SetEnabled(true);
       bp_site->SetType(BreakpointSite::eExternal);
+      if (options.IsEmpty())
+        m_breakpoint_site_stop_options.erase(site_id);
+      else
+        m_breakpoint_site_stop_options[site_id] = std::move(options);
       return error;
     }
 
@@ -3290,6 +3462,8 @@ Status ProcessGDBRemote::DisableBreakpointSite(BreakpointSite *bp_site) {
       if (m_gdb_comm.SendGDBStoppointTypePacket(stoppoint_type, false, addr,
                                                 bp_op_size))
         error.SetErrorToGenericError();
+      else
+        m_breakpoint_site_stop_options.erase(site_id);
     } break;
     }
     if (error.Success())
@@ -3307,6 +3481,361 @@ Status ProcessGDBRemote::DisableBreakpointSite(BreakpointSite *bp_site) {
   return error;
 }
 
+void ProcessGDBRemote::GetBreakpointSiteStopOptions(
+    BreakpointSite *bp_site, BreakpointSiteStopOptions &options) {
+  options = BreakpointSiteStopOptions();
+  if (!GetGlobalPluginProperties()->GetStubBreakpointConditions())
+    return;
+  const bool push_conditions = m_gdb_comm.GetConditionalBreakpointsSupported();
+  const bool push_ignore_count =
+      m_gdb_comm.GetBreakpointIgnoreCountsSupported();
+  if (!push_conditions && !push_ignore_count)
+    return;
+
+  // The stub reports the hits it skips with the next stop, and we count
+  // them as if we had seen them. That doesn't work for owners that want to
+  // look at every hit (internal breakpoints, preconditions), or for thread
+  // specific ones, which only count hits on their thread.
+  bool all_conditions = push_conditions;
+  uint32_t ignore_count = UINT32_MAX;
+  std::vector<std::vector<uint8_t>> conditions;
+  const size_t num_owners = bp_site->GetNumberOfOwners();
+  for (size_t i = 0; i < num_owners; ++i) {
+    BreakpointLocationSP loc_sp = bp_site->GetOwnerAtIndex(i);
+    if (!loc_sp)
+      return;
+    Breakpoint &breakpoint = loc_sp->GetBreakpoint();
+    const BreakpointOptions *thread_options =
+        loc_sp->GetOptionsSpecifyingKind(BreakpointOptions::eThreadSpec);
+    if (breakpoint.IsInternal() || breakpoint.GetPrecondition() ||
+        (thread_options && thread_options->GetThreadSpecNoCreate()))
+      return;
+
+    // A location with options of its own counts down its ignore count and
+    // the breakpoint's, so the hit is ignored while either is non-zero. The
+    // breakpoint's count is also used up by hits of its other locations, so
+    // the stub can only be given it when there is no other location; it
+    // gets the location's own count otherwise. The stub skips a hit only if
+    // every owner ignores it.
+    const bool own_ignore_count =
+        loc_sp->GetOptionsSpecifyingKind(BreakpointOptions::eIgnoreCount) !=
+        breakpoint.GetOptions();
+    uint32_t owner_ignore_count = 0;
+    if (breakpoint.GetNumLocations() == 1)
+      owner_ignore_count =
+          std::max(loc_sp->GetIgnoreCount(), breakpoint.GetIgnoreCount());
+    else if (own_ignore_count)
+      owner_ignore_count = loc_sp->GetIgnoreCount();
+    ignore_count = std::min(ignore_count, owner_ignore_count);
+
+    // The stub stops if any of the conditions is true, so every owner needs
+    // one.
+    if (!all_conditions)
+      continue;
+    const char *condition = loc_sp->GetConditionText();
+    std::vector<uint8_t> bytecode;
+    if (!condition || !condition[0] ||
+        !CompileBreakpointCondition(bp_site->GetLoadAddress(), condition,
+                                    bytecode)) {
+      all_conditions = false;
+      continue;
+    }
+    if (std::find(conditions.begin(), conditions.end(), bytecode) ==
+        conditions.end())
+      conditions.push_back(std::move(bytecode));
+  }
+
+  if (num_owners == 0)
+    return;
+  if (all_conditions)
+    options.conditions = std::move(conditions);
+  if (push_ignore_count)
+    options.ignore_count = ignore_count;
+}
+
+bool ProcessGDBRemote::CompileBreakpointCondition(
+    addr_t addr, llvm::StringRef condition, std::vector<uint8_t> &bytecode) {
+  auto key = std::make_pair(addr, condition.str());
+  auto pos = m_compiled_conditions.find(key);
+  if (pos != m_compiled_conditions.end()) {
+    bytecode = pos->second;
+    return !bytecode.empty();
+  }
+
+  Target &target = GetTarget();
+  Address so_addr;
+  SymbolContext sc;
+  if (target.ResolveLoadAddress(addr, so_addr))
+    so_addr.CalculateSymbolContext(&sc);
+
+  // Push "reg + offset", where "reg" is numbered in "kind".
+  auto emit_register = [this](GDBRemoteConditionCompiler &compiler,
+                              uint32_t kind, uint32_t regnum,
+                              int64_t offset) -> Status {
+    const uint32_t lldb_regnum =
+        m_register_info.ConvertRegisterKindToRegisterNumber(kind, regnum);
+    const RegisterInfo *reg_info =
+        lldb_regnum == LLDB_INVALID_REGNUM
+            ? nullptr
+            : m_register_info.GetRegisterInfoAtIndex(lldb_regnum);
+    if (!reg_info || reg_info->byte_size > 8 ||
+        reg_info->kinds[eRegisterKindProcessPlugin] > UINT16_MAX)
+      return Status("register %u is not known to the stub", regnum);
+    compiler.EmitRegister(reg_info->kinds[eRegisterKindProcessPlugin]);
+    if (offset != 0) {
+      compiler.EmitConstant((uint64_t)offset);
+      compiler.EmitAdd();
+    }
+    return Status();
+  };
+
+  // Push the frame base of the function the breakpoint is in.
+  auto emit_frame_base = [&](GDBRemoteConditionCompiler &compiler) -> Status {
+    if (!sc.function)
+      return Status("no function for the frame base");
+    DWARFExpression &frame_base = sc.function->GetFrameBaseExpression();
+    DataExtractor data;
+    if (frame_base.IsLocationList() || !frame_base.GetExpressionData(data))
+      return Status("unsupported frame base");
+    lldb::offset_t offset = 0;
+    const uint8_t op = data.GetU8(&offset);
+    Status error;
+    if (op >= DW_OP_breg0 && op <= DW_OP_breg31) {
+      const int64_t reg_offset = data.GetSLEB128(&offset);
+      error = emit_register(compiler, frame_base.GetRegisterKind(),
+                            op - DW_OP_breg0, reg_offset);
+    } else if (op >= DW_OP_reg0 && op <= DW_OP_reg31) {
+      error = emit_register(compiler, frame_base.GetRegisterKind(),
+                            op - DW_OP_reg0, 0);
+    } else if (op == DW_OP_call_frame_cfa) {
+      // Use the CFA rule the unwind info has for the breakpoint address.
+      ObjectFile *objfile =
+          sc.module_sp ? sc.module_sp->GetObjectFile() : nullptr;
+      FuncUnwindersSP unwinders_sp =
+          objfile ? objfile->GetUnwindTable().GetFuncUnwindersContainingAddress(
+                        so_addr, sc)
+                  : FuncUnwindersSP();
+      UnwindPlanSP plan_sp =
+          unwinders_sp ? unwinders_sp->GetEHFrameUnwindPlan(target, -1)
+                       : UnwindPlanSP();
+      if (!plan_sp || !plan_sp->PlanValidAtAddress(so_addr))
+        return Status("no unwind information for the frame base");
+      UnwindPlan::RowSP row_sp = plan_sp->GetRowForFunctionOffset(
+          so_addr.GetFileAddress() -
+          plan_sp->GetAddressRange().GetBaseAddress().GetFileAddress());
+      if (!row_sp || !row_sp->GetCFAValue().IsRegisterPlusOffset())
+        return Status("unsupported CFA rule for the frame base");
+      error = emit_register(compiler, plan_sp->GetRegisterKind(),
+                            row_sp->GetCFAValue().GetRegisterNumber(),
+                            row_sp->GetCFAValue().GetOffset());
+    } else
+      return Status("unsupported frame base");
+    if (error.Success() && offset != data.GetByteSize())
+      error.SetErrorString("unsupported frame base");
+    return error;
+  };
+
+  auto resolve_register = [&](llvm::StringRef name,
+                              GDBRemoteConditionCompiler &compiler,
+                              GDBRemoteConditionCompiler::ValueType &type) {
+    const size_t num_regs = m_register_info.GetNumRegisters();
+    for (size_t i = 0; i < num_regs; ++i) {
+      const RegisterInfo *reg_info = m_register_info.GetRegisterInfoAtIndex(i);
+      if (!reg_info || (name != reg_info->name &&
+                        !(reg_info->alt_name && name == reg_info->alt_name)))
+        continue;
+      if (reg_info->byte_size == 0 || reg_info->byte_size > 8 ||
+          reg_info->kinds[eRegisterKindProcessPlugin] > UINT16_MAX)
+        break;
+      compiler.EmitRegister(reg_info->kinds[eRegisterKindProcessPlugin]);
+      type.bit_size = reg_info->byte_size * 8;
+      type.is_signed = false;
+      return Status();
+    }
+    return Status("unsupported register \"%s\"", name.str().c_str());
+  };
+
+  auto resolve_variable = [&](llvm::StringRef name,
+                              GDBRemoteConditionCompiler &compiler,
+                              GDBRemoteConditionCompiler::ValueType &type) {
+    ConstString const_name(name);
+    VariableSP var_sp;
+    VariableList locals;
+    if (sc.block) {
+      sc.block->AppendVariables(true, true, true, nullptr, &locals);
+      var_sp = locals.FindVariable(const_name);
+    }
+    if (!var_sp) {
+      // Members are looked up through "this", don't mistake them for globals.
+      if (locals.FindVariable(ConstString("this")) ||
+          locals.FindVariable(ConstString("self")))
+        return Status("\"%s\" may be a member", name.str().c_str());
+      if (sc.comp_unit) {
+        VariableListSP globals_sp = sc.comp_unit->GetVariableList(true);
+        if (globals_sp)
+          var_sp = globals_sp->FindVariable(const_name);
+      }
+    }
+    if (!var_sp) {
+      VariableList globals;
+      if (target.GetImages().FindGlobalVariables(const_name, true, 2,
+                                                 globals) == 1)
+        var_sp = globals.GetVariableAtIndex(0);
+    }
+    if (!var_sp || var_sp->GetScope() == eValueTypeVariableThreadLocal)
+      return Status("unsupported variable \"%s\"", name.str().c_str());
+
+    Type *var_type = var_sp->GetType();
+    CompilerType compiler_type =
+        var_type ? var_type->GetFullCompilerType() : CompilerType();
+    bool is_signed = false;
+    if (!compiler_type.IsIntegerOrEnumerationType(is_signed)) {
+      if (!compiler_type.IsPointerType())
+        return Status("\"%s\" is not an integer", name.str().c_str());
+      is_signed = false;
+    }
+    const uint64_t byte_size = compiler_type.GetByteSize(nullptr);
+    if (byte_size != 1 && byte_size != 2 && byte_size != 4 && byte_size != 8)
+      return Status("\"%s\" has an unsupported size", name.str().c_str());
+
+    DWARFExpression &location = var_sp->LocationExpression();
+    DataExtractor data;
+    if (location.IsLocationList() || !location.GetExpressionData(data))
+      return Status("unsupported location for \"%s\"", name.str().c_str());
+    lldb::offset_t offset = 0;
+    const uint8_t op = data.GetU8(&offset);
+    bool in_memory = true;
+    Status error;
+    if (op == DW_OP_addr) {
+      const addr_t file_addr = data.GetAddress(&offset);
+      SymbolContext var_sc;
+      var_sp->CalculateSymbolContext(&var_sc);
+      Address var_addr;
+      addr_t load_addr = LLDB_INVALID_ADDRESS;
+      if (var_sc.module_sp &&
+          var_sc.module_sp->ResolveFileAddress(file_addr, var_addr))
+        load_addr = var_addr.GetLoadAddress(&target);
+      if (load_addr == LLDB_INVALID_ADDRESS)
+        return Status("\"%s\" is not loaded", name.str().c_str());
+      compiler.EmitConstant(load_addr);
+    } else if (op == DW_OP_fbreg) {
+      const int64_t fb_offset = data.GetSLEB128(&offset);
+      error = emit_frame_base(compiler);
+      if (error.Success() && fb_offset != 0) {
+        compiler.EmitConstant((uint64_t)fb_offset);
+        compiler.EmitAdd();
+      }
+    } else if (op >= DW_OP_breg0 && op <= DW_OP_breg31) {
+      const int64_t reg_offset = data.GetSLEB128(&offset);
+      error = emit_register(compiler, location.GetRegisterKind(),
+                            op - DW_OP_breg0, reg_offset);
+    } else if (op >= DW_OP_reg0 && op <= DW_OP_reg31) {
+      error = emit_register(compiler, location.GetRegisterKind(),
+                            op - DW_OP_reg0, 0);
+      in_memory = false;
+    } else
+      return Status("unsupported location for \"%s\"", name.str().c_str());
+    if (error.Fail())
+      return error;
+    // Anything after the first operation (pieces, DW_OP_stack_value, ...)
+    // is more than we know how to translate.
+    if (offset != data.GetByteSize())
+      return Status("unsupported location for \"%s\"", name.str().c_str());
+
+    if (in_memory)
+      compiler.EmitLoad(byte_size);
+    type.bit_size = byte_size * 8;
+    type.is_signed = is_signed;
+    return Status();
+  };
+
+  GDBRemoteConditionCompiler compiler(
+      condition, [&](llvm::StringRef name, GDBRemoteConditionCompiler &compiler,
+                     GDBRemoteConditionCompiler::ValueType &type) {
+        if (name.startswith("$"))
+          return resolve_register(name.drop_front(), compiler, type);
+        return resolve_variable(name, compiler, type);
+      });
+  Status error = compiler.Compile(bytecode);
+  if (error.Fail()) {
+    Log *log(
+        ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+    if (log)
+      log->Printf("ProcessGDBRemote::%s can't compile \"%s\" at 0x%" PRIx64
+                  ": %s",
+                  __FUNCTION__, condition.str().c_str(), addr,
+                  error.AsCString());
+    bytecode.clear();
+  }
+  m_compiled_conditions[key] = bytecode;
+  return !bytecode.empty();
+}
+
+void ProcessGDBRemote::UpdateBreakpointSiteStopOptions() {
+  if (!m_gdb_comm.GetConditionalBreakpointsSupported() &&
+      !m_gdb_comm.GetBreakpointIgnoreCountsSupported())
+    return;
+
+  // The stub only takes stop options when a breakpoint is inserted, so
+  // breakpoints whose options changed since have to be reinserted.
+  GetBreakpointSiteList().ForEach([this](BreakpointSite *bp_site) {
+    if (!bp_site->IsEnabled() || bp_site->IsHardware() ||
+        bp_site->GetType() != BreakpointSite::eExternal)
+      return;
+
+    BreakpointSiteStopOptions options;
+    GetBreakpointSiteStopOptions(bp_site, options);
+    auto pos = m_breakpoint_site_stop_options.find(bp_site->GetID());
+    if (pos == m_breakpoint_site_stop_options.end() ? options.IsEmpty()
+                                                    : pos->second == options)
+      return;
+
+    const addr_t addr = bp_site->GetLoadAddress();
+    const size_t bp_op_size = GetSoftwareBreakpointTrapOpcode(bp_site);
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, false, addr,
+                                              bp_op_size))
+      return;
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr,
+                                              bp_op_size, options.conditions,
+                                              options.ignore_count)) {
+      options = BreakpointSiteStopOptions();
+      if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true,
+                                                addr, bp_op_size)) {
+        bp_site->SetEnabled(false);
+        m_breakpoint_site_stop_options.erase(bp_site->GetID());
+        return;
+      }
+    }
+    if (options.IsEmpty())
+      m_breakpoint_site_stop_options.erase(bp_site->GetID());
+    else
+      m_breakpoint_site_stop_options[bp_site->GetID()] = std::move(options);
+  });
+}
+
+void ProcessGDBRemote::AddSkippedBreakpointHits(addr_t addr, uint32_t ignored,
+                                                uint32_t condition_false) {
+  Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+  if (log)
+    log->Printf("ProcessGDBRemote::%s addr = 0x%" PRIx64 ", ignored = %" PRIu32
+                ", condition false = %" PRIu32,
+                __FUNCTION__, addr, ignored, condition_false);
+
+  // A hit whose condition was false doesn't count, just like when we
+  // evaluate the condition ourselves.
+  BreakpointSiteSP bp_site_sp = GetBreakpointSiteList().FindByAddress(addr);
+  if (!bp_site_sp || ignored == 0)
+    return;
+
+  bp_site_sp->AddSkippedHits(ignored);
+
+  // The stub counted its ignore count down the same way, so the options it
+  // holds still match what GetBreakpointSiteStopOptions() computes now.
+  auto pos = m_breakpoint_site_stop_options.find(bp_site_sp->GetID());
+  if (pos != m_breakpoint_site_stop_options.end())
+    pos->second.ignore_count -= std::min(pos->second.ignore_count, ignored);
+}
+
 // Pre-requisite: wp != NULL.
 static GDBStoppointType GetGDBStoppointType(Watchpoint *wp) {
   assert(wp);
@@ -4171,6 +4700,21 @@ StructuredData::ObjectSP ProcessGDBRemote::GetSharedCacheInfo() {
   return object_sp;
 }
 
+void ProcessGDBRemote::AddStatistics(StructuredData::Dictionary &dict) {
+  Process::AddStatistics(dict);
+
+  auto gdb_remote_sp = std::make_shared<StructuredData::Dictionary>();
+  gdb_remote_sp->AddIntegerItem("packetsSent", m_gdb_comm.GetNumPacketsSent());
+  gdb_remote_sp->AddIntegerItem("bytesSent", m_gdb_comm.GetNumBytesSent());
+  gdb_remote_sp->AddIntegerItem("packetsReceived",
+                                m_gdb_comm.GetNumPacketsReceived());
+  gdb_remote_sp->AddIntegerItem("bytesReceived",
+                                m_gdb_comm.GetNumBytesReceived());
+  gdb_remote_sp->AddItem("roundTripTime",
+                         m_gdb_comm.GetRoundTripTimes().ToStructuredData());
+  dict.AddItem("gdbRemote", gdb_remote_sp);
+}
+
 Status ProcessGDBRemote::ConfigureStructuredData(
     const ConstString &type_name, const StructuredData::ObjectSP &config_sp) {
   return m_gdb_comm.ConfigureRemoteStructuredData(type_name, config_sp);
@@ -4921,6 +5465,9 @@ void ProcessGDBRemote::ModulesDidLoad(ModuleList &module_list) {
   // do anything
   Process::ModulesDidLoad(module_list);
 
+  // Variables may have moved, compile breakpoint conditions again.
+  m_compiled_conditions.clear();
+
   // After loading shared libraries, we can ask our remote GDB server if
   // it needs any symbols.
   m_gdb_comm.ServeSymbolLookups(this);
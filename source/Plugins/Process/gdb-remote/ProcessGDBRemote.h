@@ -144,6 +144,9 @@ public:
   size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
                       Status &error) override;
 
+  void
+  DoReadMemoryRanges(llvm::MutableArrayRef<MemoryReadRange> ranges) override;
+
   Status
   WriteObjectFile(std::vector<ObjectFile::LoadableData> entries) override;
 
@@ -247,6 +250,8 @@ public:
 
   StructuredData::ObjectSP GetSharedCacheInfo() override;
 
+  void AddStatistics(StructuredData::Dictionary &dict) override;
+
   std::string HarmonizeThreadIdsForProfileData(
       StringExtractorGDBRemote &inputStringExtractor);
 
@@ -310,6 +315,28 @@ protected:
   using FlashRange = FlashRangeVector::Entry;
   FlashRangeVector m_erased_flash_ranges;
 
+  // What the stub was told about when to stop at a software breakpoint
+  // site: the conditions to evaluate and the number of hits to skip.
+  struct BreakpointSiteStopOptions {
+    std::vector<std::vector<uint8_t>> conditions;
+    uint32_t ignore_count = 0;
+
+    bool IsEmpty() const { return conditions.empty() && ignore_count == 0; }
+
+    bool operator==(const BreakpointSiteStopOptions &rhs) const {
+      return conditions == rhs.conditions && ignore_count == rhs.ignore_count;
+    }
+  };
+
+  // The stop options each software breakpoint site was inserted with, so
+  // that the site can be reinserted when the options of its owners change.
+  std::map<lldb::break_id_t, BreakpointSiteStopOptions>
+      m_breakpoint_site_stop_options;
+  // Compiled conditions by breakpoint address and condition text. An empty
+  // bytecode means the condition couldn't be compiled.
+  std::map<std::pair<lldb::addr_t, std::string>, std::vector<uint8_t>>
+      m_compiled_conditions;
+
   //----------------------------------------------------------------------
   // Accessors
   //----------------------------------------------------------------------
@@ -394,6 +421,10 @@ protected:
 
   bool UpdateThreadIDList();
 
+  // Read the top of the stack of every thread whose stack pointer was
+  // expedited in the stop packets into the memory cache with one request.
+  void PrefetchThreadStacks();
+
   void DidLaunchOrAttach(ArchSpec &process_arch);
 
   Status ConnectToDebugserver(llvm::StringRef host_port);
@@ -422,6 +453,26 @@ protected:
 
   bool HasErased(FlashRange range);
 
+  // Get the conditions and ignore count the stub should apply to "bp_site".
+  // Conditions are only returned if every owner of the site has one that
+  // can be compiled, and nothing is returned if an owner needs to see every
+  // hit.
+  void GetBreakpointSiteStopOptions(BreakpointSite *bp_site,
+                                    BreakpointSiteStopOptions &options);
+
+  bool CompileBreakpointCondition(lldb::addr_t addr, llvm::StringRef condition,
+                                  std::vector<uint8_t> &bytecode);
+
+  // Reinsert the software breakpoints whose stop options changed since they
+  // were inserted.
+  void UpdateBreakpointSiteStopOptions();
+
+  // Account for the hits of the breakpoint at "addr" that the stub skipped
+  // since the last stop, "ignored" of them because of its ignore count and
+  // "condition_false" because its conditions were false.
+  void AddSkippedBreakpointHits(lldb::addr_t addr, uint32_t ignored,
+                                uint32_t condition_false);
+
 private:
   //------------------------------------------------------------------
   // For ProcessGDBRemote only
@@ -20,6 +20,7 @@
 #include "lldb/Utility/StreamString.h"
 #include "lldb/Utility/Timer.h"
 
+#include "DWARFDIEArena.h"
 #include "DWARFDIECollection.h"
 #include "DWARFDebugAbbrev.h"
 #include "DWARFDebugAranges.h"
@@ -83,19 +84,14 @@ DWARFUnitSP DWARFCompileUnit::Extract(SymbolFileDWARF *dwarf2Data,
 
 void DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die) {
   if (m_die_array.size() > 1) {
-    // std::vectors never get any smaller when resized to a smaller size,
-    // or when clear() or erase() are called, the size will report that it
-    // is smaller, but the memory allocated remains intact (call capacity()
-    // to see this). So we need to create a temporary vector and swap the
-    // contents which will cause just the internal pointers to be swapped
-    // so that when "tmp_array" goes out of scope, it will destroy the
-    // contents.
-
-    // Save at least the compile unit DIE
-    DWARFDebugInfoEntry::collection tmp_array;
-    m_die_array.swap(tmp_array);
+    // Hand the array back to the arena, which frees it, but save at least
+    // the compile unit DIE.
+    DWARFDIEArena &arena = m_dwarf2Data->GetDIEArena();
+    DWARFDebugInfoEntry cu_die = m_die_array.front();
+    arena.Release(m_die_array);
+    m_die_array = llvm::MutableArrayRef<DWARFDebugInfoEntry>();
     if (keep_compile_unit_die)
-      m_die_array.push_back(tmp_array.front());
+      m_die_array = arena.Allocate(cu_die);
   }
 
   if (m_dwo_symbol_file)
@@ -118,6 +114,7 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
       func_cat,
       "%8.8x: DWARFCompileUnit::ExtractDIEsIfNeeded( cu_die_only = %i )",
       m_offset, cu_die_only);
+  ElapsedTime elapsed(m_dwarf2Data->GetDebugInfoParseTimeRef());
 
   // Set the offset to that of the first DIE and calculate the start of the
   // next compilation unit header.
@@ -146,6 +143,15 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
   die_index_stack.reserve(32);
   die_index_stack.push_back(0);
   bool prev_die_had_children = false;
+  // The DIEs are collected in a scratch array that is reused by every
+  // extraction on this thread and then copied into exact-size storage from
+  // the DIE arena once the whole unit has been parsed. Extracting another
+  // unit while this one is being parsed (the DWO unit of a skeleton unit)
+  // takes the scratch array over and finds it empty.
+  static thread_local DWARFDebugInfoEntry::collection g_scratch_die_array;
+  DWARFDebugInfoEntry::collection die_array;
+  die_array.swap(g_scratch_die_array);
+  die_array.assign(m_die_array.begin(), m_die_array.end());
   DWARFFormValue::FixedFormSizes fixed_form_sizes =
       DWARFFormValue::GetFixedFormSizesForAddressSize(GetAddressByteSize(),
                                                       m_is_dwarf64);
@@ -160,16 +166,21 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
 
     const bool null_die = die.IsNULL();
     if (depth == 0) {
-      if (initial_die_array_size == 0)
+      if (initial_die_array_size == 0) {
         AddCompileUnitDIE(die);
+        die_array.push_back(die);
+      }
       uint64_t base_addr = die.GetAttributeValueAsAddress(
           m_dwarf2Data, this, DW_AT_low_pc, LLDB_INVALID_ADDRESS);
       if (base_addr == LLDB_INVALID_ADDRESS)
         base_addr = die.GetAttributeValueAsAddress(m_dwarf2Data, this,
                                                    DW_AT_entry_pc, 0);
       SetBaseAddress(base_addr);
-      if (cu_die_only)
+      if (cu_die_only) {
+        die_array.clear();
+        g_scratch_die_array.swap(die_array);
         return 1;
+      }
     } else {
       if (null_die) {
         if (prev_die_had_children) {
@@ -178,18 +189,18 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
           // the NULL DIEs from the list (saves up to 25% in C++ code),
           // we need a way to let the DIE know that it actually doesn't
           // have children.
-          if (!m_die_array.empty())
-            m_die_array.back().SetEmptyChildren(true);
+          if (!die_array.empty())
+            die_array.back().SetEmptyChildren(true);
         }
       } else {
-        die.SetParentIndex(m_die_array.size() - die_index_stack[depth - 1]);
+        die.SetParentIndex(die_array.size() - die_index_stack[depth - 1]);
 
         if (die_index_stack.back())
-          m_die_array[die_index_stack.back()].SetSiblingIndex(
-              m_die_array.size() - die_index_stack.back());
+          die_array[die_index_stack.back()].SetSiblingIndex(
+              die_array.size() - die_index_stack.back());
 
         // Only push the DIE if it isn't a NULL DIE
-        m_die_array.push_back(die);
+        die_array.push_back(die);
       }
     }
 
@@ -205,7 +216,7 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
 
       prev_die_had_children = false;
     } else {
-      die_index_stack.back() = m_die_array.size() - 1;
+      die_index_stack.back() = die_array.size() - 1;
       // Normal DIE
       const bool die_has_children = die.HasChildren();
       if (die_has_children) {
@@ -226,16 +237,16 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
         GetOffset(), offset);
   }
 
-  // Since std::vector objects will double their size, we really need to
-  // make a new array with the perfect size so we don't end up wasting
-  // space. So here we copy and swap to make sure we don't have any extra
-  // memory taken up.
-
-  if (m_die_array.size() < m_die_array.capacity()) {
-    DWARFDebugInfoEntry::collection exact_size_die_array(m_die_array.begin(),
-                                                         m_die_array.end());
-    exact_size_die_array.swap(m_die_array);
+  // Replace the compile unit DIE only array with one that holds all of the
+  // DIEs.
+  if (die_array.size() > m_die_array.size()) {
+    DWARFDIEArena &arena = m_dwarf2Data->GetDIEArena();
+    arena.Release(m_die_array);
+    m_die_array = arena.Allocate(die_array);
   }
+  die_array.clear();
+  g_scratch_die_array.swap(die_array);
+
   Log *log(LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
   if (log && log->GetVerbose()) {
     StreamString strm;
@@ -258,7 +269,7 @@ size_t DWARFCompileUnit::ExtractDIEsIfNeeded(bool cu_die_only) {
 
 void DWARFCompileUnit::AddCompileUnitDIE(DWARFDebugInfoEntry &die) {
   assert(m_die_array.empty() && "Compile unit DIE already added");
-  AddDIE(die);
+  m_die_array = m_dwarf2Data->GetDIEArena().Allocate(die);
 
   const DWARFDebugInfoEntry &cu_die = m_die_array.front();
   std::unique_ptr<SymbolFileDWARFDwo> dwo_symbol_file =
@@ -496,11 +507,9 @@ size_t DWARFCompileUnit::AppendDIEsWithTag(const dw_tag_t tag,
                                            DWARFDIECollection &dies,
                                            uint32_t depth) const {
   size_t old_size = dies.Size();
-  DWARFDebugInfoEntry::const_iterator pos;
-  DWARFDebugInfoEntry::const_iterator end = m_die_array.end();
-  for (pos = m_die_array.begin(); pos != end; ++pos) {
-    if (pos->Tag() == tag)
-      dies.Append(DWARFDIE(this, &(*pos)));
+  for (const DWARFDebugInfoEntry &die : m_die_array) {
+    if (die.Tag() == tag)
+      dies.Append(DWARFDIE(this, &die));
   }
 
   // Return the number of DIEs added to the collection
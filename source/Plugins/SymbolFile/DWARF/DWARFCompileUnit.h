@@ -11,6 +11,7 @@
 #define SymbolFileDWARF_DWARFCompileUnit_h_
 
 #include "DWARFUnit.h"
+#include "llvm/ADT/ArrayRef.h"
 
 class DWARFCompileUnit : public DWARFUnit {
   friend class DWARFUnit;
@@ -41,21 +42,6 @@ public:
   DWARFDIE
   DIE() { return DWARFDIE(this, DIEPtr()); }
 
-  void AddDIE(DWARFDebugInfoEntry &die) {
-    // The average bytes per DIE entry has been seen to be
-    // around 14-20 so lets pre-reserve half of that since
-    // we are now stripping the NULL tags.
-
-    // Only reserve the memory if we are adding children of
-    // the main compile unit DIE. The compile unit DIE is always
-    // the first entry, so if our size is 1, then we are adding
-    // the first compile unit child DIE and should reserve
-    // the memory.
-    if (m_die_array.empty())
-      m_die_array.reserve(GetDebugInfoSize() / 24);
-    m_die_array.push_back(die);
-  }
-
   void AddCompileUnitDIE(DWARFDebugInfoEntry &die);
 
   void SetUserData(void *d);
@@ -82,8 +68,9 @@ protected:
   std::unique_ptr<SymbolFileDWARFDwo> m_dwo_symbol_file;
   const DWARFAbbreviationDeclarationSet *m_abbrevs;
   void *m_user_data = nullptr;
-  DWARFDebugInfoEntry::collection
-      m_die_array; // The compile unit debug information entry item
+  // The compile unit debug information entry items. The storage is owned
+  // by the DWARFDIEArena of m_dwarf2Data.
+  llvm::MutableArrayRef<DWARFDebugInfoEntry> m_die_array;
   std::unique_ptr<DWARFDebugAranges> m_func_aranges_ap; // A table similar to
                                                         // the .debug_aranges
                                                         // table, but this one
@@ -0,0 +1,85 @@
+//===-- DWARFDIEArena.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFDIEArena.h"
+
+#include <memory>
+#include <type_traits>
+
+#include "DWARFDebugInfoEntry.h"
+
+// The arena never runs destructors for the entries it holds.
+static_assert(std::is_trivially_destructible<DWARFDebugInfoEntry>::value,
+              "DWARFDebugInfoEntry must be trivially destructible");
+
+DWARFDIEArena::~DWARFDIEArena() {
+  for (const auto &array : m_arrays)
+    ::operator delete(array.first);
+}
+
+llvm::MutableArrayRef<DWARFDebugInfoEntry>
+DWARFDIEArena::Allocate(llvm::ArrayRef<DWARFDebugInfoEntry> dies) {
+  if (dies.empty())
+    return llvm::MutableArrayRef<DWARFDebugInfoEntry>();
+
+  DWARFDebugInfoEntry *storage = nullptr;
+  if (dies.size() > 1) {
+    const size_t byte_size = dies.size() * sizeof(DWARFDebugInfoEntry);
+    storage = static_cast<DWARFDebugInfoEntry *>(::operator new(byte_size));
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_arrays[storage] = dies.size();
+    m_heap_bytes += byte_size;
+    m_num_dies += dies.size();
+    ++m_num_arrays;
+  } else {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (!m_free_single_dies.empty()) {
+      storage = m_free_single_dies.back();
+      m_free_single_dies.pop_back();
+    } else {
+      storage = m_allocator.Allocate<DWARFDebugInfoEntry>(1);
+    }
+    ++m_num_single_dies;
+    ++m_num_dies;
+    ++m_num_arrays;
+  }
+  std::uninitialized_copy(dies.begin(), dies.end(), storage);
+  return llvm::MutableArrayRef<DWARFDebugInfoEntry>(storage, dies.size());
+}
+
+void DWARFDIEArena::Release(llvm::MutableArrayRef<DWARFDebugInfoEntry> dies) {
+  if (dies.empty())
+    return;
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_num_dies -= dies.size();
+  --m_num_arrays;
+  if (dies.size() > 1) {
+    m_arrays.erase(dies.data());
+    m_heap_bytes -= dies.size() * sizeof(DWARFDebugInfoEntry);
+    ::operator delete(dies.data());
+    return;
+  }
+  if (--m_num_single_dies == 0) {
+    // Reset() would keep the first slab around.
+    m_free_single_dies.clear();
+    m_allocator = llvm::BumpPtrAllocator();
+  } else {
+    m_free_single_dies.push_back(dies.data());
+  }
+}
+
+DWARFDIEArena::Statistics DWARFDIEArena::GetStatistics() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  Statistics stats;
+  stats.bytes_allocated = m_allocator.getTotalMemory() + m_heap_bytes;
+  stats.bytes_used = m_num_dies * sizeof(DWARFDebugInfoEntry);
+  stats.num_dies = m_num_dies;
+  stats.num_arrays = m_num_arrays;
+  return stats;
+}
@@ -0,0 +1,77 @@
+//===-- DWARFDIEArena.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFDIEArena_h_
+#define SymbolFileDWARF_DWARFDIEArena_h_
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "lldb/lldb-defines.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Allocator.h"
+
+class DWARFDebugInfoEntry;
+
+//----------------------------------------------------------------------
+// Backing storage for the flat DIE arrays of all compile units in a
+// symbol file.
+//
+// Each compile unit's DIEs are stored in a single exact-size array, so
+// there is no slack left over from growing a std::vector. Arrays holding
+// all of a unit's DIEs get their own heap block, which is freed as soon as
+// the unit clears its DIEs. Arrays holding only a compile unit DIE, which
+// every unit keeps for as long as it exists, are carved out of a bump
+// allocator instead; released ones are reused, and the bump allocator is
+// reset once none of them are in use.
+//----------------------------------------------------------------------
+class DWARFDIEArena {
+public:
+  struct Statistics {
+    size_t bytes_allocated = 0; // Bytes obtained from the system
+    size_t bytes_used = 0;      // Bytes in arrays handed out to units
+    size_t num_dies = 0;        // DIEs in arrays handed out to units
+    size_t num_arrays = 0;      // Arrays handed out to units
+  };
+
+  DWARFDIEArena() = default;
+
+  ~DWARFDIEArena();
+
+  //------------------------------------------------------------------
+  // Copy "dies" into arena owned storage. Safe to call from multiple
+  // threads.
+  //------------------------------------------------------------------
+  llvm::MutableArrayRef<DWARFDebugInfoEntry>
+  Allocate(llvm::ArrayRef<DWARFDebugInfoEntry> dies);
+
+  //------------------------------------------------------------------
+  // Return an array obtained from Allocate(), freeing its memory.
+  //------------------------------------------------------------------
+  void Release(llvm::MutableArrayRef<DWARFDebugInfoEntry> dies);
+
+  Statistics GetStatistics() const;
+
+private:
+  mutable std::mutex m_mutex;
+  // Single DIE arrays, and the ones that were released.
+  llvm::BumpPtrAllocator m_allocator;
+  std::vector<DWARFDebugInfoEntry *> m_free_single_dies;
+  size_t m_num_single_dies = 0;
+  // Every array of more than one DIE, by address.
+  std::unordered_map<DWARFDebugInfoEntry *, size_t> m_arrays;
+  size_t m_heap_bytes = 0;
+  size_t m_num_dies = 0;
+  size_t m_num_arrays = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(DWARFDIEArena);
+};
+
+#endif // SymbolFileDWARF_DWARFDIEArena_h_
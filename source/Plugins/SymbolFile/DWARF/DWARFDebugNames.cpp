@@ -0,0 +1,370 @@
+//===-- DWARFDebugNames.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFDebugNames.h"
+
+#include "lldb/Utility/Log.h"
+#include "lldb/Utility/RegularExpression.h"
+#include "llvm/Support/MathExtras.h"
+
+#include "LogChannelDWARF.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+static bool IsFunctionTag(dw_tag_t tag) {
+  return tag == DW_TAG_subprogram || tag == DW_TAG_inlined_subroutine;
+}
+
+static bool IsVariableTag(dw_tag_t tag) { return tag == DW_TAG_variable; }
+
+static bool IsNamespaceTag(dw_tag_t tag) { return tag == DW_TAG_namespace; }
+
+static bool IsTypeTag(dw_tag_t tag) {
+  switch (tag) {
+  case DW_TAG_array_type:
+  case DW_TAG_base_type:
+  case DW_TAG_class_type:
+  case DW_TAG_const_type:
+  case DW_TAG_enumeration_type:
+  case DW_TAG_pointer_type:
+  case DW_TAG_ptr_to_member_type:
+  case DW_TAG_reference_type:
+  case DW_TAG_restrict_type:
+  case DW_TAG_rvalue_reference_type:
+  case DW_TAG_string_type:
+  case DW_TAG_structure_type:
+  case DW_TAG_subrange_type:
+  case DW_TAG_subroutine_type:
+  case DW_TAG_typedef:
+  case DW_TAG_union_type:
+  case DW_TAG_unspecified_type:
+  case DW_TAG_volatile_type:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static bool IsASCII(llvm::StringRef name) {
+  for (unsigned char c : name)
+    if (c & 0x80)
+      return false;
+  return true;
+}
+
+DWARFDebugNames::DWARFDebugNames(const DWARFDataExtractor &debug_names_data,
+                                 const DWARFDataExtractor &debug_str_data)
+    : m_data(debug_names_data), m_str_data(debug_str_data), m_name_indexes() {
+  lldb::offset_t offset = 0;
+  while (m_data.ValidOffset(offset)) {
+    NameIndex index;
+    if (!ExtractNameIndex(&offset, index))
+      break;
+    for (uint32_t cu_idx = 0; cu_idx < index.comp_unit_count; ++cu_idx)
+      m_cu_offsets.insert(
+          GetOffsetAtIndex(index, index.cu_list_offset, cu_idx));
+    m_name_indexes.push_back(std::move(index));
+  }
+}
+
+uint32_t DWARFDebugNames::HashName(llvm::StringRef name) {
+  // The DJB hash of the case folded name. Case folding is only done for
+  // ASCII characters; lookups of names with other characters don't use
+  // the hash table.
+  uint32_t hash = 5381;
+  for (unsigned char c : name) {
+    if (c >= 'A' && c <= 'Z')
+      c += 'a' - 'A';
+    hash = (hash << 5) + hash + c;
+  }
+  return hash;
+}
+
+bool DWARFDebugNames::ExtractNameIndex(lldb::offset_t *offset_ptr,
+                                       NameIndex &index) {
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  const lldb::offset_t start_offset = *offset_ptr;
+  const uint64_t unit_length = m_data.GetDWARFInitialLength(offset_ptr);
+  index.is_dwarf64 = m_data.IsDWARF64();
+  index.end_offset = *offset_ptr + unit_length;
+  if (unit_length == 0 || !m_data.ValidOffset(index.end_offset - 1)) {
+    if (log)
+      log->Printf("DWARFDebugNames: invalid unit length at 0x%8.8" PRIx64,
+                  start_offset);
+    return false;
+  }
+
+  const uint16_t version = m_data.GetU16(offset_ptr);
+  if (version != 5) {
+    if (log)
+      log->Printf("DWARFDebugNames: unsupported version %u at 0x%8.8" PRIx64,
+                  version, start_offset);
+    return false;
+  }
+  m_data.GetU16(offset_ptr); // padding
+  index.comp_unit_count = m_data.GetU32(offset_ptr);
+  index.local_type_unit_count = m_data.GetU32(offset_ptr);
+  index.foreign_type_unit_count = m_data.GetU32(offset_ptr);
+  index.bucket_count = m_data.GetU32(offset_ptr);
+  index.name_count = m_data.GetU32(offset_ptr);
+  const uint32_t abbrev_table_size = m_data.GetU32(offset_ptr);
+  const uint32_t augmentation_string_size = m_data.GetU32(offset_ptr);
+  *offset_ptr += llvm::alignTo(augmentation_string_size, 4);
+
+  const uint32_t offset_size = index.is_dwarf64 ? 8 : 4;
+  index.cu_list_offset = *offset_ptr;
+  *offset_ptr += (uint64_t)index.comp_unit_count * offset_size;
+  *offset_ptr += (uint64_t)index.local_type_unit_count * offset_size;
+  *offset_ptr += (uint64_t)index.foreign_type_unit_count * 8;
+  index.buckets_offset = *offset_ptr;
+  *offset_ptr += (uint64_t)index.bucket_count * 4;
+  index.hashes_offset = *offset_ptr;
+  if (index.bucket_count > 0)
+    *offset_ptr += (uint64_t)index.name_count * 4;
+  index.string_offsets_offset = *offset_ptr;
+  *offset_ptr += (uint64_t)index.name_count * offset_size;
+  index.entry_offsets_offset = *offset_ptr;
+  *offset_ptr += (uint64_t)index.name_count * offset_size;
+  const lldb::offset_t abbrev_offset = *offset_ptr;
+  index.entry_pool_offset = abbrev_offset + abbrev_table_size;
+
+  // Always continue with the next name index, even if this one turns out
+  // to be unusable.
+  *offset_ptr = index.end_offset;
+
+  if (index.entry_pool_offset > index.end_offset ||
+      !ExtractAbbrevs(abbrev_offset, index.entry_pool_offset, index)) {
+    if (log)
+      log->Printf("DWARFDebugNames: malformed name index at 0x%8.8" PRIx64,
+                  start_offset);
+    return false;
+  }
+  return true;
+}
+
+bool DWARFDebugNames::ExtractAbbrevs(lldb::offset_t offset,
+                                     lldb::offset_t end, NameIndex &index) {
+  while (offset < end) {
+    const uint64_t code = m_data.GetULEB128(&offset);
+    if (code == 0)
+      return true;
+    Abbrev abbrev;
+    abbrev.tag = m_data.GetULEB128(&offset);
+    while (offset < end) {
+      const uint32_t idx = m_data.GetULEB128(&offset);
+      const dw_form_t form = m_data.GetULEB128(&offset);
+      if (idx == 0 && form == 0)
+        break;
+      abbrev.attributes.push_back(std::make_pair(idx, form));
+    }
+    index.abbrevs[code] = std::move(abbrev);
+  }
+  return false;
+}
+
+uint64_t DWARFDebugNames::GetOffsetAtIndex(const NameIndex &index,
+                                           lldb::offset_t base,
+                                           uint32_t idx) const {
+  const uint32_t offset_size = index.is_dwarf64 ? 8 : 4;
+  lldb::offset_t offset = base + (uint64_t)idx * offset_size;
+  return m_data.GetMaxU64(&offset, offset_size);
+}
+
+const char *DWARFDebugNames::GetName(const NameIndex &index,
+                                     uint32_t name_idx) const {
+  return m_str_data.PeekCStr(
+      GetOffsetAtIndex(index, index.string_offsets_offset, name_idx));
+}
+
+bool DWARFDebugNames::ReadFormValue(dw_form_t form, lldb::offset_t *offset_ptr,
+                                    uint64_t &value) const {
+  switch (form) {
+  case DW_FORM_flag_present:
+    value = 1;
+    return true;
+  case DW_FORM_data1:
+  case DW_FORM_ref1:
+  case DW_FORM_flag:
+    value = m_data.GetU8(offset_ptr);
+    return true;
+  case DW_FORM_data2:
+  case DW_FORM_ref2:
+    value = m_data.GetU16(offset_ptr);
+    return true;
+  case DW_FORM_data4:
+  case DW_FORM_ref4:
+    value = m_data.GetU32(offset_ptr);
+    return true;
+  case DW_FORM_data8:
+  case DW_FORM_ref8:
+  case DW_FORM_ref_sig8:
+    value = m_data.GetU64(offset_ptr);
+    return true;
+  case DW_FORM_udata:
+  case DW_FORM_ref_udata:
+    value = m_data.GetULEB128(offset_ptr);
+    return true;
+  case DW_FORM_sdata:
+    value = m_data.GetSLEB128(offset_ptr);
+    return true;
+  default:
+    return false;
+  }
+}
+
+size_t DWARFDebugNames::AppendEntries(const NameIndex &index,
+                                      uint32_t name_idx,
+                                      const TagPredicate &predicate,
+                                      DIEArray &die_offsets) const {
+  const size_t initial_size = die_offsets.size();
+  lldb::offset_t offset =
+      index.entry_pool_offset +
+      GetOffsetAtIndex(index, index.entry_offsets_offset, name_idx);
+  while (offset < index.end_offset) {
+    const uint64_t code = m_data.GetULEB128(&offset);
+    if (code == 0)
+      break;
+    auto pos = index.abbrevs.find(code);
+    if (pos == index.abbrevs.end())
+      break;
+    const Abbrev &abbrev = pos->second;
+
+    // The compile unit attribute may be omitted when there is only one.
+    uint64_t cu_idx = index.comp_unit_count == 1 ? 0 : UINT64_MAX;
+    uint64_t die_offset = UINT64_MAX;
+    bool in_type_unit = false;
+    for (const auto &attribute : abbrev.attributes) {
+      uint64_t value = 0;
+      if (!ReadFormValue(attribute.second, &offset, value))
+        return die_offsets.size() - initial_size;
+      switch (attribute.first) {
+      case eIdxCompileUnit:
+        cu_idx = value;
+        break;
+      case eIdxTypeUnit:
+        in_type_unit = true;
+        break;
+      case eIdxDIEOffset:
+        die_offset = value;
+        break;
+      default:
+        break;
+      }
+    }
+
+    if (in_type_unit || die_offset == UINT64_MAX ||
+        cu_idx >= index.comp_unit_count || !predicate(abbrev.tag))
+      continue;
+
+    // DW_IDX_die_offset is relative to the start of its unit.
+    const dw_offset_t cu_offset =
+        GetOffsetAtIndex(index, index.cu_list_offset, cu_idx);
+    die_offsets.push_back(DIERef(cu_offset, cu_offset + die_offset));
+  }
+  return die_offsets.size() - initial_size;
+}
+
+size_t DWARFDebugNames::Find(llvm::StringRef name,
+                             const TagPredicate &predicate,
+                             DIEArray &die_offsets) const {
+  const size_t initial_size = die_offsets.size();
+  if (name.empty())
+    return 0;
+
+  const uint32_t hash = HashName(name);
+  const bool use_hash_table = IsASCII(name);
+  for (const NameIndex &index : m_name_indexes) {
+    if (index.bucket_count == 0 || !use_hash_table) {
+      for (uint32_t i = 0; i < index.name_count; ++i) {
+        const char *str = GetName(index, i);
+        if (str && name == str)
+          AppendEntries(index, i, predicate, die_offsets);
+      }
+      continue;
+    }
+
+    const uint32_t bucket = hash % index.bucket_count;
+    lldb::offset_t offset = index.buckets_offset + bucket * 4;
+    // Name indexes in the bucket and hash arrays are one based, zero means
+    // the bucket is empty.
+    uint32_t name_idx = m_data.GetU32(&offset);
+    if (name_idx == 0)
+      continue;
+    for (; name_idx <= index.name_count; ++name_idx) {
+      offset = index.hashes_offset + (name_idx - 1) * 4;
+      const uint32_t name_hash = m_data.GetU32(&offset);
+      if (name_hash % index.bucket_count != bucket)
+        break;
+      if (name_hash != hash)
+        continue;
+      const char *str = GetName(index, name_idx - 1);
+      if (str && name == str)
+        AppendEntries(index, name_idx - 1, predicate, die_offsets);
+    }
+  }
+  return die_offsets.size() - initial_size;
+}
+
+size_t DWARFDebugNames::AppendMatchingRegex(const RegularExpression &regex,
+                                            const TagPredicate &predicate,
+                                            DIEArray &die_offsets) const {
+  const size_t initial_size = die_offsets.size();
+  for (const NameIndex &index : m_name_indexes) {
+    for (uint32_t i = 0; i < index.name_count; ++i) {
+      const char *str = GetName(index, i);
+      if (str && regex.Execute(llvm::StringRef(str)))
+        AppendEntries(index, i, predicate, die_offsets);
+    }
+  }
+  return die_offsets.size() - initial_size;
+}
+
+size_t DWARFDebugNames::FindByName(llvm::StringRef name,
+                                   DIEArray &die_offsets) const {
+  return Find(name, [](dw_tag_t tag) { return true; }, die_offsets);
+}
+
+size_t DWARFDebugNames::FindByNameAndTag(llvm::StringRef name,
+                                         const dw_tag_t tag,
+                                         DIEArray &die_offsets) const {
+  return Find(name, [tag](dw_tag_t entry_tag) { return entry_tag == tag; },
+              die_offsets);
+}
+
+size_t DWARFDebugNames::FindFunctions(llvm::StringRef name,
+                                      DIEArray &die_offsets) const {
+  return Find(name, IsFunctionTag, die_offsets);
+}
+
+size_t DWARFDebugNames::FindGlobalVariables(llvm::StringRef name,
+                                            DIEArray &die_offsets) const {
+  return Find(name, IsVariableTag, die_offsets);
+}
+
+size_t DWARFDebugNames::FindTypes(llvm::StringRef name,
+                                  DIEArray &die_offsets) const {
+  return Find(name, IsTypeTag, die_offsets);
+}
+
+size_t DWARFDebugNames::FindNamespaces(llvm::StringRef name,
+                                       DIEArray &die_offsets) const {
+  return Find(name, IsNamespaceTag, die_offsets);
+}
+
+size_t
+DWARFDebugNames::AppendFunctionsMatchingRegex(const RegularExpression &regex,
+                                              DIEArray &die_offsets) const {
+  return AppendMatchingRegex(regex, IsFunctionTag, die_offsets);
+}
+
+size_t DWARFDebugNames::AppendGlobalVariablesMatchingRegex(
+    const RegularExpression &regex, DIEArray &die_offsets) const {
+  return AppendMatchingRegex(regex, IsVariableTag, die_offsets);
+}
@@ -0,0 +1,141 @@
+//===-- DWARFDebugNames.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFDebugNames_h_
+#define SymbolFileDWARF_DWARFDebugNames_h_
+
+#include <functional>
+#include <vector>
+
+#include "lldb/Core/dwarf.h"
+#include "lldb/lldb-private.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringRef.h"
+
+#include "DIERef.h"
+#include "DWARFDataExtractor.h"
+
+//----------------------------------------------------------------------
+// A reader for the DWARF 5 .debug_names accelerator table.
+//
+// Unlike the Apple accelerator tables, a single .debug_names section
+// contains functions, variables, types and namespaces together, and each
+// entry carries the tag of the DIE it refers to. The section can contain
+// several name indexes (for example one per compile unit when the linker
+// concatenates the sections of each object file); all of them are
+// searched.
+//
+// Only entries that refer to DIEs in compile units are returned. Entries
+// that refer to type units are skipped. Compile units that no name index
+// lists, e.g. the ones of object files built without .debug_names, have
+// to be indexed by other means.
+//----------------------------------------------------------------------
+class DWARFDebugNames {
+public:
+  DWARFDebugNames(const lldb_private::DWARFDataExtractor &debug_names_data,
+                  const lldb_private::DWARFDataExtractor &debug_str_data);
+
+  bool IsValid() const { return !m_name_indexes.empty(); }
+
+  // Whether the names of the compile unit at "cu_offset" are in the index.
+  bool IndexesCompileUnit(dw_offset_t cu_offset) const {
+    return m_cu_offsets.count(cu_offset) != 0;
+  }
+
+  size_t FindByName(llvm::StringRef name, DIEArray &die_offsets) const;
+
+  size_t FindByNameAndTag(llvm::StringRef name, const dw_tag_t tag,
+                          DIEArray &die_offsets) const;
+
+  size_t FindFunctions(llvm::StringRef name, DIEArray &die_offsets) const;
+
+  size_t FindGlobalVariables(llvm::StringRef name,
+                             DIEArray &die_offsets) const;
+
+  size_t FindTypes(llvm::StringRef name, DIEArray &die_offsets) const;
+
+  size_t FindNamespaces(llvm::StringRef name, DIEArray &die_offsets) const;
+
+  size_t
+  AppendFunctionsMatchingRegex(const lldb_private::RegularExpression &regex,
+                               DIEArray &die_offsets) const;
+
+  size_t AppendGlobalVariablesMatchingRegex(
+      const lldb_private::RegularExpression &regex,
+      DIEArray &die_offsets) const;
+
+  static uint32_t HashName(llvm::StringRef name);
+
+protected:
+  typedef std::function<bool(dw_tag_t tag)> TagPredicate;
+
+  // DW_IDX_* index attribute encodings from the DWARF 5 specification.
+  enum IndexAttribute : uint32_t {
+    eIdxCompileUnit = 1,
+    eIdxTypeUnit = 2,
+    eIdxDIEOffset = 3,
+    eIdxParent = 4,
+    eIdxTypeHash = 5
+  };
+
+  struct Abbrev {
+    dw_tag_t tag;
+    std::vector<std::pair<uint32_t, dw_form_t>> attributes;
+  };
+
+  struct NameIndex {
+    bool is_dwarf64;
+    uint32_t comp_unit_count;
+    uint32_t local_type_unit_count;
+    uint32_t foreign_type_unit_count;
+    uint32_t bucket_count;
+    uint32_t name_count;
+    lldb::offset_t cu_list_offset;
+    lldb::offset_t buckets_offset;
+    lldb::offset_t hashes_offset;
+    lldb::offset_t string_offsets_offset;
+    lldb::offset_t entry_offsets_offset;
+    lldb::offset_t entry_pool_offset;
+    lldb::offset_t end_offset;
+    llvm::DenseMap<uint64_t, Abbrev> abbrevs;
+  };
+
+  bool ExtractNameIndex(lldb::offset_t *offset_ptr, NameIndex &index);
+
+  bool ExtractAbbrevs(lldb::offset_t offset, lldb::offset_t end,
+                      NameIndex &index);
+
+  uint64_t GetOffsetAtIndex(const NameIndex &index, lldb::offset_t base,
+                            uint32_t idx) const;
+
+  // "name_idx" is zero based.
+  const char *GetName(const NameIndex &index, uint32_t name_idx) const;
+
+  bool ReadFormValue(dw_form_t form, lldb::offset_t *offset_ptr,
+                     uint64_t &value) const;
+
+  size_t AppendEntries(const NameIndex &index, uint32_t name_idx,
+                       const TagPredicate &predicate,
+                       DIEArray &die_offsets) const;
+
+  size_t Find(llvm::StringRef name, const TagPredicate &predicate,
+              DIEArray &die_offsets) const;
+
+  size_t AppendMatchingRegex(const lldb_private::RegularExpression &regex,
+                             const TagPredicate &predicate,
+                             DIEArray &die_offsets) const;
+
+  lldb_private::DWARFDataExtractor m_data;
+  lldb_private::DWARFDataExtractor m_str_data;
+  std::vector<NameIndex> m_name_indexes;
+  llvm::DenseSet<dw_offset_t> m_cu_offsets;
+};
+
+#endif // SymbolFileDWARF_DWARFDebugNames_h_
@@ -0,0 +1,211 @@
+//===-- DWARFIndexCache.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFIndexCache.h"
+
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/DataBufferLLVM.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/Utility/Endian.h"
+#include "lldb/Utility/StreamString.h"
+#include "lldb/Utility/Timer.h"
+#include "lldb/Utility/UUID.h"
+#include "llvm/Support/Chrono.h"
+#include "llvm/Support/DJB.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
+
+#include "LogChannelDWARF.h"
+#include "NameToDIE.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+// "LDIX" in host byte order. Bump kIndexCacheVersion whenever the layout
+// of the cache file or the contents of the name tables change.
+const uint32_t kIndexCacheMagic = 0x4c444958u;
+const uint32_t kIndexCacheVersion = 1;
+const char *kIndexCacheExtension = ".dwarf-index";
+} // namespace
+
+uint32_t DWARFIndexCacheStringTable::Add(ConstString str) {
+  auto insert_result =
+      m_string_to_index.insert(std::make_pair(str.GetCString(), 0u));
+  if (insert_result.second) {
+    insert_result.first->second = m_strings.size();
+    m_strings.push_back(str);
+  }
+  return insert_result.first->second;
+}
+
+void DWARFIndexCacheStringTable::Encode(Stream &strm) const {
+  strm.PutHex32(m_strings.size());
+  for (ConstString str : m_strings)
+    strm.PutCString(str.GetStringRef());
+}
+
+bool DWARFIndexCacheStringTable::Decode(const DataExtractor &data,
+                                        lldb::offset_t *offset_ptr) {
+  m_strings.clear();
+  m_string_to_index.clear();
+  const uint32_t count = data.GetU32(offset_ptr);
+  // Every string takes at least its NULL terminator.
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, count))
+    return false;
+  m_strings.reserve(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    const char *cstr = data.GetCStr(offset_ptr);
+    if (cstr == nullptr)
+      return false;
+    m_strings.push_back(ConstString(cstr));
+  }
+  return true;
+}
+
+DWARFIndexCache::DWARFIndexCache(ObjectFile &objfile, const FileSpec &cache_dir)
+    : m_cache_file(), m_mod_time(0), m_file_offset(0) {
+  const FileSpec &file_spec = objfile.GetFileSpec();
+  if (!cache_dir || !file_spec)
+    return;
+
+  // Object files that were read from memory have no modification time and
+  // can't be safely cached.
+  auto mod_time = FileSystem::GetModificationTime(file_spec);
+  if (mod_time == llvm::sys::TimePoint<>())
+    return;
+  m_mod_time = llvm::sys::toTimeT(mod_time);
+  m_file_offset = objfile.GetFileOffset();
+
+  std::string key;
+  UUID uuid;
+  if (objfile.GetUUID(&uuid) && uuid.IsValid())
+    key = uuid.GetAsString();
+  else
+    key = llvm::formatv("{0}-{1:x-8}",
+                        file_spec.GetFilename().GetStringRef(),
+                        llvm::djbHash(file_spec.GetPath()))
+              .str();
+  // Objects inside of a static archive share the archive's file spec.
+  if (m_file_offset != 0)
+    key += llvm::formatv("-{0:x-}", m_file_offset).str();
+  key += kIndexCacheExtension;
+
+  m_cache_file = cache_dir;
+  m_cache_file.AppendPathComponent(key);
+}
+
+bool DWARFIndexCache::Load(llvm::ArrayRef<NameToDIE *> tables) {
+  if (!IsValid())
+    return false;
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "DWARFIndexCache::Load (%s)",
+                     m_cache_file.GetPath().c_str());
+
+  // The cache file is memory mapped by llvm::MemoryBuffer when it is large
+  // enough for that to pay off.
+  auto data_sp = DataBufferLLVM::CreateFromPath(m_cache_file.GetPath());
+  if (!data_sp)
+    return false;
+
+  DataExtractor data(data_sp, endian::InlHostByteOrder(), sizeof(void *));
+  lldb::offset_t offset = 0;
+  if (data.GetU32(&offset) != kIndexCacheMagic ||
+      data.GetU32(&offset) != kIndexCacheVersion ||
+      data.GetU64(&offset) != m_mod_time ||
+      data.GetU64(&offset) != m_file_offset ||
+      data.GetU32(&offset) != tables.size())
+    return false;
+
+  DWARFIndexCacheStringTable strtab;
+  bool success = strtab.Decode(data, &offset);
+  for (size_t i = 0; success && i < tables.size(); ++i)
+    success = tables[i]->Decode(data, &offset, strtab);
+
+  if (!success) {
+    for (NameToDIE *table : tables)
+      table->Clear();
+    if (Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO))
+      log->Printf("DWARFIndexCache::Load: ignoring corrupt cache file '%s'",
+                  m_cache_file.GetPath().c_str());
+    return false;
+  }
+
+  for (NameToDIE *table : tables)
+    table->Finalize();
+  return true;
+}
+
+bool DWARFIndexCache::Save(llvm::ArrayRef<const NameToDIE *> tables) {
+  if (!IsValid())
+    return false;
+
+  static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+  Timer scoped_timer(func_cat, "DWARFIndexCache::Save (%s)",
+                     m_cache_file.GetPath().c_str());
+
+  const ByteOrder byte_order = endian::InlHostByteOrder();
+  DWARFIndexCacheStringTable strtab;
+  StreamString tables_strm(Stream::eBinary, sizeof(void *), byte_order);
+  for (const NameToDIE *table : tables)
+    table->Encode(tables_strm, strtab);
+
+  StreamString strm(Stream::eBinary, sizeof(void *), byte_order);
+  strm.PutHex32(kIndexCacheMagic);
+  strm.PutHex32(kIndexCacheVersion);
+  strm.PutHex64(m_mod_time);
+  strm.PutHex64(m_file_offset);
+  strm.PutHex32(tables.size());
+  strtab.Encode(strm);
+  strm.Write(tables_strm.GetData(), tables_strm.GetSize());
+
+  namespace fs = llvm::sys::fs;
+  Log *log = LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO);
+  const std::string path = m_cache_file.GetPath();
+  if (std::error_code ec = fs::create_directories(
+          m_cache_file.GetDirectory().GetStringRef(), true,
+          fs::perms::owner_all)) {
+    if (log)
+      log->Printf("DWARFIndexCache::Save: can't create '%s': %s",
+                  m_cache_file.GetDirectory().GetCString(),
+                  ec.message().c_str());
+    return false;
+  }
+
+  // Write to a unique temporary file and rename it into place so that
+  // concurrent debuggers never observe a partially written cache file.
+  int fd = -1;
+  llvm::SmallString<128> temp_path;
+  if (fs::createUniqueFile(path + ".tmp-%%%%%%", fd, temp_path))
+    return false;
+
+  Status error;
+  {
+    File file(fd, true);
+    size_t num_bytes = strm.GetSize();
+    error = file.Write(strm.GetData(), num_bytes);
+    if (error.Success() && num_bytes != strm.GetSize())
+      error.SetErrorString("short write");
+  }
+  if (error.Success()) {
+    if (std::error_code ec = fs::rename(temp_path, path))
+      error.SetErrorString(ec.message());
+  }
+  if (error.Fail()) {
+    fs::remove(temp_path);
+    if (log)
+      log->Printf("DWARFIndexCache::Save: failed to write '%s': %s",
+                  path.c_str(), error.AsCString());
+    return false;
+  }
+  return true;
+}
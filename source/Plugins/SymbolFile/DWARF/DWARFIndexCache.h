@@ -0,0 +1,83 @@
+//===-- DWARFIndexCache.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFIndexCache_h_
+#define SymbolFileDWARF_DWARFIndexCache_h_
+
+#include <vector>
+
+#include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/FileSpec.h"
+#include "lldb/lldb-private.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+
+class NameToDIE;
+
+//----------------------------------------------------------------------
+// Assigns a small integer index to every unique string that is written
+// to an index cache file so each name is only stored once no matter how
+// many NameToDIE tables refer to it.
+//----------------------------------------------------------------------
+class DWARFIndexCacheStringTable {
+public:
+  uint32_t Add(lldb_private::ConstString str);
+
+  void Encode(lldb_private::Stream &strm) const;
+
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr);
+
+  lldb_private::ConstString GetStringAtIndex(uint32_t idx) const {
+    return idx < m_strings.size() ? m_strings[idx]
+                                  : lldb_private::ConstString();
+  }
+
+  size_t GetSize() const { return m_strings.size(); }
+
+private:
+  llvm::DenseMap<const char *, uint32_t> m_string_to_index;
+  std::vector<lldb_private::ConstString> m_strings;
+};
+
+//----------------------------------------------------------------------
+// A persistent on-disk cache for the name tables that
+// SymbolFileDWARF::Index() builds by manually parsing every compile unit.
+//
+// Cache files are keyed by the UUID of the object file (or a hash of its
+// path when there is no UUID) and are invalidated when the modification
+// time of the object file or the cache format version changes.
+//----------------------------------------------------------------------
+class DWARFIndexCache {
+public:
+  DWARFIndexCache(lldb_private::ObjectFile &objfile,
+                  const lldb_private::FileSpec &cache_dir);
+
+  bool IsValid() const { return (bool)m_cache_file; }
+
+  const lldb_private::FileSpec &GetCacheFile() const { return m_cache_file; }
+
+  //------------------------------------------------------------------
+  // Fill in "tables" from the cache file. Returns false, and leaves the
+  // tables untouched, if there is no valid cache entry.
+  //------------------------------------------------------------------
+  bool Load(llvm::ArrayRef<NameToDIE *> tables);
+
+  //------------------------------------------------------------------
+  // Atomically replace the cache entry with the contents of "tables".
+  //------------------------------------------------------------------
+  bool Save(llvm::ArrayRef<const NameToDIE *> tables);
+
+private:
+  lldb_private::FileSpec m_cache_file;
+  uint64_t m_mod_time;
+  uint64_t m_file_offset;
+};
+
+#endif // SymbolFileDWARF_DWARFIndexCache_h_
@@ -149,8 +149,8 @@ DWARFUnit::GetDIE(dw_offset_t die_offset) {
 
     if (ContainsDIEOffset(die_offset)) {
       ExtractDIEsIfNeeded(false);
-      DWARFDebugInfoEntry::iterator end = Data().m_die_array.end();
-      DWARFDebugInfoEntry::iterator pos = lower_bound(
+      DWARFDebugInfoEntry *end = Data().m_die_array.end();
+      DWARFDebugInfoEntry *pos = lower_bound(
           Data().m_die_array.begin(), end, die_offset, CompareDIEOffset);
       if (pos != end) {
         if (die_offset == (*pos).GetOffset())
@@ -322,10 +322,9 @@ void DWARFUnit::IndexPrivate(
     NameToDIE &func_fullnames, NameToDIE &func_methods,
     NameToDIE &func_selectors, NameToDIE &objc_class_selectors,
     NameToDIE &globals, NameToDIE &types, NameToDIE &namespaces) {
-  DWARFDebugInfoEntry::const_iterator pos;
-  DWARFDebugInfoEntry::const_iterator begin =
-      dwarf_cu->Data().m_die_array.begin();
-  DWARFDebugInfoEntry::const_iterator end = dwarf_cu->Data().m_die_array.end();
+  const DWARFDebugInfoEntry *pos;
+  const DWARFDebugInfoEntry *begin = dwarf_cu->Data().m_die_array.begin();
+  const DWARFDebugInfoEntry *end = dwarf_cu->Data().m_die_array.end();
   for (pos = begin; pos != end; ++pos) {
     const DWARFDebugInfoEntry &die = *pos;
 
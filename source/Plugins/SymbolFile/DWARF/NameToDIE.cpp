@@ -10,12 +10,14 @@
 #include "NameToDIE.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Utility/ConstString.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/RegularExpression.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/StreamString.h"
 
 #include "DWARFDebugInfo.h"
 #include "DWARFDebugInfoEntry.h"
+#include "DWARFIndexCache.h"
 #include "SymbolFileDWARF.h"
 
 using namespace lldb;
@@ -79,3 +81,31 @@ void NameToDIE::Append(const NameToDIE &other) {
                  other.m_map.GetValueAtIndexUnchecked(i));
   }
 }
+
+void NameToDIE::Encode(Stream &strm, DWARFIndexCacheStringTable &strtab) const {
+  const uint32_t size = m_map.GetSize();
+  strm.PutHex32(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    const DIERef &die_ref = m_map.GetValueAtIndexUnchecked(i);
+    strm.PutHex32(strtab.Add(m_map.GetCStringAtIndexUnchecked(i)));
+    strm.PutHex32(die_ref.cu_offset);
+    strm.PutHex32(die_ref.die_offset);
+  }
+}
+
+bool NameToDIE::Decode(const DataExtractor &data, lldb::offset_t *offset_ptr,
+                       const DWARFIndexCacheStringTable &strtab) {
+  const uint32_t size = data.GetU32(offset_ptr);
+  if (!data.ValidOffsetForDataOfSize(*offset_ptr, size * 12ull))
+    return false;
+  m_map.Reserve(m_map.GetSize() + size);
+  for (uint32_t i = 0; i < size; ++i) {
+    ConstString name = strtab.GetStringAtIndex(data.GetU32(offset_ptr));
+    const dw_offset_t cu_offset = data.GetU32(offset_ptr);
+    const dw_offset_t die_offset = data.GetU32(offset_ptr);
+    if (!name)
+      return false;
+    m_map.Append(name, DIERef(cu_offset, die_offset));
+  }
+  return true;
+}
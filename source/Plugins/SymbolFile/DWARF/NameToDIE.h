@@ -17,6 +17,7 @@
 #include "lldb/Core/dwarf.h"
 #include "lldb/lldb-defines.h"
 
+class DWARFIndexCacheStringTable;
 class SymbolFileDWARF;
 
 class NameToDIE {
@@ -33,6 +34,8 @@ public:
 
   void Finalize();
 
+  void Clear() { m_map.Clear(); }
+
   size_t Find(const lldb_private::ConstString &name,
               DIEArray &info_array) const;
 
@@ -47,6 +50,17 @@ public:
                              const DIERef &die_ref)> const
               &callback) const;
 
+  //------------------------------------------------------------------
+  // Serialize the name table for the on-disk DWARF index cache. Decoded
+  // tables must be finalized before they are searched.
+  //------------------------------------------------------------------
+  void Encode(lldb_private::Stream &strm,
+              DWARFIndexCacheStringTable &strtab) const;
+
+  bool Decode(const lldb_private::DataExtractor &data,
+              lldb::offset_t *offset_ptr,
+              const DWARFIndexCacheStringTable &strtab);
+
 protected:
   lldb_private::UniqueCStringMap<DIERef> m_map;
 };
@@ -53,6 +53,7 @@
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 
 #include "lldb/Target/Language.h"
+#include "lldb/Target/Platform.h"
 
 #include "lldb/Host/TaskPool.h"
 
@@ -68,6 +69,7 @@
 #include "DWARFDebugRanges.h"
 #include "DWARFDeclContext.h"
 #include "DWARFFormValue.h"
+#include "DWARFIndexCache.h"
 #include "LogChannelDWARF.h"
 #include "SymbolFileDWARFDebugMap.h"
 #include "SymbolFileDWARFDwo.h"
@@ -116,9 +118,24 @@ PropertyDefinition g_properties[] = {
     {"comp-dir-symlink-paths", OptionValue::eTypeFileSpecList, true, 0, nullptr,
      nullptr, "If the DW_AT_comp_dir matches any of these paths the symbolic "
               "links will be resolved at DWARF parse time."},
+    {"enable-index-cache", OptionValue::eTypeBoolean, true, false, nullptr,
+     nullptr, "Save the name tables built when manually indexing DWARF to "
+              "disk and reuse them the next time the same file is loaded."},
+    {"index-cache-path", OptionValue::eTypeFileSpec, true, 0, nullptr, nullptr,
+     "The directory used to store DWARF index cache files. Defaults to a "
+     "directory next to the platform module cache."},
+    {"keep-dies-resident", OptionValue::eTypeBoolean, true, false, nullptr,
+     nullptr, "Keep the DIEs of every compile unit in memory after manually "
+              "indexing DWARF instead of discarding them and parsing them "
+              "again when they are needed."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
-enum { ePropertySymLinkPaths };
+enum {
+  ePropertySymLinkPaths,
+  ePropertyEnableIndexCache,
+  ePropertyIndexCachePath,
+  ePropertyKeepDIEsResident
+};
 
 class PluginProperties : public Properties {
 public:
@@ -138,6 +155,30 @@ public:
     assert(option_value);
     return option_value->GetCurrentValue();
   }
+
+  bool GetEnableIndexCache() const {
+    const uint32_t idx = ePropertyEnableIndexCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+  }
+
+  FileSpec GetIndexCachePath() const {
+    FileSpec cache_path = m_collection_sp->GetPropertyAtIndexAsFileSpec(
+        nullptr, ePropertyIndexCachePath);
+    if (cache_path)
+      return cache_path;
+    cache_path =
+        Platform::GetGlobalPlatformProperties()->GetModuleCacheDirectory();
+    if (cache_path)
+      cache_path.AppendPathComponent(".dwarf-index");
+    return cache_path;
+  }
+
+  bool GetKeepDIEsResident() const {
+    const uint32_t idx = ePropertyKeepDIEsResident;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+  }
 };
 
 typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -399,9 +440,10 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile *objfile)
       m_data_debug_aranges(), m_data_debug_frame(), m_data_debug_info(),
       m_data_debug_line(), m_data_debug_macro(), m_data_debug_loc(),
       m_data_debug_ranges(), m_data_debug_str(), m_data_apple_names(),
-      m_data_apple_types(), m_data_apple_namespaces(), m_abbr(), m_info(),
+      m_data_apple_types(), m_data_apple_namespaces(), m_die_arena(), m_abbr(),
+      m_info(),
       m_line(), m_apple_names_ap(), m_apple_types_ap(), m_apple_namespaces_ap(),
-      m_apple_objc_ap(), m_function_basename_index(),
+      m_apple_objc_ap(), m_debug_names_ap(), m_function_basename_index(),
       m_function_fullname_index(), m_function_method_index(),
       m_function_selector_index(), m_objc_class_selectors_index(),
       m_global_index(), m_type_index(), m_namespace_index(), m_indexed(false),
@@ -487,6 +529,19 @@ void SymbolFileDWARF::InitializeObject() {
     else
       m_apple_objc_ap.reset();
   }
+
+  // The DWARF 5 name index is only used when there are no Apple accelerator
+  // tables. The compile units it doesn't cover are still indexed manually,
+  // and lookups search both.
+  if (!m_using_apple_tables) {
+    get_debug_names_data();
+    if (m_data_debug_names.m_data.GetByteSize() > 0) {
+      m_debug_names_ap.reset(new DWARFDebugNames(m_data_debug_names.m_data,
+                                                 get_debug_str_data()));
+      if (!m_debug_names_ap->IsValid())
+        m_debug_names_ap.reset();
+    }
+  }
 }
 
 bool SymbolFileDWARF::SupportedVersion(uint16_t version) {
@@ -593,6 +648,7 @@ SymbolFileDWARF::GetCachedSectionData(lldb::SectionType sect_type,
                                       DWARFDataSegment &data_segment) {
   llvm::call_once(data_segment.m_flag, [this, sect_type, &data_segment] {
     this->LoadSectionData(sect_type, std::ref(data_segment.m_data));
+    m_debug_info_bytes_parsed += data_segment.m_data.GetByteSize();
   });
   return data_segment.m_data;
 }
@@ -681,6 +737,11 @@ const DWARFDataExtractor &SymbolFileDWARF::get_apple_objc_data() {
   return GetCachedSectionData(eSectionTypeDWARFAppleObjC, m_data_apple_objc);
 }
 
+const DWARFDataExtractor &SymbolFileDWARF::get_debug_names_data() {
+  return GetCachedSectionData(eSectionTypeDWARFDebugNames,
+                              m_data_debug_names);
+}
+
 DWARFDebugAbbrev *SymbolFileDWARF::DebugAbbrev() {
   if (m_abbr.get() == NULL) {
     const DWARFDataExtractor &debug_abbrev_data = get_debug_abbrev_data();
@@ -1467,8 +1528,11 @@ bool SymbolFileDWARF::CompleteType(CompilerType &compiler_type) {
           type->GetName().AsCString());
     assert(compiler_type);
     DWARFASTParser *dwarf_ast = dwarf_die.GetDWARFParser();
-    if (dwarf_ast)
-      return dwarf_ast->CompleteTypeFromDWARF(dwarf_die, type, compiler_type);
+    if (dwarf_ast &&
+        dwarf_ast->CompleteTypeFromDWARF(dwarf_die, type, compiler_type)) {
+      ++m_num_types_completed;
+      return true;
+    }
   }
   return false;
 }
@@ -1992,6 +2056,14 @@ void SymbolFileDWARF::PreloadSymbols() {
   Index();
 }
 
+std::vector<NameToDIE *> SymbolFileDWARF::GetIndexTables() {
+  // The order of the tables is part of the DWARFIndexCache file format.
+  return {&m_function_basename_index, &m_function_fullname_index,
+          &m_function_method_index,   &m_function_selector_index,
+          &m_objc_class_selectors_index, &m_global_index,
+          &m_type_index,              &m_namespace_index};
+}
+
 void SymbolFileDWARF::Index() {
   if (m_indexed)
     return;
@@ -2000,6 +2072,7 @@ void SymbolFileDWARF::Index() {
   Timer scoped_timer(
       func_cat, "SymbolFileDWARF::Index (%s)",
       GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+  ElapsedTime elapsed(m_index_time);
 
   DWARFDebugInfo *debug_info = DebugInfo();
   if (debug_info) {
@@ -2007,6 +2080,24 @@ void SymbolFileDWARF::Index() {
     if (num_compile_units == 0)
       return;
 
+    // Only the compile units that .debug_names doesn't cover need to be
+    // indexed here. The index cache holds complete indexes only.
+    DWARFDebugNames *debug_names = m_debug_names_ap.get();
+    auto needs_index = [debug_names](DWARFUnit *dwarf_cu) {
+      if (!dwarf_cu)
+        return false;
+      return !debug_names ||
+             !debug_names->IndexesCompileUnit(dwarf_cu->GetOffset());
+    };
+
+    std::unique_ptr<DWARFIndexCache> index_cache;
+    if (GetGlobalPluginProperties()->GetEnableIndexCache() && !debug_names) {
+      index_cache.reset(new DWARFIndexCache(
+          *GetObjectFile(), GetGlobalPluginProperties()->GetIndexCachePath()));
+      if (index_cache->Load(GetIndexTables()))
+        return;
+    }
+
     std::vector<NameToDIE> function_basename_index(num_compile_units);
     std::vector<NameToDIE> function_fullname_index(num_compile_units);
     std::vector<NameToDIE> function_method_index(num_compile_units);
@@ -2023,9 +2114,9 @@ void SymbolFileDWARF::Index() {
                       &function_fullname_index, &function_method_index,
                       &function_selector_index, &objc_class_selectors_index,
                       &global_index, &type_index,
-                      &namespace_index](size_t cu_idx) {
+                      &namespace_index, &needs_index](size_t cu_idx) {
       DWARFUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-      if (dwarf_cu) {
+      if (needs_index(dwarf_cu)) {
         dwarf_cu->Index(
             function_basename_index[cu_idx], function_fullname_index[cu_idx],
             function_method_index[cu_idx], function_selector_index[cu_idx],
@@ -2034,9 +2125,10 @@ void SymbolFileDWARF::Index() {
       }
     };
 
-    auto extract_fn = [debug_info, &clear_cu_dies](size_t cu_idx) {
+    auto extract_fn = [debug_info, &clear_cu_dies,
+                       &needs_index](size_t cu_idx) {
       DWARFUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-      if (dwarf_cu) {
+      if (needs_index(dwarf_cu)) {
         // dwarf_cu->ExtractDIEsIfNeeded(false) will return zero if the
         // DIEs for a compile unit have already been parsed.
         if (dwarf_cu->ExtractDIEsIfNeeded(false) > 1)
@@ -2089,11 +2181,32 @@ void SymbolFileDWARF::Index() {
 
     //----------------------------------------------------------------------
     // Keep memory down by clearing DIEs for any compile units if indexing
-    // caused us to load the compile unit's DIEs.
+    // caused us to load the compile unit's DIEs, unless we were asked to
+    // keep them around so they don't need to be parsed again later.
     //----------------------------------------------------------------------
-    for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx) {
-      if (clear_cu_dies[cu_idx])
-        debug_info->GetCompileUnitAtIndex(cu_idx)->ClearDIEs(true);
+    if (!GetGlobalPluginProperties()->GetKeepDIEsResident()) {
+      for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx) {
+        if (clear_cu_dies[cu_idx])
+          debug_info->GetCompileUnitAtIndex(cu_idx)->ClearDIEs(true);
+      }
+    }
+
+    //----------------------------------------------------------------------
+    // DIEs from split DWARF units live in other files whose modification
+    // times are not part of the cache key, so don't cache those indexes.
+    //----------------------------------------------------------------------
+    if (index_cache) {
+      bool has_dwo_units = false;
+      for (uint32_t cu_idx = 0; cu_idx < num_compile_units && !has_dwo_units;
+           ++cu_idx)
+        has_dwo_units =
+            debug_info->GetCompileUnitAtIndex(cu_idx)->GetDwoSymbolFile() !=
+            nullptr;
+      if (!has_dwo_units) {
+        std::vector<NameToDIE *> tables = GetIndexTables();
+        index_cache->Save(std::vector<const NameToDIE *>(tables.begin(),
+                                                         tables.end()));
+      }
     }
 
 #if defined(ENABLE_DEBUG_PRINTF)
@@ -2187,6 +2300,17 @@ uint32_t SymbolFileDWARF::FindGlobalVariables(
       m_apple_names_ap->FindByName(basename, die_offsets);
     }
   } else {
+    if (m_debug_names_ap) {
+      llvm::StringRef basename;
+      llvm::StringRef context;
+
+      if (!CPlusPlusLanguage::ExtractContextAndIdentifier(name.GetCString(),
+                                                          context, basename))
+        basename = name.GetStringRef();
+
+      m_debug_names_ap->FindGlobalVariables(basename, die_offsets);
+    }
+
     // Index the DWARF if we haven't already
     if (!m_indexed)
       Index();
@@ -2292,6 +2416,9 @@ uint32_t SymbolFileDWARF::FindGlobalVariables(const RegularExpression &regex,
         DWARFMappedHash::ExtractDIEArray(hash_data_array, die_offsets);
     }
   } else {
+    if (m_debug_names_ap)
+      m_debug_names_ap->AppendGlobalVariablesMatchingRegex(regex, die_offsets);
+
     // Index the DWARF if we haven't already
     if (!m_indexed)
       Index();
@@ -2635,6 +2762,40 @@ SymbolFileDWARF::FindFunctions(const ConstString &name,
       }
     }
   } else {
+    if (m_debug_names_ap) {
+      // .debug_names contains functions by their DW_AT_name and their
+      // DW_AT_linkage_name, so use the DIEs to decide which of the requested
+      // name types each match satisfies.
+      DIEArray die_offsets;
+      m_debug_names_ap->FindFunctions(name.GetStringRef(), die_offsets);
+      for (const DIERef &die_ref : die_offsets) {
+        DWARFDIE die = info->GetDIE(die_ref);
+        if (!die || resolved_dies.find(die.GetDIE()) != resolved_dies.end())
+          continue;
+
+        const DWARFDIE decl_ctx_die = die.GetParentDeclContextDIE();
+        const bool is_method = decl_ctx_die && decl_ctx_die.IsStructOrClass();
+        const bool has_decl_ctx = parent_decl_ctx && parent_decl_ctx->IsValid();
+        bool matches = false;
+        if ((name_type_mask & eFunctionNameTypeFull) &&
+            DIEInDeclContext(parent_decl_ctx, die)) {
+          const char *mangled_name = die.GetMangledName();
+          matches = (mangled_name && name.GetStringRef() == mangled_name) ||
+                    !decl_ctx_die ||
+                    decl_ctx_die.Tag() == DW_TAG_compile_unit;
+        }
+        if (!matches && (name_type_mask & eFunctionNameTypeBase) && !is_method)
+          matches = DIEInDeclContext(parent_decl_ctx, die);
+        if (!matches && (name_type_mask & eFunctionNameTypeMethod) && is_method)
+          matches = !has_decl_ctx;
+        if (!matches && (name_type_mask & eFunctionNameTypeSelector))
+          matches = !has_decl_ctx &&
+                    ObjCLanguage::IsPossibleObjCMethodName(die.GetName());
+
+        if (matches && ResolveFunction(die, include_inlines, sc_list))
+          resolved_dies.insert(die.GetDIE());
+      }
+    }
 
     // Index the DWARF if we haven't already
     if (!m_indexed)
@@ -2765,6 +2926,12 @@ uint32_t SymbolFileDWARF::FindFunctions(const RegularExpression &regex,
     if (m_apple_names_ap.get())
       FindFunctions(regex, *m_apple_names_ap, include_inlines, sc_list);
   } else {
+    if (m_debug_names_ap) {
+      DIEArray die_offsets;
+      if (m_debug_names_ap->AppendFunctionsMatchingRegex(regex, die_offsets))
+        ParseFunctions(die_offsets, include_inlines, sc_list);
+    }
+
     // Index the DWARF if we haven't already
     if (!m_indexed)
       Index();
@@ -2855,6 +3022,9 @@ uint32_t SymbolFileDWARF::FindTypes(
       m_apple_types_ap->FindByName(name.GetStringRef(), die_offsets);
     }
   } else {
+    if (m_debug_names_ap)
+      m_debug_names_ap->FindTypes(name.GetStringRef(), die_offsets);
+
     if (!m_indexed)
       Index();
 
@@ -2948,6 +3118,9 @@ size_t SymbolFileDWARF::FindTypes(const std::vector<CompilerContext> &context,
       m_apple_types_ap->FindByName(name.GetStringRef(), die_offsets);
     }
   } else {
+    if (m_debug_names_ap)
+      m_debug_names_ap->FindTypes(name.GetStringRef(), die_offsets);
+
     if (!m_indexed)
       Index();
 
@@ -3016,6 +3189,9 @@ SymbolFileDWARF::FindNamespace(const SymbolContext &sc, const ConstString &name,
         m_apple_namespaces_ap->FindByName(name.GetStringRef(), die_offsets);
       }
     } else {
+      if (m_debug_names_ap)
+        m_debug_names_ap->FindNamespaces(name.GetStringRef(), die_offsets);
+
       if (!m_indexed)
         Index();
 
@@ -3414,6 +3590,11 @@ TypeSP SymbolFileDWARF::FindDefinitionTypeForDWARFDeclContext(
           }
         }
       } else {
+        if (m_debug_names_ap) {
+          m_debug_names_ap->FindByNameAndTag(type_name.GetStringRef(), tag,
+                                             die_offsets);
+        }
+
         if (!m_indexed)
           Index();
 
@@ -4301,6 +4482,16 @@ size_t SymbolFileDWARF::ParseVariables(const SymbolContext &sc,
   return vars_added;
 }
 
+void SymbolFileDWARF::AddStatistics(StructuredData::Dictionary &dict) {
+  const DWARFDIEArena::Statistics arena_stats = m_die_arena.GetStatistics();
+  auto arena_sp = std::make_shared<StructuredData::Dictionary>();
+  arena_sp->AddIntegerItem("bytesAllocated", arena_stats.bytes_allocated);
+  arena_sp->AddIntegerItem("bytesUsed", arena_stats.bytes_used);
+  arena_sp->AddIntegerItem("numDIEs", arena_stats.num_dies);
+  arena_sp->AddIntegerItem("numArrays", arena_stats.num_arrays);
+  dict.AddItem("dieArena", arena_sp);
+}
+
 //------------------------------------------------------------------
 // PluginInterface protocol
 //------------------------------------------------------------------
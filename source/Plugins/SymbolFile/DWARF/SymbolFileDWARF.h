@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <list>
 #include <map>
 #include <mutex>
@@ -36,7 +37,9 @@
 #include "lldb/lldb-private.h"
 
 // Project includes
+#include "DWARFDIEArena.h"
 #include "DWARFDataExtractor.h"
+#include "DWARFDebugNames.h"
 #include "DWARFDefines.h"
 #include "HashedNameToDIE.h"
 #include "NameToDIE.h"
@@ -148,6 +151,27 @@ public:
 
   bool CompleteType(lldb_private::CompilerType &compiler_type) override;
 
+  lldb_private::StatsDuration::Duration GetDebugInfoParseTime() override {
+    return m_parse_time.get();
+  }
+
+  lldb_private::StatsDuration::Duration GetDebugInfoIndexTime() override {
+    return m_index_time.get();
+  }
+
+  uint64_t GetDebugInfoBytesParsed() override {
+    return m_debug_info_bytes_parsed;
+  }
+
+  uint32_t GetNumTypesCompleted() override { return m_num_types_completed; }
+
+  void AddStatistics(lldb_private::StructuredData::Dictionary &dict) override;
+
+  // The time spent extracting DIEs, which the compile units add to.
+  lldb_private::StatsDuration &GetDebugInfoParseTimeRef() {
+    return m_parse_time;
+  }
+
   lldb_private::Type *ResolveType(const DWARFDIE &die,
                                   bool assert_not_being_parsed = true,
                                   bool resolve_function_context = false);
@@ -250,6 +274,7 @@ public:
   const lldb_private::DWARFDataExtractor &get_apple_types_data();
   const lldb_private::DWARFDataExtractor &get_apple_namespaces_data();
   const lldb_private::DWARFDataExtractor &get_apple_objc_data();
+  const lldb_private::DWARFDataExtractor &get_debug_names_data();
 
   DWARFDebugAbbrev *DebugAbbrev();
 
@@ -259,6 +284,8 @@ public:
 
   const DWARFDebugInfo *DebugInfo() const;
 
+  DWARFDIEArena &GetDIEArena() { return m_die_arena; }
+
   DWARFDebugRanges *DebugRanges();
 
   const DWARFDebugRanges *DebugRanges() const;
@@ -419,6 +446,8 @@ protected:
 
   void Index();
 
+  std::vector<NameToDIE *> GetIndexTables();
+
   void DumpIndexes();
 
   void SetDebugMapModule(const lldb::ModuleSP &module_sp) {
@@ -495,6 +524,11 @@ protected:
   DWARFDataSegment m_data_apple_types;
   DWARFDataSegment m_data_apple_namespaces;
   DWARFDataSegment m_data_apple_objc;
+  DWARFDataSegment m_data_debug_names;
+
+  // Owns the DIE arrays of the compile units in m_info, so it must outlive
+  // them.
+  DWARFDIEArena m_die_arena;
 
   // The unique pointer items below are generated on demand if and when someone
   // accesses
@@ -506,6 +540,7 @@ protected:
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_types_ap;
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_namespaces_ap;
   std::unique_ptr<DWARFMappedHash::MemoryTable> m_apple_objc_ap;
+  std::unique_ptr<DWARFDebugNames> m_debug_names_ap;
   std::unique_ptr<GlobalVariableMap> m_global_aranges_ap;
 
   typedef std::unordered_map<lldb::offset_t, lldb_private::DebugMacrosSP>
@@ -524,6 +559,10 @@ protected:
   NameToDIE m_type_index;                 // All type DIE offsets
   NameToDIE m_namespace_index;            // All type DIE offsets
   bool m_indexed : 1, m_using_apple_tables : 1, m_fetched_external_modules : 1;
+  lldb_private::StatsDuration m_parse_time;
+  lldb_private::StatsDuration m_index_time;
+  std::atomic<uint64_t> m_debug_info_bytes_parsed{0};
+  std::atomic<uint32_t> m_num_types_completed{0};
   lldb_private::LazyBool m_supports_DW_AT_APPLE_objc_complete_type;
 
   typedef std::shared_ptr<std::set<DIERef>> DIERefSetSP;
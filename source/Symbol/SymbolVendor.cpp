@@ -440,6 +440,7 @@ Symtab *SymbolVendor::GetSymtab() {
     ObjectFile *objfile = module_sp->GetObjectFile();
     if (objfile) {
       // Get symbol table from unified section list.
+      ElapsedTime elapsed(module_sp->GetSymtabParseTime());
       return objfile->GetSymtab();
     }
   }
@@ -15,6 +15,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/STLUtils.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Host/TaskPool.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
@@ -213,192 +214,224 @@ const Symbol *Symtab::SymbolAtIndex(size_t idx) const {
   return nullptr;
 }
 
+namespace {
 //----------------------------------------------------------------------
-// InitNameIndexes
+// The name indexes for a contiguous range of symbols. InitNameIndexes
+// fills in one of these per range in parallel and merges them once all
+// of the symbols have been demangled.
 //----------------------------------------------------------------------
-void Symtab::InitNameIndexes() {
-  // Protected function, no need to lock mutex...
-  if (!m_name_indexes_computed) {
-    m_name_indexes_computed = true;
-    static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
-    Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
-    // Create the name index vector to be able to quickly search by name
-    const size_t num_symbols = m_symbols.size();
-#if 1
-    m_name_to_index.Reserve(num_symbols);
-#else
-    // TODO: benchmark this to see if we save any memory. Otherwise we
-    // will always keep the memory reserved in the vector unless we pull
-    // some STL swap magic and then recopy...
-    uint32_t actual_count = 0;
-    for (const_iterator pos = m_symbols.begin(), end = m_symbols.end();
-         pos != end; ++pos) {
-      const Mangled &mangled = pos->GetMangled();
-      if (mangled.GetMangledName())
-        ++actual_count;
-
-      if (mangled.GetDemangledName())
-        ++actual_count;
-    }
-
-    m_name_to_index.Reserve(actual_count);
-#endif
-
-    NameToIndexMap::Entry entry;
+struct NameIndexShard {
+  Symtab::NameToIndexMap name_to_index;
+  Symtab::NameToIndexMap basename_to_index;
+  Symtab::NameToIndexMap method_to_index;
+  Symtab::NameToIndexMap selector_to_index;
+  // The "const char *" in "class_contexts" must come from a
+  // ConstString::GetCString()
+  std::set<const char *> class_contexts;
+  // C++ functions whose context wasn't known to be a class when they were
+  // indexed, along with that context.
+  std::vector<std::pair<Symtab::NameToIndexMap::Entry, const char *>>
+      unknown_context_entries;
+};
 
-    // The "const char *" in "class_contexts" must come from a
-    // ConstString::GetCString()
-    std::set<const char *> class_contexts;
-    UniqueCStringMap<uint32_t> mangled_name_to_index;
-    std::vector<const char *> symbol_contexts(num_symbols, nullptr);
+// The number of symbols demangled and indexed by a single task.
+const size_t kSymbolsPerNameIndexShard = 16 * 1024;
+
+void IndexSymbolNames(ObjectFile *objfile, const Symbol *symbol,
+                      uint32_t symbol_idx, NameIndexShard &shard) {
+  // Don't let trampolines get into the lookup by name map
+  // If we ever need the trampoline symbols to be searchable by name
+  // we can remove this and then possibly add a new bool to any of the
+  // Symtab functions that lookup symbols by name to indicate if they
+  // want trampolines.
+  if (symbol->IsTrampoline())
+    return;
 
-    for (entry.value = 0; entry.value < num_symbols; ++entry.value) {
-      const Symbol *symbol = &m_symbols[entry.value];
+  Symtab::NameToIndexMap::Entry entry;
+  entry.value = symbol_idx;
 
-      // Don't let trampolines get into the lookup by name map
-      // If we ever need the trampoline symbols to be searchable by name
-      // we can remove this and then possibly add a new bool to any of the
-      // Symtab functions that lookup symbols by name to indicate if they
-      // want trampolines.
-      if (symbol->IsTrampoline())
-        continue;
+  const Mangled &mangled = symbol->GetMangled();
+  entry.cstring = mangled.GetMangledName();
+  if (entry.cstring) {
+    shard.name_to_index.Append(entry);
 
-      const Mangled &mangled = symbol->GetMangled();
-      entry.cstring = mangled.GetMangledName();
-      if (entry.cstring) {
-        m_name_to_index.Append(entry);
-
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(
-                                        entry.cstring.GetStringRef()));
-          m_name_to_index.Append(entry);
-        }
+    if (symbol->ContainsLinkerAnnotations()) {
+      // If the symbol has linker annotations, also add the version without
+      // the annotations.
+      entry.cstring = ConstString(
+          objfile->StripLinkerSymbolAnnotations(entry.cstring.GetStringRef()));
+      shard.name_to_index.Append(entry);
+    }
 
-        const SymbolType symbol_type = symbol->GetType();
-        if (symbol_type == eSymbolTypeCode ||
-            symbol_type == eSymbolTypeResolver) {
-          llvm::StringRef entry_ref(entry.cstring.GetStringRef());
-          if (entry_ref[0] == '_' && entry_ref[1] == 'Z' &&
-              (entry_ref[2] != 'T' && // avoid virtual table, VTT structure,
-                                      // typeinfo structure, and typeinfo
-                                      // name
-               entry_ref[2] != 'G' && // avoid guard variables
-               entry_ref[2] != 'Z'))  // named local entities (if we
-                                          // eventually handle eSymbolTypeData,
-                                          // we will want this back)
-          {
-            CPlusPlusLanguage::MethodName cxx_method(
-                mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
-            entry.cstring = ConstString(cxx_method.GetBasename());
-            if (entry.cstring) {
-              // ConstString objects permanently store the string in the pool so
-              // calling
-              // GetCString() on the value gets us a const char * that will
-              // never go away
-              const char *const_context =
-                  ConstString(cxx_method.GetContext()).GetCString();
-
-              if (!const_context || const_context[0] == 0) {
-                // No context for this function so this has to be a basename
-                m_basename_to_index.Append(entry);
-                // If there is no context (no namespaces or class scopes that
-                // come before the function name) then this also could be a
-                // fullname.
-                m_name_to_index.Append(entry);
+    const SymbolType symbol_type = symbol->GetType();
+    if (symbol_type == eSymbolTypeCode || symbol_type == eSymbolTypeResolver) {
+      llvm::StringRef entry_ref(entry.cstring.GetStringRef());
+      if (entry_ref[0] == '_' && entry_ref[1] == 'Z' &&
+          (entry_ref[2] != 'T' && // avoid virtual table, VTT structure,
+                                  // typeinfo structure, and typeinfo
+                                  // name
+           entry_ref[2] != 'G' && // avoid guard variables
+           entry_ref[2] != 'Z'))  // named local entities (if we
+                                  // eventually handle eSymbolTypeData,
+                                  // we will want this back)
+      {
+        CPlusPlusLanguage::MethodName cxx_method(
+            mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
+        entry.cstring = ConstString(cxx_method.GetBasename());
+        if (entry.cstring) {
+          // ConstString objects permanently store the string in the pool so
+          // calling
+          // GetCString() on the value gets us a const char * that will
+          // never go away
+          const char *const_context =
+              ConstString(cxx_method.GetContext()).GetCString();
+
+          if (!const_context || const_context[0] == 0) {
+            // No context for this function so this has to be a basename
+            shard.basename_to_index.Append(entry);
+            // If there is no context (no namespaces or class scopes that
+            // come before the function name) then this also could be a
+            // fullname.
+            shard.name_to_index.Append(entry);
+          } else {
+            entry_ref = entry.cstring.GetStringRef();
+            if (entry_ref[0] == '~' || !cxx_method.GetQualifiers().empty()) {
+              // The first character of the demangled basename is '~' which
+              // means we have a class destructor. We can use this information
+              // to help us know what is a class and what isn't.
+              shard.class_contexts.insert(const_context);
+              shard.method_to_index.Append(entry);
+            } else {
+              if (shard.class_contexts.find(const_context) !=
+                  shard.class_contexts.end()) {
+                // The current decl context is in our "class_contexts" which
+                // means
+                // this is a method on a class
+                shard.method_to_index.Append(entry);
               } else {
-                entry_ref = entry.cstring.GetStringRef();
-                if (entry_ref[0] == '~' ||
-                    !cxx_method.GetQualifiers().empty()) {
-                  // The first character of the demangled basename is '~' which
-                  // means we have a class destructor. We can use this information
-                  // to help us know what is a class and what isn't.
-                  if (class_contexts.find(const_context) == class_contexts.end())
-                    class_contexts.insert(const_context);
-                  m_method_to_index.Append(entry);
-                } else {
-                  if (class_contexts.find(const_context) !=
-                      class_contexts.end()) {
-                    // The current decl context is in our "class_contexts" which
-                    // means
-                    // this is a method on a class
-                    m_method_to_index.Append(entry);
-                  } else {
-                    // We don't know if this is a function basename or a method,
-                    // so put it into a temporary collection so once we are done
-                    // we can look in class_contexts to see if each entry is a
-                    // class
-                    // or just a function and will put any remaining items into
-                    // m_method_to_index or m_basename_to_index as needed
-                    mangled_name_to_index.Append(entry);
-                    symbol_contexts[entry.value] = const_context;
-                  }
-                }
+                // We don't know if this is a function basename or a method,
+                // so put it into a temporary collection so once we are done
+                // we can look in class_contexts to see if each entry is a
+                // class
+                // or just a function and will put any remaining items into
+                // m_method_to_index or m_basename_to_index as needed
+                shard.unknown_context_entries.push_back(
+                    std::make_pair(entry, const_context));
               }
             }
           }
         }
       }
+    }
+  }
 
-      entry.cstring = mangled.GetDemangledName(symbol->GetLanguage());
-      if (entry.cstring) {
-        m_name_to_index.Append(entry);
+  entry.cstring = mangled.GetDemangledName(symbol->GetLanguage());
+  if (entry.cstring) {
+    shard.name_to_index.Append(entry);
 
-        if (symbol->ContainsLinkerAnnotations()) {
-          // If the symbol has linker annotations, also add the version without
-          // the annotations.
-          entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(
-                                        entry.cstring.GetStringRef()));
-          m_name_to_index.Append(entry);
-        }
-      }
+    if (symbol->ContainsLinkerAnnotations()) {
+      // If the symbol has linker annotations, also add the version without
+      // the annotations.
+      entry.cstring = ConstString(
+          objfile->StripLinkerSymbolAnnotations(entry.cstring.GetStringRef()));
+      shard.name_to_index.Append(entry);
+    }
+  }
 
-      // If the demangled name turns out to be an ObjC name, and
-      // is a category name, add the version without categories to the index
-      // too.
-      ObjCLanguage::MethodName objc_method(entry.cstring.GetStringRef(), true);
-      if (objc_method.IsValid(true)) {
-        entry.cstring = objc_method.GetSelector();
-        m_selector_to_index.Append(entry);
-
-        ConstString objc_method_no_category(
-            objc_method.GetFullNameWithoutCategory(true));
-        if (objc_method_no_category) {
-          entry.cstring = objc_method_no_category;
-          m_name_to_index.Append(entry);
-        }
-      }
+  // If the demangled name turns out to be an ObjC name, and
+  // is a category name, add the version without categories to the index
+  // too.
+  ObjCLanguage::MethodName objc_method(entry.cstring.GetStringRef(), true);
+  if (objc_method.IsValid(true)) {
+    entry.cstring = objc_method.GetSelector();
+    shard.selector_to_index.Append(entry);
+
+    ConstString objc_method_no_category(
+        objc_method.GetFullNameWithoutCategory(true));
+    if (objc_method_no_category) {
+      entry.cstring = objc_method_no_category;
+      shard.name_to_index.Append(entry);
     }
+  }
+}
+} // namespace
 
-    size_t count;
-    if (!mangled_name_to_index.IsEmpty()) {
-      count = mangled_name_to_index.GetSize();
-      for (size_t i = 0; i < count; ++i) {
-        if (mangled_name_to_index.GetValueAtIndex(i, entry.value)) {
-          entry.cstring = mangled_name_to_index.GetCStringAtIndex(i);
-          if (symbol_contexts[entry.value] &&
-              class_contexts.find(symbol_contexts[entry.value]) !=
-                  class_contexts.end()) {
-            m_method_to_index.Append(entry);
-          } else {
-            // If we got here, we have something that had a context (was inside
-            // a namespace or class)
-            // yet we don't know if the entry
-            m_method_to_index.Append(entry);
-            m_basename_to_index.Append(entry);
-          }
+//----------------------------------------------------------------------
+// InitNameIndexes
+//----------------------------------------------------------------------
+void Symtab::InitNameIndexes() {
+  // Protected function, no need to lock mutex...
+  if (!m_name_indexes_computed) {
+    m_name_indexes_computed = true;
+    static Timer::Category func_cat(LLVM_PRETTY_FUNCTION);
+    Timer scoped_timer(func_cat, "%s", LLVM_PRETTY_FUNCTION);
+    StatsDuration unused_index_time;
+    ModuleSP module_sp(m_objfile ? m_objfile->GetModule() : ModuleSP());
+    ElapsedTime elapsed(module_sp ? module_sp->GetSymtabIndexTime()
+                                  : unused_index_time);
+    // Create the name index vector to be able to quickly search by name
+    const size_t num_symbols = m_symbols.size();
+    const size_t num_shards =
+        (num_symbols + kSymbolsPerNameIndexShard - 1) /
+        kSymbolsPerNameIndexShard;
+    std::vector<NameIndexShard> shards(num_shards);
+
+    // Demangling is by far the most expensive part, so do it for ranges of
+    // symbols in parallel.
+    {
+      static Timer::Category index_cat("Symtab::InitNameIndexes (index)");
+      Timer index_timer(index_cat,
+                        "Symtab::InitNameIndexes index %" PRIu64 " symbols",
+                        (uint64_t)num_symbols);
+      auto index_fn = [this, num_symbols, &shards](size_t shard_idx) {
+        const size_t end = std::min(
+            num_symbols, (shard_idx + 1) * kSymbolsPerNameIndexShard);
+        for (size_t i = shard_idx * kSymbolsPerNameIndexShard; i < end; ++i)
+          IndexSymbolNames(m_objfile, &m_symbols[i], i, shards[shard_idx]);
+      };
+      TaskMapOverInt(0, num_shards, index_fn);
+    }
+
+    static Timer::Category merge_cat("Symtab::InitNameIndexes (merge)");
+    Timer merge_timer(merge_cat, "Symtab::InitNameIndexes merge %" PRIu64
+                                 " shards",
+                      (uint64_t)num_shards);
+    std::set<const char *> class_contexts;
+    size_t name_count = 0;
+    for (const NameIndexShard &shard : shards) {
+      class_contexts.insert(shard.class_contexts.begin(),
+                            shard.class_contexts.end());
+      name_count += shard.name_to_index.GetSize();
+    }
+    m_name_to_index.Reserve(name_count);
+    for (const NameIndexShard &shard : shards) {
+      m_name_to_index.Append(shard.name_to_index);
+      m_basename_to_index.Append(shard.basename_to_index);
+      m_method_to_index.Append(shard.method_to_index);
+      m_selector_to_index.Append(shard.selector_to_index);
+
+      for (const auto &pair : shard.unknown_context_entries) {
+        if (class_contexts.find(pair.second) != class_contexts.end()) {
+          m_method_to_index.Append(pair.first);
+        } else {
+          // If we got here, we have something that had a context (was inside
+          // a namespace or class)
+          // yet we don't know if the entry
+          m_method_to_index.Append(pair.first);
+          m_basename_to_index.Append(pair.first);
         }
       }
     }
-    m_name_to_index.Sort();
-    m_name_to_index.SizeToFit();
-    m_selector_to_index.Sort();
-    m_selector_to_index.SizeToFit();
-    m_basename_to_index.Sort();
-    m_basename_to_index.SizeToFit();
-    m_method_to_index.Sort();
-    m_method_to_index.SizeToFit();
+    shards.clear();
+
+    auto finalize_fn = [](NameToIndexMap &map) {
+      map.Sort();
+      map.SizeToFit();
+    };
+    TaskPool::RunTasks([&]() { finalize_fn(m_name_to_index); },
+                       [&]() { finalize_fn(m_selector_to_index); },
+                       [&]() { finalize_fn(m_basename_to_index); },
+                       [&]() { finalize_fn(m_method_to_index); });
   }
 }
 
@@ -867,6 +900,10 @@ void Symtab::InitAddressIndexes() {
   // Protected function, no need to lock mutex...
   if (!m_file_addr_to_index_computed && !m_symbols.empty()) {
     m_file_addr_to_index_computed = true;
+    StatsDuration unused_index_time;
+    ModuleSP module_sp(m_objfile ? m_objfile->GetModule() : ModuleSP());
+    ElapsedTime elapsed(module_sp ? module_sp->GetSymtabIndexTime()
+                                  : unused_index_time);
 
     FileRangeToIndexMap::Entry entry;
     const_iterator begin = m_symbols.begin();
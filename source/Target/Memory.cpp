@@ -11,6 +11,8 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <algorithm>
+#include <set>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/RangeMap.h"
@@ -131,6 +133,18 @@ bool MemoryCache::RemoveInvalidRange(lldb::addr_t base_addr,
 
 size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
                          Status &error) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  bool missed = false;
+  const size_t bytes_read = ReadLocked(addr, dst, dst_len, error, missed);
+  if (missed)
+    ++m_num_misses;
+  else
+    ++m_num_hits;
+  return bytes_read;
+}
+
+size_t MemoryCache::ReadLocked(addr_t addr, void *dst, size_t dst_len,
+                               Status &error, bool &missed) {
   size_t bytes_left = dst_len;
 
   // Check the L1 cache for a range that contain the entire memory read.
@@ -140,7 +154,6 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   // m_L2_cache_line_byte_size bytes in size, so we don't try anything
   // tricky when reading from them (no partial reads from the L1 cache).
 
-  std::lock_guard<std::recursive_mutex> guard(m_mutex);
   if (!m_L1_cache.empty()) {
     AddrRange read_range(addr, dst_len);
     BlockMap::iterator pos = m_L1_cache.upper_bound(addr);
@@ -163,6 +176,7 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   // 4 bytes after the large memory read - so there's little benefit to saving
   // it in the cache.
   if (dst && dst_len > m_L2_cache_line_byte_size) {
+    missed = true;
     size_t bytes_read =
         m_process.ReadMemoryFromInferior(addr, dst, dst_len, error);
     // Add this non block sized range to the L1 cache if we actually read
@@ -231,6 +245,7 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
 
       if (bytes_left > 0) {
         assert((curr_addr % cache_line_byte_size) == 0);
+        missed = true;
         std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(
             new DataBufferHeap(cache_line_byte_size, 0));
         size_t process_bytes_read = m_process.ReadMemoryFromInferior(
@@ -251,6 +266,138 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
   return dst_len - bytes_left;
 }
 
+size_t MemoryCache::ReadRanges(llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  std::lock_guard<std::recursive_mutex> guard(m_mutex);
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+
+  auto is_in_L1_cache = [this](const MemoryReadRange &range) {
+    if (m_L1_cache.empty())
+      return false;
+    BlockMap::iterator pos = m_L1_cache.upper_bound(range.addr);
+    if (pos != m_L1_cache.begin())
+      --pos;
+    AddrRange chunk_range(pos->first, pos->second->GetByteSize());
+    return chunk_range.Contains(AddrRange(range.addr, range.size));
+  };
+
+  // Gather everything that has to come from the process: the missing L2
+  // cache lines of the small ranges and the ranges that are too large to go
+  // through the L2 cache. All of them are read from the process at once.
+  std::vector<MemoryReadRange> requests;
+  std::vector<std::shared_ptr<DataBufferHeap>> line_buffers;
+  std::vector<size_t> direct_range_indexes;
+  std::set<addr_t> requested_lines;
+  uint64_t num_missed_ranges = 0;
+
+  for (MemoryReadRange &range : ranges) {
+    range.bytes_read = 0;
+    if (range.buf == nullptr || range.size == 0 || is_in_L1_cache(range))
+      continue;
+    if (range.size > cache_line_byte_size) {
+      ++num_missed_ranges;
+      continue;
+    }
+
+    bool missed = false;
+    const addr_t end_addr = range.addr + range.size - 1;
+    for (addr_t line_addr = range.addr - (range.addr % cache_line_byte_size);
+         line_addr <= end_addr; line_addr += cache_line_byte_size) {
+      if (m_invalid_ranges.FindEntryThatContains(line_addr))
+        break;
+      if (m_L2_cache.count(line_addr))
+        continue;
+      missed = true;
+      if (!requested_lines.insert(line_addr).second)
+        continue;
+      std::shared_ptr<DataBufferHeap> line_buffer(
+          new DataBufferHeap(cache_line_byte_size, 0));
+      line_buffers.push_back(line_buffer);
+      requests.push_back(MemoryReadRange(line_addr, line_buffer->GetBytes(),
+                                         line_buffer->GetByteSize()));
+      // Don't wrap around at the end of the address space.
+      if (line_addr > line_addr + cache_line_byte_size)
+        break;
+    }
+    if (missed)
+      ++num_missed_ranges;
+  }
+
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    MemoryReadRange &range = ranges[i];
+    if (range.buf != nullptr && range.size > cache_line_byte_size &&
+        !is_in_L1_cache(range)) {
+      direct_range_indexes.push_back(i);
+      requests.push_back(MemoryReadRange(range.addr, range.buf, range.size));
+    }
+  }
+
+  if (!requests.empty())
+    m_process.ReadMemoryRangesFromInferior(requests);
+
+  // Cache the lines we got. Lines that couldn't be read at all are
+  // remembered so the ranges that need them don't try to read them again.
+  std::set<addr_t> failed_lines;
+  for (size_t i = 0; i < line_buffers.size(); ++i) {
+    const MemoryReadRange &request = requests[i];
+    if (request.bytes_read == 0) {
+      failed_lines.insert(request.addr);
+      continue;
+    }
+    if (request.bytes_read != cache_line_byte_size)
+      line_buffers[i]->SetByteSize(request.bytes_read);
+    m_L2_cache[request.addr] = line_buffers[i];
+  }
+
+  size_t total_bytes_read = 0;
+  for (size_t i = 0; i < direct_range_indexes.size(); ++i) {
+    const MemoryReadRange &request = requests[line_buffers.size() + i];
+    MemoryReadRange &range = ranges[direct_range_indexes[i]];
+    range.bytes_read = request.bytes_read;
+    // Add this non block sized range to the L1 cache if we actually read
+    // anything
+    if (range.bytes_read > 0)
+      AddL1CacheData(range.addr, range.buf, range.bytes_read);
+    total_bytes_read += range.bytes_read;
+  }
+
+  // Everything else is in the cache now, so let Read() copy it out.
+  for (size_t i = 0, direct_idx = 0; i < ranges.size(); ++i) {
+    if (direct_idx < direct_range_indexes.size() &&
+        direct_range_indexes[direct_idx] == i) {
+      ++direct_idx;
+      continue;
+    }
+    MemoryReadRange &range = ranges[i];
+    if (range.buf == nullptr || range.size == 0)
+      continue;
+
+    size_t read_size = range.size;
+    if (!failed_lines.empty()) {
+      auto pos = failed_lines.lower_bound(
+          range.addr - (range.addr % cache_line_byte_size));
+      if (pos != failed_lines.end() && *pos < range.addr + range.size)
+        read_size = *pos > range.addr ? *pos - range.addr : 0;
+    }
+    if (read_size == 0)
+      continue;
+
+    Status error;
+    bool missed;
+    range.bytes_read =
+        ReadLocked(range.addr, range.buf, read_size, error, missed);
+    total_bytes_read += range.bytes_read;
+  }
+
+  const uint64_t num_ranges =
+      std::count_if(ranges.begin(), ranges.end(),
+                    [](const MemoryReadRange &range) {
+                      return range.buf != nullptr && range.size != 0;
+                    });
+  m_num_misses += num_missed_ranges;
+  m_num_hits += num_ranges - num_missed_ranges;
+  return total_bytes_read;
+}
+
 AllocatedBlock::AllocatedBlock(lldb::addr_t addr, uint32_t byte_size,
                                uint32_t permissions, uint32_t chunk_size)
     : m_range(addr, byte_size), m_permissions(permissions),
@@ -15,12 +15,16 @@
 #include "lldb/Host/File.h"
 #include "lldb/Host/LockFile.h"
 #include "lldb/Utility/Log.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Path.h"
 
 #include <assert.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <vector>
 
 using namespace lldb;
 using namespace lldb_private;
@@ -28,6 +32,9 @@ using namespace lldb_private;
 namespace {
 
 const char *kModulesSubdir = ".cache";
+const char *kBlobsSubdir = ".blobs";
+const char *kBlobsLockFileName = ".lock";
+const char *kBlobUsedExtension = ".used";
 const char *kLockDirName = ".lock";
 const char *kTempFileName = ".temp";
 const char *kTempSymFileName = ".symtemp";
@@ -51,11 +58,27 @@ class ModuleLock {
 private:
   File m_file;
   std::unique_ptr<lldb_private::LockFile> m_lock;
-  FileSpec m_file_spec;
 
 public:
   ModuleLock(const FileSpec &root_dir_spec, const UUID &uuid, Status &error);
-  void Delete();
+};
+
+// Lock over the content store of a cache. Adding modules only needs a
+// shared lock, while pruning takes an exclusive one and does not wait for
+// it.
+class StoreLock {
+private:
+  File m_file;
+  std::unique_ptr<lldb_private::LockFile> m_lock;
+
+public:
+  StoreLock(const FileSpec &cache_root, bool exclusive, Status &error);
+};
+
+struct Blob {
+  std::string path;
+  uint64_t size;
+  llvm::sys::TimePoint<> last_used;
 };
 
 static FileSpec JoinPath(const FileSpec &path1, const char *path2) {
@@ -70,6 +93,15 @@ static Status MakeDirectory(const FileSpec &dir_path) {
   return fs::create_directories(dir_path.GetPath(), true, fs::perms::owner_all);
 }
 
+// All the platform directories of a cache share its content store.
+FileSpec GetCacheRoot(const FileSpec &root_dir_spec) {
+  return root_dir_spec.CopyByRemovingLastPathComponent();
+}
+
+FileSpec GetBlobDirectory(const FileSpec &cache_root) {
+  return JoinPath(cache_root, kBlobsSubdir);
+}
+
 FileSpec GetModuleDirectory(const FileSpec &root_dir_spec, const UUID &uuid) {
   const auto modules_dir_spec = JoinPath(root_dir_spec, kModulesSubdir);
   return JoinPath(modules_dir_spec, uuid.GetAsString().c_str());
@@ -79,46 +111,9 @@ FileSpec GetSymbolFileSpec(const FileSpec &module_file_spec) {
   return FileSpec(module_file_spec.GetPath() + kSymFileExtension, false);
 }
 
-void DeleteExistingModule(const FileSpec &root_dir_spec,
-                          const FileSpec &sysroot_module_path_spec) {
-  Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_MODULES));
-  UUID module_uuid;
-  {
-    auto module_sp =
-        std::make_shared<Module>(ModuleSpec(sysroot_module_path_spec));
-    module_uuid = module_sp->GetUUID();
-  }
-
-  if (!module_uuid.IsValid())
-    return;
-
-  Status error;
-  ModuleLock lock(root_dir_spec, module_uuid, error);
-  if (error.Fail()) {
-    if (log)
-      log->Printf("Failed to lock module %s: %s",
-                  module_uuid.GetAsString().c_str(), error.AsCString());
-  }
-
-  namespace fs = llvm::sys::fs;
-  fs::file_status st;
-  if (status(sysroot_module_path_spec.GetPath(), st))
-    return;
-
-  if (st.getLinkCount() > 2) // module is referred by other hosts.
-    return;
-
-  const auto module_spec_dir = GetModuleDirectory(root_dir_spec, module_uuid);
-  llvm::sys::fs::remove_directories(module_spec_dir.GetPath());
-  lock.Delete();
-}
-
-void DecrementRefExistingModule(const FileSpec &root_dir_spec,
-                                const FileSpec &sysroot_module_path_spec) {
-  // Remove $platform/.cache/$uuid folder if nobody else references it.
-  DeleteExistingModule(root_dir_spec, sysroot_module_path_spec);
-
-  // Remove sysroot link.
+void DeleteSysRootModuleLink(const FileSpec &sysroot_module_path_spec) {
+  // The module itself stays in the store until it gets pruned, as other
+  // hosts may refer to it.
   llvm::sys::fs::remove(sysroot_module_path_spec.GetPath());
 
   FileSpec symfile_spec = GetSymbolFileSpec(sysroot_module_path_spec);
@@ -133,20 +128,101 @@ Status CreateHostSysRootModuleLink(const FileSpec &root_dir_spec,
   const auto sysroot_module_path_spec =
       JoinPath(JoinPath(root_dir_spec, hostname),
                platform_module_spec.GetPath().c_str());
-  if (sysroot_module_path_spec.Exists()) {
-    if (!delete_existing)
-      return Status();
+  if (sysroot_module_path_spec.Exists() && !delete_existing)
+    return Status();
 
-    DecrementRefExistingModule(root_dir_spec, sysroot_module_path_spec);
-  }
+  // This also removes a link left dangling by pruning.
+  DeleteSysRootModuleLink(sysroot_module_path_spec);
 
   const auto error = MakeDirectory(
       FileSpec(sysroot_module_path_spec.GetDirectory().AsCString(), false));
   if (error.Fail())
     return error;
 
-  return llvm::sys::fs::create_hard_link(local_module_spec.GetPath(),
-                                         sysroot_module_path_spec.GetPath());
+  return llvm::sys::fs::create_link(local_module_spec.GetPath(),
+                                    sysroot_module_path_spec.GetPath());
+}
+
+Status GetBlobFileSpec(const FileSpec &cache_root, const FileSpec &file_spec,
+                       FileSpec &blob_spec) {
+  auto result = llvm::sys::fs::md5_contents(file_spec.GetPath());
+  if (!result)
+    return Status(result.getError());
+  blob_spec = JoinPath(GetBlobDirectory(cache_root), result->digest().c_str());
+  return Status();
+}
+
+void MarkBlobUsed(llvm::StringRef blob_path) {
+  // Truncating the empty stamp file updates its modification time.
+  File stamp((blob_path + kBlobUsedExtension).str().c_str(),
+             File::eOpenOptionWrite | File::eOpenOptionCanCreate |
+                 File::eOpenOptionTruncate | File::eOpenOptionCloseOnExec);
+}
+
+// Mark the store file that a view leads to as used. Real files in views are
+// not part of the store.
+void MarkViewUsed(const FileSpec &cache_root, const FileSpec &view_spec) {
+  llvm::SmallString<128> blob_dir_path;
+  llvm::SmallString<128> blob_path;
+  if (llvm::sys::fs::real_path(GetBlobDirectory(cache_root).GetPath(),
+                               blob_dir_path) ||
+      llvm::sys::fs::real_path(view_spec.GetPath(), blob_path))
+    return;
+  if (llvm::sys::path::parent_path(blob_path) == blob_dir_path)
+    MarkBlobUsed(blob_path);
+}
+
+std::vector<Blob> GetBlobs(const FileSpec &cache_root) {
+  namespace fs = llvm::sys::fs;
+
+  std::vector<Blob> blobs;
+  std::error_code EC;
+  fs::directory_iterator Iter(GetBlobDirectory(cache_root).GetPath(), EC,
+                              false);
+  fs::directory_iterator End;
+  for (; Iter != End && !EC; Iter.increment(EC)) {
+    const std::string &path = Iter->path();
+    // Skip the lock, the usage stamps and the files being added.
+    if (llvm::sys::path::filename(path).find('.') != llvm::StringRef::npos)
+      continue;
+    fs::file_status st;
+    if (fs::status(path, st) || !fs::is_regular_file(st))
+      continue;
+
+    Blob blob{path, st.getSize(), st.getLastModificationTime()};
+    fs::file_status stamp_st;
+    if (!fs::status(path + kBlobUsedExtension, stamp_st))
+      blob.last_used = stamp_st.getLastModificationTime();
+    blobs.push_back(blob);
+  }
+  return blobs;
+}
+
+// Call \a callback with every link found in the platform directories of a
+// cache, and whether it still leads to a file.
+void ForEachView(const FileSpec &cache_root,
+                 llvm::function_ref<void(const std::string &, bool)> callback) {
+  namespace fs = llvm::sys::fs;
+
+  std::error_code EC;
+  fs::directory_iterator Iter(cache_root.GetPath(), EC, false);
+  fs::directory_iterator End;
+  for (; Iter != End && !EC; Iter.increment(EC)) {
+    if (llvm::sys::path::filename(Iter->path()).startswith(".") ||
+        !fs::is_directory(Iter->path()))
+      continue;
+
+    std::error_code platform_EC;
+    fs::recursive_directory_iterator PlatformIter(Iter->path(), platform_EC,
+                                                  false);
+    fs::recursive_directory_iterator PlatformEnd;
+    for (; PlatformIter != PlatformEnd && !platform_EC;
+         PlatformIter.increment(platform_EC)) {
+      const std::string &path = PlatformIter->path();
+      if (fs::is_symlink_file(path))
+        callback(path, fs::exists(path));
+    }
+  }
 }
 
 } // namespace
@@ -158,10 +234,11 @@ ModuleLock::ModuleLock(const FileSpec &root_dir_spec, const UUID &uuid,
   if (error.Fail())
     return;
 
-  m_file_spec = JoinPath(lock_dir_spec, uuid.GetAsString().c_str());
-  m_file.Open(m_file_spec.GetCString(), File::eOpenOptionWrite |
-                                            File::eOpenOptionCanCreate |
-                                            File::eOpenOptionCloseOnExec);
+  const auto lock_file_spec =
+      JoinPath(lock_dir_spec, uuid.GetAsString().c_str());
+  m_file.Open(lock_file_spec.GetCString(), File::eOpenOptionWrite |
+                                               File::eOpenOptionCanCreate |
+                                               File::eOpenOptionCloseOnExec);
   if (!m_file) {
     error.SetErrorToErrno();
     return;
@@ -174,12 +251,27 @@ ModuleLock::ModuleLock(const FileSpec &root_dir_spec, const UUID &uuid,
                                    error.AsCString());
 }
 
-void ModuleLock::Delete() {
-  if (!m_file)
+StoreLock::StoreLock(const FileSpec &cache_root, bool exclusive,
+                     Status &error) {
+  const auto blob_dir_spec = GetBlobDirectory(cache_root);
+  error = MakeDirectory(blob_dir_spec);
+  if (error.Fail())
+    return;
+
+  const auto lock_file_spec = JoinPath(blob_dir_spec, kBlobsLockFileName);
+  m_file.Open(lock_file_spec.GetCString(), File::eOpenOptionWrite |
+                                               File::eOpenOptionCanCreate |
+                                               File::eOpenOptionCloseOnExec);
+  if (!m_file) {
+    error.SetErrorToErrno();
     return;
+  }
 
-  m_file.Close();
-  llvm::sys::fs::remove(m_file_spec.GetPath());
+  m_lock.reset(new lldb_private::LockFile(m_file.GetDescriptor()));
+  error = exclusive ? m_lock->TryWriteLock(0, 1) : m_lock->ReadLock(0, 1);
+  if (error.Fail())
+    error.SetErrorStringWithFormat("Failed to lock file: %s",
+                                   error.AsCString());
 }
 
 /////////////////////////////////////////////////////////////////////////
@@ -193,14 +285,32 @@ Status ModuleCache::Put(const FileSpec &root_dir_spec, const char *hostname,
       JoinPath(module_spec_dir, target_file.GetFilename().AsCString());
 
   const auto tmp_file_path = tmp_file.GetPath();
-  const auto err_code =
-      llvm::sys::fs::rename(tmp_file_path, module_file_path.GetPath());
+  FileSpec blob_spec;
+  auto error =
+      GetBlobFileSpec(GetCacheRoot(root_dir_spec), tmp_file, blob_spec);
+  if (error.Fail())
+    return Status("Failed to hash file %s: %s", tmp_file_path.c_str(),
+                  error.AsCString());
+
+  // Keep a single copy of identical files.
+  std::error_code err_code;
+  if (blob_spec.Exists())
+    llvm::sys::fs::remove(tmp_file_path);
+  else
+    err_code = llvm::sys::fs::rename(tmp_file_path, blob_spec.GetPath());
   if (err_code)
     return Status("Failed to rename file %s to %s: %s", tmp_file_path.c_str(),
-                  module_file_path.GetPath().c_str(),
-                  err_code.message().c_str());
+                  blob_spec.GetPath().c_str(), err_code.message().c_str());
+  MarkBlobUsed(blob_spec.GetPath());
 
-  const auto error = CreateHostSysRootModuleLink(
+  llvm::sys::fs::remove(module_file_path.GetPath());
+  err_code = llvm::sys::fs::create_link(blob_spec.GetPath(),
+                                        module_file_path.GetPath());
+  if (err_code)
+    return Status("Failed to create link to %s: %s",
+                  blob_spec.GetPath().c_str(), err_code.message().c_str());
+
+  error = CreateHostSysRootModuleLink(
       root_dir_spec, hostname, target_file, module_file_path, true);
   if (error.Fail())
     return Status("Failed to create link to %s: %s",
@@ -231,6 +341,10 @@ Status ModuleCache::Get(const FileSpec &root_dir_spec, const char *hostname,
     return Status("Module %s has invalid file size",
                   module_file_path.GetPath().c_str());
 
+  const auto cache_root = GetCacheRoot(root_dir_spec);
+  MarkViewUsed(cache_root, module_file_path);
+  MarkViewUsed(cache_root, GetSymbolFileSpec(module_file_path));
+
   // We may have already cached module but downloaded from an another host - in
   // this case let's create a link to it.
   auto error = CreateHostSysRootModuleLink(root_dir_spec, hostname,
@@ -267,7 +381,42 @@ Status ModuleCache::GetAndPut(const FileSpec &root_dir_spec,
                               const ModuleDownloader &module_downloader,
                               const SymfileDownloader &symfile_downloader,
                               lldb::ModuleSP &cached_module_sp,
-                              bool *did_create_ptr) {
+                              bool *did_create_ptr, uint64_t max_cache_size) {
+  const auto cache_root = GetCacheRoot(root_dir_spec);
+  bool did_put = false;
+  Status error;
+  {
+    StoreLock store_lock(cache_root, false, error);
+    if (error.Fail())
+      return Status("Failed to lock module cache %s: %s",
+                    cache_root.GetPath().c_str(), error.AsCString());
+
+    error = GetAndPutLocked(root_dir_spec, hostname, module_spec,
+                            module_downloader, symfile_downloader,
+                            cached_module_sp, did_create_ptr, did_put);
+  }
+
+  // Pruning needs the store to itself, so it has to wait until our shared
+  // lock is released. If another debugger is using the cache, it will
+  // prune it after its own downloads instead.
+  if (did_put && max_cache_size != 0) {
+    Statistics removed;
+    Status prune_error = Prune(cache_root, max_cache_size, removed);
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_MODULES));
+    if (log)
+      log->Printf("Pruning module cache %s: %s", cache_root.GetPath().c_str(),
+                  prune_error.Success() ? "success" : prune_error.AsCString());
+  }
+  return error;
+}
+
+Status ModuleCache::GetAndPutLocked(const FileSpec &root_dir_spec,
+                                    const char *hostname,
+                                    const ModuleSpec &module_spec,
+                                    const ModuleDownloader &module_downloader,
+                                    const SymfileDownloader &symfile_downloader,
+                                    lldb::ModuleSP &cached_module_sp,
+                                    bool *did_create_ptr, bool &did_put) {
   const auto module_spec_dir =
       GetModuleDirectory(root_dir_spec, module_spec.GetUUID());
   auto error = MakeDirectory(module_spec_dir);
@@ -299,6 +448,7 @@ Status ModuleCache::GetAndPut(const FileSpec &root_dir_spec,
   if (error.Fail())
     return Status("Failed to put module into cache: %s", error.AsCString());
 
+  did_put = true;
   tmp_file_remover.releaseFile();
   error = Get(root_dir_spec, escaped_hostname.c_str(), module_spec,
               cached_module_sp, did_create_ptr);
@@ -330,3 +480,68 @@ Status ModuleCache::GetAndPut(const FileSpec &root_dir_spec,
   cached_module_sp->SetSymbolFileFileSpec(symfile_spec);
   return Status();
 }
+
+Status ModuleCache::Prune(const FileSpec &cache_root, uint64_t max_size,
+                          Statistics &removed) {
+  namespace fs = llvm::sys::fs;
+
+  Status error;
+  StoreLock store_lock(cache_root, true, error);
+  if (error.Fail())
+    return Status("Module cache %s is in use: %s",
+                  cache_root.GetPath().c_str(), error.AsCString());
+
+  std::vector<Blob> blobs = GetBlobs(cache_root);
+  uint64_t total_size = 0;
+  for (const Blob &blob : blobs)
+    total_size += blob.size;
+
+  if (max_size != 0 && total_size > max_size) {
+    std::sort(blobs.begin(), blobs.end(), [](const Blob &lhs, const Blob &rhs) {
+      return lhs.last_used < rhs.last_used;
+    });
+    for (const Blob &blob : blobs) {
+      if (total_size <= max_size)
+        break;
+      if (fs::remove(blob.path))
+        continue;
+      fs::remove(blob.path + kBlobUsedExtension);
+      total_size -= blob.size;
+      ++removed.num_blobs;
+      removed.total_size += blob.size;
+    }
+  }
+
+  // A Sysroot view leads to a UUID view, so both are found dangling once the
+  // file in the store is gone.
+  std::vector<std::string> dangling_views;
+  ForEachView(cache_root, [&](const std::string &path, bool exists) {
+    if (!exists)
+      dangling_views.push_back(path);
+  });
+  for (const std::string &path : dangling_views) {
+    if (fs::remove(path))
+      continue;
+    ++removed.num_views;
+    // Drop the directory of a UUID view once it is empty.
+    fs::remove(llvm::sys::path::parent_path(path));
+  }
+  return Status();
+}
+
+Status ModuleCache::GetStatistics(const FileSpec &cache_root,
+                                  Statistics &stats) {
+  if (!llvm::sys::fs::is_directory(cache_root.GetPath()))
+    return Status("Module cache %s does not exist",
+                  cache_root.GetPath().c_str());
+
+  for (const Blob &blob : GetBlobs(cache_root)) {
+    ++stats.num_blobs;
+    stats.total_size += blob.size;
+  }
+  ForEachView(cache_root, [&stats](const std::string &path, bool exists) {
+    if (exists)
+      ++stats.num_views;
+  });
+  return Status();
+}
@@ -71,9 +71,25 @@ PropertyDefinition g_properties[] = {
      nullptr, "Use module cache."},
     {"module-cache-directory", OptionValue::eTypeFileSpec, true, 0, nullptr,
      nullptr, "Root directory for cached modules."},
+    {"module-cache-max-size", OptionValue::eTypeUInt64, true, 0, nullptr,
+     nullptr, "The number of bytes cached modules may take up before the "
+              "least recently used ones are deleted, or 0 for no limit."},
+    {"file-transfer-chunk-size", OptionValue::eTypeUInt64, true, 64 * 1024,
+     nullptr, nullptr,
+     "The number of bytes to ask for in each read when downloading a file "
+     "from a remote platform."},
+    {"file-transfer-window", OptionValue::eTypeUInt64, true, 16, nullptr,
+     nullptr, "The number of reads to keep in flight when downloading a file "
+              "from a remote platform."},
     {nullptr, OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr}};
 
-enum { ePropertyUseModuleCache, ePropertyModuleCacheDirectory };
+enum {
+  ePropertyUseModuleCache,
+  ePropertyModuleCacheDirectory,
+  ePropertyModuleCacheMaxSize,
+  ePropertyFileTransferChunkSize,
+  ePropertyFileTransferWindow
+};
 
 } // namespace
 
@@ -121,6 +137,24 @@ bool PlatformProperties::SetModuleCacheDirectory(const FileSpec &dir_spec) {
       nullptr, ePropertyModuleCacheDirectory, dir_spec);
 }
 
+uint64_t PlatformProperties::GetModuleCacheMaxSize() const {
+  const auto idx = ePropertyModuleCacheMaxSize;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_properties[idx].default_uint_value);
+}
+
+uint64_t PlatformProperties::GetFileTransferChunkSize() const {
+  const auto idx = ePropertyFileTransferChunkSize;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_properties[idx].default_uint_value);
+}
+
+uint32_t PlatformProperties::GetFileTransferWindow() const {
+  const auto idx = ePropertyFileTransferWindow;
+  return m_collection_sp->GetPropertyAtIndexAsUInt64(
+      nullptr, idx, g_properties[idx].default_uint_value);
+}
+
 //------------------------------------------------------------------
 /// Get the native host platform plug-in.
 ///
@@ -1666,7 +1700,8 @@ bool Platform::GetCachedSharedModule(const ModuleSpec &module_spec,
              const FileSpec &tmp_download_file_spec) {
         return DownloadSymbolFile(module_sp, tmp_download_file_spec);
       },
-      module_sp, did_create_ptr);
+      module_sp, did_create_ptr,
+      GetGlobalPlatformProperties()->GetModuleCacheMaxSize());
   if (error.Success())
     return true;
 
@@ -1677,6 +1712,29 @@ bool Platform::GetCachedSharedModule(const ModuleSpec &module_spec,
   return false;
 }
 
+uint64_t Platform::ReadFileRange(
+    lldb::user_id_t fd, uint64_t offset, uint64_t size,
+    llvm::function_ref<bool(llvm::ArrayRef<uint8_t>)> callback,
+    Status &error) {
+  const uint64_t chunk_size =
+      GetGlobalPlatformProperties()->GetFileTransferChunkSize();
+  std::vector<uint8_t> buffer(
+      std::max<uint64_t>(1, std::min(size, chunk_size)));
+  uint64_t total_bytes_read = 0;
+  while (total_bytes_read < size) {
+    const uint64_t to_read =
+        std::min<uint64_t>(buffer.size(), size - total_bytes_read);
+    const uint64_t n_read = ReadFile(fd, offset + total_bytes_read,
+                                     buffer.data(), to_read, error);
+    if (error.Fail() || n_read == 0 || n_read > to_read)
+      break;
+    if (!callback(llvm::ArrayRef<uint8_t>(buffer.data(), n_read)))
+      break;
+    total_bytes_read += n_read;
+  }
+  return total_bytes_read;
+}
+
 Status Platform::DownloadModuleSlice(const FileSpec &src_file_spec,
                                      const uint64_t src_offset,
                                      const uint64_t src_size,
@@ -1700,24 +1758,15 @@ Status Platform::DownloadModuleSlice(const FileSpec &src_file_spec,
     return error;
   }
 
-  std::vector<char> buffer(1024);
-  auto offset = src_offset;
-  uint64_t total_bytes_read = 0;
-  while (total_bytes_read < src_size) {
-    const auto to_read = std::min(static_cast<uint64_t>(buffer.size()),
-                                  src_size - total_bytes_read);
-    const uint64_t n_read =
-        ReadFile(src_fd, offset, &buffer[0], to_read, error);
-    if (error.Fail())
-      break;
-    if (n_read == 0) {
-      error.SetErrorString("read 0 bytes");
-      break;
-    }
-    offset += n_read;
-    total_bytes_read += n_read;
-    dst.write(&buffer[0], n_read);
-  }
+  const uint64_t total_bytes_read = ReadFileRange(
+      src_fd, src_offset, src_size,
+      [&dst](llvm::ArrayRef<uint8_t> data) {
+        dst.write(reinterpret_cast<const char *>(data.data()), data.size());
+        return true;
+      },
+      error);
+  if (error.Success() && total_bytes_read < src_size)
+    error.SetErrorString("read 0 bytes");
 
   Status close_error;
   CloseFile(src_fd, close_error); // Ignoring close error.
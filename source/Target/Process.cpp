@@ -2205,6 +2205,13 @@ size_t Process::ReadMemory(addr_t addr, void *buf, size_t size, Status &error) {
   }
 }
 
+size_t
+Process::ReadMemoryRanges(llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  if (!GetDisableMemoryCache())
+    return m_memory_cache.ReadRanges(ranges);
+  return ReadMemoryRangesFromInferior(ranges);
+}
+
 size_t Process::ReadCStringFromMemory(addr_t addr, std::string &out_str,
                                       Status &error) {
   char buf[256];
@@ -2348,6 +2355,42 @@ size_t Process::ReadMemoryFromInferior(addr_t addr, void *buf, size_t size,
   return bytes_read;
 }
 
+size_t Process::ReadMemoryRangesFromInferior(
+    llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  for (MemoryReadRange &range : ranges)
+    range.bytes_read = 0;
+
+  DoReadMemoryRanges(ranges);
+
+  size_t total_bytes_read = 0;
+  for (MemoryReadRange &range : ranges) {
+    // Replace any software breakpoint opcodes that fall into this range back
+    // into its buffer
+    if (range.bytes_read > 0)
+      RemoveBreakpointOpcodesFromBuffer(range.addr, range.bytes_read,
+                                        (uint8_t *)range.buf);
+    total_bytes_read += range.bytes_read;
+  }
+  return total_bytes_read;
+}
+
+void Process::DoReadMemoryRanges(
+    llvm::MutableArrayRef<MemoryReadRange> ranges) {
+  for (MemoryReadRange &range : ranges) {
+    uint8_t *bytes = (uint8_t *)range.buf;
+    Status error;
+    while (range.bytes_read < range.size) {
+      const size_t curr_size = range.size - range.bytes_read;
+      const size_t curr_bytes_read =
+          DoReadMemory(range.addr + range.bytes_read,
+                       bytes + range.bytes_read, curr_size, error);
+      range.bytes_read += curr_bytes_read;
+      if (curr_bytes_read == curr_size || curr_bytes_read == 0)
+        break;
+    }
+  }
+}
+
 uint64_t Process::ReadUnsignedIntegerFromMemory(lldb::addr_t vm_addr,
                                                 size_t integer_byte_size,
                                                 uint64_t fail_value,
@@ -5979,6 +6022,17 @@ void Process::PrintWarning(uint64_t warning_type, const void *repeat_key,
   }
 }
 
+void Process::AddStatistics(StructuredData::Dictionary &dict) {
+  auto cache_sp = std::make_shared<StructuredData::Dictionary>();
+  const uint64_t hits = m_memory_cache.GetNumHits();
+  const uint64_t misses = m_memory_cache.GetNumMisses();
+  cache_sp->AddIntegerItem("hits", hits);
+  cache_sp->AddIntegerItem("misses", misses);
+  cache_sp->AddFloatItem("hitRate",
+                         hits + misses ? double(hits) / (hits + misses) : 0.0);
+  dict.AddItem("memoryCache", cache_sp);
+}
+
 void Process::PrintWarningOptimization(const SymbolContext &sc) {
   if (GetWarningsOptimization() && sc.module_sp &&
       !sc.module_sp->GetFileSpec().GetFilename().IsEmpty() && sc.function &&
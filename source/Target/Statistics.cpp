@@ -0,0 +1,155 @@
+//===-- Statistics.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Target/Statistics.h"
+
+#include "lldb/Core/Module.h"
+#include "lldb/Symbol/SymbolFile.h"
+#include "lldb/Symbol/SymbolVendor.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/ConstString.h"
+
+#include <algorithm>
+
+using namespace lldb;
+using namespace lldb_private;
+
+void LatencyHistogram::Add(StatsDuration::Duration duration) {
+  const uint64_t micros =
+      std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  size_t bucket = 0;
+  for (uint64_t i = micros; i != 0 && bucket + 1 < kNumBuckets; i >>= 1)
+    ++bucket;
+
+  std::lock_guard<std::mutex> guard(m_mutex);
+  ++m_buckets[bucket];
+  ++m_count;
+  m_total += duration;
+  m_max = std::max(m_max, duration);
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_count;
+}
+
+StructuredData::DictionarySP LatencyHistogram::ToStructuredData() const {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto dict_sp = std::make_shared<StructuredData::Dictionary>();
+  dict_sp->AddIntegerItem("count", m_count);
+  dict_sp->AddFloatItem("totalTime", m_total.count());
+  dict_sp->AddFloatItem("meanTime", m_count ? m_total.count() / m_count : 0.0);
+  dict_sp->AddFloatItem("maxTime", m_max.count());
+
+  auto buckets_sp = std::make_shared<StructuredData::Dictionary>();
+  for (size_t i = 0; i < kNumBuckets; ++i) {
+    if (m_buckets[i] == 0)
+      continue;
+    // The key is the exclusive upper bound of the bucket in microseconds.
+    buckets_sp->AddIntegerItem(std::to_string(uint64_t(1) << i),
+                               m_buckets[i]);
+  }
+  dict_sp->AddItem("buckets", buckets_sp);
+  return dict_sp;
+}
+
+void TargetStats::RecordExpressionEvaluation(bool success,
+                                             StatsDuration::Duration duration) {
+  if (!m_collecting_stats)
+    return;
+  if (success)
+    ++m_expression_successes;
+  else
+    ++m_expression_failures;
+  m_expression_latency.Add(duration);
+}
+
+namespace {
+struct ModuleTotals {
+  double symtab_parse_time = 0;
+  double symtab_index_time = 0;
+  double debug_info_parse_time = 0;
+  double debug_info_index_time = 0;
+  uint64_t debug_info_size = 0;
+};
+} // namespace
+
+static StructuredData::DictionarySP GetModuleStatistics(Module &module,
+                                                        ModuleTotals &totals) {
+  auto dict_sp = std::make_shared<StructuredData::Dictionary>();
+  dict_sp->AddStringItem("path", module.GetFileSpec().GetPath());
+  dict_sp->AddStringItem("uuid", module.GetUUID().GetAsString());
+  const double symtab_parse_time = module.GetSymtabParseTime().get().count();
+  const double symtab_index_time = module.GetSymtabIndexTime().get().count();
+  dict_sp->AddFloatItem("symbolTableParseTime", symtab_parse_time);
+  dict_sp->AddFloatItem("symbolTableIndexTime", symtab_index_time);
+  totals.symtab_parse_time += symtab_parse_time;
+  totals.symtab_index_time += symtab_index_time;
+
+  // Don't load the debug information just to report that nothing was done
+  // with it.
+  SymbolVendor *sym_vendor = module.GetSymbolVendor(false);
+  SymbolFile *sym_file = sym_vendor ? sym_vendor->GetSymbolFile() : nullptr;
+  if (!sym_file)
+    return dict_sp;
+  const double parse_time = sym_file->GetDebugInfoParseTime().count();
+  const double index_time = sym_file->GetDebugInfoIndexTime().count();
+  const uint64_t size = sym_file->GetDebugInfoBytesParsed();
+  dict_sp->AddFloatItem("debugInfoParseTime", parse_time);
+  dict_sp->AddFloatItem("debugInfoIndexTime", index_time);
+  dict_sp->AddIntegerItem("debugInfoByteSize", size);
+  dict_sp->AddIntegerItem("typesCompleted", sym_file->GetNumTypesCompleted());
+  sym_file->AddStatistics(*dict_sp);
+  totals.debug_info_parse_time += parse_time;
+  totals.debug_info_index_time += index_time;
+  totals.debug_info_size += size;
+  return dict_sp;
+}
+
+StructuredData::ObjectSP TargetStats::ToStructuredData(Target &target) const {
+  auto dict_sp = std::make_shared<StructuredData::Dictionary>();
+  dict_sp->AddBooleanItem("collectingStats", m_collecting_stats);
+
+  auto expr_sp = m_expression_latency.ToStructuredData();
+  expr_sp->AddIntegerItem("successes", m_expression_successes);
+  expr_sp->AddIntegerItem("failures", m_expression_failures);
+  dict_sp->AddItem("expressionEvaluation", expr_sp);
+
+  auto modules_sp = std::make_shared<StructuredData::Array>();
+  ModuleTotals totals;
+  const ModuleList &images = target.GetImages();
+  for (size_t i = 0, e = images.GetSize(); i < e; ++i) {
+    if (ModuleSP module_sp = images.GetModuleAtIndex(i))
+      modules_sp->AddItem(GetModuleStatistics(*module_sp, totals));
+  }
+  dict_sp->AddItem("modules", modules_sp);
+  dict_sp->AddFloatItem("totalSymbolTableParseTime", totals.symtab_parse_time);
+  dict_sp->AddFloatItem("totalSymbolTableIndexTime", totals.symtab_index_time);
+  dict_sp->AddFloatItem("totalDebugInfoParseTime",
+                        totals.debug_info_parse_time);
+  dict_sp->AddFloatItem("totalDebugInfoIndexTime",
+                        totals.debug_info_index_time);
+  dict_sp->AddIntegerItem("totalDebugInfoByteSize", totals.debug_info_size);
+
+  const ConstString::Stats string_stats = ConstString::GetStats();
+  auto strings_sp = std::make_shared<StructuredData::Dictionary>();
+  strings_sp->AddIntegerItem("memorySize", string_stats.memory_size);
+  strings_sp->AddIntegerItem("stringCount", string_stats.string_count);
+  strings_sp->AddIntegerItem("contendedReads", string_stats.contended_reads);
+  strings_sp->AddIntegerItem("contendedWrites", string_stats.contended_writes);
+  dict_sp->AddItem("constStringPool", strings_sp);
+
+  if (ProcessSP process_sp = target.GetProcessSP()) {
+    auto process_dict_sp = std::make_shared<StructuredData::Dictionary>();
+    process_sp->AddStatistics(*process_dict_sp);
+    dict_sp->AddItem("process", process_dict_sp);
+  }
+  return dict_sp;
+}
@@ -2315,10 +2315,14 @@ ExpressionResults Target::EvaluateExpression(
   } else {
     llvm::StringRef prefix = GetExpressionPrefixContents();
     Status error;
+    const auto start = std::chrono::steady_clock::now();
     execution_results = UserExpression::Evaluate(exe_ctx, options, expr, prefix,
                                                  result_valobj_sp, error,
                                                  0, // Line Number
                                                  fixed_expression);
+    m_stats.RecordExpressionEvaluation(
+        execution_results == eExpressionCompleted,
+        std::chrono::steady_clock::now() - start);
   }
 
   m_suppress_stop_hooks = old_suppress_value;
@@ -21,6 +21,7 @@
 
 #include <algorithm> // for min
 #include <array>
+#include <atomic>  // for atomic
 #include <utility> // for make_pair, pair
 
 #include <inttypes.h> // for PRIu64
@@ -54,7 +55,7 @@ public:
   StringPoolValueType GetMangledCounterpart(const char *ccstr) const {
     if (ccstr != nullptr) {
       const uint8_t h = hash(llvm::StringRef(ccstr));
-      llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
+      ReadLock rlock(m_string_pools[h]);
       return GetStringMapEntryFromKeyData(ccstr).getValue();
     }
     return nullptr;
@@ -64,12 +65,12 @@ public:
     if (key_ccstr != nullptr && value_ccstr != nullptr) {
       {
         const uint8_t h = hash(llvm::StringRef(key_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
+        WriteLock wlock(m_string_pools[h]);
         GetStringMapEntryFromKeyData(key_ccstr).setValue(value_ccstr);
       }
       {
         const uint8_t h = hash(llvm::StringRef(value_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
+        WriteLock wlock(m_string_pools[h]);
         GetStringMapEntryFromKeyData(value_ccstr).setValue(key_ccstr);
       }
       return true;
@@ -91,21 +92,32 @@ public:
 
   const char *GetConstCStringWithStringRef(const llvm::StringRef &string_ref) {
     if (string_ref.data()) {
-      const uint8_t h = hash(string_ref);
-
+      const uint32_t full_hash = llvm::djbHash(string_ref);
+
+      // Most strings that are interned have been interned before, often
+      // by the same thread moments ago, so check the per-thread cache
+      // before taking the shard's lock.
+      const char *&cached_ccstr = GetThreadCacheEntry(full_hash);
+      if (cached_ccstr && GetConstCStringLength(cached_ccstr) ==
+                              string_ref.size() &&
+          ::memcmp(cached_ccstr, string_ref.data(), string_ref.size()) == 0)
+        return cached_ccstr;
+
+      PoolEntry &pool = m_string_pools[fold_hash(full_hash)];
       {
-        llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
-        auto it = m_string_pools[h].m_string_map.find(string_ref);
-        if (it != m_string_pools[h].m_string_map.end())
-          return it->getKeyData();
+        ReadLock rlock(pool);
+        auto it = pool.m_string_map.find(string_ref);
+        if (it != pool.m_string_map.end()) {
+          cached_ccstr = it->getKeyData();
+          return cached_ccstr;
+        }
       }
 
-      llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
+      WriteLock wlock(pool);
       StringPoolEntryType &entry =
-          *m_string_pools[h]
-               .m_string_map.insert(std::make_pair(string_ref, nullptr))
-               .first;
-      return entry.getKeyData();
+          *pool.m_string_map.insert(std::make_pair(string_ref, nullptr)).first;
+      cached_ccstr = entry.getKeyData();
+      return cached_ccstr;
     }
     return nullptr;
   }
@@ -119,7 +131,7 @@ public:
       {
         llvm::StringRef string_ref(demangled_cstr);
         const uint8_t h = hash(string_ref);
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
+        WriteLock wlock(m_string_pools[h]);
 
         // Make string pool entry with the mangled counterpart already set
         StringPoolEntryType &entry =
@@ -135,7 +147,7 @@ public:
         // Now assign the demangled const string as the counterpart of the
         // mangled const string...
         const uint8_t h = hash(llvm::StringRef(mangled_ccstr));
-        llvm::sys::SmartScopedWriter<false> wlock(m_string_pools[h].m_mutex);
+        WriteLock wlock(m_string_pools[h]);
         GetStringMapEntryFromKeyData(mangled_ccstr).setValue(demangled_ccstr);
       }
 
@@ -162,24 +174,107 @@ public:
   size_t MemorySize() const {
     size_t mem_size = sizeof(Pool);
     for (const auto &pool : m_string_pools) {
-      llvm::sys::SmartScopedReader<false> rlock(pool.m_mutex);
+      ReadLock rlock(pool);
       for (const auto &entry : pool.m_string_map)
         mem_size += sizeof(StringPoolEntryType) + entry.getKey().size();
     }
     return mem_size;
   }
 
+  ConstString::Stats GetStats() const {
+    ConstString::Stats stats;
+    stats.memory_size = sizeof(Pool);
+    stats.shards.resize(m_string_pools.size());
+    for (size_t i = 0; i < m_string_pools.size(); ++i) {
+      const PoolEntry &pool = m_string_pools[i];
+      ConstString::ShardStats &shard = stats.shards[i];
+      {
+        ReadLock rlock(pool);
+        shard.string_count = pool.m_string_map.size();
+        for (const auto &entry : pool.m_string_map)
+          shard.string_bytes += entry.getKey().size();
+      }
+      shard.contended_reads = pool.m_contended_reads;
+      shard.contended_writes = pool.m_contended_writes;
+      stats.memory_size += shard.string_count * sizeof(StringPoolEntryType) +
+                           shard.string_bytes;
+      stats.string_count += shard.string_count;
+      stats.contended_reads += shard.contended_reads;
+      stats.contended_writes += shard.contended_writes;
+    }
+    return stats;
+  }
+
 protected:
   uint8_t hash(const llvm::StringRef &s) const {
-    uint32_t h = llvm::djbHash(s);
+    return fold_hash(llvm::djbHash(s));
+  }
+
+  static uint8_t fold_hash(uint32_t h) {
     return ((h >> 24) ^ (h >> 16) ^ (h >> 8) ^ h) & 0xff;
   }
 
+  static const char *&GetThreadCacheEntry(uint32_t h) {
+    // Strings are never removed from the pool, so a cached pointer stays
+    // valid for the lifetime of the process.
+    static thread_local std::array<const char *, 1024> g_cache;
+    return g_cache[h % g_cache.size()];
+  }
+
   struct PoolEntry {
+    // Start each shard out with room for a good number of strings, every
+    // debug session interns thousands of them.
+    PoolEntry() : m_string_map(256) {}
+
     mutable llvm::sys::SmartRWMutex<false> m_mutex;
+    // The number of threads holding or waiting for the lock, and how many
+    // of them are writers.
+    mutable std::atomic<uint32_t> m_lockers{0};
+    mutable std::atomic<uint32_t> m_writers{0};
+    mutable std::atomic<uint64_t> m_contended_reads{0};
+    mutable std::atomic<uint64_t> m_contended_writes{0};
     StringPool m_string_map;
   };
 
+  // Scoped locks for a PoolEntry that count how often they have to wait.
+  // The mutex can't be tried without blocking, so a lock counts as
+  // contended when it is asked for while another thread holds or waits for
+  // it in a conflicting mode: a writer for readers, anyone for writers.
+  class ReadLock {
+  public:
+    ReadLock(const PoolEntry &pool) : m_pool(pool) {
+      m_pool.m_lockers.fetch_add(1, std::memory_order_relaxed);
+      if (m_pool.m_writers.load(std::memory_order_relaxed) != 0)
+        m_pool.m_contended_reads.fetch_add(1, std::memory_order_relaxed);
+      m_pool.m_mutex.lock_shared();
+    }
+    ~ReadLock() {
+      m_pool.m_mutex.unlock_shared();
+      m_pool.m_lockers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+  private:
+    const PoolEntry &m_pool;
+  };
+
+  class WriteLock {
+  public:
+    WriteLock(const PoolEntry &pool) : m_pool(pool) {
+      m_pool.m_writers.fetch_add(1, std::memory_order_relaxed);
+      if (m_pool.m_lockers.fetch_add(1, std::memory_order_relaxed) != 0)
+        m_pool.m_contended_writes.fetch_add(1, std::memory_order_relaxed);
+      m_pool.m_mutex.lock();
+    }
+    ~WriteLock() {
+      m_pool.m_mutex.unlock();
+      m_pool.m_lockers.fetch_sub(1, std::memory_order_relaxed);
+      m_pool.m_writers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+  private:
+    const PoolEntry &m_pool;
+  };
+
   std::array<PoolEntry, 256> m_string_pools;
 };
 
@@ -333,6 +428,8 @@ size_t ConstString::StaticMemorySize() {
   return StringPool().MemorySize();
 }
 
+ConstString::Stats ConstString::GetStats() { return StringPool().GetStats(); }
+
 void llvm::format_provider<ConstString>::format(const ConstString &CS,
                                                 llvm::raw_ostream &OS,
                                                 llvm::StringRef Options) {
@@ -22,10 +22,14 @@
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
 #include <chrono> // for duration, system_clock, syst...
+#include <condition_variable>
 #include <cstdarg>
 #include <mutex>
+#include <thread>
 #include <utility> // for pair
+#include <vector>
 
 #include <assert.h>  // for assert
 #if defined(LLVM_ON_WIN32)
@@ -37,6 +41,264 @@
 
 using namespace lldb_private;
 
+namespace {
+
+// Serializes the writes to the streams of channels with
+// LLDB_LOG_OPTION_THREADSAFE and those of the asynchronous writer. Never
+// destroyed, other threads may still be logging at exit.
+std::recursive_mutex &GetStreamMutex() {
+  static std::recursive_mutex *g_stream_mutex = new std::recursive_mutex();
+  return *g_stream_mutex;
+}
+
+struct AsyncLogRecord {
+  std::shared_ptr<llvm::raw_ostream> stream_sp;
+  std::string message;
+  // The order the record was logged in across all threads. The time is only
+  // printed, the clock can go backwards.
+  uint64_t sequence = 0;
+  std::chrono::system_clock::time_point time;
+  // Where the formatted time goes, if the channel wants a timestamp.
+  size_t timestamp_offset = std::string::npos;
+};
+
+// A ring of records written by one thread and read by the writer thread.
+// When the ring is full new records are dropped, and only counted, so that
+// logging never blocks on the writer.
+class AsyncLogBuffer {
+public:
+  static const size_t kCapacity = 1024;
+
+  AsyncLogBuffer() : m_records(new AsyncLogRecord[kCapacity]) {}
+
+  // Called only by the thread owning the buffer.
+  bool Push(AsyncLogRecord &&record) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head.load(std::memory_order_acquire) == kCapacity) {
+      m_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    m_records[tail % kCapacity] = std::move(record);
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Called only by the writer.
+  void PopAll(std::vector<AsyncLogRecord> &records) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    size_t tail = m_tail.load(std::memory_order_acquire);
+    for (; head != tail; ++head)
+      records.push_back(std::move(m_records[head % kCapacity]));
+    m_head.store(head, std::memory_order_release);
+  }
+
+  size_t TakeDropped() {
+    return m_dropped.exchange(0, std::memory_order_relaxed);
+  }
+
+  void AddDropped(size_t count) {
+    m_dropped.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  // The owning thread exited, the buffer will not get any more records.
+  void Orphan() { m_orphaned.store(true, std::memory_order_release); }
+
+  bool IsOrphaned() const {
+    return m_orphaned.load(std::memory_order_acquire);
+  }
+
+private:
+  std::unique_ptr<AsyncLogRecord[]> m_records;
+  std::atomic<size_t> m_head{0};
+  std::atomic<size_t> m_tail{0};
+  std::atomic<size_t> m_dropped{0};
+  std::atomic<bool> m_orphaned{false};
+};
+
+// Writes the messages of channels with LLDB_LOG_OPTION_ASYNC from a
+// background thread, in the order they were logged.
+class AsyncLogWriter {
+public:
+  static AsyncLogWriter &Get() { return *g_writer.load(); }
+
+  void Push(AsyncLogRecord &&record) {
+    AsyncLogBuffer &buffer = GetThreadBuffer();
+    record.sequence = m_next_sequence.fetch_add(1, std::memory_order_relaxed);
+    buffer.Push(std::move(record));
+    if (!m_thread_running.load(std::memory_order_acquire))
+      StartThread();
+    if (!m_pending.exchange(true)) {
+      { std::lock_guard<std::mutex> guard(m_wake_mutex); }
+      m_wake.notify_one();
+    }
+  }
+
+  // Write out everything queued so far, on the calling thread.
+  void Flush() { Drain(); }
+
+  // Stop the writer thread, if it is running, and write out what is left.
+  // Logging again starts a new thread.
+  void Stop() {
+    std::lock_guard<std::mutex> thread_guard(m_thread_mutex);
+    if (m_thread.joinable()) {
+      {
+        std::lock_guard<std::mutex> guard(m_wake_mutex);
+        m_stopping = true;
+      }
+      m_wake.notify_one();
+      m_thread.join();
+      m_thread_running.store(false, std::memory_order_release);
+      std::lock_guard<std::mutex> guard(m_wake_mutex);
+      m_stopping = false;
+    }
+    Drain();
+  }
+
+  // The writer thread doesn't exist in a forked child, and another thread
+  // may have held one of our mutexes when the process forked. Start over
+  // with a new writer; the old one is leaked.
+  static void ResetAfterFork() { g_writer.store(new AsyncLogWriter()); }
+
+private:
+  struct ThreadBufferHolder {
+    AsyncLogWriter *writer = nullptr;
+    std::shared_ptr<AsyncLogBuffer> buffer_sp;
+
+    ~ThreadBufferHolder() {
+      if (buffer_sp)
+        buffer_sp->Orphan();
+    }
+  };
+
+  AsyncLogBuffer &GetThreadBuffer() {
+    static thread_local ThreadBufferHolder g_holder;
+    if (g_holder.writer != this) {
+      if (g_holder.buffer_sp)
+        g_holder.buffer_sp->Orphan();
+      g_holder.writer = this;
+      g_holder.buffer_sp = std::make_shared<AsyncLogBuffer>();
+
+      std::lock_guard<std::mutex> guard(m_buffers_mutex);
+      m_buffers.push_back(g_holder.buffer_sp);
+    }
+    return *g_holder.buffer_sp;
+  }
+
+  void StartThread() {
+    std::lock_guard<std::mutex> guard(m_thread_mutex);
+    if (m_thread.joinable())
+      return;
+    m_thread = std::thread(&AsyncLogWriter::ThreadMain, this);
+    m_thread_running.store(true, std::memory_order_release);
+  }
+
+  void ThreadMain() {
+    llvm::set_thread_name("lldb.log.writer");
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    while (!m_stopping) {
+      m_wake.wait_for(lock, std::chrono::milliseconds(100),
+                      [this] { return m_pending.load() || m_stopping; });
+      lock.unlock();
+      Drain();
+      lock.lock();
+    }
+  }
+
+  void Drain() {
+    std::lock_guard<std::mutex> drain_guard(m_drain_mutex);
+    m_pending.store(false);
+
+    std::vector<std::shared_ptr<AsyncLogBuffer>> buffers;
+    {
+      std::lock_guard<std::mutex> guard(m_buffers_mutex);
+      buffers = m_buffers;
+    }
+
+    std::vector<AsyncLogRecord> records;
+    std::vector<AsyncLogBuffer *> finished;
+    for (const auto &buffer_sp : buffers) {
+      // Check before emptying the buffer, an orphaned buffer stays empty.
+      if (buffer_sp->IsOrphaned())
+        finished.push_back(buffer_sp.get());
+      size_t first = records.size();
+      buffer_sp->PopAll(records);
+      size_t dropped = buffer_sp->TakeDropped();
+      if (!dropped)
+        continue;
+      // Report the dropped messages on the stream of the thread's next
+      // message.
+      if (records.size() == first) {
+        buffer_sp->AddDropped(dropped);
+        continue;
+      }
+      AsyncLogRecord note;
+      note.stream_sp = records[first].stream_sp;
+      note.sequence = records[first].sequence;
+      note.time = records[first].time;
+      note.message =
+          llvm::formatv("({0} log messages dropped)\n", dropped).str();
+      records.insert(records.begin() + first, std::move(note));
+    }
+
+    std::stable_sort(records.begin(), records.end(),
+                     [](const AsyncLogRecord &lhs, const AsyncLogRecord &rhs) {
+                       return lhs.sequence < rhs.sequence;
+                     });
+
+    if (!records.empty()) {
+      std::vector<llvm::raw_ostream *> streams;
+      std::lock_guard<std::recursive_mutex> guard(GetStreamMutex());
+      for (AsyncLogRecord &record : records) {
+        if (record.timestamp_offset != std::string::npos) {
+          auto time = std::chrono::duration<double>(
+              record.time.time_since_epoch());
+          record.message.insert(record.timestamp_offset,
+                                llvm::formatv("{0:f9} ", time.count()).str());
+        }
+        *record.stream_sp << record.message;
+        if (!llvm::is_contained(streams, record.stream_sp.get()))
+          streams.push_back(record.stream_sp.get());
+      }
+      for (llvm::raw_ostream *stream : streams)
+        stream->flush();
+    }
+
+    if (!finished.empty()) {
+      std::lock_guard<std::mutex> guard(m_buffers_mutex);
+      m_buffers.erase(
+          std::remove_if(m_buffers.begin(), m_buffers.end(),
+                         [&](const std::shared_ptr<AsyncLogBuffer> &buffer_sp) {
+                           return llvm::is_contained(finished,
+                                                     buffer_sp.get());
+                         }),
+          m_buffers.end());
+    }
+  }
+
+  static std::atomic<AsyncLogWriter *> g_writer;
+
+  std::mutex m_buffers_mutex;
+  std::vector<std::shared_ptr<AsyncLogBuffer>> m_buffers;
+
+  std::mutex m_thread_mutex;
+  std::thread m_thread;
+  std::atomic<bool> m_thread_running{false};
+
+  std::atomic<uint64_t> m_next_sequence{0};
+
+  std::mutex m_drain_mutex;
+
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake;
+  std::atomic<bool> m_pending{false};
+  bool m_stopping = false;
+};
+
+// Never destroyed: the writer thread may be running at exit.
+std::atomic<AsyncLogWriter *> AsyncLogWriter::g_writer{new AsyncLogWriter()};
+
+} // namespace
+
 llvm::ManagedStatic<Log::ChannelMap> Log::g_channel_map;
 
 void Log::ListCategories(llvm::raw_ostream &stream, const ChannelMap::value_type &entry) {
@@ -90,13 +352,21 @@ void Log::Enable(const std::shared_ptr<llvm::raw_ostream> &stream_sp,
 }
 
 void Log::Disable(uint32_t flags) {
-  llvm::sys::ScopedWriter lock(m_mutex);
-
-  uint32_t mask = m_mask.fetch_and(~flags, std::memory_order_relaxed);
-  if (!(mask & ~flags)) {
-    m_stream_sp.reset();
-    m_channel.log_ptr.store(nullptr, std::memory_order_relaxed);
+  bool async = false;
+  {
+    llvm::sys::ScopedWriter lock(m_mutex);
+
+    uint32_t mask = m_mask.fetch_and(~flags, std::memory_order_relaxed);
+    if (!(mask & ~flags)) {
+      async = GetOptions().Test(LLDB_LOG_OPTION_ASYNC);
+      m_stream_sp.reset();
+      m_channel.log_ptr.store(nullptr, std::memory_order_relaxed);
+    }
   }
+  // Don't leave the messages of a disabled channel behind in the queue. The
+  // queued records keep the stream alive until then.
+  if (async)
+    FlushAsyncLogs();
 }
 
 const Flags Log::GetOptions() const {
@@ -128,14 +398,14 @@ void Log::Printf(const char *format, ...) {
 void Log::VAPrintf(const char *format, va_list args) {
   llvm::SmallString<64> FinalMessage;
   llvm::raw_svector_ostream Stream(FinalMessage);
-  WriteHeader(Stream, "", "");
+  size_t timestamp_offset = WriteHeader(Stream, "", "");
 
   llvm::SmallString<64> Content;
   lldb_private::VASprintf(Content, format, args);
 
   Stream << Content << "\n";
 
-  WriteMessage(FinalMessage.str());
+  WriteMessage(FinalMessage.str(), timestamp_offset);
 }
 
 //----------------------------------------------------------------------
@@ -249,6 +519,10 @@ void Log::DisableAllLogChannels() {
     entry.second.Disable(UINT32_MAX);
 }
 
+void Log::FlushAsyncLogs() { AsyncLogWriter::Get().Flush(); }
+
+void Log::Terminate() { AsyncLogWriter::Get().Stop(); }
+
 void Log::ListAllLogChannels(llvm::raw_ostream &stream) {
   if (g_channel_map->empty()) {
     stream << "No logging channels are currently registered.\n";
@@ -263,16 +537,21 @@ bool Log::GetVerbose() const {
   return m_options.load(std::memory_order_relaxed) & LLDB_LOG_OPTION_VERBOSE;
 }
 
-void Log::WriteHeader(llvm::raw_ostream &OS, llvm::StringRef file,
-                      llvm::StringRef function) {
+size_t Log::WriteHeader(llvm::raw_ostream &OS, llvm::StringRef file,
+                        llvm::StringRef function) {
   Flags options = GetOptions();
+  size_t timestamp_offset = std::string::npos;
   static uint32_t g_sequence_id = 0;
   // Add a sequence ID if requested
   if (options.Test(LLDB_LOG_OPTION_PREPEND_SEQUENCE))
     OS << ++g_sequence_id << " ";
 
-  // Timestamp if requested
-  if (options.Test(LLDB_LOG_OPTION_PREPEND_TIMESTAMP)) {
+  // Timestamp if requested. The asynchronous writer formats it off the
+  // logging thread.
+  if (options.Test(LLDB_LOG_OPTION_PREPEND_TIMESTAMP) &&
+      options.Test(LLDB_LOG_OPTION_ASYNC)) {
+    timestamp_offset = OS.tell();
+  } else if (options.Test(LLDB_LOG_OPTION_PREPEND_TIMESTAMP)) {
     auto now = std::chrono::duration<double>(
         std::chrono::system_clock::now().time_since_epoch());
     OS << llvm::formatv("{0:f9} ", now.count());
@@ -299,9 +578,10 @@ void Log::WriteHeader(llvm::raw_ostream &OS, llvm::StringRef file,
     function = function.take_front(40);
     OS << llvm::formatv("{0,-60:60} ", (file + ":" + function).str());
   }
+  return timestamp_offset;
 }
 
-void Log::WriteMessage(const std::string &message) {
+void Log::WriteMessage(const std::string &message, size_t timestamp_offset) {
   // Make a copy of our stream shared pointer in case someone disables our
   // log while we are logging and releases the stream
   auto stream_sp = GetStream();
@@ -309,9 +589,15 @@ void Log::WriteMessage(const std::string &message) {
     return;
 
   Flags options = GetOptions();
-  if (options.Test(LLDB_LOG_OPTION_THREADSAFE)) {
-    static std::recursive_mutex g_LogThreadedMutex;
-    std::lock_guard<std::recursive_mutex> guard(g_LogThreadedMutex);
+  if (options.Test(LLDB_LOG_OPTION_ASYNC)) {
+    AsyncLogRecord record;
+    record.stream_sp = std::move(stream_sp);
+    record.message = message;
+    record.time = std::chrono::system_clock::now();
+    record.timestamp_offset = timestamp_offset;
+    AsyncLogWriter::Get().Push(std::move(record));
+  } else if (options.Test(LLDB_LOG_OPTION_THREADSAFE)) {
+    std::lock_guard<std::recursive_mutex> guard(GetStreamMutex());
     *stream_sp << message;
     stream_sp->flush();
   } else {
@@ -324,9 +610,9 @@ void Log::Format(llvm::StringRef file, llvm::StringRef function,
                  const llvm::formatv_object_base &payload) {
   std::string message_string;
   llvm::raw_string_ostream message(message_string);
-  WriteHeader(message, file, function);
+  size_t timestamp_offset = WriteHeader(message, file, function);
   message << payload << "\n";
-  WriteMessage(message.str());
+  WriteMessage(message.str(), timestamp_offset);
 }
 
 void Log::DisableLoggingChild() {
@@ -335,4 +621,5 @@ void Log::DisableLoggingChild() {
   // trying to write to the log.
   for (auto &c: *g_channel_map)
     c.second.m_channel.log_ptr.store(nullptr, std::memory_order_relaxed);
+  AsyncLogWriter::ResetAfterFork();
 }
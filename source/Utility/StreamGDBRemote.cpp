@@ -28,18 +28,22 @@ StreamGDBRemote::~StreamGDBRemote() {}
 int StreamGDBRemote::PutEscapedBytes(const void *s, size_t src_len) {
   int bytes_written = 0;
   const uint8_t *src = (const uint8_t *)s;
+  const uint8_t *end = src + src_len;
   bool binary_is_set = m_flags.Test(eBinary);
   m_flags.Clear(eBinary);
-  while (src_len) {
-    uint8_t byte = *src;
-    src++;
-    src_len--;
+  // Write the bytes that don't need escaping in runs, rather than one at a
+  // time, as this is used for large blocks of file and memory contents.
+  const uint8_t *run_start = src;
+  for (; src != end; ++src) {
+    const uint8_t byte = *src;
     if (byte == 0x23 || byte == 0x24 || byte == 0x7d || byte == 0x2a) {
-      bytes_written += PutChar(0x7d);
-      byte ^= 0x20;
+      bytes_written += Write(run_start, src - run_start);
+      const uint8_t escaped[2] = {0x7d, static_cast<uint8_t>(byte ^ 0x20)};
+      bytes_written += Write(escaped, sizeof(escaped));
+      run_start = src + 1;
     }
-    bytes_written += PutChar(byte);
-  };
+  }
+  bytes_written += Write(run_start, end - run_start);
   if (binary_is_set)
     m_flags.Set(eBinary);
   return bytes_written;
@@ -98,6 +98,8 @@ StringExtractorGDBRemote::GetServerPacketType() const {
         return eServerPacketType_QEnvironmentHexEncoded;
       if (PACKET_STARTS_WITH("QEnableErrorStrings"))
         return eServerPacketType_QEnableErrorStrings;
+      if (PACKET_STARTS_WITH("QEnableCompression:"))
+        return eServerPacketType_QEnableCompression;
       break;
 
     case 'P':
@@ -288,11 +290,15 @@ StringExtractorGDBRemote::GetServerPacketType() const {
     case 'X':
       if (PACKET_STARTS_WITH("qXfer:auxv:read::"))
         return eServerPacketType_qXfer_auxv_read;
+      if (PACKET_STARTS_WITH("qXfer:libraries-svr4:read::"))
+        return eServerPacketType_qXfer_libraries_svr4_read;
       break;
     }
     break;
 
   case 'j':
+    if (PACKET_STARTS_WITH("jMemoryReadMulti:"))
+      return eServerPacketType_jMemoryReadMulti;
     if (PACKET_STARTS_WITH("jModulesInfo:"))
       return eServerPacketType_jModulesInfo;
     if (PACKET_MATCHES("jSignalsInfo"))
@@ -378,7 +384,7 @@ StringExtractorGDBRemote::GetServerPacketType() const {
     break;
 
   case 'g':
-    if (packet_size == 1)
+    if (packet_size == 1 || packet_cstr[1] == ';')
       return eServerPacketType_g;
     break;
 
@@ -9,8 +9,12 @@
 #include "lldb/Utility/Timer.h"
 #include "lldb/Utility/Stream.h"
 
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/Threading.h"
+
 #include <algorithm>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <utility> // for pair
 #include <vector>
@@ -18,6 +22,11 @@
 #include <assert.h> // for assert
 #include <stdarg.h> // for va_end, va_list, va_start
 #include <stdio.h>
+#if defined(LLVM_ON_WIN32)
+#include <process.h> // for getpid
+#else
+#include <unistd.h>
+#endif
 
 using namespace lldb_private;
 
@@ -26,10 +35,33 @@ using namespace lldb_private;
 namespace {
 typedef std::vector<Timer *> TimerStack;
 static std::atomic<Timer::Category *> g_categories;
+
+struct TraceEvent {
+  const char *category;
+  std::string name;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::duration duration;
+  uint32_t depth;
+};
+
+// The events recorded by one thread. Only the owning thread appends to it,
+// so the mutex is only ever contended while a trace is being dumped.
+struct TraceBuffer {
+  uint64_t tid;
+  std::string thread_name;
+  std::mutex mutex;
+  std::vector<TraceEvent> events;
+  uint64_t num_dropped = 0;
+};
+
+// Stop recording on a thread once it has this many events, so that leaving
+// tracing on can't use up all the memory.
+const size_t g_max_trace_events_per_thread = 1000000;
 } // end of anonymous namespace
 
 std::atomic<bool> Timer::g_quiet(true);
 std::atomic<unsigned> Timer::g_display_depth(0);
+std::atomic<bool> Timer::g_tracing(false);
 static std::mutex &GetFileMutex() {
   static std::mutex *g_file_mutex_ptr = new std::mutex();
   return *g_file_mutex_ptr;
@@ -40,6 +72,39 @@ static TimerStack &GetTimerStackForCurrentThread() {
   return g_stack;
 }
 
+// The buffers of all the threads that recorded events, including threads
+// that have exited since. Leaked, like the file mutex, so that timers that
+// run during shutdown can still use it.
+static std::mutex &GetTraceBuffersMutex() {
+  static std::mutex *g_mutex_ptr = new std::mutex();
+  return *g_mutex_ptr;
+}
+
+static std::vector<std::shared_ptr<TraceBuffer>> &GetTraceBuffers() {
+  static auto *g_buffers_ptr = new std::vector<std::shared_ptr<TraceBuffer>>();
+  return *g_buffers_ptr;
+}
+
+static TraceBuffer &GetTraceBufferForCurrentThread() {
+  static thread_local std::shared_ptr<TraceBuffer> g_buffer;
+  if (!g_buffer) {
+    g_buffer = std::make_shared<TraceBuffer>();
+    g_buffer->tid = llvm::get_threadid();
+    llvm::SmallString<32> thread_name;
+    llvm::get_thread_name(thread_name);
+    g_buffer->thread_name = thread_name.str().str();
+    std::lock_guard<std::mutex> guard(GetTraceBuffersMutex());
+    GetTraceBuffers().push_back(g_buffer);
+  }
+  return *g_buffer;
+}
+
+// Trace timestamps are relative to the first time tracing was turned on.
+static std::chrono::steady_clock::time_point GetTraceEpoch() {
+  static const auto g_epoch = std::chrono::steady_clock::now();
+  return g_epoch;
+}
+
 Timer::Category::Category(const char *cat) : m_name(cat) {
   m_nanos.store(0, std::memory_order_release);
   Category *expected = g_categories;
@@ -54,6 +119,20 @@ Timer::Timer(Timer::Category &category, const char *format, ...)
     : m_category(category), m_total_start(std::chrono::steady_clock::now()) {
   TimerStack &stack = GetTimerStackForCurrentThread();
 
+  if (g_tracing.load(std::memory_order_relaxed)) {
+    m_traced = true;
+    char buffer[256];
+    va_list args;
+    va_start(args, format);
+    int length = ::vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length > 0)
+      m_trace_name.assign(buffer,
+                          std::min<size_t>(length, sizeof(buffer) - 1));
+    else
+      m_trace_name = m_category.m_name;
+  }
+
   stack.push_back(this);
   if (g_quiet && stack.size() <= g_display_depth) {
     std::lock_guard<std::mutex> lock(GetFileMutex());
@@ -94,6 +173,17 @@ Timer::~Timer() {
 
   // Keep total results for each category so we can dump results.
   m_category.m_nanos += std::chrono::nanoseconds(timer_dur).count();
+
+  if (m_traced) {
+    TraceBuffer &buffer = GetTraceBufferForCurrentThread();
+    std::lock_guard<std::mutex> guard(buffer.mutex);
+    if (buffer.events.size() < g_max_trace_events_per_thread)
+      buffer.events.push_back({m_category.m_name, std::move(m_trace_name),
+                               m_total_start, total_dur,
+                               static_cast<uint32_t>(stack.size())});
+    else
+      ++buffer.num_dropped;
+  }
 }
 
 void Timer::SetDisplayDepth(uint32_t depth) { g_display_depth = depth; }
@@ -130,3 +220,113 @@ void Timer::DumpCategoryTimes(Stream *s) {
   for (const auto &timer : sorted)
     s->Printf("%.9f sec for %s\n", timer.second / 1000000000., timer.first);
 }
+
+void Timer::SetTracing(bool value) {
+  GetTraceEpoch();
+  g_tracing = value;
+}
+
+bool Timer::GetTracing() { return g_tracing; }
+
+void Timer::ResetTrace() {
+  std::lock_guard<std::mutex> guard(GetTraceBuffersMutex());
+  auto &buffers = GetTraceBuffers();
+  for (auto &buffer : buffers) {
+    std::lock_guard<std::mutex> buffer_guard(buffer->mutex);
+    buffer->events.clear();
+    buffer->num_dropped = 0;
+  }
+  // Nothing else refers to the buffers of the threads that have exited.
+  buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                               [](const std::shared_ptr<TraceBuffer> &buffer) {
+                                 return buffer.use_count() == 1;
+                               }),
+                buffers.end());
+}
+
+static void DumpJSONString(Stream &s, llvm::StringRef str) {
+  s.PutChar('"');
+  for (char ch : str) {
+    switch (ch) {
+    case '"':
+      s.PutCString("\\\"");
+      break;
+    case '\\':
+      s.PutCString("\\\\");
+      break;
+    case '\n':
+      s.PutCString("\\n");
+      break;
+    case '\t':
+      s.PutCString("\\t");
+      break;
+    default:
+      if (static_cast<unsigned char>(ch) < 0x20)
+        s.Printf("\\u%04x", ch);
+      else
+        s.PutChar(ch);
+      break;
+    }
+  }
+  s.PutChar('"');
+}
+
+void Timer::DumpTrace(Stream &s) {
+  using namespace std::chrono;
+
+  const auto epoch = GetTraceEpoch();
+  const int pid = getpid();
+  uint64_t num_dropped = 0;
+  bool first = true;
+  auto separator = [&]() {
+    s.PutCString(first ? "\n" : ",\n");
+    first = false;
+  };
+
+  s.PutCString("{\"traceEvents\":[");
+  std::lock_guard<std::mutex> guard(GetTraceBuffersMutex());
+  for (auto &buffer : GetTraceBuffers()) {
+    std::lock_guard<std::mutex> buffer_guard(buffer->mutex);
+    num_dropped += buffer->num_dropped;
+    if (buffer->events.empty())
+      continue;
+
+    if (!buffer->thread_name.empty()) {
+      separator();
+      s.Printf("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+               "\"tid\":%" PRIu64 ",\"args\":{\"name\":",
+               pid, buffer->tid);
+      DumpJSONString(s, buffer->thread_name);
+      s.PutCString("}}");
+    }
+
+    // Events are recorded when they end, so children come before their
+    // parents. Put them back in the order they started. A child can start
+    // within the same clock tick as its parent, so the outer one goes first
+    // on ties, the way trace viewers expect nested events.
+    std::stable_sort(buffer->events.begin(), buffer->events.end(),
+                     [](const TraceEvent &lhs, const TraceEvent &rhs) {
+                       if (lhs.start != rhs.start)
+                         return lhs.start < rhs.start;
+                       if (lhs.depth != rhs.depth)
+                         return lhs.depth < rhs.depth;
+                       return lhs.duration > rhs.duration;
+                     });
+    for (const TraceEvent &event : buffer->events) {
+      separator();
+      s.PutCString("{\"name\":");
+      DumpJSONString(s, event.name);
+      s.PutCString(",\"cat\":");
+      DumpJSONString(s, event.category);
+      s.Printf(",\"ph\":\"X\",\"pid\":%d,\"tid\":%" PRIu64
+               ",\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}",
+               pid, buffer->tid,
+               duration<double, std::micro>(event.start - epoch).count(),
+               duration<double, std::micro>(event.duration).count(),
+               event.depth);
+    }
+  }
+  s.Printf("\n],\"displayTimeUnit\":\"ms\",\"otherData\":{"
+           "\"droppedEvents\":%" PRIu64 "}}\n",
+           num_dropped);
+}
@@ -25,6 +25,7 @@
 #include <unistd.h>
 #endif
 
+#include <fstream>
 #include <string>
 
 #include "lldb/API/SBBreakpoint.h"
@@ -99,6 +100,12 @@ static OptionDefinition g_options[] = {
      "debugged."},
     {LLDB_OPT_SET_3, false, "core", 'c', required_argument, 0, eArgTypeFilename,
      "Tells the debugger to use the fullpath to <path> as the core file."},
+    {LLDB_OPT_SET_3, false, "core-list", 'C', required_argument, 0,
+     eArgTypeFilename,
+     "Tells the debugger to analyze each of the core files listed, one per "
+     "line, in <filename> with the commands from -o and -s, print a report "
+     "for each one and quit.  The cores are analyzed in parallel and share "
+     "the modules of the file given with --file."},
     {LLDB_OPT_SET_5, true, "attach-pid", 'p', required_argument, 0, eArgTypePid,
      "Tells the debugger to attach to a process with the given pid."},
     {LLDB_OPT_SET_4, true, "attach-name", 'n', required_argument, 0,
@@ -416,7 +423,7 @@ Driver::OptionData::OptionData()
       m_wait_for(false), m_repl(false), m_repl_lang(eLanguageTypeUnknown),
       m_repl_options(), m_process_name(),
       m_process_pid(LLDB_INVALID_PROCESS_ID), m_use_external_editor(false),
-      m_batch(false), m_seen_options() {}
+      m_batch(false), m_core_list(), m_seen_options() {}
 
 Driver::OptionData::~OptionData() {}
 
@@ -455,6 +462,7 @@ void Driver::OptionData::Clear() {
   m_wait_for = false;
   m_process_name.erase();
   m_batch = false;
+  m_core_list.clear();
   m_after_crash_commands.clear();
 
   m_process_pid = LLDB_INVALID_PROCESS_ID;
@@ -706,6 +714,16 @@ SBError Driver::ParseArgs(int argc, const char *argv[], FILE *out_fh,
                 optarg);
         } break;
 
+        case 'C': {
+          SBFileSpec file(optarg);
+          if (file.Exists()) {
+            m_option_data.m_core_list = optarg;
+          } else
+            error.SetErrorStringWithFormat(
+                "file specified in --core-list (-C) option doesn't exist: '%s'",
+                optarg);
+        } break;
+
         case 'e':
           m_option_data.m_use_external_editor = true;
           break;
@@ -1059,7 +1077,9 @@ void Driver::MainLoop() {
   bool handle_events = true;
   bool spawn_thread = false;
 
-  if (m_option_data.m_repl) {
+  if (!m_option_data.m_core_list.empty()) {
+    AnalyzeCoreList();
+  } else if (m_option_data.m_repl) {
     const char *repl_options = NULL;
     if (!m_option_data.m_repl_options.empty())
       repl_options = m_option_data.m_repl_options.c_str();
@@ -1163,6 +1183,52 @@ void Driver::MainLoop() {
   SBDebugger::Destroy(m_debugger);
 }
 
+// Append the lines of "path" that aren't empty to "lines".
+static bool ReadLines(const char *path, SBStringList &lines) {
+  std::ifstream file(path);
+  if (!file)
+    return false;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (!line.empty())
+      lines.AppendString(line.c_str());
+  }
+  return true;
+}
+
+void Driver::AnalyzeCoreList() {
+  const char *filename = GetFilename();
+  if (!filename) {
+    fprintf(stderr, "error: --core-list (-C) requires --file (-f)\n");
+    return;
+  }
+
+  SBStringList core_files;
+  if (!ReadLines(m_option_data.m_core_list.c_str(), core_files)) {
+    fprintf(stderr, "error: unable to read '%s'\n",
+            m_option_data.m_core_list.c_str());
+    return;
+  }
+
+  SBStringList commands;
+  for (const auto &entry : m_option_data.m_after_file_commands) {
+    if (entry.is_cwd_lldbinit_file_read)
+      continue;
+    if (!entry.is_file)
+      commands.AppendString(entry.contents.c_str());
+    else if (!ReadLines(entry.contents.c_str(), commands))
+      fprintf(stderr, "error: unable to read '%s'\n", entry.contents.c_str());
+  }
+
+  SBStringList reports =
+      m_debugger.AnalyzeCoreFiles(filename, core_files, commands);
+  for (uint32_t i = 0; i < reports.GetSize(); ++i)
+    fprintf(stdout, "Core file '%s':\n%s\n", core_files.GetStringAtIndex(i),
+            reports.GetStringAtIndex(i));
+}
+
 void Driver::ResizeWindow(unsigned short col) {
   GetDebugger().SetTerminalWidth(col);
 }
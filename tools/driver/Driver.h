@@ -102,6 +102,7 @@ public:
     bool m_use_external_editor; // FIXME: When we have set/show variables we can
                                 // remove this from here.
     bool m_batch;
+    std::string m_core_list;
     typedef std::set<char> OptionSet;
     OptionSet m_seen_options;
   };
@@ -119,6 +120,8 @@ private:
 
   void ResetOptionValues();
 
+  void AnalyzeCoreList();
+
   void ReadyForCommand();
 };
 
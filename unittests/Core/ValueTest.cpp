@@ -0,0 +1,63 @@
+//===-- ValueTest.cpp -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/Value.h"
+#include "lldb/Utility/DataBufferHeap.h"
+#include "lldb/Utility/DataExtractor.h"
+#include "lldb/lldb-private-types.h"
+
+using namespace lldb_private;
+
+namespace {
+class HostValue {
+public:
+  HostValue(const uint32_t &source)
+      : m_value(Scalar(static_cast<unsigned long long>(
+            reinterpret_cast<uintptr_t>(&source)))) {
+    m_reg_info.byte_size = sizeof(source);
+    m_value.SetValueType(Value::eValueTypeHostAddress);
+    m_value.SetContext(Value::eContextTypeRegisterInfo, &m_reg_info);
+  }
+
+  Value &get() { return m_value; }
+
+private:
+  RegisterInfo m_reg_info = {};
+  Value m_value;
+};
+} // namespace
+
+TEST(ValueTest, GetValueAsDataReusesItsOwnBuffer) {
+  const uint32_t source = 0x12345678;
+  HostValue value(source);
+
+  DataExtractor data(std::make_shared<DataBufferHeap>(sizeof(source), 0),
+                     lldb::eByteOrderLittle, sizeof(void *));
+  const uint8_t *buffer = data.GetDataStart();
+  ASSERT_TRUE(value.get().GetValueAsData(nullptr, data, 0, nullptr).Success());
+  EXPECT_EQ(buffer, data.GetDataStart());
+  EXPECT_EQ(0, memcmp(&source, data.GetDataStart(), sizeof(source)));
+}
+
+TEST(ValueTest, GetValueAsDataDoesNotWriteSharedBuffers) {
+  const uint32_t source = 0x12345678;
+  HostValue value(source);
+
+  // The buffer could be memory that a process handed out without a copy,
+  // like a core file mapping, so it must be left alone.
+  auto shared_sp = std::make_shared<DataBufferHeap>(sizeof(source), 0xff);
+  DataExtractor data(shared_sp, lldb::eByteOrderLittle, sizeof(void *));
+  ASSERT_TRUE(value.get().GetValueAsData(nullptr, data, 0, nullptr).Success());
+  EXPECT_NE(shared_sp->GetBytes(), data.GetDataStart());
+  EXPECT_EQ(0, memcmp(&source, data.GetDataStart(), sizeof(source)));
+  for (size_t i = 0; i < shared_sp->GetByteSize(); ++i)
+    EXPECT_EQ(0xff, shared_sp->GetBytes()[i]);
+}
@@ -2,6 +2,10 @@
 
 #include "lldb/Host/TaskPool.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 using namespace lldb_private;
 
 TEST(TaskPoolTest, AddTask) {
@@ -43,3 +47,70 @@ TEST(TaskPoolTest, TaskMap) {
   ASSERT_EQ(data[2], 4);
   ASSERT_EQ(data[3], 9);
 }
+
+TEST(TaskPoolTest, NestedTaskMap) {
+  std::atomic<int> count(0);
+  auto fn = [&count](size_t) {
+    TaskMapOverInt(0, 16, [&count](size_t) { ++count; });
+  };
+
+  TaskMapOverInt(0, 16, fn);
+  ASSERT_EQ(16 * 16, count.load());
+
+  // Tasks may wait for tasks they added themselves.
+  auto f = TaskPool::AddTask([]() {
+    auto inner = TaskPool::AddTask([]() { return 42; });
+    TaskPool::Wait(inner);
+    return inner.get();
+  });
+  ASSERT_EQ(42, f.get());
+}
+
+TEST(TaskPoolTest, ThreadCount) {
+  // The pool never runs more than 256 threads.
+  const unsigned thread_count = TaskPool::GetThreadCount();
+  ASSERT_EQ(std::min(GetHardwareConcurrencyHint(), 256u), thread_count);
+
+  TaskPool::SetThreadCount(1);
+  ASSERT_EQ(1u, TaskPool::GetThreadCount());
+  int data[8];
+  TaskMapOverInt(0, 8, [&data](size_t x) { data[x] = x * 2; });
+  for (int i = 0; i < 8; ++i)
+    ASSERT_EQ(i * 2, data[i]);
+
+  TaskPool::SetThreadCount(0);
+  ASSERT_EQ(thread_count, TaskPool::GetThreadCount());
+}
+
+TEST(TaskPoolTest, WaitRunsOnlyOwnTasks) {
+  const unsigned thread_count = TaskPool::GetThreadCount();
+  TaskPool::SetThreadCount(1);
+
+  // Keep the only worker busy with a task from another thread and queue a
+  // second task of that thread behind it.
+  std::promise<void> started, release;
+  std::future<void> other_task, blocker;
+  std::thread other([&]() {
+    blocker = TaskPool::AddTask([&]() {
+      started.set_value();
+      release.get_future().wait();
+    });
+    started.get_future().wait();
+    other_task = TaskPool::AddTask([]() {});
+  });
+  other.join();
+
+  // Our own task must run on this thread, the other one must not.
+  std::thread::id own_id;
+  auto own_task =
+      TaskPool::AddTask([&own_id]() { own_id = std::this_thread::get_id(); });
+  TaskPool::Wait(own_task);
+  ASSERT_EQ(std::this_thread::get_id(), own_id);
+  ASSERT_NE(std::future_status::ready,
+            other_task.wait_for(std::chrono::seconds(0)));
+
+  release.set_value();
+  TaskPool::Wait(blocker);
+  TaskPool::Wait(other_task);
+  TaskPool::SetThreadCount(thread_count);
+}
@@ -0,0 +1,179 @@
+//===-- DisplacedSteppingTest.cpp ----------------------------- -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "DisplacedStepping.h"
+#include "llvm/Testing/Support/Error.h"
+
+using namespace lldb_private;
+using namespace process_linux;
+
+static const lldb::addr_t kFrom = 0x7f0000001000;
+static const lldb::addr_t kTo = 0x7f0000000100;
+
+static llvm::Expected<DisplacedInstruction>
+Decode(std::vector<uint8_t> bytes) {
+  // Whatever follows the instruction mustn't be taken as part of it.
+  bytes.insert(bytes.end(), {0xcc, 0xcc, 0xcc, 0xcc});
+  return DisplacedInstruction::DecodeX86_64(bytes, kFrom, kTo);
+}
+
+static std::vector<uint8_t> GetBytes(const DisplacedInstruction &insn) {
+  return std::vector<uint8_t>(insn.GetBytes().begin(), insn.GetBytes().end());
+}
+
+TEST(DisplacedSteppingTest, Lengths) {
+  const std::vector<std::vector<uint8_t>> instructions = {
+      {0x55},                                     // push rbp
+      {0x48, 0x89, 0xe5},                         // mov rbp, rsp
+      {0x48, 0x83, 0xec, 0x10},                   // sub rsp, 0x10
+      {0x89, 0x7d, 0xfc},                         // mov [rbp-4], edi
+      {0x8b, 0x44, 0x24, 0x08},                   // mov eax, [rsp+8]
+      {0x8b, 0x04, 0x25, 0x00, 0x10, 0x00, 0x00}, // mov eax, [0x1000]
+      {0x48, 0xb8, 1, 2, 3, 4, 5, 6, 7, 8},       // movabs rax, imm64
+      {0x66, 0xb8, 0x34, 0x12},                   // mov ax, 0x1234
+      {0xf7, 0xc7, 1, 0, 0, 0},                   // test edi, 1
+      {0xf7, 0xd8},                               // neg eax
+      {0xf3, 0x0f, 0x1e, 0xfa},                   // endbr64
+      {0x0f, 0x1f, 0x44, 0x00, 0x00},             // nopl [rax+rax]
+      {0x66, 0x0f, 0x3a, 0x0f, 0xc1, 0x08},       // palignr xmm0, xmm1, 8
+      {0xf3, 0x48, 0xa5},                         // rep movsq
+      {0xc3},                                     // ret
+  };
+  for (const std::vector<uint8_t> &bytes : instructions) {
+    llvm::Expected<DisplacedInstruction> insn = Decode(bytes);
+    ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+    EXPECT_EQ(bytes, GetBytes(*insn));
+    EXPECT_FALSE(insn->IsCall());
+  }
+}
+
+TEST(DisplacedSteppingTest, RipRelative) {
+  // mov rax, [rip+0x10]
+  llvm::Expected<DisplacedInstruction> insn =
+      Decode({0x48, 0x8b, 0x05, 0x10, 0x00, 0x00, 0x00});
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  // 0x10 + (kFrom - kTo) = 0xf10
+  EXPECT_EQ(std::vector<uint8_t>({0x48, 0x8b, 0x05, 0x10, 0x0f, 0x00, 0x00}),
+            GetBytes(*insn));
+  EXPECT_EQ(kFrom + 7, insn->FixupPC(kTo + 7));
+
+  // cmp dword ptr [rip+0x10], 1 has an immediate after the displacement.
+  insn = Decode({0x83, 0x3d, 0x10, 0x00, 0x00, 0x00, 0x01});
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_EQ(std::vector<uint8_t>({0x83, 0x3d, 0x10, 0x0f, 0x00, 0x00, 0x01}),
+            GetBytes(*insn));
+
+  // Out of reach of the scratch area.
+  EXPECT_THAT_EXPECTED(
+      DisplacedInstruction::DecodeX86_64({0x8b, 0x05, 0, 0, 0, 0}, kFrom,
+                                         kFrom + 0x100000000),
+      llvm::Failed());
+}
+
+TEST(DisplacedSteppingTest, Branches) {
+  // jne +0x20
+  llvm::Expected<DisplacedInstruction> insn = Decode({0x75, 0x20});
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_EQ(kFrom + 2, insn->FixupPC(kTo + 2));
+  EXPECT_EQ(kFrom + 2 + 0x20, insn->FixupPC(kTo + 2 + 0x20));
+
+  // call +0x100
+  insn = Decode({0xe8, 0x00, 0x01, 0x00, 0x00});
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_TRUE(insn->IsCall());
+  EXPECT_EQ(kFrom + 5, insn->GetReturnAddress());
+  EXPECT_EQ(kFrom + 5 + 0x100, insn->FixupPC(kTo + 5 + 0x100));
+
+  // call rax goes to an absolute address.
+  insn = Decode({0xff, 0xd0});
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_TRUE(insn->IsCall());
+  EXPECT_EQ(0x401000u, insn->FixupPC(0x401000));
+
+  // jmp [rip+0x10], as found in PLT entries.
+  insn = Decode({0xff, 0x25, 0x10, 0x00, 0x00, 0x00});
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_FALSE(insn->IsCall());
+  EXPECT_EQ(std::vector<uint8_t>({0xff, 0x25, 0x10, 0x0f, 0x00, 0x00}),
+            GetBytes(*insn));
+  EXPECT_EQ(0x401000u, insn->FixupPC(0x401000));
+}
+
+TEST(DisplacedSteppingTest, Unsupported) {
+  EXPECT_THAT_EXPECTED(Decode({0x0f, 0x05}), llvm::Failed()); // syscall
+  EXPECT_THAT_EXPECTED(Decode({0xcd, 0x80}), llvm::Failed()); // int 0x80
+  EXPECT_THAT_EXPECTED(Decode({0x9c}), llvm::Failed());       // pushf
+  EXPECT_THAT_EXPECTED(Decode({0xff, 0x2c, 0x24}), llvm::Failed()); // ljmp
+  EXPECT_THAT_EXPECTED(Decode({0xc5, 0xf8, 0x77}), llvm::Failed()); // vzeroupper
+  EXPECT_THAT_EXPECTED(
+      DisplacedInstruction::DecodeX86_64({0x48, 0x8b}, kFrom, kTo),
+      llvm::Failed()); // truncated
+}
+
+static llvm::Expected<DisplacedInstruction> DecodePPC64LE(uint32_t word) {
+  const std::vector<uint8_t> bytes = {
+      uint8_t(word), uint8_t(word >> 8), uint8_t(word >> 16),
+      uint8_t(word >> 24), 0x08, 0x00, 0xe0, 0x7f}; // followed by a trap
+  return DisplacedInstruction::DecodePPC64LE(bytes, kFrom, kTo);
+}
+
+TEST(DisplacedSteppingTest, PPC64LE) {
+  const std::vector<uint32_t> instructions = {
+      0x38630001, // addi r3, r3, 1
+      0xe9210008, // ld r9, 8(r1)
+      0x7c0802a6, // mflr r0
+      0x4e800020, // blr
+  };
+  for (uint32_t word : instructions) {
+    llvm::Expected<DisplacedInstruction> insn = DecodePPC64LE(word);
+    ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+    EXPECT_EQ(4u, insn->GetSize());
+    EXPECT_FALSE(insn->SetsLinkRegister());
+    EXPECT_EQ(kFrom + 4, insn->FixupPC(kTo + 4));
+  }
+
+  // b +0x100
+  llvm::Expected<DisplacedInstruction> insn = DecodePPC64LE(0x48000100);
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_FALSE(insn->SetsLinkRegister());
+  EXPECT_EQ(kFrom + 0x100, insn->FixupPC(kTo + 0x100));
+
+  // beq +0x20, taken or not.
+  insn = DecodePPC64LE(0x41820020);
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_EQ(kFrom + 0x20, insn->FixupPC(kTo + 0x20));
+  EXPECT_EQ(kFrom + 4, insn->FixupPC(kTo + 4));
+
+  // bl +0x100
+  insn = DecodePPC64LE(0x48000101);
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_TRUE(insn->SetsLinkRegister());
+  EXPECT_EQ(kFrom + 4, insn->GetReturnAddress());
+  EXPECT_EQ(kFrom + 0x100, insn->FixupPC(kTo + 0x100));
+
+  // bctrl goes to an absolute address.
+  insn = DecodePPC64LE(0x4e800421);
+  ASSERT_THAT_EXPECTED(insn, llvm::Succeeded());
+  EXPECT_TRUE(insn->SetsLinkRegister());
+  EXPECT_EQ(0x10001000u, insn->FixupPC(0x10001000));
+}
+
+TEST(DisplacedSteppingTest, PPC64LEUnsupported) {
+  EXPECT_THAT_EXPECTED(DecodePPC64LE(0x44000002), llvm::Failed()); // sc
+  EXPECT_THAT_EXPECTED(DecodePPC64LE(0x7fe00008), llvm::Failed()); // trap
+  EXPECT_THAT_EXPECTED(DecodePPC64LE(0x7c602028), llvm::Failed()); // lwarx
+  EXPECT_THAT_EXPECTED(DecodePPC64LE(0x7c6021ad), llvm::Failed()); // stdcx.
+  EXPECT_THAT_EXPECTED(DecodePPC64LE(0x4c600004), llvm::Failed()); // addpcis
+  EXPECT_THAT_EXPECTED(DecodePPC64LE(0x04100000), llvm::Failed()); // prefix
+  EXPECT_THAT_EXPECTED(
+      DisplacedInstruction::DecodePPC64LE({0x01, 0x00}, kFrom, kTo),
+      llvm::Failed()); // truncated
+}
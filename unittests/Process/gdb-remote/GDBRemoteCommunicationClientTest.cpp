@@ -316,6 +316,31 @@ TEST_F(GDBRemoteCommunicationClientTest, SendSignalsToIgnore) {
   EXPECT_TRUE(result.get().Success());
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, SendGDBStoppointTypePacket) {
+  const lldb::addr_t addr = 0x1000;
+  std::future<uint8_t> result = std::async(std::launch::async, [&] {
+    return client.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr,
+                                             1, {{0x22, 0x01, 0x27}}, 0x10);
+  });
+  HandlePacket(server, "Z0,1000,1;X3,220127;I10", "OK");
+  EXPECT_EQ(0, result.get());
+
+  // Removing a breakpoint doesn't take stop options.
+  result = std::async(std::launch::async, [&] {
+    return client.SendGDBStoppointTypePacket(eBreakpointSoftware, false, addr,
+                                             1, {{0x22, 0x01, 0x27}}, 0x10);
+  });
+  HandlePacket(server, "z0,1000,1", "OK");
+  EXPECT_EQ(0, result.get());
+
+  result = std::async(std::launch::async, [&] {
+    return client.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr,
+                                             1);
+  });
+  HandlePacket(server, "Z0,1000,1", "E22");
+  EXPECT_EQ(0x22, result.get());
+}
+
 TEST_F(GDBRemoteCommunicationClientTest, GetMemoryRegionInfo) {
   const lldb::addr_t addr = 0xa000;
   MemoryRegionInfo region_info;
@@ -342,6 +367,65 @@ TEST_F(GDBRemoteCommunicationClientTest, GetMemoryRegionInfoInvalidResponse) {
   EXPECT_FALSE(result.get().Success());
 }
 
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRanges) {
+  char buf1[4] = {0};
+  char buf2[8] = {0};
+  char buf3[2] = {0};
+  MemoryReadRange ranges[] = {MemoryReadRange(0x1000, buf1, sizeof(buf1)),
+                              MemoryReadRange(0x2000, buf2, sizeof(buf2)),
+                              MemoryReadRange(0x3000, buf3, sizeof(buf3))};
+  std::future<bool> result = std::async(
+      std::launch::async, [&] { return client.ReadMemoryRanges(ranges); });
+
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ(R"(jMemoryReadMulti:[{"address":4096,"size":4},)"
+            R"({"address":8192,"size":8},{"address":12288,"size":2}])",
+            request.GetStringRef());
+  // The first range is split over two packets, the second one can only be
+  // read in part and the third one not at all.
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("b2;AB"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("b2;CD3;EFG0;"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("b0;"));
+  ASSERT_EQ(PacketResult::Success, server.SendOKResponse());
+
+  ASSERT_TRUE(result.get());
+  EXPECT_EQ(4u, ranges[0].bytes_read);
+  EXPECT_EQ("ABCD", std::string(buf1, ranges[0].bytes_read));
+  EXPECT_EQ(3u, ranges[1].bytes_read);
+  EXPECT_EQ("EFG", std::string(buf2, ranges[1].bytes_read));
+  EXPECT_EQ(0u, ranges[2].bytes_read);
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadMemoryRangesInvalidResponse) {
+  char buf[4] = {0};
+  MemoryReadRange ranges[] = {MemoryReadRange(0x1000, buf, sizeof(buf))};
+  std::future<bool> result = std::async(
+      std::launch::async, [&] { return client.ReadMemoryRanges(ranges); });
+
+  // More data than the range can hold.
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("b8;ABCDEFGH"));
+  ASSERT_EQ(PacketResult::Success, server.SendOKResponse());
+  EXPECT_FALSE(result.get());
+  EXPECT_EQ(0u, ranges[0].bytes_read);
+
+  result = std::async(std::launch::async,
+                      [&] { return client.ReadMemoryRanges(ranges); });
+  HandlePacket(server, R"(jMemoryReadMulti:[{"address":4096,"size":4}])",
+               "E08");
+  EXPECT_FALSE(result.get());
+
+  result = std::async(std::launch::async,
+                      [&] { return client.ReadMemoryRanges(ranges); });
+  HandlePacket(server, R"(jMemoryReadMulti:[{"address":4096,"size":4}])", "");
+  EXPECT_FALSE(result.get());
+
+  // The server doesn't know the packet, so it shouldn't be sent again.
+  EXPECT_FALSE(client.ReadMemoryRanges(ranges));
+}
+
 TEST_F(GDBRemoteCommunicationClientTest, SendStartTracePacket) {
   TraceOptions options;
   Status error;
@@ -534,3 +618,92 @@ TEST_F(GDBRemoteCommunicationClientTest, SendGetTraceConfigPacket) {
       incorrect_custom_params2);
   ASSERT_FALSE(result4.get().Success());
 }
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadFileRange) {
+  std::string data;
+  std::future<uint64_t> result = std::async(std::launch::async, [&] {
+    Status error;
+    uint64_t bytes_read = client.ReadFileRange(
+        5, 0x10, 10, 4, 2,
+        [&data](llvm::ArrayRef<uint8_t> bytes) {
+          data.append(bytes.begin(), bytes.end());
+          return true;
+        },
+        error);
+    EXPECT_TRUE(error.Success());
+    return bytes_read;
+  });
+
+  // The whole window is requested before the first reply.
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,4,16", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,4,20", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F4;abcd"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F4;efgh"));
+  HandlePacket(server, "vFile:pread:5,2,24", "F2;ij");
+
+  ASSERT_EQ(10u, result.get());
+  ASSERT_EQ("abcdefghij", data);
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadFileRangeShortRead) {
+  std::string data;
+  std::future<uint64_t> result = std::async(std::launch::async, [&] {
+    Status error;
+    uint64_t bytes_read = client.ReadFileRange(
+        5, 0, 8, 4, 2,
+        [&data](llvm::ArrayRef<uint8_t> bytes) {
+          data.append(bytes.begin(), bytes.end());
+          return true;
+        },
+        error);
+    EXPECT_TRUE(error.Success());
+    return bytes_read;
+  });
+
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,4,0", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,4,4", request.GetStringRef());
+  // The first read comes up short, so the reply to the second one is
+  // dropped, and the transfer resumes where the first one stopped.
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F2;ab"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F4;XXXX"));
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,4,2", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,2,6", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F4;cdef"));
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F2;gh"));
+
+  ASSERT_EQ(8u, result.get());
+  ASSERT_EQ("abcdefgh", data);
+}
+
+TEST_F(GDBRemoteCommunicationClientTest, ReadFileRangeEndOfFile) {
+  std::future<uint64_t> result = std::async(std::launch::async, [&] {
+    Status error;
+    uint64_t bytes_read = client.ReadFileRange(
+        5, 0, UINT64_MAX, 4, 2,
+        [](llvm::ArrayRef<uint8_t>) { return true; }, error);
+    EXPECT_TRUE(error.Success());
+    return bytes_read;
+  });
+
+  StringExtractorGDBRemote request;
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,4,0", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,4,4", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F4;abcd"));
+  ASSERT_EQ(PacketResult::Success, server.GetPacket(request));
+  ASSERT_EQ("vFile:pread:5,4,8", request.GetStringRef());
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F0;"));
+  // The request made before the end of the file was seen is drained.
+  ASSERT_EQ(PacketResult::Success, server.SendPacket("F0;"));
+
+  ASSERT_EQ(4u, result.get());
+}
@@ -21,6 +21,11 @@ public:
   TestClient()
       : GDBRemoteCommunication("test.client", "test.client.listener") {}
 
+  void SetCompression(CompressionType type) {
+    m_compression_type = type;
+    m_send_acks = false;
+  }
+
   PacketResult ReadPacket(StringExtractorGDBRemote &response) {
     return GDBRemoteCommunication::ReadPacket(response, std::chrono::seconds(1),
                                               /*sync_on_timeout*/ false);
@@ -65,3 +70,33 @@ TEST_F(GDBRemoteCommunicationTest, ReadPacket_checksum) {
     ASSERT_EQ(PacketResult::Success, server.GetAck());
   }
 }
+
+TEST_F(GDBRemoteCommunicationTest, ReadPacket_compressed) {
+  std::string large;
+  for (int i = 0; i < 100; ++i)
+    large += "thread:" + std::to_string(i) + ";reason:signal;}]";
+  const std::string expected_large = [&large] {
+    std::string result;
+    for (size_t i = 0; i < large.size(); ++i)
+      result.push_back(large[i] == '}' ? large[++i] ^ 0x20 : large[i]);
+    return result;
+  }();
+
+  for (CompressionType type :
+       {CompressionType::ZlibDeflate, CompressionType::LZ4}) {
+    if (!MockServer::CanCompressWith(type))
+      continue;
+    SCOPED_TRACE(static_cast<int>(type));
+    client.SetCompression(type);
+    server.SetSendCompression(type);
+
+    StringExtractorGDBRemote response;
+    ASSERT_EQ(PacketResult::Success, server.SendPacket("OK"));
+    ASSERT_EQ(PacketResult::Success, client.ReadPacket(response));
+    ASSERT_EQ("OK", response.GetStringRef());
+
+    ASSERT_EQ(PacketResult::Success, server.SendPacket(large));
+    ASSERT_EQ(PacketResult::Success, client.ReadPacket(response));
+    ASSERT_EQ(expected_large, response.GetStringRef());
+  }
+}
@@ -0,0 +1,184 @@
+//===-- GDBRemoteConditionCompilerTest.cpp ----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "Plugins/Process/gdb-remote/GDBRemoteConditionCompiler.h"
+#include "lldb/Host/common/NativeBreakpointCondition.h"
+
+#include <map>
+
+using namespace lldb_private::process_gdb_remote;
+using namespace lldb_private;
+using namespace lldb;
+
+namespace {
+
+// A fake inferior: variables live either in registers or in memory.
+class ConditionCompilerTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    // "a" is an int in register 0, "b" an unsigned char in register 1 and
+    // "x" an int in register 2.
+    m_registers[0] = 5;
+    m_registers[1] = 0xff;
+    m_registers[2] = 0;
+    // "m" is an int at 0x1000.
+    const uint32_t m = 42;
+    for (size_t i = 0; i < sizeof(m); ++i)
+      m_memory[0x1000 + i] = reinterpret_cast<const uint8_t *>(&m)[i];
+  }
+
+  Status Resolve(llvm::StringRef name, GDBRemoteConditionCompiler &compiler,
+                 GDBRemoteConditionCompiler::ValueType &type) {
+    if (name == "a" || name == "x") {
+      compiler.EmitRegister(name == "a" ? 0 : 2);
+      type.bit_size = 32;
+      type.is_signed = true;
+    } else if (name == "b") {
+      compiler.EmitRegister(1);
+      type.bit_size = 8;
+      type.is_signed = false;
+    } else if (name == "m") {
+      compiler.EmitConstant(0x1000);
+      compiler.EmitLoad(4);
+      type.bit_size = 32;
+      type.is_signed = true;
+    } else
+      return Status("unknown identifier");
+    return Status();
+  }
+
+  Status Compile(llvm::StringRef expression, std::vector<uint8_t> &bytecode) {
+    GDBRemoteConditionCompiler compiler(
+        expression,
+        [this](llvm::StringRef name, GDBRemoteConditionCompiler &compiler,
+               GDBRemoteConditionCompiler::ValueType &type) {
+          return Resolve(name, compiler, type);
+        });
+    return compiler.Compile(bytecode);
+  }
+
+  // Compile "expression" and evaluate it the way lldb-server does.
+  ::testing::AssertionResult Evaluate(llvm::StringRef expression,
+                                      bool &result) {
+    std::vector<uint8_t> bytecode;
+    Status error = Compile(expression, bytecode);
+    if (error.Fail())
+      return ::testing::AssertionFailure() << "compile: " << error.AsCString();
+
+    NativeBreakpointCondition condition(bytecode);
+    error = condition.Validate();
+    if (error.Fail())
+      return ::testing::AssertionFailure() << "validate: " << error.AsCString();
+
+    auto read_register = [this](uint32_t regnum, uint64_t &value) {
+      auto pos = m_registers.find(regnum);
+      if (pos == m_registers.end())
+        return false;
+      value = pos->second;
+      return true;
+    };
+    auto read_memory = [this](addr_t addr, void *buf, size_t size) {
+      for (size_t i = 0; i < size; ++i) {
+        auto pos = m_memory.find(addr + i);
+        if (pos == m_memory.end())
+          return false;
+        static_cast<uint8_t *>(buf)[i] = pos->second;
+      }
+      return true;
+    };
+    error = condition.Evaluate(read_register, read_memory, result);
+    if (error.Fail())
+      return ::testing::AssertionFailure() << "evaluate: " << error.AsCString();
+    return ::testing::AssertionSuccess();
+  }
+
+  bool IsTrue(llvm::StringRef expression) {
+    bool result = false;
+    EXPECT_TRUE(Evaluate(expression, result)) << expression.str();
+    return result;
+  }
+
+  std::map<uint32_t, uint64_t> m_registers;
+  std::map<addr_t, uint8_t> m_memory;
+};
+
+} // end anonymous namespace
+
+TEST_F(ConditionCompilerTest, Arithmetic) {
+  EXPECT_TRUE(IsTrue("1 + 2 * 3 == 7"));
+  EXPECT_TRUE(IsTrue("(1 + 2) * 3 == 9"));
+  EXPECT_TRUE(IsTrue("10 - 4 - 3 == 3"));
+  EXPECT_TRUE(IsTrue("17 / 5 == 3 && 17 % 5 == 2"));
+  EXPECT_TRUE(IsTrue("1 << 4 == 16 && 0x100 >> 4 == 0x10"));
+  EXPECT_TRUE(IsTrue("(6 & 3) == 2 && (6 | 3) == 7 && (6 ^ 3) == 5"));
+  EXPECT_TRUE(IsTrue("-7 / 2 == -3"));
+  EXPECT_TRUE(IsTrue("~0 == -1"));
+  EXPECT_FALSE(IsTrue("0"));
+  EXPECT_TRUE(IsTrue("true"));
+}
+
+TEST_F(ConditionCompilerTest, Comparisons) {
+  EXPECT_TRUE(IsTrue("a == 5"));
+  EXPECT_FALSE(IsTrue("a != 5"));
+  EXPECT_TRUE(IsTrue("a < 6 && a <= 5 && a > 4 && a >= 5"));
+  EXPECT_FALSE(IsTrue("a < 5 || a > 5"));
+  EXPECT_TRUE(IsTrue("m == 42"));
+}
+
+TEST_F(ConditionCompilerTest, Conversions) {
+  m_registers[0] = 0xffffffff; // a = -1
+  EXPECT_TRUE(IsTrue("a == -1"));
+  EXPECT_TRUE(IsTrue("a < 0"));
+  // -1 converted to unsigned int.
+  EXPECT_FALSE(IsTrue("a < 0u"));
+  EXPECT_TRUE(IsTrue("a == 0xffffffff"));
+  EXPECT_TRUE(IsTrue("-a == 1"));
+  // A 64 bit constant doesn't make the comparison unsigned.
+  EXPECT_TRUE(IsTrue("a < 0x100000000"));
+
+  // Unsigned char promotes to int.
+  EXPECT_TRUE(IsTrue("b == 255"));
+  EXPECT_TRUE(IsTrue("b > -1"));
+  EXPECT_TRUE(IsTrue("b + 1 == 256"));
+
+  // Wrap around in 32 bits.
+  EXPECT_TRUE(IsTrue("0xffffffffu + 1 == 0"));
+}
+
+TEST_F(ConditionCompilerTest, ShortCircuit) {
+  // Dividing by zero is an error, so these only work if the right hand side
+  // isn't evaluated.
+  EXPECT_FALSE(IsTrue("x && 10 / x > 1"));
+  EXPECT_TRUE(IsTrue("!x || 10 / x > 1"));
+  m_registers[2] = 2;
+  EXPECT_TRUE(IsTrue("x && 10 / x > 1"));
+  EXPECT_TRUE(IsTrue("(x || 0) == 1"));
+  EXPECT_TRUE(IsTrue("!(x && 0)"));
+}
+
+TEST_F(ConditionCompilerTest, Errors) {
+  std::vector<uint8_t> bytecode;
+  EXPECT_TRUE(Compile("", bytecode).Fail());
+  EXPECT_TRUE(Compile("a = 5", bytecode).Fail());
+  EXPECT_TRUE(Compile("foo(1)", bytecode).Fail());
+  EXPECT_TRUE(Compile("s.field == 1", bytecode).Fail());
+  EXPECT_TRUE(Compile("a == 1.5", bytecode).Fail());
+  EXPECT_TRUE(Compile("(a == 1", bytecode).Fail());
+  EXPECT_TRUE(Compile("a == 1)", bytecode).Fail());
+  EXPECT_TRUE(Compile("unknown == 1", bytecode).Fail());
+}
+
+TEST_F(ConditionCompilerTest, EvaluationErrors) {
+  bool result;
+  EXPECT_FALSE(Evaluate("10 / x", result));
+  m_memory.clear();
+  EXPECT_FALSE(Evaluate("m == 42", result));
+}
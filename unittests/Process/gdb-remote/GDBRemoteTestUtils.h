@@ -42,6 +42,11 @@ struct MockServer : public GDBRemoteCommunicationServer {
                                sync_on_timeout);
   }
 
+  void SetSendCompression(CompressionType type) {
+    m_send_compression_type = type;
+  }
+
+  using GDBRemoteCommunicationServer::CanCompressWith;
   using GDBRemoteCommunicationServer::SendOKResponse;
   using GDBRemoteCommunicationServer::SendUnimplementedResponse;
 };
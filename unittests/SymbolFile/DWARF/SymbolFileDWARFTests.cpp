@@ -14,21 +14,31 @@
 #include "llvm/DebugInfo/PDB/PDBSymbolExe.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/Process.h"
 
 #include "Plugins/ObjectFile/PECOFF/ObjectFilePECOFF.h"
+#include "Plugins/SymbolFile/DWARF/DWARFDIEArena.h"
+#include "Plugins/SymbolFile/DWARF/DWARFDebugInfoEntry.h"
+#include "Plugins/SymbolFile/DWARF/DWARFDebugNames.h"
+#include "Plugins/SymbolFile/DWARF/DWARFIndexCache.h"
+#include "Plugins/SymbolFile/DWARF/NameToDIE.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
 #include "Plugins/SymbolFile/PDB/SymbolFilePDB.h"
 #include "TestingSupport/TestUtilities.h"
 #include "lldb/Core/Address.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/FileSystem.h"
 #include "lldb/Host/HostInfo.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/LineTable.h"
 #include "lldb/Symbol/SymbolVendor.h"
 #include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/FileSpec.h"
+#include "lldb/Utility/RegularExpression.h"
+#include "lldb/Utility/StreamString.h"
 
 using namespace lldb_private;
 
@@ -74,3 +84,214 @@ TEST_F(SymbolFileDWARFTests, TestAbilitiesForDWARF) {
   uint32_t expected_abilities = SymbolFile::kAllAbilities;
   EXPECT_EQ(expected_abilities, symfile->CalculateAbilities());
 }
+
+TEST_F(SymbolFileDWARFTests, TestNameToDIEEncodeDecode) {
+  NameToDIE index;
+  index.Insert(ConstString("main"), DIERef(0x0, 0x2a));
+  index.Insert(ConstString("foo"), DIERef(0x100, 0x140));
+  index.Insert(ConstString("main"), DIERef(0x100, 0x180));
+  index.Finalize();
+
+  DWARFIndexCacheStringTable write_strtab;
+  StreamString strm(Stream::eBinary, 4, lldb::eByteOrderLittle);
+  index.Encode(strm, write_strtab);
+  // Names are only stored once no matter how many DIEs refer to them.
+  EXPECT_EQ(2u, write_strtab.GetSize());
+
+  StreamString strtab_strm(Stream::eBinary, 4, lldb::eByteOrderLittle);
+  write_strtab.Encode(strtab_strm);
+
+  DWARFIndexCacheStringTable read_strtab;
+  DataExtractor strtab_data(strtab_strm.GetData(), strtab_strm.GetSize(),
+                            lldb::eByteOrderLittle, 4);
+  lldb::offset_t offset = 0;
+  ASSERT_TRUE(read_strtab.Decode(strtab_data, &offset));
+
+  NameToDIE decoded;
+  DataExtractor data(strm.GetData(), strm.GetSize(), lldb::eByteOrderLittle,
+                     4);
+  offset = 0;
+  ASSERT_TRUE(decoded.Decode(data, &offset, read_strtab));
+  decoded.Finalize();
+  EXPECT_EQ(strm.GetSize(), offset);
+
+  DIEArray die_offsets;
+  EXPECT_EQ(2u, decoded.Find(ConstString("main"), die_offsets));
+  die_offsets.clear();
+  ASSERT_EQ(1u, decoded.Find(ConstString("foo"), die_offsets));
+  EXPECT_EQ(0x100u, die_offsets[0].cu_offset);
+  EXPECT_EQ(0x140u, die_offsets[0].die_offset);
+
+  // Truncated data must be rejected rather than partially decoded.
+  NameToDIE truncated;
+  DataExtractor truncated_data(strm.GetData(), strm.GetSize() - 1,
+                               lldb::eByteOrderLittle, 4);
+  offset = 0;
+  EXPECT_FALSE(truncated.Decode(truncated_data, &offset, read_strtab));
+}
+
+TEST_F(SymbolFileDWARFTests, TestDebugNamesLookup) {
+  // A name index for a single compile unit at offset zero that contains a
+  // function "foo" and a variable "bar".
+  StreamString body(Stream::eBinary, 4, lldb::eByteOrderLittle);
+  body.PutHex16(5); // version
+  body.PutHex16(0); // padding
+  body.PutHex32(1); // comp_unit_count
+  body.PutHex32(0); // local_type_unit_count
+  body.PutHex32(0); // foreign_type_unit_count
+  body.PutHex32(1); // bucket_count
+  body.PutHex32(2); // name_count
+  body.PutHex32(13); // abbrev_table_size
+  body.PutHex32(0); // augmentation_string_size
+  body.PutHex32(0); // CU list
+  body.PutHex32(1); // buckets
+  body.PutHex32(DWARFDebugNames::HashName("foo"));
+  body.PutHex32(DWARFDebugNames::HashName("bar"));
+  body.PutHex32(0); // string offsets
+  body.PutHex32(4);
+  body.PutHex32(0); // entry offsets
+  body.PutHex32(6);
+  const uint8_t abbrevs[] = {0x01, DW_TAG_subprogram, 0x03, DW_FORM_ref4,
+                             0x00, 0x00,
+                             0x02, DW_TAG_variable,   0x03, DW_FORM_ref4,
+                             0x00, 0x00,
+                             0x00};
+  body.Write(abbrevs, sizeof(abbrevs));
+  body.PutHex8(1); // "foo" entry
+  body.PutHex32(0x20);
+  body.PutHex8(0);
+  body.PutHex8(2); // "bar" entry
+  body.PutHex32(0x30);
+  body.PutHex8(0);
+
+  StreamString section(Stream::eBinary, 4, lldb::eByteOrderLittle);
+  section.PutHex32(body.GetSize());
+  section.Write(body.GetData(), body.GetSize());
+
+  const char strings[] = "foo\0bar";
+  DWARFDataExtractor names_data;
+  names_data.SetData(section.GetData(), section.GetSize(),
+                     lldb::eByteOrderLittle);
+  DWARFDataExtractor str_data;
+  str_data.SetData(strings, sizeof(strings), lldb::eByteOrderLittle);
+
+  DWARFDebugNames debug_names(names_data, str_data);
+  ASSERT_TRUE(debug_names.IsValid());
+  EXPECT_TRUE(debug_names.IndexesCompileUnit(0));
+  EXPECT_FALSE(debug_names.IndexesCompileUnit(0x40));
+
+  DIEArray die_offsets;
+  ASSERT_EQ(1u, debug_names.FindFunctions("foo", die_offsets));
+  EXPECT_EQ(0u, die_offsets[0].cu_offset);
+  EXPECT_EQ(0x20u, die_offsets[0].die_offset);
+
+  die_offsets.clear();
+  EXPECT_EQ(0u, debug_names.FindGlobalVariables("foo", die_offsets));
+  EXPECT_EQ(0u, debug_names.FindByName("FOO", die_offsets));
+  EXPECT_EQ(0u, debug_names.FindByName("baz", die_offsets));
+  ASSERT_EQ(1u, debug_names.FindGlobalVariables("bar", die_offsets));
+  EXPECT_EQ(0x30u, die_offsets[0].die_offset);
+
+  die_offsets.clear();
+  RegularExpression regex(llvm::StringRef("^b"));
+  EXPECT_EQ(0u, debug_names.AppendFunctionsMatchingRegex(regex, die_offsets));
+  EXPECT_EQ(1u,
+            debug_names.AppendGlobalVariablesMatchingRegex(regex, die_offsets));
+}
+
+TEST_F(SymbolFileDWARFTests, TestDIEArenaRelease) {
+  DWARFDIEArena arena;
+  std::vector<DWARFDebugInfoEntry> dies(3);
+  dies[1].SetEmptyChildren(true);
+
+  llvm::MutableArrayRef<DWARFDebugInfoEntry> first = arena.Allocate(dies);
+  ASSERT_EQ(3u, first.size());
+  EXPECT_TRUE(first[1].GetEmptyChildren());
+  llvm::MutableArrayRef<DWARFDebugInfoEntry> second =
+      arena.Allocate(llvm::makeArrayRef(dies).take_front(1));
+  ASSERT_EQ(1u, second.size());
+
+  DWARFDIEArena::Statistics stats = arena.GetStatistics();
+  EXPECT_EQ(4u, stats.num_dies);
+  EXPECT_EQ(2u, stats.num_arrays);
+  EXPECT_EQ(4 * sizeof(DWARFDebugInfoEntry), stats.bytes_used);
+  EXPECT_LE(stats.bytes_used, stats.bytes_allocated);
+
+  // Releasing the whole unit array must free its memory.
+  arena.Release(first);
+  stats = arena.GetStatistics();
+  EXPECT_EQ(1u, stats.num_dies);
+  EXPECT_GT(stats.bytes_allocated, 0u);
+
+  // Once nothing is in use, nothing is held.
+  arena.Release(second);
+  stats = arena.GetStatistics();
+  EXPECT_EQ(0u, stats.num_dies);
+  EXPECT_EQ(0u, stats.num_arrays);
+  EXPECT_EQ(0u, stats.bytes_allocated);
+}
+
+TEST_F(SymbolFileDWARFTests, TestIndexCacheSaveLoad) {
+  namespace fs = llvm::sys::fs;
+  llvm::SmallString<128> cache_dir;
+  ASSERT_FALSE(fs::createUniqueDirectory("DWARFIndexCache", cache_dir));
+  // Work on a copy of the object file so that its modification time can be
+  // changed below.
+  llvm::SmallString<128> exe_path(cache_dir);
+  llvm::sys::path::append(exe_path, "test-dwarf.exe");
+  ASSERT_FALSE(fs::copy_file(m_dwarf_test_exe, exe_path));
+
+  FileSpec exe_spec(exe_path.str(), false);
+  FileSpec cache_spec(cache_dir.str(), false);
+  lldb::ModuleSP module =
+      std::make_shared<Module>(exe_spec, ArchSpec("i686-pc-windows"));
+  ObjectFile *objfile = module->GetObjectFile();
+  ASSERT_NE(nullptr, objfile);
+
+  NameToDIE functions, types;
+  functions.Insert(ConstString("main"), DIERef(0x0, 0x2a));
+  functions.Insert(ConstString("foo"), DIERef(0x100, 0x140));
+  types.Insert(ConstString("foo"), DIERef(0x100, 0x180));
+  functions.Finalize();
+  types.Finalize();
+
+  DWARFIndexCache cache(*objfile, cache_spec);
+  ASSERT_TRUE(cache.IsValid());
+  ASSERT_TRUE(cache.Save({&functions, &types}));
+  EXPECT_TRUE(cache.GetCacheFile().Exists());
+
+  NameToDIE loaded_functions, loaded_types;
+  DWARFIndexCache reopened(*objfile, cache_spec);
+  EXPECT_EQ(cache.GetCacheFile(), reopened.GetCacheFile());
+  ASSERT_TRUE(reopened.Load({&loaded_functions, &loaded_types}));
+  DIEArray die_offsets;
+  EXPECT_EQ(1u, loaded_functions.Find(ConstString("main"), die_offsets));
+  EXPECT_EQ(1u, loaded_functions.Find(ConstString("foo"), die_offsets));
+  EXPECT_EQ(1u, loaded_types.Find(ConstString("foo"), die_offsets));
+  ASSERT_EQ(3u, die_offsets.size());
+  EXPECT_EQ(0x2au, die_offsets[0].die_offset);
+  EXPECT_EQ(0x140u, die_offsets[1].die_offset);
+  EXPECT_EQ(0x180u, die_offsets[2].die_offset);
+
+  // A cache written with a different set of tables doesn't match.
+  NameToDIE single;
+  EXPECT_FALSE(reopened.Load({&single}));
+
+  // Once the object file has been modified, the cache entry is stale and
+  // must be ignored.
+  int fd;
+  ASSERT_FALSE(fs::openFileForWrite(exe_path, fd, fs::F_Append));
+  ASSERT_FALSE(fs::setLastModificationAndAccessTime(
+      fd, FileSystem::GetModificationTime(exe_spec) + std::chrono::hours(1)));
+  llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+
+  NameToDIE stale_functions, stale_types;
+  DWARFIndexCache stale(*objfile, cache_spec);
+  EXPECT_EQ(cache.GetCacheFile(), stale.GetCacheFile());
+  EXPECT_FALSE(stale.Load({&stale_functions, &stale_types}));
+  die_offsets.clear();
+  EXPECT_EQ(0u, stale_functions.Find(ConstString("main"), die_offsets));
+
+  module.reset();
+  ASSERT_FALSE(fs::remove_directories(cache_dir));
+}
@@ -6,6 +6,7 @@
 
 #include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Host/HostInfo.h"
 #include "lldb/Symbol/SymbolContext.h"
@@ -163,3 +164,58 @@ TEST_F(ModuleCacheTest, GetAndPutStrangeHostname) {
   TryGetAndPut(test_cache_dir, "tab\tcolon:asterisk*", expect_download);
   VerifyDiskState(test_cache_dir, "tab_colon_asterisk_");
 }
+
+TEST_F(ModuleCacheTest, GetAndPutSharesContents) {
+  FileSpec test_cache_root = s_cache_dir;
+  test_cache_root.AppendPathComponent("GetAndPutSharesContents");
+  FileSpec platform1_dir = test_cache_root;
+  platform1_dir.AppendPathComponent("platform1");
+  FileSpec platform2_dir = test_cache_root;
+  platform2_dir.AppendPathComponent("platform2");
+
+  const bool expect_download = true;
+  TryGetAndPut(platform1_dir, dummy_hostname, expect_download);
+  TryGetAndPut(platform2_dir, dummy_hostname, expect_download);
+  VerifyDiskState(platform1_dir, dummy_hostname);
+  VerifyDiskState(platform2_dir, dummy_hostname);
+
+  // Both platforms refer to a single copy of the module.
+  ModuleCache::Statistics stats;
+  Status error = ModuleCache::GetStatistics(test_cache_root, stats);
+  ASSERT_TRUE(error.Success()) << "Error was: " << error.AsCString();
+  EXPECT_EQ(1u, stats.num_blobs);
+  EXPECT_EQ(module_size, stats.total_size);
+  EXPECT_EQ(4u, stats.num_views);
+}
+
+TEST_F(ModuleCacheTest, Prune) {
+  FileSpec test_cache_root = s_cache_dir;
+  test_cache_root.AppendPathComponent("Prune");
+  FileSpec platform_dir = test_cache_root;
+  platform_dir.AppendPathComponent("platform");
+
+  TryGetAndPut(platform_dir, dummy_hostname, true);
+
+  // The module fits in the cache.
+  ModuleCache::Statistics removed;
+  Status error = ModuleCache::Prune(test_cache_root, module_size, removed);
+  ASSERT_TRUE(error.Success()) << "Error was: " << error.AsCString();
+  EXPECT_EQ(0u, removed.num_blobs);
+  EXPECT_EQ(0u, removed.num_views);
+  VerifyDiskState(platform_dir, dummy_hostname);
+
+  // The module and both its views are removed when it does not fit.
+  error = ModuleCache::Prune(test_cache_root, module_size - 1, removed);
+  ASSERT_TRUE(error.Success()) << "Error was: " << error.AsCString();
+  EXPECT_EQ(1u, removed.num_blobs);
+  EXPECT_EQ(module_size, removed.total_size);
+  EXPECT_EQ(2u, removed.num_views);
+  EXPECT_FALSE(GetUuidView(platform_dir).Exists());
+  EXPECT_FALSE(GetSysrootView(platform_dir, dummy_hostname).Exists());
+
+  // It is downloaded again the next time it is needed. Drop the module
+  // loaded before, which could otherwise be found again by its path.
+  ModuleList::RemoveOrphanSharedModules(false);
+  TryGetAndPut(platform_dir, dummy_hostname, true);
+  VerifyDiskState(platform_dir, dummy_hostname);
+}
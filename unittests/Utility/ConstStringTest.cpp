@@ -16,3 +16,35 @@ using namespace lldb_private;
 TEST(ConstStringTest, format_provider) {
   EXPECT_EQ("foo", llvm::formatv("{0}", ConstString("foo")).str());
 }
+
+TEST(ConstStringTest, Uniquing) {
+  std::string str("ConstStringTest::Uniquing");
+  ConstString first(str);
+  // Intern the same string from a different buffer so the lookup can't be
+  // satisfied by comparing pointers.
+  std::string copy(str);
+  ConstString second(copy);
+  EXPECT_EQ(first.GetCString(), second.GetCString());
+
+  // A string that has a common prefix with a cached one must not match it.
+  ConstString prefix(llvm::StringRef(str).drop_back());
+  EXPECT_NE(first.GetCString(), prefix.GetCString());
+  EXPECT_EQ(str.size() - 1, prefix.GetLength());
+}
+
+TEST(ConstStringTest, GetStats) {
+  ConstString::Stats before = ConstString::GetStats();
+  ConstString("ConstStringTest::GetStats 1");
+  ConstString("ConstStringTest::GetStats 2");
+  ConstString("ConstStringTest::GetStats 1");
+  ConstString::Stats after = ConstString::GetStats();
+
+  EXPECT_EQ(before.string_count + 2, after.string_count);
+  EXPECT_LT(before.memory_size, after.memory_size);
+  ASSERT_FALSE(after.shards.empty());
+  size_t shard_string_count = 0;
+  for (const ConstString::ShardStats &shard : after.shards)
+    shard_string_count += shard.string_count;
+  EXPECT_EQ(after.string_count, shard_string_count);
+  EXPECT_EQ(ConstString::StaticMemorySize(), after.memory_size);
+}
@@ -307,3 +307,60 @@ TEST_F(LogChannelEnabledTest, LogGetLogThread) {
   // any undefined behavior (run the test under TSAN to verify this).
   EXPECT_THAT(mask, testing::AnyOf(0, FOO));
 }
+
+TEST_F(LogChannelEnabledTest, LogAsync) {
+  std::string err;
+  EXPECT_TRUE(
+      EnableChannel(getStream(), LLDB_LOG_OPTION_ASYNC, "chan", {}, err));
+
+  // Each thread logs fewer messages than fit in its queue, so nothing is
+  // dropped.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+    threads.emplace_back([this, t] {
+      for (int i = 0; i < 100; ++i)
+        LLDB_LOG(getLog(), "{0} {1}", t, i);
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+  Log::FlushAsyncLogs();
+
+  // All the messages of a thread are written, in order.
+  llvm::SmallVector<llvm::StringRef, 0> lines;
+  takeOutput().split(lines, '\n', -1, false);
+  EXPECT_EQ(400u, lines.size());
+  int next[4] = {0, 0, 0, 0};
+  for (llvm::StringRef line : lines) {
+    int t, i;
+    ASSERT_EQ(2, sscanf(line.str().c_str(), "%d %d", &t, &i)) << line.str();
+    ASSERT_TRUE(t >= 0 && t < 4);
+    EXPECT_EQ(next[t]++, i);
+  }
+
+  // The timestamp is added by the writer.
+  EXPECT_TRUE(EnableChannel(getStream(), LLDB_LOG_OPTION_ASYNC |
+                                             LLDB_LOG_OPTION_PREPEND_TIMESTAMP,
+                            "chan", {}, err));
+  LLDB_LOG(getLog(), "Hello World");
+  // Disabling the channel writes out what it queued.
+  EXPECT_TRUE(DisableChannel("chan", {}, err));
+  double timestamp;
+  EXPECT_EQ(1, sscanf(takeOutput().str().c_str(), "%lf Hello World",
+                      &timestamp));
+}
+
+TEST_F(LogChannelEnabledTest, LogAsyncTerminate) {
+  std::string err;
+  EXPECT_TRUE(
+      EnableChannel(getStream(), LLDB_LOG_OPTION_ASYNC, "chan", {}, err));
+
+  // Stopping the writer writes out what was queued.
+  LLDB_LOG(getLog(), "Hello");
+  Log::Terminate();
+  EXPECT_EQ("Hello\n", takeOutput());
+
+  // Logging again starts a new writer.
+  LLDB_LOG(getLog(), "World");
+  Log::Terminate();
+  EXPECT_EQ("World\n", takeOutput());
+}
@@ -70,3 +70,67 @@ TEST(TimerTest, CategoryTimes2) {
   EXPECT_LT(0.001, seconds2);
   EXPECT_GT(0.1, seconds2);
 }
+
+TEST(TimerTest, Trace) {
+  Timer::ResetTrace();
+  Timer::SetTracing(true);
+  {
+    static Timer::Category tcat1("CAT1");
+    static Timer::Category tcat2("CAT2");
+    Timer t1(tcat1, "outer %d", 1);
+    Timer t2(tcat2, "inner \"%s\"", "quoted");
+  }
+  Timer::SetTracing(false);
+  {
+    static Timer::Category tcat3("CAT3");
+    Timer t3(tcat3, "untraced");
+  }
+  StreamString ss;
+  Timer::DumpTrace(ss);
+  llvm::StringRef trace = ss.GetString();
+  ASSERT_TRUE(trace.startswith("{\"traceEvents\":["));
+  EXPECT_TRUE(trace.contains("\"droppedEvents\":0"));
+  EXPECT_EQ(2U, trace.count("\"ph\":\"X\""));
+  EXPECT_FALSE(trace.contains("untraced"));
+
+  // The outer timer started first, so it is listed first even though it
+  // ended last.
+  size_t outer = trace.find("{\"name\":\"outer 1\",\"cat\":\"CAT1\"");
+  size_t inner =
+      trace.find("{\"name\":\"inner \\\"quoted\\\"\",\"cat\":\"CAT2\"");
+  ASSERT_NE(llvm::StringRef::npos, outer);
+  ASSERT_NE(llvm::StringRef::npos, inner);
+  EXPECT_LT(outer, inner);
+  EXPECT_TRUE(trace.substr(outer, inner - outer).contains("\"depth\":0"));
+  EXPECT_TRUE(trace.substr(inner).contains("\"depth\":1"));
+
+  Timer::ResetTrace();
+  ss.Clear();
+  Timer::DumpTrace(ss);
+  EXPECT_EQ(0U, ss.GetString().count("\"ph\":\"X\""));
+}
+
+TEST(TimerTest, TraceThreads) {
+  Timer::ResetTrace();
+  Timer::SetTracing(true);
+  static Timer::Category tcat("CAT1");
+  auto work = []() { Timer t(tcat, "work"); };
+  std::thread thread1(work), thread2(work);
+  thread1.join();
+  thread2.join();
+  Timer::SetTracing(false);
+
+  StreamString ss;
+  Timer::DumpTrace(ss);
+  llvm::StringRef trace = ss.GetString();
+  EXPECT_EQ(2U, trace.count("\"name\":\"work\""));
+  // The events come from two different threads.
+  size_t first = trace.find("\"name\":\"work\"");
+  size_t second = trace.find("\"name\":\"work\"", first + 1);
+  ASSERT_NE(llvm::StringRef::npos, second);
+  auto get_tid = [&](size_t pos) {
+    return trace.substr(trace.find("\"tid\":", pos)).split(',').first;
+  };
+  EXPECT_NE(get_tid(first), get_tid(second));
+  Timer::ResetTrace();
+}